@@ -1,25 +1,65 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <stdexcept>
-
-template< typename T >
+#include <type_traits>
+
+/**
+ * A list in the manner of java.util.ArrayList. The allocator is std::allocator
+ * except for the scratch lists of ScratchArena.h, which live in the arena of
+ * the current step.
+ *
+ * The elements are only handed out as const, and are changed through set(..),
+ * add(..), remove(..) and the other members, so that layoutVersion() sees
+ * every change that replaces or moves an element.
+ */
+
+template< typename T, typename Allocator = std::allocator<T> >
 class ArrayList 
 {
 public:
+	using const_iterator = typename std::vector<T, Allocator>::const_iterator;
+
+	ArrayList() = default;
 
-	typename std::vector<T>::iterator erase( typename std::vector<T>::iterator pos )
+	/**
+	 * Copy a list of another element type, such as the shared_ptr edges of a
+	 * mesh list into the WeakLink edges of a node, converting each element.
+	 */
+	template< typename U, typename OtherAllocator >
+		requires ( !std::is_same_v<T, U> && std::is_convertible_v<const U&, T> )
+	ArrayList( const ArrayList<U, OtherAllocator>& other )
 	{
+		mArray.reserve( other.size() );
+		for ( const auto& item : other )
+		{
+			mArray.push_back( item );
+		}
+	}
+
+	const_iterator erase( const_iterator pos )
+	{
+		++mLayout;
 		return mArray.erase( pos );
 	}
 
 	// Wrap std::vector::erase (range of iterators)
-	typename std::vector<T>::iterator erase( typename std::vector<T>::iterator first,
-											 typename std::vector<T>::iterator last )
+	const_iterator erase( const_iterator first, const_iterator last )
 	{
+		++mLayout;
 		return mArray.erase( first, last );
 	}
 
+	/** Remove the elements for which pred(element) is true, keeping the order. */
+	template< typename Predicate >
+	void removeIf( Predicate pred )
+	{
+		++mLayout;
+		mArray.erase( std::remove_if( mArray.begin(), mArray.end(), pred ), mArray.end() );
+	}
+
 	void reserve( size_t size )
 	{
 		mArray.reserve( size );
@@ -29,16 +69,19 @@ public:
 	{
 		if ( index > mArray.size() )
 			throw std::out_of_range( "Index out of range in add" );
+		++mLayout;
 		mArray.insert( mArray.begin() + index, item );
 	}
 
-	void addAll( const ArrayList<T>& other )
+	template< typename OtherAllocator >
+	void addAll( const ArrayList<T, OtherAllocator>& other )
 	{
-		mArray.insert( mArray.end(), other.mArray.begin(), other.mArray.end() );
+		mArray.insert( mArray.end(), other.begin(), other.end() );
 	}
 
 	void set( size_t Index, const T& Item )
 	{
+		++mLayout;
 		mArray[Index] = Item;
 	}
 
@@ -46,6 +89,7 @@ public:
 	{
 		if ( Index >= mArray.size() )
 			throw std::out_of_range( "Index out of range in remove" );
+		++mLayout;
 		mArray.erase( mArray.begin() + Index );
 	}
 
@@ -56,6 +100,7 @@ public:
 
 	void clear()
 	{
+		++mLayout;
 		mArray.clear();
 	}
 
@@ -69,26 +114,16 @@ public:
 		return mArray.size();
 	}
 
-	const T& get( size_t index ) const
+	auto capacity() const
 	{
-		return mArray.at( index );
+		return mArray.capacity();
 	}
 
-	T& get( size_t index )
+	const T& get( size_t index ) const
 	{
 		return mArray.at( index );
 	}
 
-	auto begin() 
-	{ 
-		return mArray.begin();
-	}
-	
-	auto end()
-	{ 
-		return mArray.end();
-	}
-
 	auto begin() const 
 	{ 
 		return mArray.begin();
@@ -118,7 +153,7 @@ public:
 
 		for ( size_t i = start; i < end; ++i )
 		{
-			if ( mArray[i] && mArray[i]->equals( value ) )
+			if ( mArray[i] && same( mArray[i], value ) )
 			{
 				return static_cast<std::ptrdiff_t>( i );
 			}
@@ -126,6 +161,52 @@ public:
 		return -1; // not found
 	}
 
+	/**
+	 * @return the index of the first element that equals(..) value, or -1. For
+	 *         the mesh entities, this is the search by coordinates that
+	 *         indexOf(..) does not do.
+	 */
+	std::ptrdiff_t indexOfEqual( const T& value ) const
+	{
+		for ( size_t i = 0; i < mArray.size(); ++i )
+		{
+			if ( mArray[i] && mArray[i]->equals( value ) )
+			{
+				return static_cast<std::ptrdiff_t>( i );
+			}
+		}
+		return -1;
+	}
+
+	bool containsEqual( const T& value ) const
+	{
+		return indexOfEqual( value ) != -1;
+	}
+
+	/**
+	 * @return a counter that changes whenever an element is replaced or moved to
+	 *         another index. Appending elements leaves it unchanged.
+	 */
+	size_t layoutVersion() const
+	{
+		return mLayout;
+	}
+
 private:
-	std::vector<T> mArray;
+	std::vector<T, Allocator> mArray;
+
+	// Mesh entities, which carry an id, are the same only if they are the same
+	// object. Other elements are compared by equals(..).
+	static bool same( const T& a, const T& b )
+	{
+		if constexpr ( requires { a->id; } )
+		{
+			return a == b;
+		}
+		else
+		{
+			return a->equals( b );
+		}
+	}
+	size_t mLayout = 0;
 };
\ No newline at end of file
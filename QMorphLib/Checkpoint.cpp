@@ -0,0 +1,687 @@
+#include "pch.h"
+#include "Checkpoint.h"
+
+#include "GeomBasics.h"
+#include "QMorph.h"
+#include "TopoCleanup.h"
+#include "Edge.h"
+#include "FrontList.h"
+#include "Node.h"
+#include "Quad.h"
+#include "Triangle.h"
+#include "Types.h"
+#include "Msg.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+static constexpr uint32_t checkpointMagic = 0x50434d51; // "QMCP"
+static constexpr uint32_t checkpointVersion = 1;
+
+void
+Checkpoint::Writer::write( std::string& to, const void* p, size_t n )
+{
+	to.append( static_cast<const char*>(p), n );
+}
+
+void
+Checkpoint::Writer::u8( uint8_t v )
+{
+	write( state, &v, sizeof( v ) );
+}
+
+void
+Checkpoint::Writer::u32( uint32_t v )
+{
+	write( state, &v, sizeof( v ) );
+}
+
+void
+Checkpoint::Writer::i32( int v )
+{
+	int32_t w = v;
+	write( state, &w, sizeof( w ) );
+}
+
+void
+Checkpoint::Writer::f64( double v )
+{
+	write( state, &v, sizeof( v ) );
+}
+
+void
+Checkpoint::Writer::flag( bool v )
+{
+	u8( v ? 1 : 0 );
+}
+
+uint32_t
+Checkpoint::Writer::idOf( const std::shared_ptr<Node>& n )
+{
+	if ( n == nullptr )
+	{
+		return 0;
+	}
+	auto [it, added] = nodeIds.emplace( n.get(), static_cast<uint32_t>(nodeById.size() + 1) );
+	if ( added )
+	{
+		nodeById.push_back( n );
+	}
+	return it->second;
+}
+
+uint32_t
+Checkpoint::Writer::idOf( const std::shared_ptr<Edge>& e )
+{
+	if ( e == nullptr )
+	{
+		return 0;
+	}
+	auto [it, added] = edgeIds.emplace( e.get(), static_cast<uint32_t>(edgeById.size() + 1) );
+	if ( added )
+	{
+		edgeById.push_back( e );
+	}
+	return it->second;
+}
+
+uint32_t
+Checkpoint::Writer::idOf( const std::shared_ptr<Element>& e )
+{
+	if ( e == nullptr )
+	{
+		return 0;
+	}
+	auto [it, added] = elementIds.emplace( e.get(), static_cast<uint32_t>(elementById.size() + 1) );
+	if ( added )
+	{
+		elementById.push_back( e );
+	}
+	return it->second;
+}
+
+void
+Checkpoint::Writer::node( const std::shared_ptr<Node>& n )
+{
+	u32( idOf( n ) );
+}
+
+void
+Checkpoint::Writer::edge( const std::shared_ptr<Edge>& e )
+{
+	u32( idOf( e ) );
+}
+
+void
+Checkpoint::Writer::element( const std::shared_ptr<Element>& e )
+{
+	u32( idOf( e ) );
+}
+
+void
+Checkpoint::Writer::nodes( const ArrayList<std::shared_ptr<Node>>& list )
+{
+	u32( static_cast<uint32_t>(list.size()) );
+	for ( const auto& n : list )
+	{
+		node( n );
+	}
+}
+
+void
+Checkpoint::Writer::edges( const ArrayList<std::shared_ptr<Edge>>& list )
+{
+	u32( static_cast<uint32_t>(list.size()) );
+	for ( const auto& e : list )
+	{
+		edge( e );
+	}
+}
+
+void
+Checkpoint::Writer::edges( const FrontList& list )
+{
+	u32( static_cast<uint32_t>(list.size()) );
+	for ( const auto& e : list )
+	{
+		edge( e );
+	}
+}
+
+void
+Checkpoint::Writer::reachAll()
+{
+	for ( const auto& n : GeomBasics::nodeList )
+	{
+		idOf( n );
+	}
+	for ( const auto& e : GeomBasics::edgeList )
+	{
+		idOf( e );
+	}
+	for ( const auto& t : GeomBasics::triangleList )
+	{
+		idOf( std::static_pointer_cast<Element>(t) );
+	}
+	for ( const auto& e : GeomBasics::elementList )
+	{
+		idOf( e );
+	}
+	for ( const auto& list : Edge::stateList )
+	{
+		for ( const auto& e : list )
+		{
+			idOf( e );
+		}
+	}
+	for ( const auto& n : { GeomBasics::leftmost, GeomBasics::rightmost, GeomBasics::uppermost, GeomBasics::lowermost } )
+	{
+		idOf( n );
+	}
+
+	// Numbering an entity may reach new ones, so go on until all are numbered
+	size_t n = 0, e = 0, el = 0;
+	while ( n < nodeById.size() || e < edgeById.size() || el < elementById.size() )
+	{
+		for ( ; n < nodeById.size(); n++ )
+		{
+			auto cur = nodeById[n];
+			for ( const auto& ne : cur->edgeList )
+			{
+				idOf( ne );
+			}
+		}
+		for ( ; e < edgeById.size(); e++ )
+		{
+			auto cur = edgeById[e];
+			idOf( cur->leftNode );
+			idOf( cur->rightNode );
+			idOf( cur->element1 );
+			idOf( cur->element2 );
+			idOf( cur->leftFrontNeighbor );
+			idOf( cur->rightFrontNeighbor );
+		}
+		for ( ; el < elementById.size(); el++ )
+		{
+			auto cur = elementById[el];
+			for ( const auto& ee : cur->edgeList )
+			{
+				idOf( ee );
+			}
+			idOf( cur->firstNode );
+		}
+	}
+}
+
+void
+Checkpoint::Writer::finish( std::ostream& out )
+{
+	reachAll();
+
+	// The mesh goes ahead of the state that refers to it
+	std::string phaseState = std::move( state );
+	state.clear();
+
+	u32( static_cast<uint32_t>(nodeById.size()) );
+	u32( static_cast<uint32_t>(edgeById.size()) );
+	u32( static_cast<uint32_t>(elementById.size()) );
+
+	for ( const auto& n : nodeById )
+	{
+		f64( n->x );
+		f64( n->y );
+		i32( n->GetNumber() );
+		flag( n->movedByOBS );
+		u8( static_cast<uint8_t>(n->color) );
+		u32( static_cast<uint32_t>(n->pattern.size()) );
+		for ( auto p : n->pattern )
+		{
+			u8( p );
+		}
+	}
+	for ( const auto& e : edgeById )
+	{
+		node( e->leftNode );
+		node( e->rightNode );
+	}
+	for ( const auto& el : elementById )
+	{
+		auto q = rcl::quadCast(el);
+		u8( q != nullptr ? 1 : 0 );
+		u32( static_cast<uint32_t>(el->edgeList.size()) );
+		for ( const auto& e : el->edgeList )
+		{
+			edge( e );
+		}
+		node( el->firstNode );
+		u32( static_cast<uint32_t>(el->ang.size()) );
+		for ( auto a : el->ang )
+		{
+			f64( a );
+		}
+		f64( el->distortionMetric );
+		f64( el->newDistortionMetric );
+		f64( el->gX );
+		f64( el->gY );
+		flag( q != nullptr && q->isFake );
+	}
+
+	// The fields of the edges that building the elements may have changed
+	for ( const auto& e : edgeById )
+	{
+		element( e->element1 );
+		element( e->element2 );
+		edge( e->leftFrontNeighbor );
+		edge( e->rightFrontNeighbor );
+		i32( e->level );
+		flag( e->frontEdge );
+		flag( e->swappable );
+		flag( e->selectable );
+		flag( e->leftSide );
+		flag( e->rightSide );
+		f64( e->len );
+		u8( static_cast<uint8_t>(e->color) );
+	}
+	for ( const auto& n : nodeById )
+	{
+		edges( n->edgeList );
+	}
+
+	nodes( GeomBasics::nodeList );
+	edges( GeomBasics::edgeList );
+	u32( static_cast<uint32_t>(GeomBasics::triangleList.size()) );
+	for ( const auto& t : GeomBasics::triangleList )
+	{
+		element( t );
+	}
+	u32( static_cast<uint32_t>(GeomBasics::elementList.size()) );
+	for ( const auto& e : GeomBasics::elementList )
+	{
+		element( e );
+	}
+	for ( const auto& list : Edge::stateList )
+	{
+		edges( list );
+	}
+	node( GeomBasics::leftmost );
+	node( GeomBasics::rightmost );
+	node( GeomBasics::uppermost );
+	node( GeomBasics::lowermost );
+	i32( Node::mLastNumber );
+
+	out.write( state.data(), static_cast<std::streamsize>(state.size()) );
+	out.write( phaseState.data(), static_cast<std::streamsize>(phaseState.size()) );
+}
+
+Checkpoint::Reader::Reader( std::istream& in ) :
+	in( in )
+{
+	auto start = in.tellg();
+	if ( start != std::istream::pos_type( -1 ) && in.seekg( 0, std::ios::end ) )
+	{
+		remaining = static_cast<size_t>(in.tellg() - start);
+		in.seekg( start );
+	}
+	in.clear();
+}
+
+void
+Checkpoint::Reader::read( void* p, size_t n )
+{
+	if ( ok && (n > remaining || !in.read( static_cast<char*>(p), static_cast<std::streamsize>(n) )) )
+	{
+		ok = false;
+	}
+	if ( ok )
+	{
+		remaining -= n;
+	}
+	if ( !ok )
+	{
+		std::memset( p, 0, n );
+	}
+}
+
+uint8_t
+Checkpoint::Reader::u8()
+{
+	uint8_t v;
+	read( &v, sizeof( v ) );
+	return v;
+}
+
+uint32_t
+Checkpoint::Reader::u32()
+{
+	uint32_t v;
+	read( &v, sizeof( v ) );
+	return v;
+}
+
+int
+Checkpoint::Reader::i32()
+{
+	int32_t v;
+	read( &v, sizeof( v ) );
+	return v;
+}
+
+double
+Checkpoint::Reader::f64()
+{
+	double v;
+	read( &v, sizeof( v ) );
+	return v;
+}
+
+bool
+Checkpoint::Reader::flag()
+{
+	return u8() != 0;
+}
+
+uint32_t
+Checkpoint::Reader::count( size_t itemBytes )
+{
+	auto n = u32();
+	if ( ok && n > remaining / itemBytes )
+	{
+		ok = false;
+	}
+	return ok ? n : 0;
+}
+
+std::shared_ptr<Node>
+Checkpoint::Reader::node()
+{
+	auto id = u32();
+	if ( id > nodeById.size() )
+	{
+		ok = false;
+	}
+	return id == 0 || !ok ? nullptr : nodeById[id - 1];
+}
+
+std::shared_ptr<Edge>
+Checkpoint::Reader::edge()
+{
+	auto id = u32();
+	if ( id > edgeById.size() )
+	{
+		ok = false;
+	}
+	return id == 0 || !ok ? nullptr : edgeById[id - 1];
+}
+
+std::shared_ptr<Element>
+Checkpoint::Reader::element()
+{
+	auto id = u32();
+	if ( id > elementById.size() )
+	{
+		ok = false;
+	}
+	return id == 0 || !ok ? nullptr : elementById[id - 1];
+}
+
+ArrayList<std::shared_ptr<Node>>
+Checkpoint::Reader::nodes()
+{
+	ArrayList<std::shared_ptr<Node>> list;
+	auto n = count( sizeof( uint32_t ) );
+	for ( uint32_t i = 0; i < n && ok; i++ )
+	{
+		list.add( node() );
+	}
+	return list;
+}
+
+ArrayList<std::shared_ptr<Edge>>
+Checkpoint::Reader::edges()
+{
+	ArrayList<std::shared_ptr<Edge>> list;
+	auto n = count( sizeof( uint32_t ) );
+	for ( uint32_t i = 0; i < n && ok; i++ )
+	{
+		list.add( edge() );
+	}
+	return list;
+}
+
+void
+Checkpoint::Reader::mesh()
+{
+	// The smallest number of bytes each node, edge and element is written in
+	const size_t nodeBytes = 2 * sizeof( double ) + sizeof( int32_t ) + 2 + sizeof( uint32_t );
+	const size_t edgeBytes = 2 * sizeof( uint32_t );
+	const size_t elementBytes = 1 + sizeof( uint32_t );
+	auto nNodes = count( nodeBytes );
+	auto nEdges = count( edgeBytes );
+	auto nElements = count( elementBytes );
+
+	for ( uint32_t i = 0; i < nNodes && ok; i++ )
+	{
+		auto n = std::make_shared<Node>();
+		n->x = f64();
+		n->y = f64();
+		n->SetNumber( i32() );
+		n->movedByOBS = flag();
+		n->color = static_cast<Constants::Color>(u8());
+		n->pattern.resize( count( 1 ) );
+		for ( auto& p : n->pattern )
+		{
+			p = u8();
+		}
+		nodeById.push_back( n );
+	}
+	for ( uint32_t i = 0; i < nEdges && ok; i++ )
+	{
+		auto e = std::make_shared<Edge>();
+		e->leftNode = node();
+		e->rightNode = node();
+		if ( e->leftNode == nullptr || e->rightNode == nullptr )
+		{
+			ok = false;
+		}
+		edgeById.push_back( e );
+	}
+	for ( uint32_t i = 0; i < nElements && ok; i++ )
+	{
+		bool isQuad = u8() != 0;
+		std::vector<std::shared_ptr<Edge>> elemEdges( count( sizeof( uint32_t ) ) );
+		for ( auto& e : elemEdges )
+		{
+			e = edge();
+		}
+		if ( !ok || elemEdges.size() != (isQuad ? 4u : 3u) )
+		{
+			ok = false;
+			break;
+		}
+
+		std::shared_ptr<Element> el;
+		if ( isQuad )
+		{
+			el = std::make_shared<Quad>( elemEdges[0], elemEdges[1], elemEdges[2], elemEdges[3] );
+		}
+		else
+		{
+			el = std::make_shared<Triangle>( elemEdges[0], elemEdges[1], elemEdges[2] );
+		}
+		// The constructors order the edges and compute the angles, so put back
+		// the stored ones
+		el->edgeList = elemEdges;
+		el->firstNode = node();
+		uint32_t nAng = count( sizeof( double ) );
+		if ( nAng > el->ang.capacity() )
+		{
+			ok = false;
+			break;
+		}
+		el->ang.resize( nAng );
+		for ( auto& a : el->ang )
+		{
+			a = f64();
+		}
+		el->distortionMetric = f64();
+		el->newDistortionMetric = f64();
+		el->gX = f64();
+		el->gY = f64();
+		bool isFake = flag();
+		if ( isQuad )
+		{
+			std::static_pointer_cast<Quad>(el)->isFake = isFake;
+		}
+		elementById.push_back( el );
+	}
+	for ( uint32_t i = 0; i < edgeById.size() && ok; i++ )
+	{
+		const auto& e = edgeById[i];
+		e->element1 = element();
+		e->element2 = element();
+		e->leftFrontNeighbor = edge();
+		e->rightFrontNeighbor = edge();
+		e->level = i32();
+		e->frontEdge = flag();
+		e->swappable = flag();
+		e->selectable = flag();
+		e->leftSide = flag();
+		e->rightSide = flag();
+		e->len = f64();
+		e->color = static_cast<Constants::Color>(u8());
+	}
+	for ( uint32_t i = 0; i < nodeById.size() && ok; i++ )
+	{
+		nodeById[i]->edgeList = edges();
+	}
+
+	GeomBasics::clearLists();
+	GeomBasics::nodeList = nodes();
+	GeomBasics::edgeList.addAll( edges() );
+	auto nTriangles = count( sizeof( uint32_t ) );
+	for ( uint32_t i = 0; i < nTriangles && ok; i++ )
+	{
+		auto el = element();
+		auto t = rcl::triangleCast(el);
+		if ( el != nullptr && t == nullptr )
+		{
+			ok = false;
+		}
+		GeomBasics::triangleList.add( t );
+	}
+	auto nElems = count( sizeof( uint32_t ) );
+	for ( uint32_t i = 0; i < nElems && ok; i++ )
+	{
+		GeomBasics::elementList.add( element() );
+	}
+	Edge::clearStateList();
+	for ( auto& list : Edge::stateList )
+	{
+		list = edges();
+	}
+	GeomBasics::leftmost = node();
+	GeomBasics::rightmost = node();
+	GeomBasics::uppermost = node();
+	GeomBasics::lowermost = node();
+	Node::mLastNumber = i32();
+}
+
+//TODO: Tests
+bool
+Checkpoint::save( const std::string& filename, Phase phase, const QMorph* morph )
+{
+	Writer w;
+	if ( phase == Phase::Morph )
+	{
+		morph->writeState( w );
+	}
+	else if ( phase == Phase::Cleanup )
+	{
+		GeomBasics::topoCleanup->writeState( w );
+	}
+
+	auto tmp = filename + ".tmp";
+	{
+		std::ofstream out( tmp, std::ios::binary | std::ios::trunc );
+		if ( !out )
+		{
+			Msg::warning( "Cannot write checkpoint " + tmp );
+			return false;
+		}
+		uint8_t p = static_cast<uint8_t>(phase);
+		out.write( reinterpret_cast<const char*>(&checkpointMagic), sizeof( checkpointMagic ) );
+		out.write( reinterpret_cast<const char*>(&checkpointVersion), sizeof( checkpointVersion ) );
+		out.write( reinterpret_cast<const char*>(&p), sizeof( p ) );
+		w.finish( out );
+		if ( !out )
+		{
+			Msg::warning( "Cannot write checkpoint " + tmp );
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename( tmp, filename, ec );
+	if ( ec )
+	{
+		Msg::warning( "Cannot rename checkpoint " + tmp + " to " + filename + ": " + ec.message() );
+		return false;
+	}
+	Msg::debug( "Wrote checkpoint " + filename );
+	return true;
+}
+
+//TODO: Tests
+bool
+Checkpoint::load( const std::string& filename, QMorph& morph, Phase& phase )
+{
+	std::ifstream in( filename, std::ios::binary );
+	if ( !in )
+	{
+		Msg::warning( "Cannot open checkpoint " + filename );
+		return false;
+	}
+
+	Reader r( in );
+	if ( r.u32() != checkpointMagic || r.u32() != checkpointVersion )
+	{
+		Msg::warning( filename + " is not a checkpoint of this version" );
+		return false;
+	}
+	auto p = r.u8();
+	if ( p > static_cast<uint8_t>(Phase::Done) )
+	{
+		Msg::warning( filename + " is not a checkpoint of this version" );
+		return false;
+	}
+	phase = static_cast<Phase>(p);
+
+	r.mesh();
+	if ( phase == Phase::Morph )
+	{
+		morph.readState( r );
+	}
+	else if ( phase == Phase::Cleanup )
+	{
+		GeomBasics::topoCleanup = std::make_shared<TopoCleanup>( morph.getOptions() );
+		GeomBasics::topoCleanup->readState( r );
+	}
+
+	if ( !r.good() )
+	{
+		Msg::warning( "Checkpoint " + filename + " is truncated or corrupt" );
+		GeomBasics::clearLists();
+		return false;
+	}
+	return true;
+}
+
+void
+Checkpoint::saveIfEnabled( Phase phase, const QMorph* morph )
+{
+	if ( !GeomBasics::checkpointFilename.empty() )
+	{
+		save( GeomBasics::checkpointFilename, phase, morph );
+	}
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "ArrayList.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Node;
+class Edge;
+class Element;
+class FrontList;
+class QMorph;
+
+/**
+ * Binary snapshots of a running QMorph, from which the run can be resumed with
+ * the same subsequent results.
+ *
+ * A snapshot holds every node, edge and element reachable from the lists of
+ * GeomBasics, with all the fields the algorithms read, the membership and
+ * order of the lists, of the QMorph frontList and of Edge::stateList, and the
+ * state of the phase that was running when it was written: the counters of
+ * QMorph while fronts are being advanced, or the pass flags of TopoCleanup
+ * during the topological cleanup. Doubles are stored bit for bit, and the
+ * entities are referred to by their index in the snapshot.
+ *
+ * Caches that are rebuilt on demand, that is the node stars, the EdgeGrid and
+ * the FrontLoops, are not stored.
+ */
+
+class Checkpoint
+{
+public:
+	/** The phase of the run a snapshot was taken in */
+	enum class Phase : uint8_t
+	{
+		Morph = 0,	 // advancing the fronts
+		Cleanup = 1, // in TopoCleanup::run()
+		Smooth = 2,	 // between TopoCleanup and the global smooth
+		Done = 3	 // a finished mesh, as kept by ResultCache
+	};
+
+	/**
+	 * Writes the state of a phase, numbering the entities it refers to, and then
+	 * the snapshot with all entities reachable from the lists and that state.
+	 */
+	class Writer
+	{
+	public:
+		void u8( uint8_t v );
+		void u32( uint32_t v );
+		void i32( int v );
+		void f64( double v );
+		void flag( bool v );
+
+		void node( const std::shared_ptr<Node>& n );
+		void edge( const std::shared_ptr<Edge>& e );
+		void element( const std::shared_ptr<Element>& e );
+
+		void nodes( const ArrayList<std::shared_ptr<Node>>& list );
+		void edges( const ArrayList<std::shared_ptr<Edge>>& list );
+		void edges( const FrontList& list );
+
+		/** Write the mesh, followed by the state written so far. */
+		void finish( std::ostream& out );
+
+	private:
+		std::string state;
+		std::vector<std::shared_ptr<Node>> nodeById;
+		std::vector<std::shared_ptr<Edge>> edgeById;
+		std::vector<std::shared_ptr<Element>> elementById;
+		std::unordered_map<const Node*, uint32_t> nodeIds;
+		std::unordered_map<const Edge*, uint32_t> edgeIds;
+		std::unordered_map<const Element*, uint32_t> elementIds;
+
+		void write( std::string& to, const void* p, size_t n );
+		uint32_t idOf( const std::shared_ptr<Node>& n );
+		uint32_t idOf( const std::shared_ptr<Edge>& e );
+		uint32_t idOf( const std::shared_ptr<Element>& e );
+		void reachAll();
+	};
+
+	/** Reads back what Writer wrote, in the same order. */
+	class Reader
+	{
+	public:
+		explicit Reader( std::istream& in );
+
+		uint8_t u8();
+		uint32_t u32();
+		int i32();
+		double f64();
+		bool flag();
+
+		/**
+		 * Read the length of a list whose items take at least itemBytes each.
+		 *
+		 * @return the length, or 0 with good() false if that many items cannot
+		 *         fit in the rest of the snapshot
+		 */
+		uint32_t count( size_t itemBytes );
+
+		std::shared_ptr<Node> node();
+		std::shared_ptr<Edge> edge();
+		std::shared_ptr<Element> element();
+
+		ArrayList<std::shared_ptr<Node>> nodes();
+		ArrayList<std::shared_ptr<Edge>> edges();
+
+		/** Recreate the entities and restore the lists, ahead of the state. */
+		void mesh();
+
+		/** @return false once a read ran past the end of the snapshot */
+		bool good() const { return ok; }
+
+	private:
+		std::istream& in;
+		bool ok = true;
+		// The number of bytes not read yet
+		size_t remaining = std::numeric_limits<size_t>::max();
+		std::vector<std::shared_ptr<Node>> nodeById;
+		std::vector<std::shared_ptr<Edge>> edgeById;
+		std::vector<std::shared_ptr<Element>> elementById;
+
+		void read( void* p, size_t n );
+	};
+
+	/**
+	 * Write a snapshot of the current mesh and the given phase.
+	 *
+	 * The snapshot is written next to filename first and then renamed, so that
+	 * an earlier snapshot under the same name survives a failed write.
+	 *
+	 * @param morph the running QMorph, whose state is stored in Phase::Morph
+	 * @return false if the file could not be written
+	 */
+	static bool save( const std::string& filename, Phase phase, const QMorph* morph );
+
+	/**
+	 * Replace the mesh by the one in a snapshot, and restore the state of its
+	 * phase into morph and GeomBasics::topoCleanup.
+	 *
+	 * @param phase set to the phase the snapshot was taken in
+	 * @return false if the file could not be read or is not a snapshot
+	 */
+	static bool load( const std::string& filename, QMorph& morph, Phase& phase );
+
+	/**
+	 * Write a snapshot to GeomBasics::checkpointFilename, if one is set.
+	 */
+	static void saveIfEnabled( Phase phase, const QMorph* morph );
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <numbers>
+#include <cstdint>
 #include <cmath>
 #include <vector>
 #include <string>
@@ -16,7 +17,7 @@
 class Constants
 {
 public:
-	enum class Color
+	enum class Color : uint8_t
 	{
 		None,
 		Cyan,
@@ -82,13 +83,9 @@ public:
 	// 200 degrees in radians
 	inline static constexpr double DEG_200 = toRadians * 200;
 
-	// Constants for the seam, transition seam and transition split operations:
-	// Note that we must have (EPSILON1 < EPSILON2)
-	inline static const double EPSILON1 = std::numbers::pi * 0.04;
-	inline static const double EPSILON2 = std::numbers::pi * 0.09;
-
-	// The minimum size of the greatest angle in a chevron.
-	inline static const double CHEVRONMIN = DEG_200;
+	// The seam angle limits EPSILON1 and EPSILON2, the chevron angle CHEVRONMIN
+	// and the smoothing parameters OBSTOL, MYMIN, GAMMA and MAXITER are runtime
+	// options, see QMorphOptions. Their defaults are below.
 
 	// Constants for side edge selection (EPSILON < EPSILONLARGER)
 	inline static const double sqrt3div2 = sqrt( 3.0 ) / 2.0;
@@ -101,15 +98,10 @@ public:
 	inline static const double COINCTOL = 0.01;
 	// A value for the move tolerance. I don't know if it's any good.
 	inline static const double MOVETOLERANCE = 0.01;
-	// OBS tolerance. Should be 0.1, but may be adjusted to trigger OBS.
-	inline static const double OBSTOL = 0.1;
 	inline static const double DELTAFACTOR = 0.00001;
-	inline static const double MYMIN = 0.05;
 	// The maximum angle allowed in an element (not given in the paper)
 	inline static constexpr double THETAMAX = toRadians * 200;
 	inline static const double TOL = 0.00001;
-	inline static const double GAMMA = 0.8; // 0.8
-	inline static const int MAXITER = 5;
 
 	// And now some doubles to hold the default values of some of the above:
 	inline static const double defaultE1Factor = 0.04;
@@ -1,18 +1,34 @@
 #include "pch.h"
 #include "DelaunayMeshGen.h"
 
+#include "IndexedDelaunay.h"
 #include "MyVector.h"
+#include "Predicates.h"
 #include "Quad.h"
+#include "ThreadPool.h"
 #include "Triangle.h"
 
 #include "Msg.h"
 #include "Types.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 //TODO: Tests
 void
-DelaunayMeshGen::init( bool delaunayCompliant )
+DelaunayMeshGen::init( bool delaunayCompliant,
+					   InsertionMode mode )
 {
 	this->delaunayCompliant = delaunayCompliant;
+	insertionMode = mode;
 	setCurMethod( shared_from_this() );
 
 	// Perform the steps necessary before inserting the Nodes in incrDelaunay():
@@ -213,7 +229,7 @@ DelaunayMeshGen::findTriangleContaining( const std::shared_ptr<Node>& newNode,
 		{ // try to move to the adjacent triangle
 			online = nullptr;
 			Msg::debug( "*not* in halfplane t=" + t->descr() + " e=" + e->descr() );
-			ts = std::dynamic_pointer_cast<Triangle>(t->neighbor( e ));
+			ts = rcl::triangleCast(t->neighbor( e ));
 			if ( ts == nullptr )
 			{
 				/*
@@ -242,8 +258,8 @@ void
 DelaunayMeshGen::swap( std::shared_ptr<Edge>& e )
 {
 	Msg::debug( "Entering swap(..)" );
-	auto t1 = std::dynamic_pointer_cast<Triangle>(e->element1);
-	auto t2 = std::dynamic_pointer_cast<Triangle>(e->element2);
+	auto t1 = rcl::triangleCast(e->element1);
+	auto t2 = rcl::triangleCast(e->element2);
 
 	if ( t1 == nullptr || t2 == nullptr )
 	{
@@ -269,9 +285,7 @@ DelaunayMeshGen::swap( std::shared_ptr<Edge>& e )
 	auto ei = std::make_shared<Edge>( nc, nd );
 	Msg::debug( "Swapping diagonal " + e->descr() );
 
-	e->swapToAndSetElementsFor( ei );
-	auto tNew1 = std::dynamic_pointer_cast<Triangle>(ei->element1);
-	auto tNew2 = std::dynamic_pointer_cast<Triangle>(ei->element2);
+	auto [tNew1, tNew2] = e->swapToAndSetElementsFor( ei );
 
 	// Update "global" lists: remove old triangles and edge e, add new ones
 	auto ind1 = triangleList.indexOf( t1 );
@@ -302,8 +316,8 @@ DelaunayMeshGen::recSwapDelaunay( const std::shared_ptr<Edge>& e,
 								  const std::shared_ptr<Node>& n )
 {
 	Msg::debug( "Entering recSwapDelaunay(..)" );
-	auto t1 = std::dynamic_pointer_cast<Triangle>(e->element1);
-	auto t2 = std::dynamic_pointer_cast<Triangle>(e->element2);
+	auto t1 = rcl::triangleCast(e->element1);
+	auto t2 = rcl::triangleCast(e->element2);
 
 	if ( t1 == nullptr || t2 == nullptr )
 	{// Make sure we're dealing with an interior edge
@@ -314,11 +328,11 @@ DelaunayMeshGen::recSwapDelaunay( const std::shared_ptr<Edge>& e,
 	std::shared_ptr<Triangle> t;
 	if ( !e->element1->hasNode( n ) )
 	{
-		t = std::dynamic_pointer_cast<Triangle>(e->element1);
+		t = rcl::triangleCast(e->element1);
 	}
 	else
 	{
-		t = std::dynamic_pointer_cast<Triangle>(e->element2);
+		t = rcl::triangleCast(e->element2);
 	}
 
 	std::shared_ptr<Node> p1, p2, p3, opposite = t->oppositeOfEdge( e );
@@ -352,9 +366,7 @@ DelaunayMeshGen::recSwapDelaunay( const std::shared_ptr<Edge>& e,
 	auto ei = std::make_shared<Edge>( p2, n );
 	Msg::debug( "Swapping diagonal " + e->descr() + " of quad " + q->descr() );
 
-	e->swapToAndSetElementsFor( ei );
-	auto tNew1 = std::dynamic_pointer_cast<Triangle>(ei->element1);
-	auto tNew2 = std::dynamic_pointer_cast<Triangle>(ei->element2);
+	auto [tNew1, tNew2] = e->swapToAndSetElementsFor( ei );
 
 	// Update "global" lists: remove old triangles and edge e, add new ones
 	auto ind1 = triangleList.indexOf( t1 );
@@ -440,9 +452,9 @@ DelaunayMeshGen::makeDelaunayTriangle( const std::shared_ptr<Triangle>& t,
 		}
 
 		e1 = t->otherEdge( e );
-		t1 = std::dynamic_pointer_cast<Triangle>(t->neighbor( e1 ));
+		t1 = rcl::triangleCast(t->neighbor( e1 ));
 		e2 = t->otherEdge( e, e1 );
-		t2 = std::dynamic_pointer_cast<Triangle>(t->neighbor( e2 ));
+		t2 = rcl::triangleCast(t->neighbor( e2 ));
 
 		e->disconnectNodes();
 		j = edgeList.indexOf( e );
@@ -516,6 +528,12 @@ DelaunayMeshGen::insertNode( const std::shared_ptr<Node>& n,
 
 	// Locate the triangle that contains the point
 	auto o = findTriangleContaining( n, triangleList.get( 0 ) );
+	if ( remainDelaunay && insertionMode == InsertionMode::Cavity )
+	{
+		insertNodeInCavity( n, o );
+		return;
+	}
+
 	if ( !inside )
 	{
 		// --- the Node is to be inserted outside the current triangulation --- //
@@ -620,6 +638,7 @@ DelaunayMeshGen::insertNode( const std::shared_ptr<Node>& n,
 
 		// Sort this list of edges in ccw order
 		n->edgeList = n->calcCCWSortedEdgeList( b0, b1 );
+		n->invalidateStar();
 		Msg::debug( "n.edgeList.size(): " + std::to_string( n->edgeList.size() ) );
 
 		// Create each triangle
@@ -631,7 +650,7 @@ DelaunayMeshGen::insertNode( const std::shared_ptr<Node>& n,
 			other = e1->otherNode( n );
 			other2 = e2->otherNode( n );
 			e = std::make_shared<Edge>( other, other2 );
-			auto j = other->edgeList.indexOf( e );
+			auto j = other->edgeList.indexOfEqual( e );
 			if ( j != -1 )
 			{
 				e = other->edgeList.get( j );
@@ -719,8 +738,8 @@ DelaunayMeshGen::insertNode( const std::shared_ptr<Node>& n,
 
 		Msg::debug( "findTriangleCont... returns " + e->descr() );
 
-		oldt1 = std::dynamic_pointer_cast<Triangle>(e->element1);
-		oldt2 = std::dynamic_pointer_cast<Triangle>(e->element2);
+		oldt1 = rcl::triangleCast(e->element1);
+		oldt2 = rcl::triangleCast(e->element2);
 
 		// Create the (2 or) 4 new Edges, get ptrs for the (2 or) 4 outer Edges,
 		// remove the old Edge e.
@@ -826,4 +845,604 @@ DelaunayMeshGen::insertNode( const std::shared_ptr<Node>& n,
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+//TODO: Tests
+bool
+DelaunayMeshGen::inConflict( const std::shared_ptr<Triangle>& t,
+							 const std::shared_ptr<Node>& n )
+{
+	const auto& e = t->edgeList[0];
+	return n->inCircle( e->leftNode, e->rightNode, t->oppositeOfEdge( e ) );
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::insertNodeInCavity( const std::shared_ptr<Node>& n,
+									 const std::shared_ptr<Constants>& o )
+{
+	Msg::debug( "Entering insertNodeInCavity(" + n->descr() + ")" );
+	std::vector<std::shared_ptr<Triangle>> cavity, stack;
+	ArrayList<std::shared_ptr<Edge>> visible, boundary, freeEdges;
+	std::shared_ptr<Edge> split = nullptr;
+
+	auto addToCavity = [&]( const std::shared_ptr<Triangle>& t )
+	{
+		if ( std::find( cavity.begin(), cavity.end(), t ) == cavity.end() )
+		{
+			cavity.push_back( t );
+			stack.push_back( t );
+		}
+	};
+
+	// --- Seed the conflict region --- //
+	if ( !inside )
+	{
+		// n is outside the current triangulation. Every boundary Edge that can be
+		// seen from n is part of the cavity boundary or lies inside the cavity.
+		auto e = std::dynamic_pointer_cast<Edge>(o);
+		visible.add( e );
+		for ( auto start : { e->leftNode, e->rightNode } )
+		{
+			auto node = start;
+			auto prev = e;
+			while ( true )
+			{
+				auto next = node->anotherBoundaryEdge( prev );
+				if ( next == nullptr || next == e || n->inHalfplane( next->getTriangleElement(), next ) != -1 )
+				{
+					break;
+				}
+				visible.add( next );
+				node = next->otherNode( node );
+				prev = next;
+			}
+		}
+		Msg::debug( "Nr of boundary edges visible from n is " + std::to_string( visible.size() ) );
+
+		for ( const auto& ve : visible )
+		{
+			auto t = ve->getTriangleElement();
+			if ( inConflict( t, n ) )
+			{
+				addToCavity( t );
+			}
+		}
+	}
+	else if ( auto t = std::dynamic_pointer_cast<Triangle>(o) )
+	{
+		addToCavity( t );
+	}
+	else
+	{
+		// n lies on this Edge, which is removed along with its (1 or) 2 Triangles
+		split = std::dynamic_pointer_cast<Edge>(o);
+		addToCavity( rcl::triangleCast(split->element1) );
+		if ( split->element2 != nullptr )
+		{
+			addToCavity( rcl::triangleCast(split->element2) );
+		}
+	}
+
+	// --- Grow the conflict region across the Edges of the cavity --- //
+	while ( !stack.empty() )
+	{
+		auto t = stack.back();
+		stack.pop_back();
+		for ( const auto& e : t->edgeList )
+		{
+			if ( e == split )
+			{
+				continue;
+			}
+			auto neighbor = rcl::triangleCast(t->neighbor( e ));
+			if ( neighbor != nullptr && inConflict( neighbor, n ) )
+			{
+				addToCavity( neighbor );
+			}
+		}
+	}
+	Msg::debug( "Nr of triangles in cavity is " + std::to_string( cavity.size() ) );
+
+	// --- Classify the Edges of the cavity --- //
+	auto inCavity = [&]( const std::shared_ptr<Element>& elem )
+	{
+		return std::find( cavity.begin(), cavity.end(), elem ) != cavity.end();
+	};
+
+	for ( const auto& t : cavity )
+	{
+		for ( const auto& e : t->edgeList )
+		{
+			auto neighbor = t->neighbor( e );
+			if ( e == split || (neighbor == nullptr && visible.contains( e )) )
+			{
+				freeEdges.add( e );
+			}
+			else if ( neighbor == nullptr || !inCavity( neighbor ) )
+			{
+				boundary.add( e );
+			}
+			else if ( neighbor.get() < static_cast<Element*>(t.get()) )
+			{
+				// Interior Edge of the cavity, seen from both sides
+				freeEdges.add( e );
+			}
+		}
+	}
+	for ( const auto& e : visible )
+	{
+		if ( !inCavity( e->getTriangleElement() ) )
+		{
+			boundary.add( e );
+		}
+	}
+
+	// --- Remove the cavity --- //
+	for ( const auto& t : cavity )
+	{
+		t->disconnectEdges();
+	}
+	for ( const auto& e : freeEdges )
+	{
+		e->disconnectNodes();
+	}
+
+	// --- Connect n to every Node on the cavity boundary --- //
+	size_t nextEdge = 0, nextTriangle = 0;
+	auto newEdge = [&]( const std::shared_ptr<Node>& other )
+	{
+		std::shared_ptr<Edge> e;
+		if ( nextEdge < freeEdges.size() )
+		{
+			e = freeEdges.get( nextEdge++ );
+			e->reinit( n, other );
+		}
+		else
+		{
+			e = std::make_shared<Edge>( n, other );
+			edgeList.add( e );
+			Msg::debug( "ADDING EDGE " + e->descr() + " to edgeList" );
+		}
+		e->connectNodes();
+		return e;
+	};
+
+	std::vector<std::pair<std::shared_ptr<Node>, std::shared_ptr<Edge>>> spokes;
+	auto spokeTo = [&]( const std::shared_ptr<Node>& other )
+	{
+		for ( const auto& spoke : spokes )
+		{
+			if ( spoke.first == other )
+			{
+				return spoke.second;
+			}
+		}
+		auto e = newEdge( other );
+		spokes.emplace_back( other, e );
+		return e;
+	};
+
+	for ( const auto& b : boundary )
+	{
+		auto e1 = spokeTo( b->leftNode );
+		auto e2 = spokeTo( b->rightNode );
+
+		std::shared_ptr<Triangle> t;
+		if ( nextTriangle < cavity.size() )
+		{
+			t = cavity[nextTriangle++];
+			t->reinit( b, e1, e2 );
+		}
+		else
+		{
+			t = std::make_shared<Triangle>( b, e1, e2 );
+			triangleList.add( t );
+		}
+		t->connectEdges();
+		Msg::debug( "Creating new triangle: " + t->descr() );
+	}
+
+	// --- Drop the objects that were not needed again --- //
+	for ( ; nextEdge < freeEdges.size(); nextEdge++ )
+	{
+		const auto& e = freeEdges.get( nextEdge );
+		edgeList.remove( edgeList.indexOf( e ) );
+		Msg::debug( "REMOVING EDGE " + e->descr() + " FROM edgeList" );
+	}
+	for ( ; nextTriangle < cavity.size(); nextTriangle++ )
+	{
+		triangleList.remove( triangleList.indexOf( cavity[nextTriangle] ) );
+	}
+
+	Msg::debug( "Leaving insertNodeInCavity(..)" );
+}
+
+namespace
+{
+	using Tri = IndexedDelaunay::Tri;
+
+	// Below this many Nodes the split does not pay off
+	constexpr int minParallelNodes = 2000;
+
+	// true if p and q lie in the same direction from o
+	bool
+	sameDirection( const IndexedDelaunay& dt, int o, int p, int q )
+	{
+		double px = dt.x( p ) - dt.x( o ), py = dt.y( p ) - dt.y( o );
+		double qx = dt.x( q ) - dt.x( o ), qy = dt.y( q ) - dt.y( o );
+		return rcl::orient2d( dt.x( o ), dt.y( o ), dt.x( p ), dt.y( p ), dt.x( q ), dt.y( q ) ) == 0.0
+			&& px * qx + py * qy > 0.0;
+	}
+
+	// true if the ray from o through d lies strictly inside the ccw corner (o, r, s)
+	bool
+	insideCorner( const IndexedDelaunay& dt, int o, int r, int s, int d )
+	{
+		return rcl::orient2d( dt.x( o ), dt.y( o ), dt.x( r ), dt.y( r ), dt.x( d ), dt.y( d ) ) > 0.0
+			&& rcl::orient2d( dt.x( o ), dt.y( o ), dt.x( d ), dt.y( d ), dt.x( s ), dt.y( s ) ) > 0.0;
+	}
+
+	// true if the ccw triangle corners (o, r1, s1) and (o, r2, s2) overlap
+	bool
+	cornersOverlap( const IndexedDelaunay& dt, int o, int r1, int s1, int r2, int s2 )
+	{
+		return insideCorner( dt, o, r1, s1, r2 ) || insideCorner( dt, o, r1, s1, s2 )
+			|| insideCorner( dt, o, r2, s2, r1 ) || insideCorner( dt, o, r2, s2, s1 )
+			|| (sameDirection( dt, o, r1, r2 ) && sameDirection( dt, o, s1, s2 ));
+	}
+
+	// true if the circumcircle of t lies strictly between x= lo and x= hi. Nearly
+	// degenerate triangles, whose circumcentre cannot be trusted, never do.
+	bool
+	circumcircleWithin( const IndexedDelaunay& dt, const Tri& t, double lo, double hi )
+	{
+		double ax = dt.x( t[0] ), ay = dt.y( t[0] );
+		double bx = dt.x( t[1] ) - ax, by = dt.y( t[1] ) - ay;
+		double cx = dt.x( t[2] ) - ax, cy = dt.y( t[2] ) - ay;
+		double det = bx * cy - by * cx;
+		if ( std::abs( det ) * 1e6 <= std::abs( bx * cy ) + std::abs( by * cx ) )
+		{
+			return false;
+		}
+		double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+		double ux = (cy * b2 - by * c2) / (2.0 * det);
+		double uy = (bx * c2 - cx * b2) / (2.0 * det);
+		double r = std::hypot( ux, uy );
+		double centre = ax + ux;
+		double tol = 1e-6 * r + 1e-12 * (std::abs( ax ) + r);
+		return centre - r > lo + tol && centre + r < hi - tol;
+	}
+
+	// Every edge borders at most two triangles and V - E + F == 1
+	bool
+	isTriangulatedDisk( const std::vector<Tri>& tris )
+	{
+		std::unordered_map<uint64_t, int> edges;
+		std::unordered_set<int> vertices;
+		edges.reserve( 2 * tris.size() );
+		for ( const auto& t : tris )
+		{
+			for ( int k = 0; k < 3; k++ )
+			{
+				auto a = static_cast<uint64_t>(std::min( t[k], t[(k + 1) % 3] ));
+				auto b = static_cast<uint64_t>(std::max( t[k], t[(k + 1) % 3] ));
+				if ( ++edges[(a << 32) | b] > 2 )
+				{
+					return false;
+				}
+				vertices.insert( t[k] );
+			}
+		}
+		return static_cast<long long>(vertices.size()) - static_cast<long long>(edges.size())
+			+ static_cast<long long>(tris.size()) == 1;
+	}
+
+	struct StripResult
+	{
+		std::vector<Tri> finals;
+		std::vector<int> seam;
+	};
+
+	StripResult
+	triangulateStrip( const std::vector<double>& xs, const std::vector<double>& ys,
+					  const std::vector<int>& indices, double lo, double hi )
+	{
+		StripResult result;
+		IndexedDelaunay dt( xs, ys );
+		dt.triangulate( indices );
+		for ( const auto& t : dt.triangles( true ) )
+		{
+			if ( t[0] >= 0 && t[1] >= 0 && t[2] >= 0 && circumcircleWithin( dt, t, lo, hi ) )
+			{
+				result.finals.push_back( t );
+			}
+			else
+			{
+				for ( int v : t )
+				{
+					if ( v >= 0 )
+					{
+						result.seam.push_back( v );
+					}
+				}
+			}
+		}
+		std::sort( result.seam.begin(), result.seam.end() );
+		result.seam.erase( std::unique( result.seam.begin(), result.seam.end() ), result.seam.end() );
+		return result;
+	}
+
+	// Split the points into strips, triangulate them concurrently and fill the
+	// seams. Returns an empty vector if the merged result is inconsistent.
+	std::vector<Tri>
+	triangulateStrips( const std::vector<double>& xs, const std::vector<double>& ys,
+					   const std::vector<int>& order, unsigned nStrips, ThreadPool& pool )
+	{
+		const int n = static_cast<int>(order.size());
+		std::vector<std::future<StripResult>> futures;
+		for ( unsigned i = 0; i < nStrips; i++ )
+		{
+			int begin = static_cast<int>(static_cast<long long>(n) * i / nStrips);
+			int end = static_cast<int>(static_cast<long long>(n) * (i + 1) / nStrips);
+			double lo = begin > 0 ? xs[order[begin - 1]] : -std::numeric_limits<double>::infinity();
+			double hi = end < n ? xs[order[end]] : std::numeric_limits<double>::infinity();
+			std::vector<int> indices( order.begin() + begin, order.begin() + end );
+			futures.push_back( pool.submit( [&xs, &ys, indices = std::move( indices ), lo, hi]() {
+				return triangulateStrip( xs, ys, indices, lo, hi );
+			} ) );
+		}
+
+		std::vector<Tri> tris;
+		std::vector<int> seam;
+		for ( auto& f : futures )
+		{
+			auto strip = f.get();
+			tris.insert( tris.end(), strip.finals.begin(), strip.finals.end() );
+			seam.insert( seam.end(), strip.seam.begin(), strip.seam.end() );
+		}
+		const size_t nFinals = tris.size();
+
+		// For each vertex, the final triangles incident to it
+		std::vector<int> start( xs.size() + 1, 0 ), incident( 3 * nFinals );
+		for ( size_t j = 0; j < nFinals; j++ )
+		{
+			for ( int v : tris[j] )
+			{
+				start[v + 1]++;
+			}
+		}
+		for ( size_t i = 0; i < xs.size(); i++ )
+		{
+			start[i + 1] += start[i];
+		}
+		std::vector<int> fill( start.begin(), start.end() - 1 );
+		for ( size_t j = 0; j < nFinals; j++ )
+		{
+			for ( int v : tris[j] )
+			{
+				incident[fill[v]++] = static_cast<int>(j);
+			}
+		}
+
+		// A seam triangle is kept unless it overlaps a final triangle. Since the
+		// final triangles are a subset of the Delaunay triangulation, any overlap
+		// shows up at the corners of a shared vertex.
+		IndexedDelaunay dt( xs, ys );
+		dt.triangulate( seam );
+		for ( const auto& t : dt.triangles() )
+		{
+			int o = t[0];
+			bool overlaps = false;
+			for ( int i = start[o]; i < start[o + 1] && !overlaps; i++ )
+			{
+				const auto& f = tris[incident[i]];
+				int p = f[0] == o ? 0 : (f[1] == o ? 1 : 2);
+				overlaps = cornersOverlap( dt, o, t[1], t[2], f[(p + 1) % 3], f[(p + 2) % 3] );
+			}
+			if ( !overlaps )
+			{
+				tris.push_back( t );
+			}
+		}
+
+		Msg::debug( "runParallel: " + std::to_string( nFinals ) + " strip triangles, "
+					+ std::to_string( seam.size() ) + " seam nodes" );
+
+		if ( !isTriangulatedDisk( tris ) )
+		{
+			tris.clear();
+		}
+		return tris;
+	}
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::runParallel( unsigned nThreads,
+							  unsigned nStrips )
+{
+	setCurMethod( shared_from_this() );
+
+	const int n = nodeList.size();
+	std::vector<double> xs( n ), ys( n );
+	for ( int i = 0; i < n; i++ )
+	{
+		xs[i] = nodeList.get( i )->x;
+		ys[i] = nodeList.get( i )->y;
+	}
+	std::vector<int> order( n );
+	std::iota( order.begin(), order.end(), 0 );
+	std::sort( order.begin(), order.end(), [&xs, &ys]( int a, int b ) {
+		return xs[a] < xs[b] || (xs[a] == xs[b] && ys[a] < ys[b]);
+	} );
+
+	if ( nThreads == 0 )
+	{
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+	if ( nStrips == 0 )
+	{
+		nStrips = nThreads;
+	}
+
+	std::vector<Tri> tris;
+	if ( nStrips > 1 && n >= minParallelNodes )
+	{
+		ThreadPool pool( nThreads );
+		tris = triangulateStrips( xs, ys, order, nStrips, pool );
+		if ( tris.empty() )
+		{
+			Msg::warning( "runParallel: inconsistent seam, triangulating sequentially" );
+		}
+	}
+	if ( tris.empty() )
+	{
+		IndexedDelaunay dt( xs, ys );
+		dt.triangulate( order );
+		tris = dt.triangles();
+	}
+
+	buildMesh( tris );
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::runConstrained( const ArrayList<std::shared_ptr<Node>>& outer,
+								 const std::vector<ArrayList<std::shared_ptr<Node>>>& holes )
+{
+	setCurMethod( shared_from_this() );
+
+	std::vector<const ArrayList<std::shared_ptr<Node>>*> loops{ &outer };
+	for ( const auto& hole : holes )
+	{
+		loops.push_back( &hole );
+	}
+
+	// Number the Nodes, merging those with equal coordinates
+	nodeList.clear();
+	std::vector<double> xs, ys;
+	std::map<std::pair<double, double>, int> index;
+	std::vector<std::vector<int>> loopIndices;
+	for ( const auto* loop : loops )
+	{
+		std::vector<int> indices;
+		for ( const auto& n : *loop )
+		{
+			auto it = index.try_emplace( std::make_pair( n->x, n->y ), static_cast<int>(xs.size()) ).first;
+			if ( it->second == static_cast<int>(xs.size()) )
+			{
+				nodeList.add( n );
+				xs.push_back( n->x );
+				ys.push_back( n->y );
+			}
+			indices.push_back( it->second );
+		}
+		loopIndices.push_back( std::move( indices ) );
+	}
+
+	std::vector<int> all( xs.size() );
+	std::iota( all.begin(), all.end(), 0 );
+	IndexedDelaunay dt( xs, ys );
+	dt.triangulate( all );
+
+	for ( const auto& indices : loopIndices )
+	{
+		for ( size_t i = 0; i < indices.size(); i++ )
+		{
+			int a = indices[i], b = indices[(i + 1) % indices.size()];
+			if ( !dt.insertSegment( a, b ) )
+			{
+				Msg::error( "DelaunayMeshGen.runConstrained: boundary segment " + nodeList.get( a )->descr()
+							+ " - " + nodeList.get( b )->descr() + " crosses another boundary segment." );
+			}
+		}
+	}
+	Msg::debug( "DelaunayMeshGen.runConstrained: boundary recovered" );
+
+	if ( sizing || minAngle > 0.0 )
+	{
+		if ( !dt.refine( minAngle, sizing, maxSteinerPoints, !keepBoundary ) )
+		{
+			Msg::warning( "DelaunayMeshGen.runConstrained: refinement stopped after "
+						  + std::to_string( maxSteinerPoints ) + " Steiner nodes" );
+		}
+		for ( int i = static_cast<int>(xs.size()); i < dt.pointCount(); i++ )
+		{
+			nodeList.add( std::make_shared<Node>( dt.x( i ), dt.y( i ) ) );
+		}
+		Msg::debug( "DelaunayMeshGen.runConstrained: inserted "
+					+ std::to_string( dt.pointCount() - xs.size() ) + " Steiner nodes" );
+	}
+
+	elementList.clear();
+	buildMesh( dt.trianglesInside() );
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::setRefinement( double meshSize,
+								double minAngle,
+								size_t maxPoints )
+{
+	if ( meshSize > 0.0 )
+	{
+		sizing = [meshSize]( double, double ) { return meshSize; };
+	}
+	else
+	{
+		sizing = nullptr;
+	}
+	this->minAngle = minAngle;
+	maxSteinerPoints = maxPoints;
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::setRefinement( const SizingFunction& size,
+								double minAngle,
+								size_t maxPoints )
+{
+	sizing = size;
+	this->minAngle = minAngle;
+	maxSteinerPoints = maxPoints;
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::setKeepBoundary( bool keep )
+{
+	keepBoundary = keep;
+}
+
+//TODO: Tests
+void
+DelaunayMeshGen::buildMesh( const std::vector<std::array<int, 3>>& tris )
+{
+	triangleList.clear();
+	edgeList.clear();
+
+	std::unordered_map<uint64_t, std::shared_ptr<Edge>> edges;
+	edges.reserve( 2 * tris.size() );
+	auto edgeBetween = [this, &edges]( int a, int b ) {
+		auto key = (static_cast<uint64_t>(std::min( a, b )) << 32) | static_cast<uint64_t>(std::max( a, b ));
+		auto& e = edges[key];
+		if ( !e )
+		{
+			e = std::make_shared<Edge>( nodeList.get( a ), nodeList.get( b ) );
+			e->connectNodes();
+			edgeList.add( e );
+		}
+		return e;
+	};
+
+	for ( const auto& t : tris )
+	{
+		auto e1 = edgeBetween( t[0], t[1] );
+		auto e2 = edgeBetween( t[1], t[2] );
+		auto e3 = edgeBetween( t[2], t[0] );
+		auto triangle = std::make_shared<Triangle>( e1, e2, e3 );
+		triangle->connectEdges();
+		triangleList.add( triangle );
+	}
+}
@@ -3,7 +3,10 @@
 #include "GeomBasics.h"
 #include "ArrayList.h"
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <vector>
 
 /**
  * This class offers methods for incrementally constructing Delaunay triangle
@@ -17,6 +20,22 @@ class DelaunayMeshGen :
 	public GeomBasics,
 	public std::enable_shared_from_this<DelaunayMeshGen>
 {
+public:
+	/**
+	 * The way the mesh is made Delaunay compliant again after each insertion.
+	 * EdgeFlip is the original recursive swapping of edges (Lawson). Cavity
+	 * removes every triangle whose circumcircle contains the new Node and
+	 * connects the Node to the boundary of the resulting hole (Bowyer-Watson).
+	 */
+	enum class InsertionMode
+	{
+		EdgeFlip,
+		Cavity
+	};
+
+	/** The desired edge length at the point (x, y) */
+	using SizingFunction = std::function<double( double x, double y )>;
+
 private:
 	bool inside = false;
 	ArrayList<std::shared_ptr<Node>> irNodes;
@@ -30,9 +49,24 @@ private:
 	 */
 	bool delaunayCompliant = false;
 	int counter = 0;
+	InsertionMode insertionMode = InsertionMode::EdgeFlip;
+
+	// Refinement settings for runConstrained(..)
+	SizingFunction sizing;
+	double minAngle = 0.0;
+	size_t maxSteinerPoints = 0;
+	bool keepBoundary = false;
 
 public:
-	void init( bool delaunayCompliant );
+	/**
+	 * Create the two initial triangles from the four most extreme Nodes.
+	 *
+	 * @param delaunayCompliant whether to create a delaunay compliant mesh or not
+	 * @param mode              the insertion method used when delaunayCompliant is
+	 *                          true
+	 */
+	void init( bool delaunayCompliant,
+			   InsertionMode mode = InsertionMode::EdgeFlip );
 
 	// Run the implementation on the give set of nodes. */
 	void run();
@@ -43,6 +77,82 @@ public:
 	 */
 	void step() override;
 
+	/**
+	 * Triangulate the Nodes in nodeList in parallel, replacing the contents of
+	 * edgeList and triangleList. This is an alternative to init(true, ..) and
+	 * run() for large point sets.
+	 *
+	 * The Nodes are sorted by x and split into vertical strips that are
+	 * triangulated concurrently. A strip triangle whose circumcircle lies
+	 * strictly between the neighbouring strips is final. The Nodes of all other
+	 * triangles are triangulated once more, sequentially, to fill the seams. If
+	 * the merged mesh fails a consistency check the whole set is triangulated
+	 * sequentially instead.
+	 *
+	 * @param nThreads the number of worker threads, or 0 for one per hardware
+	 *                 thread
+	 * @param nStrips  the number of strips, or 0 to use one per thread
+	 */
+	void runParallel( unsigned nThreads = 0,
+					  unsigned nStrips = 0 );
+
+	/**
+	 * Generate a constrained Delaunay triangle mesh of the region bounded by
+	 * the given loops, replacing the contents of nodeList, edgeList,
+	 * triangleList and elementList. Each loop segment becomes an Edge of the
+	 * mesh, and the triangles outside the outer loop or inside a hole are
+	 * removed. The result is ready for QMorph::init().
+	 *
+	 * Nodes with equal coordinates are merged. The loops must not cross each
+	 * other or themselves; if they do, the method fails with Msg::error(..).
+	 *
+	 * If setRefinement(..) has been called, Steiner Nodes are then inserted
+	 * until the mesh satisfies the quality and size requirements.
+	 *
+	 * @param outer the Nodes of the outer boundary loop, in order
+	 * @param holes the Nodes of each hole boundary loop, in order
+	 */
+	void runConstrained( const ArrayList<std::shared_ptr<Node>>& outer,
+						 const std::vector<ArrayList<std::shared_ptr<Node>>>& holes = {} );
+
+	/**
+	 * Make runConstrained(..) refine the mesh to a uniform edge length.
+	 *
+	 * @param meshSize  the desired edge length, as the mesh_size parameter of
+	 *                  QMorph::init(..), or 0 to only improve the angles
+	 * @param minAngle  the smallest acceptable angle in degrees. Values above
+	 *                  about 30 may keep the refinement from terminating before
+	 *                  maxPoints Nodes have been inserted.
+	 * @param maxPoints the largest number of Steiner Nodes to insert
+	 */
+	void setRefinement( double meshSize,
+						double minAngle = 20.0,
+						size_t maxPoints = 1000000 );
+
+	/**
+	 * Make runConstrained(..) refine the mesh to a varying edge length.
+	 *
+	 * @param size      the desired edge length at each point of the domain
+	 * @param minAngle  the smallest acceptable angle in degrees
+	 * @param maxPoints the largest number of Steiner Nodes to insert
+	 */
+	void setRefinement( const SizingFunction& size,
+						double minAngle = 20.0,
+						size_t maxPoints = 1000000 );
+
+	/**
+	 * Make the refinement of runConstrained(..) keep each loop segment a single
+	 * Edge, so that the boundary of the mesh is exactly the given loops.
+	 * Triangles that could only be improved by splitting a segment are left as
+	 * they are.
+	 */
+	void setKeepBoundary( bool keep );
+
+	bool equals( const std::shared_ptr<Constants>& elem ) const override
+	{
+		return std::dynamic_pointer_cast<DelaunayMeshGen>(elem) != nullptr;
+	}
+
 private:
 	/**
 	 * Find the triangle (in the list) that contains the specified Node. A method
@@ -89,4 +199,27 @@ private:
 	void insertNode( const std::shared_ptr<Node>& n,
 					 bool remainDelaunay );
 
+	/**
+	 * Insert a Node with the Bowyer-Watson method. The triangles in conflict with
+	 * n are collected with an explicit stack, starting from the location found by
+	 * findTriangleContaining(..). The cavity is then retriangulated in one pass,
+	 * reusing the removed Triangle and Edge objects before allocating new ones.
+	 *
+	 * @param n the Node to insert
+	 * @param o the return value of findTriangleContaining(n, ..)
+	 */
+	void insertNodeInCavity( const std::shared_ptr<Node>& n,
+							 const std::shared_ptr<Constants>& o );
+
+	/** @return true if n lies strictly inside the circumcircle of t */
+	bool inConflict( const std::shared_ptr<Triangle>& t,
+					 const std::shared_ptr<Node>& n );
+
+	/**
+	 * Replace edgeList and triangleList with the given triangles.
+	 *
+	 * @param tris triples of indices into nodeList, in ccw order
+	 */
+	void buildMesh( const std::vector<std::array<int, 3>>& tris );
+
 };
@@ -0,0 +1,470 @@
+#include "pch.h"
+#include "DomainDecomposition.h"
+
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Msg.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+
+DomainDecomposition::DomainDecomposition( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+										  const ArrayList<std::shared_ptr<Edge>>& edges,
+										  const ArrayList<std::shared_ptr<Node>>& nodes,
+										  unsigned nSubdomains )
+{
+	const int nT = static_cast<int>(triangles.size());
+	if ( nSubdomains < 2 || nT < 2 * static_cast<int>(nSubdomains) )
+	{
+		return;
+	}
+
+	std::unordered_map<const Element*, int> triIndex;
+	for ( int i = 0; i < nT; i++ )
+	{
+		triIndex.emplace( triangles.get( i ).get(), i );
+	}
+
+	// The triangles on either side of each edge, -1 for none
+	std::vector<std::pair<int, int>> sides( edges.size(), { -1, -1 } );
+	std::unordered_map<const Edge*, int> edgeIndex;
+	std::unordered_map<const Node*, std::vector<int>> nodeEdges, nodeTris;
+	for ( int i = 0; i < static_cast<int>(edges.size()); i++ )
+	{
+		const auto& e = edges.get( i );
+		edgeIndex.emplace( e.get(), i );
+		for ( const auto& [elem, side] : { std::make_pair( e->element1, &sides[i].first ),
+										   std::make_pair( e->element2, &sides[i].second ) } )
+		{
+			if ( elem == nullptr )
+			{
+				continue;
+			}
+			auto it = triIndex.find( elem.get() );
+			if ( it == triIndex.end() )
+			{
+				return; // Not an all-triangle mesh
+			}
+			*side = it->second;
+		}
+		nodeEdges[e->leftNode.get()].push_back( i );
+		nodeEdges[e->rightNode.get()].push_back( i );
+	}
+	for ( int i = 0; i < nT; i++ )
+	{
+		const auto& t = triangles.get( i );
+		for ( const auto& n : { t->edgeList[0]->leftNode, t->edgeList[0]->rightNode,
+								t->edgeList[1]->otherNode( t->edgeList[0]->commonNode( t->edgeList[1] ) ) } )
+		{
+			nodeTris[n.get()].push_back( i );
+		}
+	}
+
+	// Cut the triangles into strips by the x coordinate of their centroids
+	std::vector<double> cx( nT ), cy( nT );
+	for ( int i = 0; i < nT; i++ )
+	{
+		const auto& t = triangles.get( i );
+		const auto& a = t->edgeList[0]->leftNode;
+		const auto& b = t->edgeList[0]->rightNode;
+		auto c = t->edgeList[1]->otherNode( t->edgeList[0]->commonNode( t->edgeList[1] ) );
+		cx[i] = (a->x + b->x + c->x) / 3.0;
+		cy[i] = (a->y + b->y + c->y) / 3.0;
+	}
+	std::vector<int> order( nT );
+	std::iota( order.begin(), order.end(), 0 );
+	std::sort( order.begin(), order.end(), [&cx, &cy]( int a, int b ) {
+		return cx[a] < cx[b] || (cx[a] == cx[b] && cy[a] < cy[b]);
+	} );
+	part.assign( nT, 0 );
+	for ( int r = 0; r < nT; r++ )
+	{
+		part[order[r]] = static_cast<int>(static_cast<long long>(r) * nSubdomains / nT);
+	}
+
+	auto sideOf = [this]( int tri ) { return tri >= 0 ? part[tri] : -1; };
+
+	// A node is pinched if the triangles of some subdomain around it form more
+	// than one fan, that is, if more than two of its edges bound the subdomain
+	auto pinched = [&]( const Node* n ) {
+		std::unordered_map<int, int> bounding;
+		for ( int i : nodeEdges[n] )
+		{
+			int sa = sideOf( sides[i].first ), sb = sideOf( sides[i].second );
+			if ( sa != sb )
+			{
+				if ( sa >= 0 && ++bounding[sa] > 2 )
+				{
+					return true;
+				}
+				if ( sb >= 0 && ++bounding[sb] > 2 )
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	// Give all the triangles around a pinched node to the subdomain holding most
+	// of them, until no node is pinched
+	const int maxRounds = 20;
+	bool clean = false;
+	for ( int round = 0; round < maxRounds && !clean; round++ )
+	{
+		clean = true;
+		for ( const auto& n : nodes )
+		{
+			if ( !pinched( n.get() ) )
+			{
+				continue;
+			}
+			clean = false;
+			std::unordered_map<int, int> votes;
+			int best = -1;
+			for ( int t : nodeTris[n.get()] )
+			{
+				int v = ++votes[part[t]];
+				if ( best == -1 || v > votes[best] || (v == votes[best] && part[t] < best) )
+				{
+					best = part[t];
+				}
+			}
+			for ( int t : nodeTris[n.get()] )
+			{
+				part[t] = best;
+			}
+		}
+	}
+	if ( !clean )
+	{
+		Msg::warning( "DomainDecomposition: cannot remove the pinched nodes of the partition" );
+		part.clear();
+		return;
+	}
+
+	// Drop the subdomains emptied above
+	std::vector<int> renumber( nSubdomains, -1 );
+	int nS = 0;
+	for ( int i = 0; i < nT; i++ )
+	{
+		renumber[part[i]] = 1;
+	}
+	for ( auto& r : renumber )
+	{
+		r = r == 1 ? nS++ : -1;
+	}
+	if ( nS < 2 )
+	{
+		part.clear();
+		return;
+	}
+	for ( auto& p : part )
+	{
+		p = renumber[p];
+	}
+
+	auto countBoundaries = [&]() {
+		boundaryEdges.assign( nS, 0 );
+		for ( const auto& [a, b] : sides )
+		{
+			int sa = sideOf( a ), sb = sideOf( b );
+			if ( sa != sb )
+			{
+				if ( sa >= 0 )
+				{
+					boundaryEdges[sa]++;
+				}
+				if ( sb >= 0 )
+				{
+					boundaryEdges[sb]++;
+				}
+			}
+		}
+	};
+	countBoundaries();
+
+	std::vector<int> sizes( nS, 0 );
+	for ( int p : part )
+	{
+		sizes[p]++;
+	}
+
+	// Moving a triangle from one subdomain to a neighboring one changes the
+	// parity of the boundary of both, whatever the other edges of the triangle
+	// border. Fix the parity of the subdomains in order, each fix passing the odd
+	// parity on to a later subdomain, and undo moves that pinch a node.
+	auto tryMove = [&]( int t, int to ) {
+		int from = part[t];
+		if ( sizes[from] < 2 )
+		{
+			return false;
+		}
+		part[t] = to;
+		const auto& tri = triangles.get( t );
+		for ( const auto& te : tri->edgeList )
+		{
+			if ( pinched( te->leftNode.get() ) || pinched( te->rightNode.get() ) )
+			{
+				part[t] = from;
+				return false;
+			}
+		}
+		sizes[from]--;
+		sizes[to]++;
+		return true;
+	};
+
+	for ( int s = 0; s + 1 < nS; s++ )
+	{
+		if ( (boundaryEdges[s] & 1) == 0 )
+		{
+			continue;
+		}
+		bool fixed = false;
+		for ( int i = 0; i < static_cast<int>(sides.size()) && !fixed; i++ )
+		{
+			int a = sides[i].first, b = sides[i].second;
+			if ( a < 0 || b < 0 )
+			{
+				continue;
+			}
+			for ( const auto& [t, other] : { std::make_pair( a, b ), std::make_pair( b, a ) } )
+			{
+				int from = part[t], to = part[other];
+				if ( ((from == s && to > s) || (from > s && to == s)) && tryMove( t, to ) )
+				{
+					fixed = true;
+					break;
+				}
+			}
+		}
+		countBoundaries();
+		if ( !fixed )
+		{
+			Msg::warning( "DomainDecomposition: cannot make subdomain " + std::to_string( s ) + " even" );
+		}
+	}
+
+	copySubdomains( triangles, edges, nodes );
+}
+
+int
+DomainDecomposition::boundaryEdgeCount( size_t i ) const
+{
+	return boundaryEdges[i];
+}
+
+void
+DomainDecomposition::copySubdomains( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+									 const ArrayList<std::shared_ptr<Edge>>& edges,
+									 const ArrayList<std::shared_ptr<Node>>& nodes )
+{
+	const size_t nS = boundaryEdges.size();
+	copies.assign( nS, {} );
+	interfaceEdges.assign( nS, {} );
+	interfaceNodes.assign( nS, {} );
+
+	std::unordered_map<const Element*, int> triIndex;
+	std::unordered_map<const Node*, std::vector<int>> nodeParts;
+	for ( int i = 0; i < static_cast<int>(triangles.size()); i++ )
+	{
+		const auto& t = triangles.get( i );
+		triIndex.emplace( t.get(), i );
+		for ( const auto& e : t->edgeList )
+		{
+			for ( const auto& n : { e->leftNode, e->rightNode } )
+			{
+				auto& p = nodeParts[n.get()];
+				if ( std::find( p.begin(), p.end(), part[i] ) == p.end() )
+				{
+					p.push_back( part[i] );
+				}
+			}
+		}
+	}
+
+	std::vector<std::unordered_map<const Node*, std::shared_ptr<Node>>> nodeCopy( nS );
+	for ( const auto& n : nodes )
+	{
+		const auto& p = nodeParts[n.get()];
+		for ( int s : p )
+		{
+			auto copy = std::make_shared<Node>( n->x, n->y );
+			copies[s].nodes.add( copy );
+			nodeCopy[s].emplace( n.get(), copy );
+			if ( p.size() > 1 )
+			{
+				interfaceNodes[s].emplace( copy.get(), n.get() );
+			}
+		}
+	}
+
+	std::vector<std::unordered_map<const Edge*, std::shared_ptr<Edge>>> edgeCopy( nS );
+	for ( const auto& e : edges )
+	{
+		int sa = e->element1 != nullptr ? part[triIndex[e->element1.get()]] : -1;
+		int sb = e->element2 != nullptr ? part[triIndex[e->element2.get()]] : -1;
+		for ( int s : { sa, sb } )
+		{
+			if ( s < 0 || edgeCopy[s].count( e.get() ) != 0 )
+			{
+				continue;
+			}
+			auto copy = std::make_shared<Edge>( nodeCopy[s][e->leftNode.get()], nodeCopy[s][e->rightNode.get()] );
+			copy->connectNodes();
+			copies[s].edges.add( copy );
+			edgeCopy[s].emplace( e.get(), copy );
+			if ( sa >= 0 && sb >= 0 && sa != sb )
+			{
+				interfaceEdges[s].emplace( copy.get(), e.get() );
+			}
+		}
+	}
+
+	for ( int i = 0; i < static_cast<int>(triangles.size()); i++ )
+	{
+		const auto& t = triangles.get( i );
+		auto& ec = edgeCopy[part[i]];
+		auto copy = std::make_shared<Triangle>( ec[t->edgeList[0].get()], ec[t->edgeList[1].get()], ec[t->edgeList[2].get()] );
+		copy->connectEdges();
+		copies[part[i]].triangles.add( copy );
+	}
+}
+
+bool
+DomainDecomposition::stitch( const std::vector<MeshComponents::Component>& meshed,
+							 MeshComponents::Component& result,
+							 ArrayList<std::shared_ptr<Node>>& seam ) const
+{
+	// Check that every copy of an interface edge is still there, between the
+	// copies of its nodes, and that these have not moved
+	for ( size_t s = 0; s < copies.size(); s++ )
+	{
+		std::unordered_set<const Edge*> edgesLeft;
+		std::unordered_set<const Node*> nodesLeft;
+		for ( const auto& e : meshed[s].edges )
+		{
+			edgesLeft.insert( e.get() );
+		}
+		for ( const auto& n : meshed[s].nodes )
+		{
+			nodesLeft.insert( n.get() );
+		}
+		for ( const auto& [copy, orig] : interfaceNodes[s] )
+		{
+			if ( nodesLeft.count( copy ) == 0 || copy->x != orig->x || copy->y != orig->y )
+			{
+				return false;
+			}
+		}
+		for ( const auto& [copy, orig] : interfaceEdges[s] )
+		{
+			if ( edgesLeft.count( copy ) == 0 )
+			{
+				return false;
+			}
+			auto l = interfaceNodes[s].find( copy->leftNode.get() );
+			auto r = interfaceNodes[s].find( copy->rightNode.get() );
+			if ( l == interfaceNodes[s].end() || r == interfaceNodes[s].end()
+				 || l->second != orig->leftNode.get() || r->second != orig->rightNode.get() )
+			{
+				return false;
+			}
+		}
+	}
+
+	// The copy in the first subdomain holding an interface node or edge stands in
+	// for the copies in the others
+	std::unordered_map<const Node*, std::shared_ptr<Node>> nodeRep;
+	std::unordered_map<const Edge*, std::shared_ptr<Edge>> edgeRep;
+	std::unordered_map<const Node*, std::shared_ptr<Node>> nodeReplace;
+	std::unordered_map<const Edge*, std::shared_ptr<Edge>> edgeReplace;
+	std::vector<ArrayList<std::shared_ptr<Edge>>> kept( copies.size() );
+
+	result = MeshComponents::Component();
+	seam.clear();
+	for ( size_t s = 0; s < copies.size(); s++ )
+	{
+		for ( const auto& n : meshed[s].nodes )
+		{
+			auto it = interfaceNodes[s].find( n.get() );
+			if ( it == interfaceNodes[s].end() )
+			{
+				result.nodes.add( n );
+				continue;
+			}
+			auto [rep, added] = nodeRep.emplace( it->second, n );
+			if ( added )
+			{
+				result.nodes.add( n );
+				seam.add( n );
+			}
+			else
+			{
+				nodeReplace.emplace( n.get(), rep->second );
+			}
+		}
+		for ( const auto& e : meshed[s].edges )
+		{
+			auto it = interfaceEdges[s].find( e.get() );
+			if ( it != interfaceEdges[s].end() )
+			{
+				auto [rep, added] = edgeRep.emplace( it->second, e );
+				if ( !added )
+				{
+					edgeReplace.emplace( e.get(), rep->second );
+					continue;
+				}
+			}
+			kept[s].add( e );
+		}
+	}
+
+	for ( size_t s = 0; s < copies.size(); s++ )
+	{
+		for ( const auto& e : kept[s] )
+		{
+			for ( const auto& n : { e->leftNode, e->rightNode } )
+			{
+				auto it = nodeReplace.find( n.get() );
+				if ( it != nodeReplace.end() )
+				{
+					e->replaceNode( n, it->second );
+					it->second->connectToEdge( e );
+				}
+			}
+			result.edges.add( e );
+		}
+
+		auto rewire = [&]( const std::shared_ptr<Element>& elem ) {
+			for ( auto& e : elem->edgeList )
+			{
+				auto it = edgeReplace.find( e.get() );
+				if ( it != edgeReplace.end() )
+				{
+					e = it->second;
+					e->connectToElement( elem );
+				}
+			}
+			auto it = nodeReplace.find( elem->firstNode.get() );
+			if ( it != nodeReplace.end() )
+			{
+				elem->firstNode = it->second;
+			}
+		};
+		for ( const auto& elem : meshed[s].elements )
+		{
+			rewire( elem );
+			result.elements.add( elem );
+		}
+		for ( const auto& t : meshed[s].triangles )
+		{
+			rewire( t );
+			result.triangles.add( t );
+		}
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ArrayList.h"
+#include "MeshComponents.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Node;
+class Edge;
+class Triangle;
+
+/**
+ * A partition of a triangle mesh into subdomains along its existing edges, so
+ * that the subdomains can be quad meshed independently and stitched together
+ * afterwards.
+ *
+ * The triangles are sorted by the x coordinate of their centroids and cut into
+ * strips of equal size. Nodes where the triangles of a subdomain do not form a
+ * single fan are then given to one subdomain, and triangles are moved across
+ * the interfaces until each subdomain is bounded by an even number of edges,
+ * the condition for an all-quad mesh that QMorph records in
+ * evenInitNrOfFronts. The parity of the last strip is that of the whole
+ * boundary, and cannot be changed.
+ *
+ * Each subdomain is handed out as a copy with nodes and edges of its own, so
+ * the original mesh is left untouched until stitch(..) succeeds, and the
+ * subdomains can be meshed on separate threads. Their interface edges are
+ * boundary edges of the copies, and QMorph does not move or split boundary
+ * edges.
+ */
+
+class DomainDecomposition
+{
+public:
+	/**
+	 * Partition the mesh into at most nSubdomains subdomains. A mesh that cannot
+	 * be partitioned gets no subdomains.
+	 */
+	DomainDecomposition( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+						 const ArrayList<std::shared_ptr<Edge>>& edges,
+						 const ArrayList<std::shared_ptr<Node>>& nodes,
+						 unsigned nSubdomains );
+
+	/** @return the number of subdomains */
+	size_t size() const { return copies.size(); }
+
+	/** @return the subdomain of each triangle, in the order of the triangle list */
+	const std::vector<int>& getPartition() const { return part; }
+
+	/** @return the copy of subdomain i */
+	const MeshComponents::Component& subdomain( size_t i ) const { return copies[i]; }
+
+	/**
+	 * @return the number of edges bounding subdomain i, interface edges
+	 *         included
+	 */
+	int boundaryEdgeCount( size_t i ) const;
+
+	/**
+	 * Stitch the meshed subdomains together, merging the copies of each interface
+	 * node and edge into one.
+	 *
+	 * @param meshed the subdomains after meshing, in the order of subdomain(..)
+	 * @param result set to the stitched mesh
+	 * @param seam   set to the nodes on the interfaces
+	 * @return false, leaving the meshed subdomains unchanged, if the meshing has
+	 *         moved, split or removed an interface node or edge
+	 */
+	bool stitch( const std::vector<MeshComponents::Component>& meshed,
+				 MeshComponents::Component& result,
+				 ArrayList<std::shared_ptr<Node>>& seam ) const;
+
+private:
+	std::vector<int> part;
+	std::vector<int> boundaryEdges;
+	std::vector<MeshComponents::Component> copies;
+	// For each subdomain, its copies of the interface edges and nodes, mapped to
+	// the originals
+	std::vector<std::unordered_map<const Edge*, const Edge*>> interfaceEdges;
+	std::vector<std::unordered_map<const Node*, const Node*>> interfaceNodes;
+
+	void copySubdomains( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+						 const ArrayList<std::shared_ptr<Edge>>& edges,
+						 const ArrayList<std::shared_ptr<Node>>& nodes );
+};
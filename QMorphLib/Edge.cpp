@@ -8,26 +8,18 @@
 #include "Msg.h"
 #include "Element.h"
 #include "Types.h"
+#include "EdgeGrid.h"
+#include "FrontList.h"
+#include "FrontLoops.h"
 
 #include <iostream>
 
-std::array<ArrayList<std::shared_ptr<Edge>>, 3> Edge::stateList;
+thread_local std::array<ArrayList<std::shared_ptr<Edge>>, 3> Edge::stateList;
 
 Edge::Edge( const std::shared_ptr<Node>& node1,
 			const std::shared_ptr<Node>& node2 )
 {
-	if ( (node1->x < node2->x) || (rcl::equal(node1->x, node2->x) && node1->y > node2->y) )
-	{
-		leftNode = node1;
-		rightNode = node2;
-	}
-	else
-	{
-		leftNode = node2;
-		rightNode = node1;
-	}
-
-	len = computeLength();
+	reinit( node1, node2 );
 }
 
 Edge::Edge( const Edge& e )
@@ -46,6 +38,36 @@ Edge::copy()
 	return std::make_shared<Edge>( e );
 }
 
+void
+Edge::reinit( const std::shared_ptr<Node>& node1,
+			  const std::shared_ptr<Node>& node2 )
+{
+	if ( (node1->x < node2->x) || (rcl::equal(node1->x, node2->x) && node1->y > node2->y) )
+	{
+		leftNode = node1;
+		rightNode = node2;
+	}
+	else
+	{
+		leftNode = node2;
+		rightNode = node1;
+	}
+	len = computeLength();
+
+	element1 = nullptr;
+	element2 = nullptr;
+	leftFrontNeighbor = nullptr;
+	rightFrontNeighbor = nullptr;
+	level = 0;
+	frontEdge = false;
+	swappable = true;
+	selectable = true;
+	leftSide = false;
+	rightSide = false;
+	color = Color::Green;
+	EdgeGrid::edgeMoved( *this );
+}
+
 void 
 Edge::clearStateList()
 {
@@ -346,17 +368,21 @@ Edge::replaceNode( const std::shared_ptr<Node>& n1,
 {
 	if ( leftNode->equals( n1 ) )
 	{
+		leftNode->invalidateStar();
 		leftNode = n2;
 	}
 	else if ( rightNode->equals( n1 ) )
 	{
+		rightNode->invalidateStar();
 		rightNode = n2;
 	}
 	else
 	{
 		return false;
 	}
+	invalidateStars();
 	len = computeLength();
+	EdgeGrid::edgeMoved( *this );
 	return true;
 }
 
@@ -385,6 +411,7 @@ Edge::seamWith( const std::shared_ptr<Edge>& e )
 					found = true;
 
 					other->edgeList.remove( other->edgeList.indexOf( eI ) );
+					other->invalidateStar();
 
 					if ( eI->element1->firstNode == nKm1 )
 					{ // Don't forget firstNode!!
@@ -408,6 +435,7 @@ Edge::seamWith( const std::shared_ptr<Edge>& e )
 
 				eI->replaceNode( nKm1, nKp1 );
 				nKp1->edgeList.add( eI );
+				nKp1->invalidateStar();
 			}
 			else
 			{
@@ -418,6 +446,7 @@ Edge::seamWith( const std::shared_ptr<Edge>& e )
 		{
 			// Remove the edge between eKp1 and eKm1 (from the edgeList of eKp1)
 			nKp1->edgeList.remove( nKp1->edgeList.indexOf( eI ) );
+			nKp1->invalidateStar();
 		}
 	}
 }
@@ -690,6 +719,7 @@ Edge::connectNodes()
 {
 	leftNode->edgeList.add( shared_from_this() );
 	rightNode->edgeList.add( shared_from_this() );
+	invalidateStars();
 }
 
 void
@@ -697,6 +727,7 @@ Edge::disconnectNodes()
 {
 	leftNode->edgeList.remove( leftNode->edgeList.indexOf( shared_from_this() ) );
 	rightNode->edgeList.remove( rightNode->edgeList.indexOf( shared_from_this() ) );
+	invalidateStars();
 }
 
 void
@@ -712,6 +743,40 @@ Edge::tryToDisconnectNodes()
 	{
 		rightNode->edgeList.remove( i );
 	}
+	invalidateStars();
+}
+
+void
+Edge::invalidateStars()
+{
+	leftNode->invalidateStar();
+	rightNode->invalidateStar();
+	for ( const auto& elem : { element1, element2 } )
+	{
+		if ( elem == nullptr )
+		{
+			continue;
+		}
+		for ( const auto& e : elem->edgeList )
+		{
+			if ( e != nullptr )
+			{
+				e->leftNode->invalidateStar();
+				e->rightNode->invalidateStar();
+			}
+		}
+	}
+}
+
+void
+Edge::releaseLinks()
+{
+	leftNode = rightNode = nullptr;
+	element1 = element2 = nullptr;
+	leftFrontNeighbor = rightFrontNeighbor = nullptr;
+	frontOwner = nullptr;
+	frontNext = nullptr;
+	frontPrev = nullptr;
 }
 
 void 
@@ -724,10 +789,12 @@ Edge::connectToTriangle( const std::shared_ptr<Triangle>& triangle )
 	if ( element1 == nullptr )
 	{
 		element1 = triangle;
+		invalidateStars();
 	}
 	else if ( element2 == nullptr )
 	{
 		element2 = triangle;
+		invalidateStars();
 	}
 	else
 	{
@@ -745,10 +812,12 @@ Edge::connectToQuad( const std::shared_ptr<Quad>& q )
 	if ( element1 == nullptr )
 	{
 		element1 = q;
+		invalidateStars();
 	}
 	else if ( element2 == nullptr )
 	{
 		element2 = q;
+		invalidateStars();
 	}
 	else
 	{
@@ -766,10 +835,12 @@ Edge::connectToElement( const std::shared_ptr<Element>& elem )
 	if ( element1 == nullptr )
 	{
 		element1 = elem;
+		invalidateStars();
 	}
 	else if ( element2 == nullptr )
 	{
 		element2 = elem;
+		invalidateStars();
 	}
 	else
 	{
@@ -780,6 +851,7 @@ Edge::connectToElement( const std::shared_ptr<Element>& elem )
 void
 Edge::disconnectFromElement( const std::shared_ptr<Element>& elem )
 {
+	invalidateStars();
 	if ( element1 == elem )
 	{
 		element1 = element2;
@@ -893,7 +965,7 @@ Edge::getSwappedEdge()
 	return swappedEdge;
 }
 
-void 
+std::array<std::shared_ptr<Triangle>, 2>
 Edge::swapToAndSetElementsFor( const std::shared_ptr<Edge>& e )
 {
 	Msg::debug("Entering Edge.swapToAndSetElementsFor(..)");
@@ -927,6 +999,7 @@ Edge::swapToAndSetElementsFor( const std::shared_ptr<Edge>& e )
 	e->connectNodes();
 
 	Msg::debug( "Leaving Edge.swapToAndSetElementsFor(..)" );
+	return { t1, t2 };
 }
 
 MyVector 
@@ -953,6 +1026,25 @@ Edge::getVector( const std::shared_ptr<Node>& origin )
 	}
 }
 
+//TODO: Tests
+Vec2
+Edge::getVec2( const std::shared_ptr<Node>& origin )
+{
+	if ( origin->equals( leftNode ) )
+	{
+		return rightNode->point() - leftNode->point();
+	}
+	else if ( origin->equals( rightNode ) )
+	{
+		return leftNode->point() - rightNode->point();
+	}
+	else
+	{
+		Msg::error( "Edge::getVec2(Node): Node not an endpoint in this edge." );
+		throw std::runtime_error( "Node not an endpoint in this edge." );
+	}
+}
+
 bool
 Edge::bordersToTriangle()
 {
@@ -1238,7 +1330,9 @@ Edge::setFrontNeighbor( const std::shared_ptr<Edge>& e )
 	else
 	{
 		Msg::warning( "Edge.setFrontNeighbor(..): Could not set." );
+		return;
 	}
+	FrontLoops::edgeChanged( *this );
 }
 
 bool 
@@ -1253,6 +1347,10 @@ Edge::setFrontNeighbors( const ArrayList<std::shared_ptr<Edge>>& frontList2 )
 	}
 	leftFrontNeighbor = lFront;
 	rightFrontNeighbor = rFront;
+	if ( res )
+	{
+		FrontLoops::edgeChanged( *this );
+	}
 
 	if ( lFront != nullptr && !lFront->hasFrontNeighbor( shared_from_this() ) )
 	{
@@ -1265,6 +1363,14 @@ Edge::setFrontNeighbors( const ArrayList<std::shared_ptr<Edge>>& frontList2 )
 	return res;
 }
 
+bool
+Edge::setFrontNeighbors( const FrontList& /*frontList2*/ )
+{
+	// The front neighbors are found among the edges at the two nodes, so the
+	// list itself is never looked at
+	return setFrontNeighbors( ArrayList<std::shared_ptr<Edge>>() );
+}
+
 void 
 Edge::promoteToFront( int level,
 					  ArrayList<std::shared_ptr<Edge>>& frontList )
@@ -1274,6 +1380,7 @@ Edge::promoteToFront( int level,
 		frontList.add( shared_from_this() );
 		this->level = level;
 		frontEdge = true;
+		FrontLoops::edgeChanged( *this );
 	}
 }
 
@@ -1281,7 +1388,11 @@ bool
 Edge::removeFromFront( ArrayList<std::shared_ptr<Edge>>& frontList2 )
 {
 	auto i = frontList2.indexOf( shared_from_this() );
-	frontEdge = false;
+	if ( frontEdge )
+	{
+		frontEdge = false;
+		FrontLoops::edgeChanged( *this );
+	}
 	if ( i != -1 )
 	{
 		frontList2.remove( i );
@@ -1293,19 +1404,49 @@ Edge::removeFromFront( ArrayList<std::shared_ptr<Edge>>& frontList2 )
 	}
 }
 
+void
+Edge::promoteToFront( int level,
+					  FrontList& frontList )
+{
+	if ( !frontEdge )
+	{
+		frontList.add( shared_from_this() );
+		this->level = level;
+		frontEdge = true;
+		FrontLoops::edgeChanged( *this );
+	}
+}
+
+bool
+Edge::removeFromFront( FrontList& frontList2 )
+{
+	if ( frontEdge )
+	{
+		frontEdge = false;
+		FrontLoops::edgeChanged( *this );
+	}
+	// An edge already taken out of the mesh drops its front neighbors, or two
+	// such edges pointing at each other would keep each other alive
+	if ( leftNode != nullptr && leftNode->edgeList.indexOf( shared_from_this() ) == -1 )
+	{
+		leftFrontNeighbor = rightFrontNeighbor = nullptr;
+	}
+	return frontList2.remove( shared_from_this() );
+}
+
 std::shared_ptr<Edge>
 Edge::splitTrianglesAt( const std::shared_ptr<Node>& nN,
 						const std::shared_ptr<Node>& ben,
-						ArrayList<std::shared_ptr<Triangle>>& triangleList,
-						ArrayList<std::shared_ptr<Edge>>& edgeList,
+						MeshList<std::shared_ptr<Triangle>>& triangleList,
+						EdgeList& edgeList,
 						const ArrayList<std::shared_ptr<Node>>& nodeList )
 {
 	Msg::debug( "Entering Edge.splitTrianglesAt(..)" );
 	auto eK1 = std::make_shared<Edge>( leftNode, nN );
 	auto eK2 = std::make_shared<Edge>( rightNode, nN );
 
-	auto tri1 = std::dynamic_pointer_cast<Triangle>(element1);
-	auto tri2 = std::dynamic_pointer_cast<Triangle>(element2);
+	auto tri1 = rcl::triangleCast(element1);
+	auto tri2 = rcl::triangleCast(element2);
 
 	auto n1 = tri1->oppositeOfEdge( shared_from_this() );
 	auto n2 = tri2->oppositeOfEdge( shared_from_this() );
@@ -1340,14 +1481,14 @@ Edge::splitTrianglesAt( const std::shared_ptr<Node>& nN,
 	t22->connectEdges();
 
 	// Update "global" lists
-	edgeList.remove( edgeList.indexOf( shared_from_this() ) );
+	edgeList.markRemoved( shared_from_this() );
 	edgeList.add( eK1 );
 	edgeList.add( eK2 );
 	edgeList.add( diagonal1 );
 	edgeList.add( diagonal2 );
 
-	triangleList.remove( triangleList.indexOf( tri1 ) );
-	triangleList.remove( triangleList.indexOf( tri2 ) );
+	triangleList.markRemoved( tri1 );
+	triangleList.markRemoved( tri2 );
 	triangleList.add( t11 );
 	triangleList.add( t12 );
 	triangleList.add( t21 );
@@ -1375,8 +1516,8 @@ Edge::splitTrianglesAt( const std::shared_ptr<Node>& nN,
 }
 
 std::shared_ptr<Edge>
-Edge::splitTrianglesAtMyMidPoint( ArrayList<std::shared_ptr<Triangle>>& triangleList,
-								  ArrayList<std::shared_ptr<Edge>>& edgeList,
+Edge::splitTrianglesAtMyMidPoint( MeshList<std::shared_ptr<Triangle>>& triangleList,
+								  EdgeList& edgeList,
 								  ArrayList<std::shared_ptr<Node>>& nodeList,
 								  const std::shared_ptr<Edge>& baseEdge )
 {
@@ -1409,7 +1550,7 @@ Edge::nextQuadEdgeAt( const std::shared_ptr<Node>& n,
 	while ( elem != nullptr && !(rcl::instanceOf<Quad>(elem)) && elem != startElem )
 	{
 		e = elem->neighborEdge( n, e );
-		Msg::debug( "..." + i );
+		Msg::debug( "..." + std::to_string( i ) );
 		i++;
 		elem = elem->neighbor( e );
 	}
@@ -1429,11 +1570,11 @@ Edge::getQuadElement()
 {
 	if ( rcl::instanceOf<Quad>( element1 ) )
 	{
-		return std::dynamic_pointer_cast<Quad>(element1);
+		return rcl::quadCast(element1);
 	}
 	else if ( rcl::instanceOf<Quad>( element2 ) )
 	{
-		return std::dynamic_pointer_cast<Quad>(element2);
+		return rcl::quadCast(element2);
 	}
 	else
 	{
@@ -1446,11 +1587,11 @@ Edge::getTriangleElement()
 {
 	if ( rcl::instanceOf<Triangle>( element1 ) )
 	{
-		return std::dynamic_pointer_cast<Triangle>(element1);
+		return rcl::triangleCast(element1);
 	}
 	else if ( rcl::instanceOf<Triangle>( element2 ) )
 	{
-		return std::dynamic_pointer_cast<Triangle>(element2);
+		return rcl::triangleCast(element2);
 	}
 	else
 	{
@@ -1463,11 +1604,11 @@ Edge::getQuadWithEdge( const std::shared_ptr<Edge>& e )
 {
 	if ( rcl::instanceOf<Quad>( element1 ) && element1->hasEdge( e ) )
 	{
-		return std::dynamic_pointer_cast<Quad>(element1);
+		return rcl::quadCast(element1);
 	}
 	else if ( rcl::instanceOf<Quad>( element2 ) && element2->hasEdge( e ) )
 	{
-		return std::dynamic_pointer_cast<Quad>(element2);
+		return rcl::quadCast(element2);
 	}
 	else
 	{
@@ -1541,7 +1682,7 @@ Edge::markAllSelectable()
 {
 	for ( auto& l : stateList )
 	{
-		std::for_each( l.begin(), l.end(), []( std::shared_ptr<Edge>& e )
+		std::for_each( l.begin(), l.end(), []( const std::shared_ptr<Edge>& e )
 					   {
 						   e->selectable = true;
 					   } );
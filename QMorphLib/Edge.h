@@ -2,8 +2,14 @@
 
 #include "Constants.h"
 #include "ArrayList.h"
+#include "MeshList.h"
+#include "LiveCount.h"
+#include "Vec2.h"
+#include "WeakLink.h"
 
 #include <array>
+#include <atomic>
+#include <cstdint>
 
 /**
  * This class holds information for edges, and has methods for handling issues
@@ -12,6 +18,8 @@
 
 class Node;
 class Element;
+class FrontList;
+class EdgeList;
 class Edge;
 class Triangle;
 class Quad;
@@ -23,20 +31,35 @@ class Edge :
 {
 public:
 	std::shared_ptr<Node> leftNode, rightNode; // This Edge has these two nodes
-	std::shared_ptr<Element> element1 = nullptr, element2 = nullptr; // Belongs to these Elements (Quads/Triangles)
-	std::shared_ptr<Edge> leftFrontNeighbor, rightFrontNeighbor;
-	int level;
-
-	static std::array<ArrayList<std::shared_ptr<Edge>>, 3> stateList;
-
-	bool frontEdge = false;
-	bool swappable = true;
-	bool selectable = true;
+	// Belongs to these Elements (Quads/Triangles), which are owned by the lists
+	// of GeomBasics
+	WeakLink<Element> element1 = nullptr, element2 = nullptr;
+	WeakLink<Edge> leftFrontNeighbor, rightFrontNeighbor;
+	int level = 0;
+
+	// The links of the FrontList holding this Edge, if any
+	FrontList* frontOwner = nullptr;
+	std::shared_ptr<Edge> frontNext = nullptr;
+	Edge* frontPrev = nullptr;
+
+	static thread_local std::array<ArrayList<std::shared_ptr<Edge>>, 3> stateList;
+
+	// The flags share a byte with color, ahead of the 4-byte snapshotIndex
+	bool frontEdge : 1 = false;
+	bool swappable : 1 = true;
+	bool selectable : 1 = true;
 	// Edge leftSide= null, rightSide= null; // Side edges when building a quad
-	bool leftSide = false, rightSide = false; // Indicates if frontNeighbor is
+	bool leftSide : 1 = false, rightSide : 1 = false; // Indicates if frontNeighbor is
 	// to be used as side edge in quad
-	double len; // length of this edge
 	Color color = Color::Green;
+	LiveCount<Edge> liveCount;
+	// The number of this edge in the last MeshSnapshot taken of its mesh
+	uint32_t snapshotIndex = 0;
+	double len = 0.0; // length of this edge
+	// A number given to this edge when it is made, unique among the edges
+	uint64_t id = lastId.fetch_add( 1, std::memory_order_relaxed ) + 1;
+
+	inline static std::atomic<uint64_t> lastId = 0;
 
 	Edge() {}
 
@@ -53,6 +76,13 @@ public:
 	// Return a copy of the edge
 	std::shared_ptr<Edge> copy();
 
+	// Make this the Edge between node1 and node2, as the constructor does, for
+	// reuse by the mesh generator. The id and the FrontList links are kept; the
+	// elements, the front neighbors and the flags are reset. An edge registered
+	// in the EdgeGrid of the edgeList is moved to its new cells.
+	void reinit( const std::shared_ptr<Node>& node1,
+				 const std::shared_ptr<Node>& node2 );
+
 	static void clearStateList();
 
 	// Removes an Edge from the stateLists
@@ -182,6 +212,15 @@ public:
 	// Remove this Edge from the nodes' edgeLists. Safety checks...
 	void tryToDisconnectNodes();
 
+	// Drop the cached stars of the two nodes of this Edge and of all the nodes
+	// of its elements.
+	void invalidateStars();
+
+	// Drop every link this Edge holds to nodes, elements and other edges, so
+	// that none of them is kept alive by it. Used when the whole mesh is
+	// released, and leaves the Edge unusable.
+	void releaseLinks();
+
 	void connectToTriangle( const std::shared_ptr<Triangle>& triangle );
 
 	void connectToQuad( const std::shared_ptr<Quad>& q );
@@ -227,13 +266,19 @@ public:
 	/**
 	 * Swap diagonal between the edge's two triangles and update locally (To be used
 	 * with getSwappedEdge())
+	 *
+	 * @return the new triangles, e.element1 and e.element2. The edges only link
+	 *         back to them, so the caller must put them in a list to keep them.
 	 */
-	void swapToAndSetElementsFor( const std::shared_ptr<Edge>& e );
+	std::array<std::shared_ptr<Triangle>, 2> swapToAndSetElementsFor( const std::shared_ptr<Edge>& e );
 
 	MyVector getVector();
 
 	MyVector getVector( const std::shared_ptr<Node>& origin );
 
+	/** @return the vector of getVector(origin) as a value */
+	Vec2 getVec2( const std::shared_ptr<Node>& origin );
+
 	bool bordersToTriangle();
 
 	bool boundaryEdge();
@@ -285,24 +330,43 @@ public:
 	/** Returns true if the frontEdgeNeighbors are changed. */
 	bool setFrontNeighbors( const ArrayList<std::shared_ptr<Edge>>& frontList2 );
 
+	/** @see setFrontNeighbors(const ArrayList<std::shared_ptr<Edge>>&) */
+	bool setFrontNeighbors( const FrontList& frontList2 );
+
 	void promoteToFront( int level,
 						 ArrayList<std::shared_ptr<Edge>>& frontList );
 
+	/** @see promoteToFront(int, ArrayList<std::shared_ptr<Edge>>&) */
+	void promoteToFront( int level,
+						 FrontList& frontList );
+
+	// The edgeList is not a front list, and would lose its EdgeGrid through an
+	// ArrayList reference
+	void promoteToFront( int level,
+						 EdgeList& frontList ) = delete;
+
 	bool removeFromFront( ArrayList<std::shared_ptr<Edge>>& frontList2 );
 
+	/** @see removeFromFront(ArrayList<std::shared_ptr<Edge>>&) */
+	bool removeFromFront( FrontList& frontList2 );
+
+	bool removeFromFront( EdgeList& frontList2 ) = delete;
+
 	/**
 	 * Halve this Edge by introducing a new Node at the midpoint, and create two
 	 * Edges from this midpoint to the each of the two opposite Nodes of Edge this:
 	 * one in element1 and one in element2. Also create two new Edges from Node mid
 	 * to the two Nodes of Edge this. Create four new Triangles. Update everything
-	 * (also remove this Edge from edgeList and disconnect the nodes).
+	 * (also remove this Edge from edgeList and disconnect the nodes). The old
+	 * Edge and Triangles are left as tombstones in the lists, for the caller to
+	 * compact at the end of its phase.
 	 *
 	 * @return the new Edge incident with Node ben.
 	 */
 	std::shared_ptr<Edge> splitTrianglesAt( const std::shared_ptr<Node>& nN,
 											const std::shared_ptr<Node>& ben,
-											ArrayList<std::shared_ptr<Triangle>>& triangleList,
-											ArrayList<std::shared_ptr<Edge>>& edgeList,
+											MeshList<std::shared_ptr<Triangle>>& triangleList,
+											EdgeList& edgeList,
 											const ArrayList<std::shared_ptr<Node>>& nodeList );
 
 	/**
@@ -311,8 +375,8 @@ public:
 	 * @return the "lower" (the one incident with the baseEdge) of the two edges
 	 *         created from splitting this edge.
 	 */
-	std::shared_ptr<Edge> splitTrianglesAtMyMidPoint( ArrayList<std::shared_ptr<Triangle>>& triangleList,
-													  ArrayList<std::shared_ptr<Edge>>& edgeList,
+	std::shared_ptr<Edge> splitTrianglesAtMyMidPoint( MeshList<std::shared_ptr<Triangle>>& triangleList,
+													  EdgeList& edgeList,
 													  ArrayList<std::shared_ptr<Node>>& nodeList,
 													  const std::shared_ptr<Edge>& baseEdge );
 
@@ -0,0 +1,516 @@
+#include "pch.h"
+#include "EdgeGrid.h"
+
+#include "Edge.h"
+#include "Node.h"
+#include "GeomBasics.h"
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+namespace
+{
+	// Edges are registered in every cell their bounding box comes within this
+	// fraction of a cell from, so that rounding in the cell traversal of
+	// crossing(..) cannot skip a cell that the segment only grazes.
+	constexpr double padding = 1e-6;
+
+	double
+	pointSegmentDistance( double px, double py,
+						  double ax, double ay,
+						  double bx, double by )
+	{
+		double dx = bx - ax, dy = by - ay;
+		double len2 = dx * dx + dy * dy;
+		double t = 0.0;
+		if ( len2 > 0.0 )
+		{
+			t = std::clamp( ((px - ax) * dx + (py - ay) * dy) / len2, 0.0, 1.0 );
+		}
+		return std::hypot( ax + t * dx - px, ay + t * dy - py );
+	}
+}
+
+EdgeGrid::EdgeGrid( double cellSize ) :
+	cellSize( cellSize > 0.0 ? cellSize : 1.0 )
+{
+}
+
+EdgeGrid::EdgeGrid( const ArrayList<std::shared_ptr<Edge>>& edges ) :
+	cellSize( 1.0 )
+{
+	double sum = 0.0;
+	for ( const auto& e : edges )
+	{
+		sum += std::hypot( e->rightNode->x - e->leftNode->x, e->rightNode->y - e->leftNode->y );
+	}
+	if ( edges.size() > 0 && sum > 0.0 )
+	{
+		cellSize = sum / static_cast<double>(edges.size());
+	}
+
+	entries.reserve( edges.size() );
+	for ( const auto& e : edges )
+	{
+		insert( e );
+	}
+}
+
+int
+EdgeGrid::cellOf( double v ) const
+{
+	constexpr double lim = static_cast<double>(std::numeric_limits<int>::max() / 2);
+	return static_cast<int>(std::floor( std::clamp( v / cellSize, -lim, lim ) ));
+}
+
+uint64_t
+EdgeGrid::key( int i, int j )
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(i)) << 32) | static_cast<uint32_t>(j);
+}
+
+EdgeGrid::Entry
+EdgeGrid::entryFor( const std::shared_ptr<Edge>& e ) const
+{
+	const auto& a = *e->leftNode;
+	const auto& b = *e->rightNode;
+	double pad = padding * cellSize;
+
+	Entry entry;
+	entry.edge = e;
+	entry.i0 = cellOf( std::min( a.x, b.x ) - pad );
+	entry.i1 = cellOf( std::max( a.x, b.x ) + pad );
+	entry.j0 = cellOf( std::min( a.y, b.y ) - pad );
+	entry.j1 = cellOf( std::max( a.y, b.y ) + pad );
+	return entry;
+}
+
+void
+EdgeGrid::link( const Entry& entry )
+{
+	for ( int i = entry.i0; i <= entry.i1; i++ )
+	{
+		for ( int j = entry.j0; j <= entry.j1; j++ )
+		{
+			cells[key( i, j )].push_back( entry.edge.get() );
+		}
+	}
+
+	if ( maxI < minI )
+	{
+		minI = entry.i0;
+		maxI = entry.i1;
+		minJ = entry.j0;
+		maxJ = entry.j1;
+	}
+	else
+	{
+		minI = std::min( minI, entry.i0 );
+		maxI = std::max( maxI, entry.i1 );
+		minJ = std::min( minJ, entry.j0 );
+		maxJ = std::max( maxJ, entry.j1 );
+	}
+}
+
+void
+EdgeGrid::unlink( const Entry& entry )
+{
+	for ( int i = entry.i0; i <= entry.i1; i++ )
+	{
+		for ( int j = entry.j0; j <= entry.j1; j++ )
+		{
+			auto it = cells.find( key( i, j ) );
+			if ( it == cells.end() )
+			{
+				continue;
+			}
+			auto& bucket = it->second;
+			auto pos = std::find( bucket.begin(), bucket.end(), entry.edge.get() );
+			if ( pos != bucket.end() )
+			{
+				*pos = bucket.back();
+				bucket.pop_back();
+			}
+			if ( bucket.empty() )
+			{
+				cells.erase( it );
+			}
+		}
+	}
+}
+
+void
+EdgeGrid::insert( const std::shared_ptr<Edge>& e )
+{
+	if ( e == nullptr || entries.count( e.get() ) != 0 )
+	{
+		return;
+	}
+	auto entry = entryFor( e );
+	link( entry );
+	entries.emplace( e.get(), std::move( entry ) );
+}
+
+void
+EdgeGrid::remove( const std::shared_ptr<Edge>& e )
+{
+	if ( e == nullptr )
+	{
+		return;
+	}
+	auto it = entries.find( e.get() );
+	if ( it == entries.end() )
+	{
+		return;
+	}
+	unlink( it->second );
+	entries.erase( it );
+}
+
+void
+EdgeGrid::update( const std::shared_ptr<Edge>& e )
+{
+	if ( e != nullptr )
+	{
+		refresh( *e );
+	}
+}
+
+void
+EdgeGrid::refresh( const Edge& e )
+{
+	auto it = entries.find( &e );
+	if ( it == entries.end() )
+	{
+		return;
+	}
+	auto entry = entryFor( it->second.edge );
+	const auto& old = it->second;
+	if ( entry.i0 == old.i0 && entry.i1 == old.i1 && entry.j0 == old.j0 && entry.j1 == old.j1 )
+	{
+		return;
+	}
+	unlink( old );
+	link( entry );
+	it->second = std::move( entry );
+}
+
+void
+EdgeGrid::clear()
+{
+	entries.clear();
+	cells.clear();
+	minI = minJ = 0;
+	maxI = maxJ = -1;
+}
+
+bool
+EdgeGrid::contains( const std::shared_ptr<Edge>& e ) const
+{
+	return e != nullptr && entries.count( e.get() ) != 0;
+}
+
+ArrayList<std::shared_ptr<Edge>>
+EdgeGrid::crossing( const Node& a, const Node& b ) const
+{
+	return crossing( a.x, a.y, b.x, b.y );
+}
+
+ArrayList<std::shared_ptr<Edge>>
+EdgeGrid::crossing( double ax, double ay, double bx, double by ) const
+{
+	std::vector<std::pair<double, const Edge*>> found;
+	std::unordered_set<const Edge*> seen;
+
+	auto visit = [&]( int i, int j )
+	{
+		auto it = cells.find( key( i, j ) );
+		if ( it == cells.end() )
+		{
+			return;
+		}
+		for ( const Edge* e : it->second )
+		{
+			if ( !seen.insert( e ).second )
+			{
+				continue;
+			}
+			const auto& p = *e->leftNode;
+			const auto& q = *e->rightNode;
+			int sp = rcl::orientation( ax, ay, bx, by, p.x, p.y );
+			int sq = rcl::orientation( ax, ay, bx, by, q.x, q.y );
+			if ( sp == 0 || sq == 0 || sp == sq )
+			{
+				continue;
+			}
+			double oa = rcl::orient2d( p.x, p.y, q.x, q.y, ax, ay );
+			double ob = rcl::orient2d( p.x, p.y, q.x, q.y, bx, by );
+			if ( oa == 0.0 || ob == 0.0 || (oa > 0.0) == (ob > 0.0) )
+			{
+				continue;
+			}
+			found.emplace_back( oa / (oa - ob), e );
+		}
+	};
+
+	// Walk the cells pierced by the segment, after Amanatides and Woo
+	int i = cellOf( ax ), j = cellOf( ay );
+	const int iEnd = cellOf( bx ), jEnd = cellOf( by );
+	const double dx = bx - ax, dy = by - ay;
+	const int stepI = (dx > 0.0) - (dx < 0.0);
+	const int stepJ = (dy > 0.0) - (dy < 0.0);
+	constexpr double inf = std::numeric_limits<double>::infinity();
+	double tMaxX = stepI == 0 ? inf : ((i + (stepI > 0)) * cellSize - ax) / dx;
+	double tMaxY = stepJ == 0 ? inf : ((j + (stepJ > 0)) * cellSize - ay) / dy;
+	const double tDeltaX = stepI == 0 ? inf : cellSize / std::abs( dx );
+	const double tDeltaY = stepJ == 0 ? inf : cellSize / std::abs( dy );
+
+	int steps = std::abs( iEnd - i ) + std::abs( jEnd - j );
+	visit( i, j );
+	while ( steps-- > 0 )
+	{
+		// Never step past the last cell along an axis, whatever the rounding
+		if ( j == jEnd || (i != iEnd && tMaxX < tMaxY) )
+		{
+			i += stepI;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			j += stepJ;
+			tMaxY += tDeltaY;
+		}
+		visit( i, j );
+	}
+
+	std::sort( found.begin(), found.end(), []( const auto& l, const auto& r ) { return l.first < r.first; } );
+
+	ArrayList<std::shared_ptr<Edge>> result;
+	result.reserve( found.size() );
+	for ( const auto& f : found )
+	{
+		result.add( entries.at( f.second ).edge );
+	}
+	return result;
+}
+
+std::shared_ptr<Edge>
+EdgeGrid::nearest( double x, double y, double* dist ) const
+{
+	if ( entries.empty() )
+	{
+		if ( dist != nullptr )
+		{
+			*dist = std::numeric_limits<double>::infinity();
+		}
+		return nullptr;
+	}
+
+	const int ci = cellOf( x ), cj = cellOf( y );
+	const Edge* best = nullptr;
+	double bestDist = std::numeric_limits<double>::infinity();
+
+	auto visit = [&]( int i, int j )
+	{
+		if ( i < minI || i > maxI || j < minJ || j > maxJ )
+		{
+			return;
+		}
+		auto it = cells.find( key( i, j ) );
+		if ( it == cells.end() )
+		{
+			return;
+		}
+		for ( const Edge* e : it->second )
+		{
+			const auto& p = *e->leftNode;
+			const auto& q = *e->rightNode;
+			double d = pointSegmentDistance( x, y, p.x, p.y, q.x, q.y );
+			if ( d < bestDist )
+			{
+				bestDist = d;
+				best = e;
+			}
+		}
+	};
+
+	// Search square rings of cells around (x, y). Every edge not yet seen after
+	// ring r lies outside the searched block, at least r cells away.
+	int r = std::max( { 0, minI - ci, ci - maxI, minJ - cj, cj - maxJ } );
+	while ( true )
+	{
+		if ( r == 0 )
+		{
+			visit( ci, cj );
+		}
+		else
+		{
+			for ( int i = std::max( ci - r, minI ); i <= std::min( ci + r, maxI ); i++ )
+			{
+				visit( i, cj - r );
+				visit( i, cj + r );
+			}
+			for ( int j = std::max( cj - r + 1, minJ ); j <= std::min( cj + r - 1, maxJ ); j++ )
+			{
+				visit( ci - r, j );
+				visit( ci + r, j );
+			}
+		}
+
+		bool covered = ci - r <= minI && ci + r >= maxI && cj - r <= minJ && cj + r >= maxJ;
+		if ( covered || (best != nullptr && bestDist <= r * cellSize) )
+		{
+			break;
+		}
+		r++;
+	}
+
+	if ( dist != nullptr )
+	{
+		*dist = bestDist;
+	}
+	return entries.at( best ).edge;
+}
+
+void
+EdgeGrid::nodeMoved( const Node& n )
+{
+	const auto& grid = GeomBasics::edgeList.getGrid();
+	if ( grid == nullptr )
+	{
+		return;
+	}
+	for ( const auto& e : n.edgeList )
+	{
+		grid->update( e );
+	}
+}
+
+void
+EdgeGrid::edgeMoved( const Edge& e )
+{
+	const auto& grid = GeomBasics::edgeList.getGrid();
+	if ( grid != nullptr )
+	{
+		grid->refresh( e );
+	}
+}
+
+void
+EdgeList::setGrid( const std::shared_ptr<EdgeGrid>& g )
+{
+	grid = g;
+	if ( grid != nullptr )
+	{
+		grid->clear();
+		for ( const auto& e : *this )
+		{
+			grid->insert( e );
+		}
+	}
+}
+
+void
+EdgeList::add( const std::shared_ptr<Edge>& item )
+{
+	Base::add( item );
+	if ( grid != nullptr )
+	{
+		grid->insert( item );
+	}
+}
+
+void
+EdgeList::add( size_t index, const std::shared_ptr<Edge>& item )
+{
+	Base::add( index, item );
+	if ( grid != nullptr )
+	{
+		grid->insert( item );
+	}
+}
+
+void
+EdgeList::addAll( const ArrayList<std::shared_ptr<Edge>>& other )
+{
+	Base::addAll( other );
+	if ( grid != nullptr )
+	{
+		for ( const auto& e : other )
+		{
+			grid->insert( e );
+		}
+	}
+}
+
+void
+EdgeList::set( size_t index, const std::shared_ptr<Edge>& item )
+{
+	if ( grid != nullptr )
+	{
+		grid->remove( get( index ) );
+		grid->insert( item );
+	}
+	Base::set( index, item );
+}
+
+void
+EdgeList::remove( size_t index )
+{
+	if ( grid != nullptr && index < size() )
+	{
+		grid->remove( get( index ) );
+	}
+	Base::remove( index );
+}
+
+bool
+EdgeList::markRemoved( const std::shared_ptr<Edge>& item )
+{
+	if ( !Base::markRemoved( item ) )
+	{
+		return false;
+	}
+	if ( grid != nullptr )
+	{
+		grid->remove( item );
+	}
+	return true;
+}
+
+void
+EdgeList::clear()
+{
+	if ( grid != nullptr )
+	{
+		grid->clear();
+	}
+	Base::clear();
+}
+
+EdgeList::const_iterator
+EdgeList::erase( const_iterator pos )
+{
+	if ( grid != nullptr )
+	{
+		grid->remove( *pos );
+	}
+	return Base::erase( pos );
+}
+
+EdgeList::const_iterator
+EdgeList::erase( const_iterator first, const_iterator last )
+{
+	if ( grid != nullptr )
+	{
+		for ( auto it = first; it != last; ++it )
+		{
+			grid->remove( *it );
+		}
+	}
+	return Base::erase( first, last );
+}
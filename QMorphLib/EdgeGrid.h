@@ -0,0 +1,170 @@
+#pragma once
+
+#include "ArrayList.h"
+#include "MeshList.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Node;
+class Edge;
+
+/**
+ * A uniform grid over the edges of the mesh, answering segment-crossing and
+ * nearest-edge queries without scanning the whole edgeList. Each edge is
+ * registered in every cell overlapped by its bounding box. Cells are hashed,
+ * so the grid has no fixed extent and never needs to be rebuilt when the mesh
+ * grows.
+ *
+ * The grid does not observe the edges on its own. An EdgeList with an attached
+ * grid keeps it up to date as edges are added and removed, the Node move
+ * methods and Node::update() re-register the edges of a moved node and
+ * Edge::replaceNode(..) and Edge::reinit(..) re-register the edge they change.
+ * Code that writes node coordinates directly must call update(..) for the
+ * affected edges.
+ */
+
+class EdgeGrid
+{
+public:
+	/** @param cellSize the side length of a grid cell */
+	explicit EdgeGrid( double cellSize );
+
+	/**
+	 * Create a grid holding the given edges, with a cell size equal to their
+	 * mean length.
+	 */
+	explicit EdgeGrid( const ArrayList<std::shared_ptr<Edge>>& edges );
+
+	/** Register an edge. Does nothing if the edge is already registered. */
+	void insert( const std::shared_ptr<Edge>& e );
+
+	/** Unregister an edge. Does nothing if the edge is not registered. */
+	void remove( const std::shared_ptr<Edge>& e );
+
+	/** Re-register an edge after one of its nodes has moved. */
+	void update( const std::shared_ptr<Edge>& e );
+
+	/** Unregister all edges. */
+	void clear();
+
+	/** @return true if the edge is registered */
+	bool contains( const std::shared_ptr<Edge>& e ) const;
+
+	/** @return the number of registered edges */
+	size_t size() const { return entries.size(); }
+
+	double getCellSize() const { return cellSize; }
+
+	/**
+	 * Find the edges whose interior properly crosses the interior of the segment
+	 * from (ax, ay) to (bx, by). Edges that merely touch the segment, share an
+	 * endpoint with it or overlap it are not reported.
+	 *
+	 * @return the crossing edges, ordered by increasing distance from (ax, ay)
+	 */
+	ArrayList<std::shared_ptr<Edge>> crossing( double ax, double ay,
+											   double bx, double by ) const;
+
+	/** @see crossing(double, double, double, double) */
+	ArrayList<std::shared_ptr<Edge>> crossing( const Node& a, const Node& b ) const;
+
+	/**
+	 * @param dist if not null, set to the distance from (x, y) to the edge
+	 * @return the registered edge closest to the point (x, y), or nullptr if the
+	 *         grid is empty
+	 */
+	std::shared_ptr<Edge> nearest( double x, double y, double* dist = nullptr ) const;
+
+	/**
+	 * Re-register the edges of a node that has moved in the grid attached to
+	 * GeomBasics::edgeList, if there is one.
+	 */
+	static void nodeMoved( const Node& n );
+
+	/**
+	 * Re-register an edge that has got a new node in the grid attached to
+	 * GeomBasics::edgeList, if there is one.
+	 */
+	static void edgeMoved( const Edge& e );
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<Edge> edge;
+		int i0, j0, i1, j1; // The range of cells the edge is registered in
+	};
+
+	double cellSize;
+	std::unordered_map<const Edge*, Entry> entries;
+	std::unordered_map<uint64_t, std::vector<const Edge*>> cells;
+	// The range of cells ever occupied, bounding the nearest(..) search
+	int minI = 0, minJ = 0, maxI = -1, maxJ = -1;
+
+	int cellOf( double v ) const;
+	static uint64_t key( int i, int j );
+	void link( const Entry& entry );
+	void unlink( const Entry& entry );
+	Entry entryFor( const std::shared_ptr<Edge>& e ) const;
+	void refresh( const Edge& e );
+};
+
+/**
+ * A MeshList of edges that keeps an optional EdgeGrid in sync with its
+ * contents. All the methods that add or remove elements are shadowed, so the
+ * list must be modified through an EdgeList reference for the grid to see the
+ * change. An edge passed to markRemoved(..) leaves the grid at once, before its
+ * tombstone is compacted away.
+ */
+
+class EdgeList :
+	public MeshList<std::shared_ptr<Edge>>
+{
+	using Base = MeshList<std::shared_ptr<Edge>>;
+
+public:
+	/** Attach a grid, registering the current contents of the list in it. */
+	void setGrid( const std::shared_ptr<EdgeGrid>& g );
+
+	/** @return the attached grid, or nullptr */
+	const std::shared_ptr<EdgeGrid>& getGrid() const { return grid; }
+
+	void add( const std::shared_ptr<Edge>& item );
+
+	void add( size_t index, const std::shared_ptr<Edge>& item );
+
+	void addAll( const ArrayList<std::shared_ptr<Edge>>& other );
+
+	void set( size_t index, const std::shared_ptr<Edge>& item );
+
+	void remove( size_t index );
+
+	bool markRemoved( const std::shared_ptr<Edge>& item );
+
+	void clear();
+
+	const_iterator erase( const_iterator pos );
+
+	const_iterator erase( const_iterator first, const_iterator last );
+
+	template< typename Predicate >
+	void removeIf( Predicate pred )
+	{
+		if ( grid != nullptr )
+		{
+			for ( const auto& e : *this )
+			{
+				if ( e != nullptr && pred( e ) )
+				{
+					grid->remove( e );
+				}
+			}
+		}
+		Base::removeIf( pred );
+	}
+
+private:
+	std::shared_ptr<EdgeGrid> grid = nullptr;
+};
@@ -2,6 +2,15 @@
 #include "Element.h"
 
 #include "Node.h"
+#include "Predicates.h"
+
+//TODO: Tests
+void
+Element::releaseLinks()
+{
+	edgeList.clear();
+	firstNode = nullptr;
+}
 
 double 
 Element::cross( const std::shared_ptr<Node>& o1,
@@ -9,9 +18,5 @@ Element::cross( const std::shared_ptr<Node>& o1,
 				const std::shared_ptr<Node>& o2,
 				const std::shared_ptr<Node>& p2 )
 {
-	double x1 = p1->x - o1->x;
-	double x2 = p2->x - o2->x;
-	double y1 = p1->y - o1->y;
-	double y2 = p2->y - o2->y; 
-	return x1 * y2 - x2 * y1;
+	return rcl::cross2d( o1->x, o1->y, p1->x, p1->y, o2->x, o2->y, p2->x, p2->y );
 }
\ No newline at end of file
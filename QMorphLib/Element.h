@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Constants.h"
+#include "InlineVector.h"
+#include "LiveCount.h"
+
+#include <atomic>
+#include <cstdint>
 
 #include <string>
 
@@ -12,22 +17,49 @@
 class Edge;
 class Node;
 
+/** The types of element, told apart by Element::type without an RTTI cast */
+enum class ElementType : uint8_t
+{
+	Triangle,
+	Quad,
+	// Any other subclass of Element
+	Other
+};
+
 class Element : public Constants
 {
 public:
 
+	/**
+	 * The type of this element, set by the constructors of Triangle and Quad and
+	 * never changed afterwards. A fake quad is a Quad with isFake set.
+	 */
+	ElementType type;
+	LiveCount<Element> liveCount;
+	// The number of this element in the last MeshSnapshot taken of its mesh
+	uint32_t snapshotIndex = 0;
 	/** An array of interior angles */
-	std::vector<double> ang;
+	InlineVector<double, 4> ang;
 	/** An array of edges */
-	std::vector<std::shared_ptr<Edge>> edgeList;
+	InlineVector<std::shared_ptr<Edge>, 4> edgeList;
 	/** Node used for determining inversion, amonst other things. */
 	std::shared_ptr<Node> firstNode;
 	/**
 	 * Doubles to hold the cur. distortion metric and the metric after perturbation
 	 */
-	double distortionMetric, newDistortionMetric;
+	double distortionMetric = 0.0, newDistortionMetric = 0.0;
 	/** Doubles to hold the gradient vector */
-	double gX, gY;
+	double gX = 0.0, gY = 0.0;
+	// A number given to this element when it is made, unique among the elements
+	uint64_t id = lastId.fetch_add( 1, std::memory_order_relaxed ) + 1;
+
+	inline static std::atomic<uint64_t> lastId = 0;
+
+	/** @return true if this element is a Triangle */
+	bool isTriangle() const { return type == ElementType::Triangle; }
+
+	/** @return true if this element is a Quad, fake or not */
+	bool isQuad() const { return type == ElementType::Quad; }
 
 	/** @return neighbor element sharing edge e */
 	virtual std::shared_ptr<Element> neighbor( const std::shared_ptr<Edge>& e ) = 0;
@@ -99,7 +131,17 @@ public:
 	 */
 	virtual void disconnectEdges() = 0;
 
-	/** Create a simple element for testing purposes only. */
+	/**
+	 * Drop the edges and the first node of this element, so that none of them
+	 * is kept alive by it. Used when the whole mesh is released, and leaves the
+	 * element unusable.
+	 */
+	void releaseLinks();
+
+	/**
+	 * Create a simple element for testing purposes only. It is made in scratch
+	 * memory (see ScratchArena.h), and must not outlive the current step.
+	 */
 	virtual std::shared_ptr<Element> elementWithExchangedNodes( const std::shared_ptr<Node>& original, 
 																const std::shared_ptr<Node>& replacement ) = 0;
 
@@ -146,4 +188,15 @@ public:
 						 const std::shared_ptr<Node>& p1,
 						 const std::shared_ptr<Node>& o2,
 						 const std::shared_ptr<Node>& p2 );
+
+protected:
+	Element() :
+		type( ElementType::Other )
+	{
+	}
+
+	explicit Element( ElementType type ) :
+		type( type )
+	{
+	}
 };
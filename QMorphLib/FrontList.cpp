@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "FrontList.h"
+
+#include "Edge.h"
+
+FrontList::Iterator&
+FrontList::Iterator::operator++()
+{
+	slot = &(*slot)->frontNext;
+	return *this;
+}
+
+FrontList::Iterator
+FrontList::Iterator::operator++( int )
+{
+	auto old = *this;
+	++(*this);
+	return old;
+}
+
+FrontList::~FrontList()
+{
+	clear();
+}
+
+void
+FrontList::add( const std::shared_ptr<Edge>& e )
+{
+	if ( e->frontOwner == this )
+	{
+		return;
+	}
+	e->frontOwner = this;
+	e->frontPrev = tail;
+	if ( tail != nullptr )
+	{
+		tail->frontNext = e;
+	}
+	else
+	{
+		head = e;
+	}
+	tail = e.get();
+	count++;
+}
+
+bool
+FrontList::remove( const std::shared_ptr<Edge>& e )
+{
+	if ( e == nullptr || e->frontOwner != this )
+	{
+		return false;
+	}
+
+	// e may be a reference to the very link that is about to be overwritten
+	auto removed = e;
+	auto next = removed->frontNext;
+	auto prev = removed->frontPrev;
+	if ( prev != nullptr )
+	{
+		prev->frontNext = next;
+	}
+	else
+	{
+		head = next;
+	}
+	if ( next != nullptr )
+	{
+		next->frontPrev = prev;
+	}
+	else
+	{
+		tail = prev;
+	}
+	removed->frontNext = nullptr;
+	removed->frontPrev = nullptr;
+	removed->frontOwner = nullptr;
+	count--;
+	return true;
+}
+
+bool
+FrontList::contains( const std::shared_ptr<Edge>& e ) const
+{
+	return e != nullptr && e->frontOwner == this;
+}
+
+void
+FrontList::clear()
+{
+	// Unlink one edge at a time, since releasing the head would otherwise
+	// destroy a long chain of edges recursively
+	while ( head != nullptr )
+	{
+		auto cur = head;
+		head = cur->frontNext;
+		cur->frontNext = nullptr;
+		cur->frontPrev = nullptr;
+		cur->frontOwner = nullptr;
+	}
+	tail = nullptr;
+	count = 0;
+}
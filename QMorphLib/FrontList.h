@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+class Edge;
+
+/**
+ * The list of front edges used by QMorph. The list is intrusive: the links
+ * live in the edges themselves (Edge::frontNext, Edge::frontPrev), so adding
+ * an edge at the end and removing any edge take constant time, while the edges
+ * keep the order in which they were added, just as in an ArrayList.
+ *
+ * An edge is in at most one FrontList at a time. The list holds a reference to
+ * each of its edges through the frontNext link of the edge before it, keeping
+ * them alive while they are on the front.
+ */
+
+class FrontList
+{
+public:
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::shared_ptr<Edge>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::shared_ptr<Edge>*;
+		using reference = const std::shared_ptr<Edge>&;
+
+		Iterator() = default;
+		explicit Iterator( const std::shared_ptr<Edge>* slot ) : slot( slot ) {}
+
+		reference operator*() const { return *slot; }
+		pointer operator->() const { return slot; }
+		Iterator& operator++();
+		Iterator operator++( int );
+		bool operator==( const Iterator& other ) const { return edge() == other.edge(); }
+		bool operator!=( const Iterator& other ) const { return edge() != other.edge(); }
+
+	private:
+		// The link holding the current edge: the head of the list or the
+		// frontNext of the edge before it
+		const std::shared_ptr<Edge>* slot = nullptr;
+
+		const Edge* edge() const { return slot != nullptr ? slot->get() : nullptr; }
+	};
+
+	FrontList() = default;
+	~FrontList();
+
+	FrontList( const FrontList& ) = delete;
+	FrontList& operator=( const FrontList& ) = delete;
+
+	/** Add e at the end of the list. Does nothing if e is already in the list. */
+	void add( const std::shared_ptr<Edge>& e );
+
+	/**
+	 * Remove e from the list.
+	 *
+	 * @return true if e was in the list
+	 */
+	bool remove( const std::shared_ptr<Edge>& e );
+
+	/** @return true if e is in the list */
+	bool contains( const std::shared_ptr<Edge>& e ) const;
+
+	/** Remove all edges from the list. */
+	void clear();
+
+	size_t size() const { return count; }
+
+	bool empty() const { return count == 0; }
+
+	Iterator begin() const { return Iterator( &head ); }
+
+	Iterator end() const { return Iterator(); }
+
+private:
+	std::shared_ptr<Edge> head = nullptr;
+	Edge* tail = nullptr;
+	size_t count = 0;
+};
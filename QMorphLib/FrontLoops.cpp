@@ -0,0 +1,457 @@
+#include "pch.h"
+#include "FrontLoops.h"
+
+#include "Edge.h"
+#include "GeomBasics.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+FrontLoops::FrontLoops( const ArrayList<std::shared_ptr<Edge>>& frontList )
+{
+	for ( const auto& e : frontList )
+	{
+		changed( e );
+	}
+}
+
+FrontLoops::FrontLoops( const FrontList& frontList )
+{
+	for ( const auto& e : frontList )
+	{
+		changed( e );
+	}
+}
+
+void
+FrontLoops::changed( const std::shared_ptr<Edge>& e )
+{
+	dirty.emplace( e.get(), e );
+}
+
+bool
+FrontLoops::contains( const std::shared_ptr<Edge>& e )
+{
+	sync();
+	return find( e ) != nullptr;
+}
+
+size_t
+FrontLoops::size()
+{
+	sync();
+	return items.size();
+}
+
+int
+FrontLoops::loopSize( const std::shared_ptr<Edge>& e )
+{
+	sync();
+	auto t = find( e );
+	if ( t == nullptr )
+	{
+		return 0;
+	}
+	auto root = rootOf( t );
+	return closed( root ) ? root->size : 0;
+}
+
+bool
+FrontLoops::sameLoop( const std::shared_ptr<Edge>& a, const std::shared_ptr<Edge>& b )
+{
+	sync();
+	auto ta = find( a ), tb = find( b );
+	if ( ta == nullptr || tb == nullptr )
+	{
+		return false;
+	}
+	auto root = rootOf( ta );
+	return root == rootOf( tb ) && closed( root );
+}
+
+int
+FrontLoops::direction( const std::shared_ptr<Edge>& from, const std::shared_ptr<Edge>& next )
+{
+	if ( !sameLoop( from, next ) )
+	{
+		return 0;
+	}
+	auto tf = find( from ), tn = find( next );
+	int n = rootOf( tf )->size;
+	int d = (indexOf( tn ) - indexOf( tf ) + n) % n;
+	if ( d == 1 )
+	{
+		return 1;
+	}
+	else if ( d == n - 1 )
+	{
+		return -1;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+int
+FrontLoops::distance( const std::shared_ptr<Edge>& from, const std::shared_ptr<Edge>& to, int dir )
+{
+	if ( !sameLoop( from, to ) )
+	{
+		return -1;
+	}
+	auto tf = find( from ), tt = find( to );
+	int n = rootOf( tf )->size;
+	int d = dir * (indexOf( tt ) - indexOf( tf ));
+	return ((d % n) + n) % n;
+}
+
+int
+FrontLoops::lowestLevel()
+{
+	sync();
+	return levels.empty() ? -1 : levels.begin()->first;
+}
+
+int
+FrontLoops::countAtLowestLevel()
+{
+	sync();
+	return levels.empty() ? 0 : levels.begin()->second;
+}
+
+void
+FrontLoops::edgeChanged( Edge& e )
+{
+	const auto& loops = GeomBasics::frontLoops;
+	if ( loops != nullptr )
+	{
+		loops->changed( e.shared_from_this() );
+	}
+}
+
+unsigned
+FrontLoops::nextPriority()
+{
+	// xorshift32
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+int
+FrontLoops::sizeOf( const Item* t )
+{
+	return t != nullptr ? t->size : 0;
+}
+
+void
+FrontLoops::push( Item* t )
+{
+	if ( t != nullptr && t->reversed )
+	{
+		std::swap( t->left, t->right );
+		if ( t->left != nullptr )
+		{
+			t->left->reversed = !t->left->reversed;
+		}
+		if ( t->right != nullptr )
+		{
+			t->right->reversed = !t->right->reversed;
+		}
+		t->reversed = false;
+	}
+}
+
+void
+FrontLoops::pull( Item* t )
+{
+	t->size = 1 + sizeOf( t->left ) + sizeOf( t->right );
+	if ( t->left != nullptr )
+	{
+		t->left->parent = t;
+	}
+	if ( t->right != nullptr )
+	{
+		t->right->parent = t;
+	}
+}
+
+FrontLoops::Item*
+FrontLoops::merge( Item* a, Item* b )
+{
+	if ( a == nullptr )
+	{
+		return b;
+	}
+	if ( b == nullptr )
+	{
+		return a;
+	}
+	Item* root;
+	if ( a->priority > b->priority )
+	{
+		push( a );
+		a->right = merge( a->right, b );
+		root = a;
+	}
+	else
+	{
+		push( b );
+		b->left = merge( a, b->left );
+		root = b;
+	}
+	pull( root );
+	root->parent = nullptr;
+	return root;
+}
+
+void
+FrontLoops::split( Item* t, int k, Item*& a, Item*& b )
+{
+	if ( t == nullptr )
+	{
+		a = b = nullptr;
+		return;
+	}
+	push( t );
+	if ( sizeOf( t->left ) < k )
+	{
+		split( t->right, k - sizeOf( t->left ) - 1, t->right, b );
+		a = t;
+	}
+	else
+	{
+		split( t->left, k, a, t->left );
+		b = t;
+	}
+	pull( t );
+	if ( a != nullptr )
+	{
+		a->parent = nullptr;
+	}
+	if ( b != nullptr )
+	{
+		b->parent = nullptr;
+	}
+}
+
+FrontLoops::Item*
+FrontLoops::rootOf( Item* t )
+{
+	while ( t->parent != nullptr )
+	{
+		t = t->parent;
+	}
+	return t;
+}
+
+int
+FrontLoops::indexOf( Item* t )
+{
+	// Apply pending reversals from the root down, so that the left subtrees on
+	// the path tell the position of t
+	std::vector<Item*> path;
+	for ( auto cur = t; cur != nullptr; cur = cur->parent )
+	{
+		path.push_back( cur );
+	}
+	for ( auto it = path.rbegin(); it != path.rend(); ++it )
+	{
+		push( *it );
+	}
+
+	int i = sizeOf( t->left );
+	for ( auto cur = t; cur->parent != nullptr; cur = cur->parent )
+	{
+		if ( cur == cur->parent->right )
+		{
+			i += sizeOf( cur->parent->left ) + 1;
+		}
+	}
+	return i;
+}
+
+FrontLoops::Item*
+FrontLoops::at( Item* root, int k )
+{
+	auto cur = root;
+	while ( cur != nullptr )
+	{
+		push( cur );
+		int l = sizeOf( cur->left );
+		if ( k < l )
+		{
+			cur = cur->left;
+		}
+		else if ( k == l )
+		{
+			return cur;
+		}
+		else
+		{
+			k -= l + 1;
+			cur = cur->right;
+		}
+	}
+	return nullptr;
+}
+
+bool
+FrontLoops::linked( const Edge& a, const Edge& b )
+{
+	return (a.leftFrontNeighbor.get() == &b || a.rightFrontNeighbor.get() == &b)
+		&& (b.leftFrontNeighbor.get() == &a || b.rightFrontNeighbor.get() == &a);
+}
+
+bool
+FrontLoops::closed( Item* root )
+{
+	// Loops of one or two edges cannot tell their two ends apart, and the
+	// callers walk those instead
+	if ( root->size < 3 )
+	{
+		return false;
+	}
+	return linked( *at( root, 0 )->edge, *at( root, root->size - 1 )->edge );
+}
+
+FrontLoops::Item*
+FrontLoops::find( const std::shared_ptr<Edge>& e )
+{
+	auto it = items.find( e.get() );
+	return it != items.end() ? it->second.get() : nullptr;
+}
+
+void
+FrontLoops::detach( Item* t )
+{
+	auto root = rootOf( t );
+	int n = root->size;
+	int i = indexOf( t );
+	auto first = at( root, 0 ), last = at( root, n - 1 );
+
+	// If t lies inside a closed loop, the rest of the loop stays one chain
+	bool wrap = first != t && last != t && linked( *first->edge, *last->edge );
+
+	Item *before, *rest, *mid, *after;
+	split( root, i, before, rest );
+	split( rest, 1, mid, after );
+	if ( wrap )
+	{
+		merge( after, before );
+	}
+
+	auto level = levels.find( t->level );
+	if ( --level->second == 0 )
+	{
+		levels.erase( level );
+	}
+	items.erase( t->edge.get() );
+}
+
+void
+FrontLoops::link( Item* a, Item* b )
+{
+	auto ra = rootOf( a ), rb = rootOf( b );
+	int ia = indexOf( a ), ib = indexOf( b );
+
+	if ( ra == rb )
+	{
+		// Either neighbors already, or the two ends of a chain closing into a
+		// loop
+		int n = ra->size;
+		if ( std::abs( ia - ib ) != 1 && !(std::min( ia, ib ) == 0 && std::max( ia, ib ) == n - 1) )
+		{
+			consistent = false;
+		}
+		return;
+	}
+
+	// Turn the chains so that a is last in its chain and b first in its chain
+	if ( ia == 0 && ra->size > 1 )
+	{
+		ra->reversed = !ra->reversed;
+	}
+	else if ( ia != ra->size - 1 )
+	{
+		consistent = false;
+		return;
+	}
+	if ( ib == rb->size - 1 && rb->size > 1 )
+	{
+		rb->reversed = !rb->reversed;
+	}
+	else if ( ib != 0 )
+	{
+		consistent = false;
+		return;
+	}
+	merge( ra, rb );
+}
+
+void
+FrontLoops::sync()
+{
+	// A second attempt starts over from the current front neighbors, should the
+	// first one find them not to form chains
+	for ( int attempt = 0; attempt < 2 && !dirty.empty(); attempt++ )
+	{
+		for ( const auto& [key, e] : dirty )
+		{
+			auto t = find( e );
+			if ( t != nullptr )
+			{
+				detach( t );
+			}
+		}
+		for ( const auto& [key, e] : dirty )
+		{
+			if ( e->frontEdge )
+			{
+				auto t = std::make_unique<Item>();
+				t->edge = e;
+				t->priority = nextPriority();
+				t->level = e->level;
+				levels[e->level]++;
+				items.emplace( key, std::move( t ) );
+			}
+		}
+		for ( const auto& [key, e] : dirty )
+		{
+			auto t = find( e );
+			if ( t == nullptr )
+			{
+				continue;
+			}
+			for ( const auto& nb : { e->leftFrontNeighbor, e->rightFrontNeighbor } )
+			{
+				auto tn = nb != nullptr && nb != e ? find( nb ) : nullptr;
+				if ( tn != nullptr && linked( *e, *nb ) )
+				{
+					link( t, tn );
+				}
+			}
+		}
+		dirty.clear();
+
+		if ( !consistent )
+		{
+			rebuild();
+		}
+	}
+}
+
+void
+FrontLoops::rebuild()
+{
+	for ( auto& [key, t] : items )
+	{
+		dirty.emplace( key, t->edge );
+	}
+	items.clear();
+	levels.clear();
+	consistent = true;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ArrayList.h"
+#include "FrontList.h"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Edge;
+
+/**
+ * The front loops of QMorph held as balanced sequences, so that the length of a
+ * loop and the distance between two of its edges can be found in O(log n) time
+ * instead of by walking the loop with Edge::nextFrontNeighbor(..).
+ *
+ * Each loop is an implicit treap of its front edges in loop order. Two front
+ * edges are neighbors in a sequence when each is a front neighbor of the
+ * other, and a sequence is a closed loop when its first and last edges are
+ * front neighbors as well. Splitting a loop in two and merging two loops into
+ * one are then treap splits and merges.
+ *
+ * The loops do not observe the edges on their own. Edge::promoteToFront(..),
+ * Edge::removeFromFront(..) and the methods setting the front neighbors report
+ * the edges they change through edgeChanged(..), and the loops are brought up
+ * to date with those edges before the next query. Should the reported changes
+ * not add up to a set of chains, the loops are rebuilt from scratch.
+ */
+
+class FrontLoops
+{
+public:
+	FrontLoops() = default;
+
+	FrontLoops( const FrontLoops& ) = delete;
+	FrontLoops& operator=( const FrontLoops& ) = delete;
+
+	/** Create the loops of the given front edges. */
+	explicit FrontLoops( const ArrayList<std::shared_ptr<Edge>>& frontList );
+
+	/** Create the loops of the given front edges. */
+	explicit FrontLoops( const FrontList& frontList );
+
+	/** Note that the front status or the front neighbors of an edge changed. */
+	void changed( const std::shared_ptr<Edge>& e );
+
+	/** @return true if e is a front edge held in one of the loops */
+	bool contains( const std::shared_ptr<Edge>& e );
+
+	/** @return the number of front edges held */
+	size_t size();
+
+	/**
+	 * @return the number of edges in the closed loop holding e, or 0 if e is not
+	 *         a front edge or its chain of front neighbors is open
+	 */
+	int loopSize( const std::shared_ptr<Edge>& e );
+
+	/** @return true if a and b are held in the same closed loop */
+	bool sameLoop( const std::shared_ptr<Edge>& a, const std::shared_ptr<Edge>& b );
+
+	/**
+	 * @return 1 or -1 if next follows or precedes from in their closed loop, or 0
+	 *         if they are not neighbors in a closed loop of three or more edges
+	 */
+	int direction( const std::shared_ptr<Edge>& from, const std::shared_ptr<Edge>& next );
+
+	/**
+	 * @param dir 1 or -1, as returned by direction(..)
+	 * @return the number of steps from edge from to edge to in the given
+	 *         direction, in the range [0, loopSize(from)), or -1 if the two edges
+	 *         are not in the same closed loop
+	 */
+	int distance( const std::shared_ptr<Edge>& from, const std::shared_ptr<Edge>& to, int dir );
+
+	/** @return the lowest level of the front edges held, or -1 if there are none */
+	int lowestLevel();
+
+	/** @return the number of front edges held at the lowest level */
+	int countAtLowestLevel();
+
+	/**
+	 * Report a change to the front status or the front neighbors of an edge to
+	 * the loops attached to GeomBasics::frontLoops, if there are any.
+	 */
+	static void edgeChanged( Edge& e );
+
+private:
+	struct Item
+	{
+		std::shared_ptr<Edge> edge;
+		Item* left = nullptr;
+		Item* right = nullptr;
+		Item* parent = nullptr;
+		unsigned priority;
+		int size = 1;
+		int level;
+		bool reversed = false;
+	};
+
+	std::unordered_map<const Edge*, std::unique_ptr<Item>> items;
+	std::unordered_map<const Edge*, std::shared_ptr<Edge>> dirty;
+	std::map<int, int> levels;
+	unsigned seed = 0x9e3779b9u;
+	bool consistent = true;
+
+	unsigned nextPriority();
+	static int sizeOf( const Item* t );
+	static void push( Item* t );
+	static void pull( Item* t );
+	static Item* merge( Item* a, Item* b );
+	static void split( Item* t, int k, Item*& a, Item*& b );
+	static Item* rootOf( Item* t );
+	static int indexOf( Item* t );
+	static Item* at( Item* root, int k );
+	static bool linked( const Edge& a, const Edge& b );
+	static bool closed( Item* root );
+
+	Item* find( const std::shared_ptr<Edge>& e );
+	void detach( Item* t );
+	void link( Item* a, Item* b );
+	void sync();
+	void rebuild();
+};
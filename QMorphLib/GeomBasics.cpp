@@ -6,9 +6,13 @@
 #include "MyVector.h"
 
 #include "Msg.h"
+#include "Predicates.h"
 
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <string>
+#include <unordered_set>
 
 //TODO: Tests
 void
@@ -18,6 +22,7 @@ GeomBasics::createNewLists()
 	triangleList.clear();
 	edgeList.clear();
 	nodeList.clear();
+	frontLoops = nullptr;
 }
 
 //TODO: Tests
@@ -88,6 +93,7 @@ GeomBasics::clearEdges()
 	{
 		auto& curNode = nodeList.get( i );
 		curNode->edgeList.clear();
+		curNode->invalidateStar();
 	}
 
 	elementList.clear();
@@ -97,12 +103,114 @@ GeomBasics::clearEdges()
 
 //TODO: Tests
 void
-GeomBasics::clearLists()
+GeomBasics::detachLists()
 {
 	nodeList.clear();
 	edgeList.clear();
 	triangleList.clear();
 	elementList.clear();
+	frontLoops = nullptr;
+}
+
+//TODO: Tests
+void
+GeomBasics::clearLists()
+{
+	// Collect every entity reachable from the lists, as entities that have
+	// left the lists may still be linked to from the mesh, such as an element
+	// in the cached star of a node. Holding them all here keeps them alive
+	// until their links have been dropped.
+	std::vector<std::shared_ptr<Node>> nodes;
+	std::vector<std::shared_ptr<Edge>> edges;
+	std::vector<std::shared_ptr<Element>> elements;
+	std::unordered_set<const void*> seen;
+	auto visit = [&seen]( auto& found, const auto& p ) {
+		if ( p != nullptr && seen.insert( p.get() ).second )
+		{
+			found.push_back( p );
+		}
+	};
+	for ( const auto& n : nodeList )
+	{
+		visit( nodes, n );
+	}
+	for ( const auto& e : edgeList )
+	{
+		visit( edges, e );
+	}
+	for ( const auto& list : Edge::stateList )
+	{
+		for ( const auto& e : list )
+		{
+			visit( edges, e );
+		}
+	}
+	for ( const auto& t : triangleList )
+	{
+		visit( elements, t );
+	}
+	for ( const auto& elem : elementList )
+	{
+		visit( elements, elem );
+	}
+
+	for ( size_t i = 0, j = 0, k = 0; i < nodes.size() || j < edges.size() || k < elements.size(); )
+	{
+		for ( ; i < nodes.size(); i++ )
+		{
+			for ( const auto& e : nodes[i]->edgeList )
+			{
+				visit( edges, e );
+			}
+		}
+		for ( ; j < edges.size(); j++ )
+		{
+			// Not a reference, as visiting the front neighbors may grow edges
+			auto e = edges[j].get();
+			visit( nodes, e->leftNode );
+			visit( nodes, e->rightNode );
+			visit( elements, e->element1 );
+			visit( elements, e->element2 );
+			visit( edges, e->leftFrontNeighbor );
+			visit( edges, e->rightFrontNeighbor );
+			visit( edges, e->frontNext );
+		}
+		for ( ; k < elements.size(); k++ )
+		{
+			for ( const auto& e : elements[k]->edgeList )
+			{
+				visit( edges, e );
+			}
+			visit( nodes, elements[k]->firstNode );
+		}
+	}
+
+	for ( const auto& n : nodes )
+	{
+		n->releaseLinks();
+	}
+	for ( const auto& e : edges )
+	{
+		e->releaseLinks();
+	}
+	for ( const auto& elem : elements )
+	{
+		elem->releaseLinks();
+	}
+	edgeList.setGrid( nullptr );
+	detachLists();
+	Edge::clearStateList();
+	leftmost = rightmost = uppermost = lowermost = nullptr;
+}
+
+//TODO: Tests
+void
+GeomBasics::compactLists()
+{
+	nodeList.compact();
+	edgeList.compact();
+	triangleList.compact();
+	elementList.compact();
 }
 
 //TODO: Tests
@@ -146,13 +254,12 @@ GeomBasics::meshMetricsReport()
 			if ( elem != nullptr )
 			{
 				size++;
-				if ( rcl::instanceOf<Triangle>( elem ) )
+				if ( elem->isTriangle() )
 				{
 					nTris++;
 				}
-				else if ( rcl::instanceOf<Quad>( elem ) )
+				else if ( auto q = rcl::asQuad( elem ) )
 				{
-					const auto& q = std::dynamic_pointer_cast<Quad>(elem);
 					if ( q->isFake )
 					{
 						nTris++;
@@ -254,6 +361,65 @@ GeomBasics::meshMetricsReport()
 	return s;
 }
 
+//TODO: Tests
+std::string
+GeomBasics::memoryReport()
+{
+	// std::make_shared puts each entity behind a control block holding a
+	// vtable pointer and the two reference counts
+	const size_t controlBlock = sizeof( void* ) + 2 * sizeof( int );
+
+	size_t nNodes = 0, nodeHeap = 0, nEdges = 0, nTris = 0, nQuads = 0;
+	for ( const auto& n : nodeList )
+	{
+		if ( n != nullptr )
+		{
+			nNodes++;
+			nodeHeap += n->heapBytes();
+		}
+	}
+	for ( const auto& e : edgeList )
+	{
+		if ( e != nullptr )
+		{
+			nEdges++;
+		}
+	}
+	for ( const auto& t : triangleList )
+	{
+		if ( t != nullptr )
+		{
+			nTris++;
+		}
+	}
+	for ( const auto& elem : elementList )
+	{
+		if ( elem != nullptr )
+		{
+			(elem->isTriangle() ? nTris : nQuads)++;
+		}
+	}
+
+	std::string s = "entity      count  object  heap/entity      total\n";
+	size_t sum = 0;
+	char line[96];
+	auto row = [&]( const char* name, size_t count, size_t object, size_t heap ) {
+		size_t total = count * (object + controlBlock) + heap;
+		sum += total;
+		std::snprintf( line, sizeof( line ), "%-9s  %6zu  %6zu  %11.1f  %9zu\n", name, count, object + controlBlock,
+					   count > 0 ? static_cast<double>(heap) / count : 0.0, total );
+		s += line;
+	};
+	// The elements keep their edges and angles inline, and the edges own no
+	// heap blocks at all
+	row( "nodes", nNodes, sizeof( Node ), nodeHeap );
+	row( "edges", nEdges, sizeof( Edge ), 0 );
+	row( "triangles", nTris, sizeof( Triangle ), 0 );
+	row( "quads", nQuads, sizeof( Quad ), 0 );
+	std::snprintf( line, sizeof( line ), "%-9s  %6zu  %6s  %11s  %9zu\n", "all", nNodes + nEdges + nTris + nQuads, "", "", sum );
+	return s + line;
+}
+
 //TODO: Tests
 void
 GeomBasics::detectInvertedElements()
@@ -289,7 +455,7 @@ GeomBasics::countTriangles()
 	int fakes = 0, tris = 0;
 	for ( auto elem : elementList )
 	{
-		auto Q = std::dynamic_pointer_cast<Quad>(elem);
+		auto Q = rcl::quadCast(elem);
 		if ( Q && Q->isFake )
 		{
 			fakes++;
@@ -354,12 +520,12 @@ GeomBasics::consistencyCheck()
 			Msg::warning( "Edge " + e->descr() + " has null in element1 pointer" );
 		}
 
-		if ( e->element1 != nullptr && !triangleList.contains( std::dynamic_pointer_cast<Triangle>(e->element1) ) && !elementList.contains( e->element1 ) )
+		if ( e->element1 != nullptr && !triangleList.contains( rcl::triangleCast(e->element1) ) && !elementList.contains( e->element1 ) )
 		{
 			Msg::warning( "element1 of edge " + e->descr() + " is not found in triangleList or elementList" );
 		}
 
-		if ( e->element2 != nullptr && !triangleList.contains( std::dynamic_pointer_cast<Triangle>(e->element2) ) && !elementList.contains( e->element2 ) )
+		if ( e->element2 != nullptr && !triangleList.contains( rcl::triangleCast(e->element2) ) && !elementList.contains( e->element2 ) )
 		{
 			Msg::warning( "element2 of edge " + e->descr() + " is not found in triangleList or elementList" );
 		}
@@ -424,7 +590,7 @@ GeomBasics::consistencyCheck()
 		{
 			Msg::debug( "elementList has a null-entry." );
 		}
-		else if ( const auto& q = std::dynamic_pointer_cast<Quad>(elem) )
+		else if ( const auto& q = rcl::quadCast(elem) )
 		{
 			if ( !q->edgeList[base]->hasElement( q ) )
 			{
@@ -480,11 +646,7 @@ GeomBasics::cross( const std::shared_ptr<Node>& o1,
 				   const std::shared_ptr<Node>& o2,
 				   const std::shared_ptr<Node>& p2 )
 {
-	double x1 = p1->x - o1->x;
-	double x2 = p2->x - o2->x;
-	double y1 = p1->y - o1->y;
-	double y2 = p2->y - o2->y;
-	return x1 * y2 - x2 * y1;
+	return rcl::cross2d( o1->x, o1->y, p1->x, p1->y, o2->x, o2->y, p2->x, p2->y );
 }
 
 double
@@ -518,7 +680,7 @@ GeomBasics::loadMesh()
 
 	try
 	{
-		std::ifstream fis( meshDirectory + "\\" + meshFilename);
+		std::ifstream fis( std::filesystem::path( meshDirectory ) / meshFilename );
 		double x1, x2, x3, x4, y1, y2, y3, y4;
 		int i = 0;
 
@@ -539,89 +701,89 @@ GeomBasics::loadMesh()
 				y4 = nextDouble( inputLine );
 
 				auto node1 = std::make_shared<Node>( x1, y1 );
-				if ( !usNodeList.contains( node1 ) )
+				if ( !usNodeList.containsEqual( node1 ) )
 				{
 					usNodeList.add( node1 );
 				}
 				else
 				{
-					node1 = usNodeList.get( usNodeList.indexOf( node1 ) );
+					node1 = usNodeList.get( usNodeList.indexOfEqual( node1 ) );
 				}
 
 				auto node2 = std::make_shared<Node>( x2, y2 );
-				if ( !usNodeList.contains( node2 ) )
+				if ( !usNodeList.containsEqual( node2 ) )
 				{
 					usNodeList.add( node2 );
 				}
 				else
 				{
-					node2 = usNodeList.get( usNodeList.indexOf( node2 ) );
+					node2 = usNodeList.get( usNodeList.indexOfEqual( node2 ) );
 				}
 
 				auto node3 = std::make_shared<Node>( x3, y3 );
-				if ( !usNodeList.contains( node3 ) )
+				if ( !usNodeList.containsEqual( node3 ) )
 				{
 					usNodeList.add( node3 );
 				}
 				else
 				{
-					node3 = usNodeList.get( usNodeList.indexOf( node3 ) );
+					node3 = usNodeList.get( usNodeList.indexOfEqual( node3 ) );
 				}
 
 				auto edge1 = std::make_shared<Edge>( node1, node2 );
-				if ( !edgeList.contains( edge1 ) )
+				if ( !edgeList.containsEqual( edge1 ) )
 				{
 					edgeList.add( edge1 );
 					edge1->connectNodes();
 				}
 				else
 				{
-					edge1 = edgeList.get( edgeList.indexOf( edge1 ) );
+					edge1 = edgeList.get( edgeList.indexOfEqual( edge1 ) );
 				}
 
 				auto edge2 = std::make_shared<Edge>( node1, node3 );
-				if ( !edgeList.contains( edge2 ) )
+				if ( !edgeList.containsEqual( edge2 ) )
 				{
 					edgeList.add( edge2 );
 					edge2->connectNodes();
 				}
 				else
 				{
-					edge2 = edgeList.get( edgeList.indexOf( edge2 ) );
+					edge2 = edgeList.get( edgeList.indexOfEqual( edge2 ) );
 				}
 
 				if ( !std::isnan( x4 ) && !std::isnan( y4 ) )
 				{
 					auto node4 = std::make_shared<Node>( x4, y4 );
-					if ( !usNodeList.contains( node4 ) )
+					if ( !usNodeList.containsEqual( node4 ) )
 					{
 						usNodeList.add( node4 );
 					}
 					else
 					{
-						node4 = usNodeList.get( usNodeList.indexOf( node4 ) );
+						node4 = usNodeList.get( usNodeList.indexOfEqual( node4 ) );
 					}
 
 					auto edge3 = std::make_shared<Edge>( node2, node4 );
-					if ( !edgeList.contains( edge3 ) )
+					if ( !edgeList.containsEqual( edge3 ) )
 					{
 						edgeList.add( edge3 );
 						edge3->connectNodes();
 					}
 					else
 					{
-						edge3 = edgeList.get( edgeList.indexOf( edge3 ) );
+						edge3 = edgeList.get( edgeList.indexOfEqual( edge3 ) );
 					}
 
 					auto edge4 = std::make_shared<Edge>( node3, node4 );
-					if ( !edgeList.contains( edge4 ) )
+					if ( !edgeList.containsEqual( edge4 ) )
 					{
 						edgeList.add( edge4 );
 						edge4->connectNodes();
 					}
 					else
 					{
-						edge4 = edgeList.get( edgeList.indexOf( edge4 ) );
+						edge4 = edgeList.get( edgeList.indexOfEqual( edge4 ) );
 					}
 
 					auto q = std::make_shared<Quad>( edge1, edge2, edge3, edge4 );
@@ -631,14 +793,14 @@ GeomBasics::loadMesh()
 				else
 				{
 					auto edge3 = std::make_shared<Edge>( node2, node3 );
-					if ( !edgeList.contains( edge3 ) )
+					if ( !edgeList.containsEqual( edge3 ) )
 					{
 						edgeList.add( edge3 );
 						edge3->connectNodes();
 					}
 					else
 					{
-						edge3 = edgeList.get( edgeList.indexOf( edge3 ) );
+						edge3 = edgeList.get( edgeList.indexOfEqual( edge3 ) );
 					}
 
 					auto t = std::make_shared<Triangle>( edge1, edge2, edge3 );
@@ -691,67 +853,67 @@ GeomBasics::loadTriangleMesh()
 				y3 = nextDouble( inputLine );
 
 				auto node1 = std::make_shared<Node>( x1, y1 );
-				if ( !usNodeList.contains( node1 ) )
+				if ( !usNodeList.containsEqual( node1 ) )
 				{
 					usNodeList.add( node1 );
 				}
 				else
 				{
-					node1 = usNodeList.get( usNodeList.indexOf( node1 ) );
+					node1 = usNodeList.get( usNodeList.indexOfEqual( node1 ) );
 				}
 
 				auto node2 = std::make_shared<Node>( x2, y2 );
-				if ( !usNodeList.contains( node2 ) )
+				if ( !usNodeList.containsEqual( node2 ) )
 				{
 					usNodeList.add( node2 );
 				}
 				else
 				{
-					node2 = usNodeList.get( usNodeList.indexOf( node2 ) );
+					node2 = usNodeList.get( usNodeList.indexOfEqual( node2 ) );
 				}
 
 				auto node3 = std::make_shared<Node>( x3, y3 );
-				if ( !usNodeList.contains( node3 ) )
+				if ( !usNodeList.containsEqual( node3 ) )
 				{
 					usNodeList.add( node3 );
 				}
 				else
 				{
-					node3 = usNodeList.get( usNodeList.indexOf( node3 ) );
+					node3 = usNodeList.get( usNodeList.indexOfEqual( node3 ) );
 				}
 
 				auto edge1 = std::make_shared<Edge>( node1, node2 );
-				if ( !edgeList.contains( edge1 ) )
+				if ( !edgeList.containsEqual( edge1 ) )
 				{
 					edgeList.add( edge1 );
 				}
 				else
 				{
-					edge1 = edgeList.get( edgeList.indexOf( edge1 ) );
+					edge1 = edgeList.get( edgeList.indexOfEqual( edge1 ) );
 				}
 				edge1->leftNode->connectToEdge( edge1 );
 				edge1->rightNode->connectToEdge( edge1 );
 
 				auto edge2 = std::make_shared<Edge>( node2, node3 );
-				if ( !edgeList.contains( edge2 ) )
+				if ( !edgeList.containsEqual( edge2 ) )
 				{
 					edgeList.add( edge2 );
 				}
 				else
 				{
-					edge2 = edgeList.get( edgeList.indexOf( edge2 ) );
+					edge2 = edgeList.get( edgeList.indexOfEqual( edge2 ) );
 				}
 				edge2->leftNode->connectToEdge( edge2 );
 				edge2->rightNode->connectToEdge( edge2 );
 
 				auto edge3 = std::make_shared<Edge>( node1, node3 );
-				if ( !edgeList.contains( edge3 ) )
+				if ( !edgeList.containsEqual( edge3 ) )
 				{
 					edgeList.add( edge3 );
 				}
 				else
 				{
-					edge3 = edgeList.get( edgeList.indexOf( edge3 ) );
+					edge3 = edgeList.get( edgeList.indexOfEqual( edge3 ) );
 				}
 				edge3->leftNode->connectToEdge( edge3 );
 				edge3->rightNode->connectToEdge( edge3 );
@@ -819,7 +981,7 @@ GeomBasics::loadNodes()
 				if ( !std::isnan( x1 ) && !std::isnan( y1 ) )
 				{
 					auto node1 = std::make_shared<Node>( x1, y1 );
-					if ( !usNodeList.contains( node1 ) )
+					if ( !usNodeList.containsEqual( node1 ) )
 					{
 						usNodeList.add( node1 );
 					}
@@ -827,7 +989,7 @@ GeomBasics::loadNodes()
 				if ( !std::isnan( x2 ) && !std::isnan( y2 ) )
 				{
 					auto node2 = std::make_shared<Node>( x2, y2 );
-					if ( !usNodeList.contains( node2 ) )
+					if ( !usNodeList.containsEqual( node2 ) )
 					{
 						usNodeList.add( node2 );
 					}
@@ -835,7 +997,7 @@ GeomBasics::loadNodes()
 				if ( !std::isnan( x3 ) && !std::isnan( y3 ) )
 				{
 					auto node3 = std::make_shared<Node>( x3, y3 );
-					if ( !usNodeList.contains( node3 ) )
+					if ( !usNodeList.containsEqual( node3 ) )
 					{
 						usNodeList.add( node3 );
 					}
@@ -843,7 +1005,7 @@ GeomBasics::loadNodes()
 				if ( !std::isnan( x4 ) && !std::isnan( y4 ) )
 				{
 					auto node4 = std::make_shared<Node>( x4, y4 );
-					if ( !usNodeList.contains( node4 ) )
+					if ( !usNodeList.containsEqual( node4 ) )
 					{
 						usNodeList.add( node4 );
 					}
@@ -1021,7 +1183,7 @@ GeomBasics::writeQuadMesh( const std::string& filename,
 		{
 			for ( auto elem : list )
 			{
-				if ( auto q = std::dynamic_pointer_cast<Quad>(elem) )
+				if ( auto q = rcl::quadCast(elem) )
 				{
 					x1 = q->edgeList[base]->leftNode->x;
 					y1 = q->edgeList[base]->leftNode->y;
@@ -1034,7 +1196,7 @@ GeomBasics::writeQuadMesh( const std::string& filename,
 
 					fos << x1 << ", " << y1 << ", " << x2 << ", " << y2 << ", " << x3 << ", " << y3 << ", " << x4 << ", " << y4;
 				}
-				else if ( auto t = std::dynamic_pointer_cast<Triangle>(elem) )
+				else if ( auto t = rcl::triangleCast(elem) )
 				{
 					x1 = t->edgeList[0]->leftNode->x;
 					y1 = t->edgeList[0]->leftNode->y;
@@ -1111,7 +1273,7 @@ GeomBasics::writeMesh( const std::string& filename )
 		{
 			for ( auto element : elementList )
 			{
-				if ( auto q = std::dynamic_pointer_cast<Quad>(element) )
+				if ( auto q = rcl::quadCast(element) )
 				{
 					x1 = q->edgeList[base]->leftNode->x;
 					y1 = q->edgeList[base]->leftNode->y;
@@ -1145,7 +1307,7 @@ GeomBasics::writeMesh( const std::string& filename )
 						}
 					}
 				}
-				else if ( auto t = std::dynamic_pointer_cast<Triangle>(element) )
+				else if ( auto t = rcl::triangleCast(element) )
 				{
 					x1 = t->edgeList[0]->leftNode->x;
 					y1 = t->edgeList[0]->leftNode->y;
@@ -1319,6 +1481,32 @@ GeomBasics::printEdgeList( const ArrayList<std::shared_ptr<Edge>>& list )
 	}
 }
 
+//TODO: Tests
+void
+GeomBasics::printEdgeList( const FrontList& list )
+{
+	if ( Msg::debugMode )
+	{
+		for ( const auto& edge : list )
+		{
+			edge->printMe();
+		}
+	}
+}
+
+//TODO: Tests
+void
+GeomBasics::printEdgeList( const ArrayList<WeakLink<Edge>>& list )
+{
+	if ( Msg::debugMode )
+	{
+		for ( const auto& edge : list )
+		{
+			edge->printMe();
+		}
+	}
+}
+
 //TODO: Tests
 void 
 GeomBasics::printNodes( const ArrayList<std::shared_ptr<Node>>& nodeList )
@@ -1596,16 +1784,16 @@ GeomBasics::repairZeroAreaTriangles()
 			if ( !e->boundaryEdge() )
 			{
 				Msg::debug( "...longest edge not on boundary!" );
-				const auto& old1 = std::dynamic_pointer_cast<Triangle>(e->element1);
-				const auto& old2 = std::dynamic_pointer_cast<Triangle>(e->element2);
+				const auto& old1 = rcl::triangleCast(e->element1);
+				const auto& old2 = rcl::triangleCast(e->element2);
 				const auto& eS = e->getSwappedEdge();
-				e->swapToAndSetElementsFor( eS );
+				auto tNew = e->swapToAndSetElementsFor( eS );
 
 				triangleList.set( triangleList.indexOf( old1 ), nullptr );
 				triangleList.set( triangleList.indexOf( old2 ), nullptr );
 
-				triangleList.add( std::dynamic_pointer_cast<Triangle>(eS->element1) );
-				triangleList.add( std::dynamic_pointer_cast<Triangle>(eS->element2) );
+				triangleList.add( tNew[0] );
+				triangleList.add( tNew[1] );
 
 				edgeList.remove( edgeList.indexOf( e ) );
 				edgeList.add( eS );
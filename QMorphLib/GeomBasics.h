@@ -6,6 +6,10 @@
 #include "Triangle.h"
 #include "Node.h"
 #include "Edge.h"
+#include "EdgeGrid.h"
+#include "FrontList.h"
+#include "FrontLoops.h"
+#include "MeshList.h"
 
 #include <memory>
 #include <string>
@@ -22,17 +26,28 @@ class GeomBasics :
 	public Constants
 {
 public:
-	inline static ArrayList<std::shared_ptr<Element>> elementList;
-	inline static ArrayList<std::shared_ptr<Triangle>> triangleList;
-	inline static ArrayList<std::shared_ptr<Node>> nodeList;
-	inline static ArrayList<std::shared_ptr<Edge>> edgeList;
-
-	inline static std::shared_ptr<Node> leftmost = nullptr, rightmost = nullptr, uppermost = nullptr, lowermost = nullptr;
+	// The mesh and the state of the methods working on it are thread_local, so
+	// that QMorph::runParallel(..) can mesh disconnected components on separate
+	// threads
+	inline static thread_local MeshList<std::shared_ptr<Element>> elementList;
+	inline static thread_local MeshList<std::shared_ptr<Triangle>> triangleList;
+	inline static thread_local MeshList<std::shared_ptr<Node>> nodeList;
+	inline static thread_local EdgeList edgeList;
+	// The loops of QMorph's frontList while it is running, or nullptr
+	inline static thread_local std::shared_ptr<FrontLoops> frontLoops = nullptr;
+
+	inline static thread_local std::shared_ptr<Node> leftmost = nullptr, rightmost = nullptr, uppermost = nullptr, lowermost = nullptr;
 
 	inline static bool m_step = false;
+	// Where QMorph writes its checkpoints, see Checkpoint, or empty for none.
+	// The meshes made on worker threads are not checkpointed.
+	inline static thread_local std::string checkpointFilename = "";
+	// The number of QMorph steps between checkpoints while the fronts are
+	// advanced, or 0 for checkpoints at the phase boundaries only
+	inline static thread_local int checkpointInterval = 0;
 
-	inline static std::shared_ptr<TopoCleanup> topoCleanup = nullptr;
-	inline static std::shared_ptr<GlobalSmooth> m_globalSmooth = nullptr;
+	inline static thread_local std::shared_ptr<TopoCleanup> topoCleanup = nullptr;
+	inline static thread_local std::shared_ptr<GlobalSmooth> m_globalSmooth = nullptr;
 
 	inline static std::string meshFilename = "";
 	inline static std::string meshDirectory = ".";
@@ -58,7 +73,7 @@ public:
 	static ArrayList<std::shared_ptr<Element>> getElementList();
 
 private:
-	inline static std::shared_ptr<GeomBasics> curMethod = nullptr;
+	inline static thread_local std::shared_ptr<GeomBasics> curMethod = nullptr;
 
 public:
 	static void setCurMethod( const std::shared_ptr<GeomBasics>& method );
@@ -71,15 +86,44 @@ public:
 	/** Delete all the edges in the mesh. */
 	static void clearEdges();
 
-	/** Clear the nodeList, edgeList, triangleList and elementList. */
+	/**
+	 * Tear the mesh down and clear the nodeList, edgeList, triangleList and
+	 * elementList. The nodes, edges and elements point at each other through
+	 * shared_ptrs, so emptying the lists alone would leave them alive in
+	 * cycles. This drops the links of every entity reachable from the lists
+	 * first, and clears the Edge state lists and the extreme nodes, so that the
+	 * whole mesh is freed in linear time. Entities held elsewhere survive, but
+	 * without their links. Use detachLists() to hand the mesh on instead.
+	 */
 	static void clearLists();
 
+	/**
+	 * Empty the nodeList, edgeList, triangleList and elementList without
+	 * touching the entities in them, for when the mesh lives on elsewhere, such
+	 * as in a MeshComponents::Component handed to another thread.
+	 */
+	static void detachLists();
+
+	/**
+	 * Drop the tombstones left by MeshList::markRemoved(..) from the nodeList,
+	 * edgeList, triangleList and elementList.
+	 */
+	static void compactLists();
+
 	/** Update distortion metric for all elements in mesh. */
 	static void updateMeshMetrics();
 
 	/** @return a string containing the average and minimum element metrics. */
 	static std::string meshMetricsReport();
 
+	/**
+	 * @return a table of the memory taken by the entities of the mesh: for
+	 *         nodes, edges, triangles and quads their number, the bytes of each
+	 *         object with its shared_ptr control block, the average bytes each
+	 *         holds in heap blocks of its own, and the total
+	 */
+	static std::string memoryReport();
+
 	/** Find inverted elements and paint them with red colour. */
 	static void detectInvertedElements();
 
@@ -147,6 +191,11 @@ public:
 
 	static void printEdgeList( const ArrayList<std::shared_ptr<Edge>>& list );
 
+	static void printEdgeList( const FrontList& list );
+
+	/** @see printEdgeList(const ArrayList<std::shared_ptr<Edge>>&) */
+	static void printEdgeList( const ArrayList<WeakLink<Edge>>& list );
+
 	static void printNodes( const ArrayList<std::shared_ptr<Node>>& nodeList );
 
 	static void printValences();
@@ -3,15 +3,23 @@
 
 #include "Node.h"
 #include "MyVector.h"
+#include "ScratchArena.h"
 
 #include "Msg.h"
 
+//TODO: Tests
+GlobalSmooth::GlobalSmooth( const QMorphOptions& options ) :
+	m_options( options )
+{
+}
+
 //TODO: Tests
 std::shared_ptr<Node> 
 GlobalSmooth::constrainedLaplacianSmooth( const std::shared_ptr<Node>& n )
 {
 	Msg::debug( "Entering constrainedLaplacianSmooth(..)" );
-	auto elements = n->adjElements();
+	ScratchList<std::shared_ptr<Element>> elements;
+	elements.addAll( n->adjElements() );
 	std::shared_ptr<Element> oElem, sElem;
 	auto vL = n->laplacianMoveVector();
 	double deltaMy = 0, theta = 0, temp;
@@ -52,13 +60,13 @@ GlobalSmooth::constrainedLaplacianSmooth( const std::shared_ptr<Node>& n )
 			// # elements whose metric improves significantly
 			if ( (oElem->distortionMetric < 0 && sElem->distortionMetric >= 0)
 				 || (oElem->distortionMetric < 0 && sElem->distortionMetric > oElem->distortionMetric)
-				 || (oElem->distortionMetric < MYMIN && sElem->distortionMetric >= MYMIN) )
+				 || (oElem->distortionMetric < m_options.myMin && sElem->distortionMetric >= m_options.myMin) )
 			{
 				Nup++;
 			}
 			else if ( (oElem->distortionMetric >= 0 && sElem->distortionMetric < 0)
 					  || (oElem->distortionMetric < 0 && sElem->distortionMetric < oElem->distortionMetric)
-					  || (oElem->distortionMetric >= MYMIN && sElem->distortionMetric < MYMIN) )
+					  || (oElem->distortionMetric >= m_options.myMin && sElem->distortionMetric < m_options.myMin) )
 			{
 				Ndown++;
 			}
@@ -112,11 +120,11 @@ GlobalSmooth::acceptable( int N, int Nminus, int Nplus,
 	Msg::debug( "... deltaMy:" + std::to_string( deltaMy ) );
 	Msg::debug( "... theta:" + std::to_string( theta ) );
 	Msg::debug( "Leaving acceptable(..)" );
-	if ( Nminus == N || Ninverted > 0 || Ndown > Nup || deltaMy < MYMIN || theta > THETAMAX )
+	if ( Nminus == N || Ninverted > 0 || Ndown > Nup || deltaMy < m_options.myMin || theta > THETAMAX )
 	{
 		return false;
 	}
-	else if ( Nplus == N || (Nup > 0 && Ndown == 0) || (Nup >= Ndown && deltaMy > MYMIN) )
+	else if ( Nplus == N || (Nup > 0 && Ndown == 0) || (Nup >= Ndown && deltaMy > m_options.myMin) )
 	{
 		return true;
 	}
@@ -134,7 +142,7 @@ GlobalSmooth::optBasedSmooth( const std::shared_ptr<Node>& x,
 	Msg::debug( "Entering optBasedSmooth(..)" );
 	std::shared_ptr<Element> oElem, sElem;
 	double delta = Constants::DELTAFACTOR * maxModDim;
-	auto xPX = std::make_shared<Node>( x->x, x->y ), xPY = std::make_shared<Node>( x->x, x->y ), xNew = std::make_shared<Node>( x->x, x->y );
+	auto xPX = ScratchArena::make<Node>( x->x, x->y ), xPY = ScratchArena::make<Node>( x->x, x->y ), xNew = ScratchArena::make<Node>( x->x, x->y );
 	double gX, gY;
 	double minDM, newMinDM = std::numeric_limits<double>::max();
 	int iterations = 0;
@@ -198,7 +206,7 @@ GlobalSmooth::optBasedSmooth( const std::shared_ptr<Node>& x,
 
 		if ( !flag )
 		{ // What is "sufficiently small"?
-			gamma = GAMMA; // I suppose something in the range (0, 1] so 0.8 is ok?
+			gamma = m_options.gamma; // I suppose something in the range (0, 1] so 0.8 is ok?
 		}
 
 		Msg::debug( "...step 2 okay" );
@@ -253,7 +261,7 @@ GlobalSmooth::optBasedSmooth( const std::shared_ptr<Node>& x,
 			return x;
 		}
 		Msg::debug( "...step 3 okay" );
-	} while ( minDM <= OBSTOL && iterations++ <= 3 ); // Set max # of iterations
+	} while ( minDM <= m_options.obsTol && iterations++ <= 3 ); // Set max # of iterations
 
 	Msg::debug( "Leaving optBasedSmooth(..)" );
 	return x;
@@ -334,6 +342,8 @@ GlobalSmooth::run()
 		nodeMoved = false;
 		for ( i = 0; i < nodes.size(); i++ )
 		{
+			// The temporaries of smoothing one node are dropped together
+			ScratchArena::Scope scratch;
 			v = nodes.get( i );
 
 			if ( v == nullptr )
@@ -400,7 +410,7 @@ GlobalSmooth::run()
 					}
 				}
 				Msg::debug( "...minDistMetric== " + std::to_string( minDistMetric ) );
-				if ( minDistMetric <= OBSTOL )
+				if ( minDistMetric <= m_options.obsTol )
 				{
 					oldX = v->x;
 					oldY = v->y;
@@ -443,6 +453,6 @@ GlobalSmooth::run()
 			}
 		}
 		niter++;
-	} while ( nodeMoved && maxMoveDistance >= 1.75 * MOVETOLERANCE && niter < MAXITER );
+	} while ( nodeMoved && maxMoveDistance >= 1.75 * MOVETOLERANCE && niter < m_options.maxIter );
 	Msg::debug( "Leaving GlobalSmooth.run(), niter==" + std::to_string( niter ) );
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GeomBasics.h"
+#include "QMorphOptions.h"
 
 #include <memory>
 
@@ -55,8 +56,12 @@ private:
 										  const ArrayList<std::shared_ptr<Element>>& elements );
 
 	double maxModDim = 0.0;
+	QMorphOptions m_options;
 
 public:
+	/** @param options the tunable parameters of the smoothing */
+	explicit GlobalSmooth( const QMorphOptions& options = QMorphOptions() );
+
 	/** Initialize the object. */
 	void init();
 
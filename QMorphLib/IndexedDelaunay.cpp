@@ -0,0 +1,1028 @@
+#include "pch.h"
+#include "IndexedDelaunay.h"
+
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+namespace
+{
+	// Distance from the centre of the point set to the super-triangle vertices,
+	// in units of the extent of the point set.
+	constexpr double superScale = 1e3;
+
+	// refine(..) splits triangles whose circumradius exceeds that of an
+	// equilateral triangle with edges sizeSlack times the desired length. With
+	// 1 the mean edge length would come out well below the desired length.
+	constexpr double sizeSlack = 1.3;
+
+	// Position along a Hilbert curve of order 16
+	uint64_t
+	hilbertIndex( uint32_t x, uint32_t y )
+	{
+		const uint32_t n = 1u << 16;
+		uint64_t d = 0;
+		for ( uint32_t s = n / 2; s > 0; s /= 2 )
+		{
+			uint32_t rx = (x & s) > 0;
+			uint32_t ry = (y & s) > 0;
+			d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+			if ( ry == 0 )
+			{
+				if ( rx == 1 )
+				{
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				std::swap( x, y );
+			}
+		}
+		return d;
+	}
+}
+
+IndexedDelaunay::IndexedDelaunay( const std::vector<double>& xs,
+								  const std::vector<double>& ys ) :
+	xs( xs ),
+	ys( ys ),
+	nBase( static_cast<int>(xs.size()) )
+{
+}
+
+void
+IndexedDelaunay::triangulate( const std::vector<int>& indices )
+{
+	faces.clear();
+	freeFaces.clear();
+	mark.clear();
+	constraints.clear();
+	extraX.clear();
+	extraY.clear();
+	extraOrigin.clear();
+	vertexFace.assign( xs.size(), -1 );
+	stamp = 0;
+	if ( indices.empty() )
+	{
+		return;
+	}
+
+	double minX = xs[indices[0]], maxX = minX, minY = ys[indices[0]], maxY = minY;
+	for ( int i : indices )
+	{
+		minX = std::min( minX, xs[i] );
+		maxX = std::max( maxX, xs[i] );
+		minY = std::min( minY, ys[i] );
+		maxY = std::max( maxY, ys[i] );
+	}
+	double d = std::max( maxX - minX, maxY - minY );
+	if ( d <= 0.0 )
+	{
+		d = 1.0;
+	}
+	double cx = 0.5 * (minX + maxX), cy = 0.5 * (minY + maxY);
+
+	superX = { cx - superScale * d, cx + superScale * d, cx };
+	superY = { cy - superScale * d, cy - superScale * d, cy + superScale * d };
+
+	faces.reserve( 2 * indices.size() + 1 );
+	mark.reserve( 2 * indices.size() + 1 );
+	last = newFace( -1, -2, -3 );
+
+	// Insert along a Hilbert curve, so that each point is located close to the
+	// triangles created for the previous one.
+	std::vector<std::pair<uint64_t, int>> order;
+	order.reserve( indices.size() );
+	const double cells = 65535.0 / d;
+	for ( int i : indices )
+	{
+		auto hx = static_cast<uint32_t>((xs[i] - minX) * cells);
+		auto hy = static_cast<uint32_t>((ys[i] - minY) * cells);
+		order.emplace_back( hilbertIndex( hx, hy ), i );
+	}
+	std::sort( order.begin(), order.end() );
+
+	for ( const auto& entry : order )
+	{
+		insert( entry.second );
+	}
+}
+
+std::vector<IndexedDelaunay::Tri>
+IndexedDelaunay::triangles( bool withSuper ) const
+{
+	std::vector<Tri> result;
+	result.reserve( faces.size() );
+	for ( const auto& f : faces )
+	{
+		if ( f.alive && (withSuper || (f.v[0] >= 0 && f.v[1] >= 0 && f.v[2] >= 0)) )
+		{
+			result.push_back( f.v );
+		}
+	}
+	return result;
+}
+
+int
+IndexedDelaunay::newFace( int a, int b, int c )
+{
+	int id;
+	if ( !freeFaces.empty() )
+	{
+		id = freeFaces.back();
+		freeFaces.pop_back();
+	}
+	else
+	{
+		id = static_cast<int>(faces.size());
+		faces.emplace_back();
+		mark.push_back( 0 );
+	}
+	faces[id].v = { a, b, c };
+	faces[id].nbr = { -1, -1, -1 };
+	faces[id].alive = true;
+	faces[id].inside = false;
+	mark[id] = 0;
+	for ( int v : faces[id].v )
+	{
+		if ( v >= 0 )
+		{
+			vertexFace[v] = id;
+		}
+	}
+	return id;
+}
+
+int
+IndexedDelaunay::locate( int p )
+{
+	int f = last;
+	while ( true )
+	{
+		const auto& face = faces[f];
+
+		// Start with a pseudo-random edge so that the walk cannot cycle
+		walkSeed = walkSeed * 1103515245u + 12345u;
+		int start = static_cast<int>((walkSeed >> 16) % 3);
+
+		int next = -1;
+		for ( int j = 0; j < 3; j++ )
+		{
+			int k = (start + j) % 3;
+			int a = face.v[(k + 1) % 3], b = face.v[(k + 2) % 3];
+			if ( rcl::orient2d( x( a ), y( a ), x( b ), y( b ), x( p ), y( p ) ) < 0.0 )
+			{
+				next = face.nbr[k];
+				break;
+			}
+		}
+		if ( next < 0 )
+		{
+			return f;
+		}
+		f = next;
+	}
+}
+
+bool
+IndexedDelaunay::inConflict( int f, int p ) const
+{
+	const auto& v = faces[f].v;
+	return rcl::inCircumcircle( x( v[0] ), y( v[0] ), x( v[1] ), y( v[1] ), x( v[2] ), y( v[2] ), x( p ), y( p ) );
+}
+
+bool
+IndexedDelaunay::insert( int p )
+{
+	int f = locate( p );
+	for ( int v : faces[f].v )
+	{
+		if ( x( v ) == x( p ) && y( v ) == y( p ) )
+		{
+			return false;
+		}
+	}
+
+	collectCavity( p, f, ~uint64_t( 0 ) );
+	fillCavity( p );
+	return true;
+}
+
+bool
+IndexedDelaunay::collectCavity( int p, int f, uint64_t unconstrained )
+{
+	const bool barriers = !constraints.empty();
+	auto blocks = [this, barriers, unconstrained]( int a, int b ) {
+		return barriers && isConstrained( a, b ) && edgeKey( a, b ) != unconstrained;
+	};
+
+	// Collect the cavity with an explicit stack
+	++stamp;
+	cavity.clear();
+	stack.clear();
+	boundary.clear();
+
+	mark[f] = stamp;
+	stack.push_back( f );
+	while ( !stack.empty() )
+	{
+		int g = stack.back();
+		stack.pop_back();
+		cavity.push_back( g );
+		const auto& face = faces[g];
+		for ( int k = 0; k < 3; k++ )
+		{
+			int n = face.nbr[k];
+			int a = face.v[(k + 1) % 3], b = face.v[(k + 2) % 3];
+			if ( n >= 0 && mark[n] != stamp && !blocks( a, b )
+				 && ((barriers && edgeKey( a, b ) == unconstrained) || inConflict( n, p )) )
+			{
+				mark[n] = stamp;
+				stack.push_back( n );
+			}
+		}
+	}
+
+	bool valid = true;
+	for ( int g : cavity )
+	{
+		const auto& face = faces[g];
+		for ( int k = 0; k < 3; k++ )
+		{
+			int n = face.nbr[k];
+			int a = face.v[(k + 1) % 3], b = face.v[(k + 2) % 3];
+			bool blocked = blocks( a, b );
+			if ( n < 0 || mark[n] != stamp || blocked )
+			{
+				boundary.push_back( { a, b, n, face.inside } );
+
+				// A constrained edge must not end up inside the cavity, and every
+				// new Face must be ccw. Without constraints both hold trivially.
+				if ( barriers && ((blocked && n >= 0 && mark[n] == stamp) || orient( a, b, p ) <= 0.0) )
+				{
+					valid = false;
+				}
+			}
+		}
+	}
+
+	// A cavity without vertices inside it is a disk triangulated by
+	// boundary.size() - 2 Faces
+	return valid && (!barriers || boundary.size() == cavity.size() + 2);
+}
+
+void
+IndexedDelaunay::fillCavity( int p )
+{
+	created.clear();
+	for ( int g : cavity )
+	{
+		faces[g].alive = false;
+		freeFaces.push_back( g );
+	}
+
+	// Connect p to each edge of the cavity boundary
+	for ( const auto& be : boundary )
+	{
+		int id = newFace( be.a, be.b, p );
+		faces[id].nbr[2] = be.outer;
+		faces[id].inside = be.inside;
+		if ( be.outer >= 0 )
+		{
+			auto& outer = faces[be.outer];
+			for ( int k = 0; k < 3; k++ )
+			{
+				if ( outer.v[k] != be.a && outer.v[k] != be.b )
+				{
+					outer.nbr[k] = id;
+				}
+			}
+		}
+		created.emplace_back( be.a, id );
+	}
+
+	// Face (a, b, p) shares the edge (b, p) with the new Face starting at b
+	std::sort( created.begin(), created.end() );
+	for ( const auto& entry : created )
+	{
+		int id = entry.second;
+		int b = faces[id].v[1];
+		auto it = std::lower_bound( created.begin(), created.end(), std::make_pair( b, -1 ) );
+		int g = it->second;
+		faces[id].nbr[0] = g;
+		faces[g].nbr[1] = id;
+	}
+
+	last = created.back().second;
+}
+
+uint64_t
+IndexedDelaunay::edgeKey( int a, int b )
+{
+	auto lo = static_cast<uint32_t>(std::min( a, b ));
+	auto hi = static_cast<uint32_t>(std::max( a, b ));
+	return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+
+bool
+IndexedDelaunay::isConstrained( int a, int b ) const
+{
+	return constraints.count( edgeKey( a, b ) ) > 0;
+}
+
+double
+IndexedDelaunay::orient( int a, int b, int c ) const
+{
+	return rcl::orient2d( x( a ), y( a ), x( b ), y( b ), x( c ), y( c ) );
+}
+
+int
+IndexedDelaunay::faceWithEdge( int a, int b, int& k ) const
+{
+	// Super vertices have no entry in vertexFace, so walk around b instead
+	bool aroundB = a < 0;
+	int centre = aroundB ? b : a, other = aroundB ? a : b;
+
+	int start = vertexFace[centre];
+	int f = start;
+	do
+	{
+		const auto& face = faces[f];
+		int i = face.v[0] == centre ? 0 : (face.v[1] == centre ? 1 : 2);
+		if ( !aroundB && face.v[(i + 1) % 3] == other )
+		{
+			k = (i + 2) % 3;
+			return f;
+		}
+		if ( aroundB && face.v[(i + 2) % 3] == other )
+		{
+			k = (i + 1) % 3;
+			return f;
+		}
+		// The next Face ccw around a shares the edge (a, v[i + 2])
+		f = face.nbr[(i + 1) % 3];
+	} while ( f >= 0 && f != start );
+	return -1;
+}
+
+void
+IndexedDelaunay::replaceNeighbour( int f, int from, int to )
+{
+	if ( f >= 0 )
+	{
+		for ( auto& n : faces[f].nbr )
+		{
+			if ( n == from )
+			{
+				n = to;
+			}
+		}
+	}
+}
+
+void
+IndexedDelaunay::flip( int f, int k )
+{
+	// Face f is (a, b, c) and Face g on the other side of (b, c) is (d, c, b).
+	// They become (a, b, d) and (a, d, c).
+	int g = faces[f].nbr[k];
+	int a = faces[f].v[k], b = faces[f].v[(k + 1) % 3], c = faces[f].v[(k + 2) % 3];
+	int j = faces[g].nbr[0] == f ? 0 : (faces[g].nbr[1] == f ? 1 : 2);
+	int d = faces[g].v[j];
+
+	int nAB = faces[f].nbr[(k + 2) % 3], nCA = faces[f].nbr[(k + 1) % 3];
+	int nBD = faces[g].nbr[(j + 1) % 3], nDC = faces[g].nbr[(j + 2) % 3];
+
+	faces[f].v = { a, b, d };
+	faces[f].nbr = { nBD, g, nAB };
+	faces[g].v = { a, d, c };
+	faces[g].nbr = { nDC, nCA, f };
+	replaceNeighbour( nBD, g, f );
+	replaceNeighbour( nCA, f, g );
+
+	for ( int v : { a, b, d } )
+	{
+		if ( v >= 0 )
+		{
+			vertexFace[v] = f;
+		}
+	}
+	if ( c >= 0 )
+	{
+		vertexFace[c] = g;
+	}
+	last = f;
+}
+
+bool
+IndexedDelaunay::insertSegment( int a, int b )
+{
+	if ( a == b )
+	{
+		return true;
+	}
+	if ( a < 0 || b < 0 || vertexFace[a] < 0 || vertexFace[b] < 0 )
+	{
+		return false;
+	}
+
+	int k;
+	if ( faceWithEdge( a, b, k ) >= 0 )
+	{
+		constraints.emplace( edgeKey( a, b ), std::make_pair( a, b ) );
+		return true;
+	}
+
+	auto onSegment = [this, a, b]( int v ) {
+		return v >= 0 && orient( a, b, v ) == 0.0
+			&& (x( v ) - x( a )) * (x( b ) - x( a )) + (y( v ) - y( a )) * (y( b ) - y( a )) > 0.0;
+	};
+
+	// Find the Face around a through which the segment leaves. Its edge
+	// opposite a is the first edge crossing the segment, with p on the right
+	// and q on the left of a->b.
+	int start = vertexFace[a];
+	int f = start, p = -1, q = -1, i = 0;
+	bool found = false;
+	do
+	{
+		const auto& face = faces[f];
+		i = face.v[0] == a ? 0 : (face.v[1] == a ? 1 : 2);
+		p = face.v[(i + 1) % 3];
+		q = face.v[(i + 2) % 3];
+		if ( onSegment( p ) )
+		{
+			return insertSegment( a, p ) && insertSegment( p, b );
+		}
+		if ( orient( a, b, p ) < 0.0 && orient( a, b, q ) > 0.0 )
+		{
+			found = true;
+			break;
+		}
+		f = face.nbr[(i + 1) % 3];
+	} while ( f != start );
+	if ( !found )
+	{
+		return false;
+	}
+
+	// Walk along the segment collecting the crossing edges
+	std::deque<std::pair<int, int>> crossing;
+	int g = faces[f].nbr[i];
+	while ( true )
+	{
+		if ( isConstrained( p, q ) )
+		{
+			return false;
+		}
+		crossing.emplace_back( p, q );
+
+		const auto& face = faces[g];
+		int r = face.v[0];
+		for ( int v : face.v )
+		{
+			if ( v != p && v != q )
+			{
+				r = v;
+			}
+		}
+		if ( r == b )
+		{
+			break;
+		}
+		if ( onSegment( r ) )
+		{
+			return insertSegment( a, r ) && insertSegment( r, b );
+		}
+
+		int replaced;
+		if ( orient( a, b, r ) > 0.0 )
+		{
+			replaced = q;
+			q = r;
+		}
+		else
+		{
+			replaced = p;
+			p = r;
+		}
+		int j = face.v[0] == replaced ? 0 : (face.v[1] == replaced ? 1 : 2);
+		g = face.nbr[j];
+	}
+
+	auto crosses = [this, a, b]( int c, int d ) {
+		double o1 = orient( a, b, c ), o2 = orient( a, b, d );
+		double o3 = orient( c, d, a ), o4 = orient( c, d, b );
+		return ((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0))
+			&& ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0));
+	};
+
+	// Flip the crossing edges whose quadrilateral is convex until none is left
+	std::vector<std::pair<int, int>> created;
+	while ( !crossing.empty() )
+	{
+		auto [u, w] = crossing.front();
+		crossing.pop_front();
+
+		int h = faceWithEdge( u, w, k );
+		int c = faces[h].v[k];
+		int n = faces[h].nbr[k];
+		int j = faces[n].nbr[0] == h ? 0 : (faces[n].nbr[1] == h ? 1 : 2);
+		int d = faces[n].v[j];
+
+		if ( orient( c, u, d ) <= 0.0 || orient( c, d, w ) <= 0.0 )
+		{
+			crossing.emplace_back( u, w );
+			continue;
+		}
+		flip( h, k );
+		if ( crosses( c, d ) )
+		{
+			crossing.emplace_back( c, d );
+		}
+		else
+		{
+			created.emplace_back( c, d );
+		}
+	}
+	constraints.emplace( edgeKey( a, b ), std::make_pair( a, b ) );
+
+	// Restore the Delaunay property of the new edges
+	bool flipped = true;
+	while ( flipped )
+	{
+		flipped = false;
+		for ( auto& e : created )
+		{
+			if ( isConstrained( e.first, e.second ) )
+			{
+				continue;
+			}
+			int h = faceWithEdge( e.first, e.second, k );
+			int c = faces[h].v[k];
+			int n = faces[h].nbr[k];
+			int j = faces[n].nbr[0] == h ? 0 : (faces[n].nbr[1] == h ? 1 : 2);
+			int d = faces[n].v[j];
+			if ( rcl::inCircumcircle( x( c ), y( c ), x( e.first ), y( e.first ), x( e.second ), y( e.second ), x( d ), y( d ) ) )
+			{
+				flip( h, k );
+				e = { c, d };
+				flipped = true;
+			}
+		}
+	}
+	return true;
+}
+
+std::vector<int>
+IndexedDelaunay::constraintDepth() const
+{
+	// 0-1 breadth first search from the outside, where crossing a constrained
+	// edge costs 1
+	std::vector<int> depth( faces.size(), -1 );
+	std::deque<int> queue;
+	for ( size_t f = 0; f < faces.size() && queue.empty(); f++ )
+	{
+		const auto& v = faces[f].v;
+		if ( faces[f].alive && (v[0] < 0 || v[1] < 0 || v[2] < 0) )
+		{
+			depth[f] = 0;
+			queue.push_back( static_cast<int>(f) );
+		}
+	}
+
+	while ( !queue.empty() )
+	{
+		int f = queue.front();
+		queue.pop_front();
+		const auto& face = faces[f];
+		for ( int k = 0; k < 3; k++ )
+		{
+			int n = face.nbr[k];
+			if ( n < 0 )
+			{
+				continue;
+			}
+			int w = isConstrained( face.v[(k + 1) % 3], face.v[(k + 2) % 3] ) ? 1 : 0;
+			if ( depth[n] < 0 || depth[f] + w < depth[n] )
+			{
+				depth[n] = depth[f] + w;
+				if ( w == 0 )
+				{
+					queue.push_front( n );
+				}
+				else
+				{
+					queue.push_back( n );
+				}
+			}
+		}
+	}
+	return depth;
+}
+
+std::vector<IndexedDelaunay::Tri>
+IndexedDelaunay::trianglesInside() const
+{
+	auto depth = constraintDepth();
+	std::vector<Tri> result;
+	for ( size_t f = 0; f < faces.size(); f++ )
+	{
+		const auto& v = faces[f].v;
+		if ( faces[f].alive && depth[f] % 2 == 1 && v[0] >= 0 && v[1] >= 0 && v[2] >= 0 )
+		{
+			result.push_back( v );
+		}
+	}
+	return result;
+}
+
+void
+IndexedDelaunay::classify()
+{
+	auto depth = constraintDepth();
+	for ( size_t f = 0; f < faces.size(); f++ )
+	{
+		const auto& v = faces[f].v;
+		faces[f].inside = faces[f].alive && depth[f] % 2 == 1 && v[0] >= 0 && v[1] >= 0 && v[2] >= 0;
+	}
+}
+
+int
+IndexedDelaunay::addPoint( double px, double py )
+{
+	extraX.push_back( px );
+	extraY.push_back( py );
+	extraOrigin.emplace_back( -1, -1 );
+	vertexFace.push_back( -1 );
+	return pointCount() - 1;
+}
+
+void
+IndexedDelaunay::removeLastPoint()
+{
+	extraX.pop_back();
+	extraY.pop_back();
+	extraOrigin.pop_back();
+	vertexFace.pop_back();
+}
+
+bool
+IndexedDelaunay::inSmallAngle( int u, int w ) const
+{
+	if ( u < nBase || w < nBase )
+	{
+		return false;
+	}
+	auto ou = extraOrigin[u - nBase], ow = extraOrigin[w - nBase];
+	if ( ou.first < 0 || ow.first < 0 || ou == ow )
+	{
+		return false;
+	}
+
+	int apex = -1;
+	for ( int e : { ou.first, ou.second } )
+	{
+		if ( e == ow.first || e == ow.second )
+		{
+			apex = e;
+		}
+	}
+	if ( apex < 0 )
+	{
+		return false;
+	}
+
+	double ux = x( u ) - x( apex ), uy = y( u ) - y( apex );
+	double wx = x( w ) - x( apex ), wy = y( w ) - y( apex );
+	double du = std::hypot( ux, uy ), dw = std::hypot( wx, wy );
+	return std::abs( du - dw ) <= 1e-3 * std::max( du, dw ) && ux * wx + uy * wy > 0.5 * du * dw;
+}
+
+int
+IndexedDelaunay::walkTo( int f, int p, std::pair<int, int>& blocked ) const
+{
+	const auto& v = faces[f].v;
+	double ox = (x( v[0] ) + x( v[1] ) + x( v[2] )) / 3.0;
+	double oy = (y( v[0] ) + y( v[1] ) + y( v[2] )) / 3.0;
+	blocked = { -1, -1 };
+
+	// A ray through a vertex could make the walk circle around it
+	for ( size_t steps = 0; steps < faces.size(); steps++ )
+	{
+		const auto& face = faces[f];
+		int exit = -1, beyond = -1;
+		for ( int k = 0; k < 3 && exit < 0; k++ )
+		{
+			int u = face.v[(k + 1) % 3], w = face.v[(k + 2) % 3];
+			if ( orient( u, w, p ) < 0.0 )
+			{
+				beyond = k;
+				if ( rcl::orient2d( ox, oy, x( p ), y( p ), x( u ), y( u ) ) <= 0.0
+					 && rcl::orient2d( ox, oy, x( p ), y( p ), x( w ), y( w ) ) >= 0.0 )
+				{
+					exit = k;
+				}
+			}
+		}
+		if ( beyond < 0 )
+		{
+			return f;
+		}
+		// The rounded centroid of a sliver may lie outside it, so that the ray
+		// misses every edge. Continue through any edge facing p then.
+		if ( exit < 0 )
+		{
+			exit = beyond;
+		}
+
+		int u = face.v[(exit + 1) % 3], w = face.v[(exit + 2) % 3];
+		if ( isConstrained( u, w ) )
+		{
+			blocked = { u, w };
+			return -1;
+		}
+		f = face.nbr[exit];
+		if ( f < 0 )
+		{
+			return -1;
+		}
+	}
+	return -1;
+}
+
+bool
+IndexedDelaunay::refine( double minAngle,
+						 const std::function<double( double, double )>& size,
+						 size_t maxPoints,
+						 bool splitSegments )
+{
+	classify();
+
+	// The largest acceptable ratio of circumradius to shortest edge
+	const double pi = std::acos( -1.0 );
+	const double maxRatio = minAngle > 0.0 ? 1.0 / (2.0 * std::sin( minAngle * pi / 180.0 ))
+		: std::numeric_limits<double>::infinity();
+
+	// A constrained edge to split. force is set when a rejected point would
+	// have encroached upon it.
+	struct Segment
+	{
+		int a, b;
+		bool force;
+	};
+	// A Face to check, as it was when queued. tries counts the times it has
+	// been queued again because its new point was rejected.
+	struct Candidate
+	{
+		int f;
+		Tri v;
+		int tries;
+	};
+	std::deque<Segment> segments;
+	std::deque<Candidate> candidates;
+
+	for ( const auto& [key, origin] : constraints )
+	{
+		segments.push_back( { static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffffu), false } );
+	}
+	for ( size_t f = 0; f < faces.size(); f++ )
+	{
+		if ( faces[f].alive && faces[f].inside )
+		{
+			candidates.push_back( { static_cast<int>(f), faces[f].v, 0 } );
+		}
+	}
+
+	auto encroaches = [this]( int v, int a, int b ) {
+		return v >= 0 && (x( a ) - x( v )) * (x( b ) - x( v )) + (y( a ) - y( v )) * (y( b ) - y( v )) < 0.0;
+	};
+
+	auto needsSplit = [&]( const Segment& s ) {
+		if ( !splitSegments || !isConstrained( s.a, s.b ) )
+		{
+			return false;
+		}
+		if ( s.force )
+		{
+			return true;
+		}
+		if ( size )
+		{
+			double h = size( 0.5 * (x( s.a ) + x( s.b )), 0.5 * (y( s.a ) + y( s.b )) );
+			double dx = x( s.b ) - x( s.a ), dy = y( s.b ) - y( s.a );
+			if ( h > 0.0 && dx * dx + dy * dy > h * h )
+			{
+				return true;
+			}
+		}
+		int k;
+		for ( auto [a, b] : { std::make_pair( s.a, s.b ), std::make_pair( s.b, s.a ) } )
+		{
+			int f = faceWithEdge( a, b, k );
+			if ( f >= 0 && faces[f].inside && encroaches( faces[f].v[k], a, b ) )
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// Queue the Faces just created around p and the constrained edges facing p
+	auto queueCreated = [&]( int p ) {
+		for ( const auto& entry : created )
+		{
+			const auto& face = faces[entry.second];
+			if ( face.inside )
+			{
+				candidates.push_back( { entry.second, face.v, 0 } );
+			}
+			if ( isConstrained( face.v[0], face.v[1] ) && encroaches( p, face.v[0], face.v[1] ) )
+			{
+				segments.push_back( { face.v[0], face.v[1], false } );
+			}
+		}
+	};
+
+	size_t added = 0;
+	while ( true )
+	{
+		// Encroached constrained edges first
+		if ( !segments.empty() )
+		{
+			auto s = segments.front();
+			segments.pop_front();
+			if ( !needsSplit( s ) )
+			{
+				continue;
+			}
+			if ( added >= maxPoints )
+			{
+				return false;
+			}
+
+			// Split at the midpoint, or on a circular shell of radius a power of
+			// two around an input vertex (Ruppert's concentric shells). Segments
+			// meeting at a small angle are then split at equal distances from
+			// the apex, which keeps them from encroaching upon each other forever.
+			int a = s.a, b = s.b;
+			if ( b < nBase && a >= nBase )
+			{
+				std::swap( a, b );
+			}
+			double t = 0.5;
+			if ( a < nBase && b >= nBase )
+			{
+				double len = std::hypot( x( b ) - x( a ), y( b ) - y( a ) );
+				t = std::exp2( std::round( std::log2( 0.5 * len ) ) ) / len;
+			}
+
+			int k;
+			auto origin = constraints.at( edgeKey( a, b ) );
+			int f = faceWithEdge( a, b, k );
+			int m = addPoint( x( a ) + t * (x( b ) - x( a )), y( a ) + t * (y( b ) - y( a )) );
+			extraOrigin.back() = origin;
+			if ( f < 0 || !collectCavity( m, f, edgeKey( a, b ) ) )
+			{
+				removeLastPoint();
+				continue;
+			}
+			constraints.erase( edgeKey( a, b ) );
+			constraints.emplace( edgeKey( a, m ), origin );
+			constraints.emplace( edgeKey( m, b ), origin );
+			fillCavity( m );
+			added++;
+
+			segments.push_back( { s.a, m, false } );
+			segments.push_back( { m, s.b, false } );
+			queueCreated( m );
+			continue;
+		}
+
+		if ( candidates.empty() )
+		{
+			return true;
+		}
+		auto c = candidates.front();
+		candidates.pop_front();
+		const auto& face = faces[c.f];
+		if ( !face.alive || !face.inside || face.v != c.v )
+		{
+			continue;
+		}
+
+		// Circumcentre, relative to v[0]
+		double ax = x( c.v[0] ), ay = y( c.v[0] );
+		double bx = x( c.v[1] ) - ax, by = y( c.v[1] ) - ay;
+		double cx = x( c.v[2] ) - ax, cy = y( c.v[2] ) - ay;
+		double det = 2.0 * (bx * cy - by * cx);
+		if ( det <= 0.0 )
+		{
+			continue;
+		}
+		double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+		double ux = (cy * b2 - by * c2) / det, uy = (bx * c2 - cx * b2) / det;
+		double radius = std::hypot( ux, uy );
+
+		// The shortest edge is opposite v[shortest]
+		std::array<double, 3> len2;
+		for ( int k = 0; k < 3; k++ )
+		{
+			int u = c.v[(k + 1) % 3], w = c.v[(k + 2) % 3];
+			len2[k] = (x( w ) - x( u )) * (x( w ) - x( u )) + (y( w ) - y( u )) * (y( w ) - y( u ));
+		}
+		int shortest = static_cast<int>(std::min_element( len2.begin(), len2.end() ) - len2.begin());
+		double lmin = std::sqrt( len2[shortest] );
+
+		bool skinny = radius > maxRatio * lmin && !inSmallAngle( c.v[(shortest + 1) % 3], c.v[(shortest + 2) % 3] );
+		bool large = false;
+		if ( size )
+		{
+			double h = size( ax + (bx + cx) / 3.0, ay + (by + cy) / 3.0 );
+			large = h > 0.0 && radius * std::sqrt( 3.0 ) > sizeSlack * h;
+		}
+		if ( !skinny && !large )
+		{
+			continue;
+		}
+		if ( added >= maxPoints )
+		{
+			return false;
+		}
+
+		double px = ax + ux, py = ay + uy;
+		if ( skinny )
+		{
+			// The off-centre lies on the bisector of the shortest edge, where the
+			// triangle it forms with that edge has a ratio of exactly maxRatio.
+			// Use it when it is closer to the edge than the circumcentre.
+			int u = c.v[(shortest + 1) % 3], w = c.v[(shortest + 2) % 3];
+			double mx = 0.5 * (x( u ) + x( w )), my = 0.5 * (y( u ) + y( w ));
+			double dc = std::hypot( px - mx, py - my );
+			double r = maxRatio * lmin;
+			double h = r + std::sqrt( std::max( 0.0, r * r - 0.25 * lmin * lmin ) );
+			if ( dc > 0.0 && h < dc )
+			{
+				px = mx + (px - mx) * h / dc;
+				py = my + (py - my) * h / dc;
+			}
+		}
+
+		auto retry = [&]() {
+			// The edge in the way only changes if it may be split
+			if ( splitSegments && c.tries < 8 )
+			{
+				candidates.push_back( { c.f, c.v, c.tries + 1 } );
+			}
+		};
+
+		int p = addPoint( px, py );
+		std::pair<int, int> blocked;
+		int g = walkTo( c.f, p, blocked );
+		if ( g < 0 )
+		{
+			// The new point lies behind a constrained edge, so it encroaches upon it
+			removeLastPoint();
+			if ( blocked.first >= 0 )
+			{
+				segments.push_back( { blocked.first, blocked.second, true } );
+				retry();
+			}
+			continue;
+		}
+
+		bool duplicate = false;
+		for ( int v : faces[g].v )
+		{
+			duplicate = duplicate || (x( v ) == px && y( v ) == py);
+		}
+		if ( duplicate || !collectCavity( p, g, ~uint64_t( 0 ) ) )
+		{
+			removeLastPoint();
+			continue;
+		}
+
+		bool rejected = false;
+		for ( const auto& be : boundary )
+		{
+			if ( isConstrained( be.a, be.b ) && encroaches( p, be.a, be.b ) )
+			{
+				segments.push_back( { be.a, be.b, true } );
+				rejected = true;
+			}
+		}
+		if ( rejected )
+		{
+			removeLastPoint();
+			retry();
+			continue;
+		}
+
+		fillCavity( p );
+		added++;
+		queueCreated( p );
+	}
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A compact incremental (Bowyer-Watson) Delaunay triangulator working on plain
+ * coordinate arrays and vertex indices. Unlike DelaunayMeshGen it does not
+ * touch any Node, Edge or Triangle objects nor the global lists in GeomBasics,
+ * so several instances can triangulate different subsets of the same point
+ * set concurrently.
+ *
+ * The points are enclosed in a large super-triangle whose vertices have the
+ * negative indices -1, -2 and -3. All orientation and incircle tests use the
+ * adaptive predicates from Predicates.h.
+ *
+ * Segments can be inserted as constrained edges after the points have been
+ * triangulated, giving a constrained Delaunay triangulation, which can then be
+ * refined by inserting Steiner points.
+ *
+ * The insertion follows the same steps as DelaunayMeshGen::insertNodeInCavity(..)
+ * and uses the same conflict test, rcl::inCircumcircle(..). The two are kept
+ * apart on purpose: DelaunayMeshGen works on the linked Node, Edge and Triangle
+ * objects that QMorph goes on to convert, with its own handling of points
+ * outside the current triangulation, and reuses those objects in place so that
+ * their positions in the global lists are kept. Here the mesh is a flat array
+ * of Faces with neighbour indices, free of reference counts and shared state,
+ * which is what makes the strip-parallel, constrained and local re-meshing
+ * paths cheap and thread safe. The Faces are turned into objects only once, by
+ * DelaunayMeshGen, after the triangulation is done.
+ */
+
+class IndexedDelaunay
+{
+public:
+	/** Three vertex indices in ccw order. */
+	using Tri = std::array<int, 3>;
+
+	/**
+	 * @param xs the x coordinates of the whole point set
+	 * @param ys the y coordinates of the whole point set
+	 */
+	IndexedDelaunay( const std::vector<double>& xs,
+					 const std::vector<double>& ys );
+
+	/**
+	 * Triangulate the points with the given indices. The points are inserted in
+	 * spatially coherent order. Points coinciding with an already inserted point
+	 * are skipped.
+	 */
+	void triangulate( const std::vector<int>& indices );
+
+	/**
+	 * @param withSuper whether to include the triangles having a vertex of the
+	 *                  super-triangle
+	 * @return the triangles of the triangulation
+	 */
+	std::vector<Tri> triangles( bool withSuper = false ) const;
+
+	/**
+	 * Make the segment between vertices a and b part of the triangulation by
+	 * flipping away the edges crossing it (Sloan's method), then restore the
+	 * Delaunay property around the new edges. The resulting edges are
+	 * constrained and are never flipped afterwards. A vertex lying on the
+	 * segment splits it into two constrained edges.
+	 *
+	 * @return false if a or b is not a vertex of the triangulation, or if the
+	 *         segment crosses a constrained edge
+	 */
+	bool insertSegment( int a, int b );
+
+	/**
+	 * @return the triangles separated from the super-triangle by an odd number
+	 *         of constrained edges. When the constrained edges form closed
+	 *         loops, these are the triangles inside the outer loop and outside
+	 *         any hole.
+	 */
+	std::vector<Tri> trianglesInside() const;
+
+	/** @return true if the edge between a and b is constrained */
+	bool isConstrained( int a, int b ) const;
+
+	/**
+	 * Delaunay refinement of the triangles returned by trianglesInside(), after
+	 * Ruppert and Chew. Constrained edges whose diametral circle contains a
+	 * vertex, or that are longer than the local size, are split in two.
+	 * Triangles whose smallest angle is below minAngle get an off-centre
+	 * (Üngör) inserted, those larger than the local size get their
+	 * circumcentre. A new point that would encroach upon a constrained edge is
+	 * not inserted; the edge is split instead. Triangles in the corner between
+	 * two input segments meeting at a small angle are not refined for quality,
+	 * as that would never end.
+	 *
+	 * With splitSegments false the constrained edges are kept whole. A point
+	 * that would encroach upon one is then dropped, and the triangle it was
+	 * meant for is left as it is.
+	 *
+	 * The new points get the indices from pointCount() before the call onwards.
+	 *
+	 * @param minAngle      the smallest acceptable angle in degrees, or 0
+	 * @param size          the desired edge length at a point, or empty
+	 * @param maxPoints     the largest number of points to insert
+	 * @param splitSegments whether constrained edges may be split
+	 * @return false if maxPoints was reached before the mesh was acceptable
+	 */
+	bool refine( double minAngle,
+				 const std::function<double( double, double )>& size,
+				 size_t maxPoints,
+				 bool splitSegments = true );
+
+	/** @return the number of points, including those added by refine(..) */
+	int pointCount() const { return nBase + static_cast<int>(extraX.size()); }
+
+	/** @return the x coordinate of vertex i, which may be a super vertex */
+	double x( int i ) const { return i < 0 ? superX[-i - 1] : (i < nBase ? xs[i] : extraX[i - nBase]); }
+
+	/** @return the y coordinate of vertex i, which may be a super vertex */
+	double y( int i ) const { return i < 0 ? superY[-i - 1] : (i < nBase ? ys[i] : extraY[i - nBase]); }
+
+private:
+	struct Face
+	{
+		Tri v;
+		std::array<int, 3> nbr; // nbr[k] is the Face across the edge opposite v[k]
+		bool alive;
+		bool inside; // maintained by refine(..) only
+	};
+
+	const std::vector<double>& xs;
+	const std::vector<double>& ys;
+	const int nBase;
+	std::vector<double> extraX, extraY; // Steiner points
+	std::vector<std::pair<int, int>> extraOrigin; // the input segment a Steiner point lies on, or -1
+	std::array<double, 3> superX{}, superY{};
+
+	std::vector<Face> faces;
+	std::vector<int> freeFaces;
+	std::vector<int> vertexFace; // a Face incident to each vertex, or -1
+	// The constrained edges, each with the endpoints of the input segment it
+	// is part of
+	std::unordered_map<uint64_t, std::pair<int, int>> constraints;
+	std::vector<unsigned> mark;
+	unsigned stamp = 0;
+	int last = 0;
+	unsigned walkSeed = 0;
+
+	// Scratch buffers reused between insertions
+	std::vector<int> cavity, stack;
+	struct BoundaryEdge
+	{
+		int a, b, outer;
+		bool inside;
+	};
+	std::vector<BoundaryEdge> boundary;
+	std::vector<std::pair<int, int>> created;
+
+	int newFace( int a, int b, int c );
+
+	static uint64_t edgeKey( int a, int b );
+
+	double orient( int a, int b, int c ) const;
+
+	/**
+	 * @return the Face having a, b as consecutive vertices in ccw order, or -1.
+	 *         k is set to the position of the third vertex.
+	 */
+	int faceWithEdge( int a, int b, int& k ) const;
+
+	/** Flip the edge opposite position k of Face f. */
+	void flip( int f, int k );
+
+	void replaceNeighbour( int f, int from, int to );
+
+	/** @return the Face containing point p, found by a visibility walk */
+	int locate( int p );
+
+	/** @return true if p lies strictly inside the circumcircle of Face f */
+	bool inConflict( int f, int p ) const;
+
+	/** Insert point p. @return false if p coincides with an existing vertex. */
+	bool insert( int p );
+
+	/**
+	 * Collect the Faces in conflict with p that can be reached from Face f
+	 * without crossing a constrained edge into cavity, and their outline into
+	 * boundary. The edge with key unconstrained is being split by p: both Faces
+	 * beside it are always part of the cavity, since the rounded midpoint may
+	 * lie just outside the circumcircle of one of them.
+	 *
+	 * @return false if the cavity cannot be filled, because a constrained edge
+	 *         lies inside it or part of its outline is not visible from p
+	 */
+	bool collectCavity( int p, int f, uint64_t unconstrained );
+
+	/** Replace the collected cavity by Faces connecting p to its outline. */
+	void fillCavity( int p );
+
+	/** Set Face::inside from the constrained edges, as trianglesInside(). */
+	void classify();
+
+	/**
+	 * @return for each Face, the smallest number of constrained edges that
+	 *         separate it from the super-triangle
+	 */
+	std::vector<int> constraintDepth() const;
+
+	int addPoint( double px, double py );
+
+	void removeLastPoint();
+
+	/**
+	 * @return true if u and w lie on two input segments that meet at an angle
+	 *         below 60 degrees, at the same distance from their common vertex.
+	 *         Triangles with such a shortest edge cannot be improved, so
+	 *         refine(..) leaves them alone.
+	 */
+	bool inSmallAngle( int u, int w ) const;
+
+	/**
+	 * Walk in a straight line from the centroid of Face f towards point p.
+	 *
+	 * @return the Face containing p, or -1 if a constrained edge is in the way,
+	 *         in which case its vertices are stored in blocked
+	 */
+	int walkTo( int f, int p, std::pair<int, int>& blocked ) const;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * A vector of at most N elements stored inside the object itself. It stands
+ * in for std::vector where the size is small and bounded, such as the edges
+ * and angles of an element, so that those are laid out with their owner
+ * instead of in heap blocks of their own. Only the part of the std::vector
+ * interface used for such members is provided; growing beyond N throws
+ * std::length_error.
+ */
+
+template< typename T, size_t N >
+class InlineVector
+{
+	static_assert( N <= UINT8_MAX, "InlineVector keeps its size in a byte" );
+
+public:
+	using value_type = T;
+	using iterator = typename std::array<T, N>::iterator;
+	using const_iterator = typename std::array<T, N>::const_iterator;
+
+	InlineVector() = default;
+
+	explicit InlineVector( size_t count, const T& value = T() )
+	{
+		assign( count, value );
+	}
+
+	template< typename Container >
+	InlineVector& operator=( const Container& other )
+	{
+		assign( other.begin(), other.end() );
+		return *this;
+	}
+
+	static constexpr size_t capacity() { return N; }
+	size_t size() const { return mSize; }
+	bool empty() const { return mSize == 0; }
+
+	T& operator[]( size_t index ) { return mArray[index]; }
+	const T& operator[]( size_t index ) const { return mArray[index]; }
+
+	T& at( size_t index )
+	{
+		if ( index >= mSize )
+			throw std::out_of_range( "Index out of range in at" );
+		return mArray[index];
+	}
+
+	const T& at( size_t index ) const
+	{
+		if ( index >= mSize )
+			throw std::out_of_range( "Index out of range in at" );
+		return mArray[index];
+	}
+
+	iterator begin() { return mArray.begin(); }
+	iterator end() { return mArray.begin() + mSize; }
+	const_iterator begin() const { return mArray.begin(); }
+	const_iterator end() const { return mArray.begin() + mSize; }
+
+	void assign( size_t count, const T& value )
+	{
+		resize( count );
+		std::fill( begin(), end(), value );
+	}
+
+	template< typename It >
+	void assign( It first, It last )
+	{
+		clear();
+		for ( ; first != last; ++first )
+		{
+			push_back( *first );
+		}
+	}
+
+	// Elements dropped by shrinking are reset, so they hold on to nothing
+	void resize( size_t count )
+	{
+		if ( count > N )
+			throw std::length_error( "Size out of range in resize" );
+		for ( size_t i = count; i < mSize; i++ )
+		{
+			mArray[i] = T();
+		}
+		mSize = static_cast<uint8_t>(count);
+	}
+
+	void push_back( const T& item )
+	{
+		if ( mSize == N )
+			throw std::length_error( "No room left in push_back" );
+		mArray[mSize++] = item;
+	}
+
+	void clear()
+	{
+		resize( 0 );
+	}
+
+private:
+	std::array<T, N> mArray{};
+	uint8_t mSize = 0;
+};
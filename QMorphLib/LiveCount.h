@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A member counting the live objects of the class T holding it. Every
+ * constructor of T, the copy constructor included, counts the object in and
+ * the destructor counts it out, so the count shows whether the entities of a
+ * mesh are actually freed. The member has no data of its own and is placed in
+ * padding where its owner has some.
+ */
+
+template< typename T >
+class LiveCount
+{
+public:
+	LiveCount() { count.fetch_add( 1, std::memory_order_relaxed ); }
+	LiveCount( const LiveCount& ) : LiveCount() {}
+	LiveCount& operator=( const LiveCount& ) { return *this; }
+	~LiveCount() { count.fetch_sub( 1, std::memory_order_relaxed ); }
+
+	/** @return the number of objects of T alive, on all threads */
+	static int64_t get() { return count.load( std::memory_order_relaxed ); }
+
+private:
+	inline static std::atomic<int64_t> count = 0;
+};
@@ -0,0 +1,339 @@
+#include "pch.h"
+#include "MeshCavity.h"
+
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Types.h"
+#include "Msg.h"
+
+#include <cmath>
+#include <map>
+
+//TODO: Tests
+MeshCavity::MeshCavity( const ArrayList<std::shared_ptr<Node>>& changed,
+						double band )
+{
+	auto nearChange = [&changed, band]( const std::shared_ptr<Node>& n ) {
+		for ( const auto& c : changed )
+		{
+			if ( std::hypot( n->x - c->x, n->y - c->y ) <= band )
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	for ( const auto& c : changed )
+	{
+		for ( const auto& e : c->edgeList )
+		{
+			add( e->element1 );
+			add( e->element2 );
+		}
+	}
+
+	// Grow the cavity across its edges to the elements with a node near the
+	// change. The elements list doubles as the queue.
+	for ( size_t i = 0; i < elements.size(); i++ )
+	{
+		auto elem = elements[i];
+		for ( const auto& e : elem->edgeList )
+		{
+			auto other = e->element1 == elem ? e->element2 : e->element1;
+			if ( other == nullptr || inCavity.count( other.get() ) != 0 )
+			{
+				continue;
+			}
+			for ( const auto& oe : other->edgeList )
+			{
+				if ( nearChange( oe->leftNode ) || nearChange( oe->rightNode ) )
+				{
+					add( other );
+					break;
+				}
+			}
+		}
+	}
+
+	// Surround the nodes where the cavity touches itself, so that each boundary
+	// node has two boundary edges
+	auto pinched = findBoundary();
+	for ( int round = 0; round < 20 && !pinched.empty(); round++ )
+	{
+		for ( const auto& n : pinched )
+		{
+			for ( const auto& e : n->edgeList )
+			{
+				add( e->element1 );
+				add( e->element2 );
+			}
+		}
+		pinched = findBoundary();
+	}
+	if ( !pinched.empty() )
+	{
+		Msg::warning( "MeshCavity: the boundary of the cavity is not a set of simple loops" );
+		elements.clear();
+		inCavity.clear();
+		boundary.clear();
+		return;
+	}
+
+	std::unordered_set<const Node*> onBoundary;
+	for ( const auto& e : boundary )
+	{
+		onBoundary.insert( e->leftNode.get() );
+		onBoundary.insert( e->rightNode.get() );
+	}
+	std::unordered_set<const Edge*> seenEdges( boundary.size() );
+	std::unordered_set<const Node*> seenNodes;
+	for ( const auto& e : boundary )
+	{
+		seenEdges.insert( e.get() );
+	}
+	for ( const auto& elem : elements )
+	{
+		for ( const auto& e : elem->edgeList )
+		{
+			if ( seenEdges.insert( e.get() ).second )
+			{
+				innerEdges.push_back( e );
+			}
+			for ( const auto& n : { e->leftNode, e->rightNode } )
+			{
+				if ( onBoundary.count( n.get() ) == 0 && seenNodes.insert( n.get() ).second )
+				{
+					innerNodes.push_back( n );
+				}
+			}
+		}
+	}
+
+	copyLoops();
+}
+
+void
+MeshCavity::add( const std::shared_ptr<Element>& elem )
+{
+	if ( elem != nullptr && inCavity.insert( elem.get() ).second )
+	{
+		elements.push_back( elem );
+	}
+}
+
+std::vector<std::shared_ptr<Node>>
+MeshCavity::findBoundary()
+{
+	boundary.clear();
+	std::unordered_set<const Edge*> seen;
+	std::unordered_map<const Node*, int> count;
+	std::vector<std::shared_ptr<Node>> pinched;
+
+	auto inside = [this]( const std::shared_ptr<Element>& elem ) {
+		return elem != nullptr && inCavity.count( elem.get() ) != 0;
+	};
+
+	for ( const auto& elem : elements )
+	{
+		for ( const auto& e : elem->edgeList )
+		{
+			if ( !seen.insert( e.get() ).second || inside( e->element1 ) == inside( e->element2 ) )
+			{
+				continue;
+			}
+			boundary.push_back( e );
+			for ( const auto& n : { e->leftNode, e->rightNode } )
+			{
+				if ( ++count[n.get()] == 3 )
+				{
+					pinched.push_back( n );
+				}
+			}
+		}
+	}
+	return pinched;
+}
+
+void
+MeshCavity::copyLoops()
+{
+	std::unordered_map<const Node*, std::vector<std::shared_ptr<Edge>>> edgesAt;
+	for ( const auto& e : boundary )
+	{
+		edgesAt[e->leftNode.get()].push_back( e );
+		edgesAt[e->rightNode.get()].push_back( e );
+	}
+
+	std::unordered_map<const Node*, std::shared_ptr<Node>> copyOf;
+	std::unordered_set<const Edge*> done;
+	for ( const auto& start : boundary )
+	{
+		if ( done.count( start.get() ) != 0 )
+		{
+			continue;
+		}
+
+		ArrayList<std::shared_ptr<Node>> loop;
+		auto e = start;
+		auto n = start->leftNode;
+		do
+		{
+			done.insert( e.get() );
+			auto copy = std::make_shared<Node>( n->x, n->y );
+			copyOf.emplace( n.get(), copy );
+			original.emplace( copy.get(), n );
+			loop.add( copy );
+
+			n = e->otherNode( n );
+			const auto& at = edgesAt[n.get()];
+			e = at[0] == e ? at[1] : at[0];
+		} while ( e != start );
+		loops.push_back( std::move( loop ) );
+	}
+}
+
+//TODO: Tests
+double
+MeshCavity::edgeLength( double x, double y ) const
+{
+	double sum = 0.0, weights = 0.0;
+	for ( const auto& e : boundary )
+	{
+		double mx = 0.5 * (e->leftNode->x + e->rightNode->x), my = 0.5 * (e->leftNode->y + e->rightNode->y);
+		double d2 = (mx - x) * (mx - x) + (my - y) * (my - y);
+		double len = e->computeLength();
+		if ( d2 == 0.0 )
+		{
+			return len;
+		}
+		sum += len / d2;
+		weights += 1.0 / d2;
+	}
+	return weights > 0.0 ? sum / weights : 0.0;
+}
+
+//TODO: Tests
+bool
+MeshCavity::replace( const MeshComponents::Component& meshed ) const
+{
+	// Check that every boundary node is still there and has not moved, and that
+	// every boundary edge is still there between them
+	std::unordered_set<const Node*> nodesLeft;
+	for ( const auto& n : meshed.nodes )
+	{
+		nodesLeft.insert( n.get() );
+	}
+	for ( const auto& [copy, orig] : original )
+	{
+		if ( nodesLeft.count( copy ) == 0 || copy->x != orig->x || copy->y != orig->y )
+		{
+			return false;
+		}
+	}
+
+	auto key = []( const Node* a, const Node* b ) {
+		return a < b ? std::make_pair( a, b ) : std::make_pair( b, a );
+	};
+	std::map<std::pair<const Node*, const Node*>, std::shared_ptr<Edge>> boundaryAt;
+	for ( const auto& e : boundary )
+	{
+		boundaryAt.emplace( key( e->leftNode.get(), e->rightNode.get() ), e );
+	}
+	std::unordered_map<const Edge*, std::shared_ptr<Edge>> edgeReplace;
+	for ( const auto& e : meshed.edges )
+	{
+		auto l = original.find( e->leftNode.get() ), r = original.find( e->rightNode.get() );
+		if ( l == original.end() || r == original.end() )
+		{
+			continue;
+		}
+		auto it = boundaryAt.find( key( l->second.get(), r->second.get() ) );
+		if ( it != boundaryAt.end() )
+		{
+			edgeReplace.emplace( e.get(), it->second );
+		}
+	}
+	if ( edgeReplace.size() != boundary.size() )
+	{
+		return false;
+	}
+
+	// Tear out the cavity
+	for ( const auto& elem : elements )
+	{
+		elem->disconnectEdges();
+		GeomBasics::elementList.markRemoved( elem );
+		if ( auto t = rcl::triangleCast(elem) )
+		{
+			GeomBasics::triangleList.markRemoved( t );
+		}
+	}
+	for ( const auto& e : innerEdges )
+	{
+		e->disconnectNodes();
+		GeomBasics::edgeList.markRemoved( e );
+	}
+	for ( const auto& n : innerNodes )
+	{
+		GeomBasics::nodeList.markRemoved( n );
+	}
+
+	// Put the new mesh in its place, with the original boundary nodes and edges
+	// standing in for their copies
+	for ( const auto& n : meshed.nodes )
+	{
+		if ( original.count( n.get() ) == 0 )
+		{
+			GeomBasics::nodeList.add( n );
+		}
+	}
+	for ( const auto& e : meshed.edges )
+	{
+		if ( edgeReplace.count( e.get() ) != 0 )
+		{
+			continue;
+		}
+		for ( const auto& n : { e->leftNode, e->rightNode } )
+		{
+			auto it = original.find( n.get() );
+			if ( it != original.end() )
+			{
+				e->replaceNode( n, it->second );
+				it->second->connectToEdge( e );
+			}
+		}
+		GeomBasics::edgeList.add( e );
+	}
+
+	auto rewire = [&]( const std::shared_ptr<Element>& elem ) {
+		for ( auto& e : elem->edgeList )
+		{
+			auto it = edgeReplace.find( e.get() );
+			if ( it != edgeReplace.end() )
+			{
+				e = it->second;
+				e->connectToElement( elem );
+			}
+		}
+		auto it = original.find( elem->firstNode.get() );
+		if ( it != original.end() )
+		{
+			elem->firstNode = it->second;
+		}
+	};
+	for ( const auto& elem : meshed.elements )
+	{
+		rewire( elem );
+		GeomBasics::elementList.add( elem );
+	}
+	for ( const auto& t : meshed.triangles )
+	{
+		rewire( t );
+		GeomBasics::triangleList.add( t );
+	}
+	return true;
+}
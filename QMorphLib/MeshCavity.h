@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ArrayList.h"
+#include "MeshComponents.h"
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Node;
+class Edge;
+class Element;
+
+/**
+ * The elements of the mesh in the GeomBasics lists around a locally changed
+ * region, torn out so that the region can be meshed again without touching the
+ * rest of the mesh.
+ *
+ * The cavity holds every element that has a node within a given distance of a
+ * changed node and can be reached from the changed nodes through such
+ * elements. Nodes where the cavity touches itself are then surrounded by it, so
+ * that its boundary is a set of simple loops. These loops are handed out as
+ * copies of their nodes, to be triangulated and quad meshed on their own, and
+ * replace(..) puts the result in place of the cavity, joined to the rest of the
+ * mesh through the original boundary edges.
+ *
+ * Only the elements near the changed nodes are visited, so the work grows with
+ * the size of the cavity and not with the size of the mesh.
+ */
+
+class MeshCavity
+{
+public:
+	/**
+	 * Find the cavity around the given nodes of the mesh in the GeomBasics lists.
+	 * The mesh is not changed.
+	 *
+	 * @param changed the nodes at the edit, e.g. those of a boundary loop that
+	 *                has been moved
+	 * @param band    the distance from the changed nodes within which elements
+	 *                are torn out. It must exceed the distance the changed nodes
+	 *                have moved, or the cavity boundary may cross itself.
+	 */
+	MeshCavity( const ArrayList<std::shared_ptr<Node>>& changed,
+				double band );
+
+	/** @return the number of elements in the cavity */
+	size_t size() const { return elements.size(); }
+
+	/** @return the elements in the cavity */
+	const std::vector<std::shared_ptr<Element>>& getElements() const { return elements; }
+
+	/**
+	 * @return the boundary loops of the cavity, made of copies of the original
+	 *         boundary nodes, in order along each loop
+	 */
+	const std::vector<ArrayList<std::shared_ptr<Node>>>& getLoops() const { return loops; }
+
+	/**
+	 * The desired edge length inside the cavity at (x, y), interpolated from the
+	 * lengths of the boundary edges with inverse squared distance weights.
+	 */
+	double edgeLength( double x, double y ) const;
+
+	/**
+	 * Replace the cavity in the GeomBasics lists by the given mesh of its loops.
+	 *
+	 * @param meshed a mesh whose boundary is made of the copies in getLoops()
+	 * @return false, leaving the mesh unchanged, if meshed has moved, split or
+	 *         removed a boundary node or edge
+	 */
+	bool replace( const MeshComponents::Component& meshed ) const;
+
+private:
+	std::vector<std::shared_ptr<Element>> elements;
+	std::unordered_set<const Element*> inCavity;
+	// The edges between the cavity and the rest of the mesh or the domain
+	// boundary, and the edges and nodes inside the cavity
+	std::vector<std::shared_ptr<Edge>> boundary;
+	std::vector<std::shared_ptr<Edge>> innerEdges;
+	std::vector<std::shared_ptr<Node>> innerNodes;
+	std::vector<ArrayList<std::shared_ptr<Node>>> loops;
+	// The original of each copy in loops
+	std::unordered_map<const Node*, std::shared_ptr<Node>> original;
+
+	void add( const std::shared_ptr<Element>& elem );
+
+	/** Find the boundary edges, and the nodes with more than two of them. */
+	std::vector<std::shared_ptr<Node>> findBoundary();
+
+	void copyLoops();
+};
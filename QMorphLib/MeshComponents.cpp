@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "MeshComponents.h"
+
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+MeshComponents::MeshComponents( size_t n ) :
+	parent( n ),
+	rank( n, 0 )
+{
+	std::iota( parent.begin(), parent.end(), 0 );
+}
+
+int
+MeshComponents::find( int i )
+{
+	// Path halving
+	while ( parent[i] != i )
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+void
+MeshComponents::unite( int a, int b )
+{
+	a = find( a );
+	b = find( b );
+	if ( a == b )
+	{
+		return;
+	}
+	if ( rank[a] < rank[b] )
+	{
+		std::swap( a, b );
+	}
+	parent[b] = a;
+	if ( rank[a] == rank[b] )
+	{
+		rank[a]++;
+	}
+}
+
+std::vector<MeshComponents::Component>
+MeshComponents::split( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+					   const ArrayList<std::shared_ptr<Edge>>& edges,
+					   const ArrayList<std::shared_ptr<Node>>& nodes )
+{
+	MeshComponents uf( triangles.size() );
+
+	// Unite each triangle with the first triangle seen at each of its nodes
+	std::unordered_map<const Node*, int> owner;
+	for ( int i = 0; i < static_cast<int>(triangles.size()); i++ )
+	{
+		for ( const auto& e : triangles.get( i )->edgeList )
+		{
+			for ( const auto& n : { e->leftNode, e->rightNode } )
+			{
+				auto [it, added] = owner.emplace( n.get(), i );
+				if ( !added )
+				{
+					uf.unite( i, it->second );
+				}
+			}
+		}
+	}
+
+	std::vector<Component> components;
+	std::vector<int> index( triangles.size(), -1 );
+	auto componentOf = [&]( int tri ) -> Component& {
+		int root = uf.find( tri );
+		if ( index[root] == -1 )
+		{
+			index[root] = static_cast<int>(components.size());
+			components.emplace_back();
+		}
+		return components[index[root]];
+	};
+
+	for ( int i = 0; i < static_cast<int>(triangles.size()); i++ )
+	{
+		componentOf( i ).triangles.add( triangles.get( i ) );
+	}
+	for ( const auto& e : edges )
+	{
+		auto it = owner.find( e->leftNode.get() );
+		if ( it == owner.end() )
+		{
+			return {};
+		}
+		componentOf( it->second ).edges.add( e );
+	}
+	for ( const auto& n : nodes )
+	{
+		auto it = owner.find( n.get() );
+		if ( it == owner.end() )
+		{
+			return {};
+		}
+		componentOf( it->second ).nodes.add( n );
+	}
+	return components;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ArrayList.h"
+
+#include <memory>
+#include <vector>
+
+class Node;
+class Edge;
+class Triangle;
+class Element;
+
+/**
+ * The connected components of a triangle mesh, found with a union-find over its
+ * triangles. Two triangles belong to the same component when they share a node,
+ * so no node or edge is shared between two components, and each component can
+ * be meshed on its own.
+ */
+
+class MeshComponents
+{
+public:
+	struct Component
+	{
+		ArrayList<std::shared_ptr<Triangle>> triangles;
+		ArrayList<std::shared_ptr<Edge>> edges;
+		ArrayList<std::shared_ptr<Node>> nodes;
+		// The elements made from the component, left empty by split(..)
+		ArrayList<std::shared_ptr<Element>> elements;
+	};
+
+	/**
+	 * Split a triangle mesh into its connected components. The components are
+	 * ordered by their first triangle, and each keeps the order of the input
+	 * lists.
+	 *
+	 * @return the components, or an empty vector if some edge or node does not
+	 *         belong to any triangle
+	 */
+	static std::vector<Component> split( const ArrayList<std::shared_ptr<Triangle>>& triangles,
+										 const ArrayList<std::shared_ptr<Edge>>& edges,
+										 const ArrayList<std::shared_ptr<Node>>& nodes );
+
+private:
+	std::vector<int> parent;
+	std::vector<int> rank;
+
+	explicit MeshComponents( size_t n );
+
+	int find( int i );
+	void unite( int a, int b );
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "ArrayList.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * An ArrayList of mesh entities supporting deferred removal. markRemoved(..)
+ * replaces an entity by a nullptr tombstone in O(1) time instead of shifting
+ * the rest of the list, and compact() drops all the tombstones in one linear
+ * pass. Code iterating the list between the two must skip nullptr entries;
+ * indexOf(..) and contains(..) already do. As the lists own the mesh, an
+ * entity passed to markRemoved(..) is held until compact(), so that the
+ * operation removing it may still read it.
+ *
+ * The entities are found by identity through a map from entity to index. The
+ * map is built lazily, extended as entities are appended or replaced through
+ * set(..) and rebuilt only after the list has been changed in a way that moves
+ * its entities, such as remove(..). The entities of a MeshList are expected to
+ * be unique.
+ */
+
+template< typename T >
+class MeshList :
+	public ArrayList<T>
+{
+	using Base = ArrayList<T>;
+
+public:
+	MeshList() = default;
+
+	MeshList( const Base& other ) :
+		Base( other )
+	{
+	}
+
+	MeshList& operator=( const Base& other )
+	{
+		Base::operator=( other );
+		removed.clear();
+		forgetPositions();
+		return *this;
+	}
+
+	/**
+	 * Replace the entity by a tombstone, leaving the indices of all the other
+	 * entities unchanged.
+	 *
+	 * @return true if the entity was found in the list
+	 */
+	bool markRemoved( const T& item )
+	{
+		if ( item == nullptr )
+		{
+			return false;
+		}
+
+		auto i = positionOf( item );
+		if ( i < 0 )
+		{
+			return false;
+		}
+
+		Base::set( static_cast<size_t>( i ), nullptr );
+		positions.erase( item.get() );
+		layout = Base::layoutVersion();
+		removed.push_back( item );
+		return true;
+	}
+
+	/**
+	 * Replace the entity at the index. Unlike the other changes that move
+	 * entities, this keeps the map from entity to index up to date instead of
+	 * having it rebuilt by the next markRemoved(..).
+	 */
+	void set( size_t index, const T& item )
+	{
+		bool current = layout == Base::layoutVersion();
+		const void* old = Base::get( index ).get();
+		Base::set( index, item );
+		if ( !current )
+		{
+			return;
+		}
+
+		if ( index < indexed )
+		{
+			auto it = positions.find( old );
+			if ( it != positions.end() && it->second == index )
+			{
+				positions.erase( it );
+			}
+			if ( item != nullptr )
+			{
+				positions.insert_or_assign( item.get(), index );
+			}
+		}
+		layout = Base::layoutVersion();
+	}
+
+	/** @return the number of tombstones left by markRemoved(..) */
+	size_t removedCount() const
+	{
+		return removed.size();
+	}
+
+	/** Drop all nullptr entries from the list. */
+	void compact()
+	{
+		Base::removeIf( []( const T& item ) { return item == nullptr; } );
+		removed.clear();
+		forgetPositions();
+	}
+
+	void clear()
+	{
+		Base::clear();
+		removed.clear();
+		forgetPositions();
+	}
+
+private:
+	std::unordered_map<const void*, size_t> positions;
+	size_t indexed = 0;
+	size_t layout = 0;
+	std::vector<T> removed;
+
+	void forgetPositions()
+	{
+		positions.clear();
+		indexed = 0;
+		layout = Base::layoutVersion();
+	}
+
+	/** @return the index of the entity, or -1 if it is not in the list */
+	std::ptrdiff_t positionOf( const T& item )
+	{
+		if ( layout != Base::layoutVersion() )
+		{
+			forgetPositions();
+		}
+
+		// Index the entities appended since the last lookup
+		for ( ; indexed < Base::size(); indexed++ )
+		{
+			const auto& cur = Base::get( indexed );
+			if ( cur != nullptr )
+			{
+				positions.emplace( cur.get(), indexed );
+			}
+		}
+
+		auto it = positions.find( item.get() );
+		if ( it == positions.end() )
+		{
+			return -1;
+		}
+		return static_cast<std::ptrdiff_t>( it->second );
+	}
+};
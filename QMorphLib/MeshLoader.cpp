@@ -143,7 +143,7 @@ MeshLoader::getEdge( ArrayList<std::shared_ptr<Edge>>& edgeList,
 					 const std::shared_ptr<Node>& node2 )
 {
 	auto edge = std::make_shared<Edge>( node1, node2 );
-	auto index = edgeList.indexOf( edge ); // Assuming Edge class has proper equals() and hashCode()
+	auto index = edgeList.indexOfEqual( edge ); // The edge with the same end points, if any
 	if ( index == -1 )
 	{
 		edgeList.add( edge );
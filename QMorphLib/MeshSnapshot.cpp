@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "MeshSnapshot.h"
+
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Quad.h"
+#include "Triangle.h"
+
+//TODO: Tests
+MeshSnapshot::MeshSnapshot()
+{
+	// Number the entities in the order they are reached. An entity is numbered
+	// if its snapshotIndex points back at it, whatever an earlier snapshot left
+	// there.
+	std::vector<Node*> nodeAt;
+	std::vector<Edge*> edgeAt;
+	std::vector<Element*> elementAt;
+	nodeAt.reserve( GeomBasics::nodeList.size() );
+	edgeAt.reserve( GeomBasics::edgeList.size() );
+	elementAt.reserve( GeomBasics::triangleList.size() + GeomBasics::elementList.size() );
+
+	auto nodeId = [&nodeAt]( Node* n ) {
+		if ( n == nullptr )
+		{
+			return none;
+		}
+		if ( n->snapshotIndex >= nodeAt.size() || nodeAt[n->snapshotIndex] != n )
+		{
+			n->snapshotIndex = static_cast<uint32_t>(nodeAt.size());
+			nodeAt.push_back( n );
+		}
+		return n->snapshotIndex;
+	};
+	auto edgeId = [&edgeAt]( Edge* e ) {
+		if ( e == nullptr )
+		{
+			return none;
+		}
+		if ( e->snapshotIndex >= edgeAt.size() || edgeAt[e->snapshotIndex] != e )
+		{
+			e->snapshotIndex = static_cast<uint32_t>(edgeAt.size());
+			edgeAt.push_back( e );
+		}
+		return e->snapshotIndex;
+	};
+	auto elementId = [&elementAt]( Element* el ) {
+		if ( el == nullptr )
+		{
+			return none;
+		}
+		if ( el->snapshotIndex >= elementAt.size() || elementAt[el->snapshotIndex] != el )
+		{
+			el->snapshotIndex = static_cast<uint32_t>(elementAt.size());
+			elementAt.push_back( el );
+		}
+		return el->snapshotIndex;
+	};
+
+	// The lists skip their removed entries
+	for ( const auto& n : GeomBasics::nodeList )
+	{
+		if ( n != nullptr )
+		{
+			nodeList.push_back( nodeId( n.get() ) );
+		}
+	}
+	for ( const auto& e : GeomBasics::edgeList )
+	{
+		if ( e != nullptr )
+		{
+			edgeList.push_back( edgeId( e.get() ) );
+		}
+	}
+	for ( const auto& t : GeomBasics::triangleList )
+	{
+		if ( t != nullptr )
+		{
+			triangleList.push_back( elementId( t.get() ) );
+		}
+	}
+	for ( const auto& el : GeomBasics::elementList )
+	{
+		if ( el != nullptr )
+		{
+			elementList.push_back( elementId( el.get() ) );
+		}
+	}
+	for ( size_t i = 0; i < stateList.size(); i++ )
+	{
+		for ( const auto& e : Edge::stateList[i] )
+		{
+			stateList[i].push_back( edgeId( e.get() ) );
+		}
+	}
+	extremes = { nodeId( GeomBasics::leftmost.get() ), nodeId( GeomBasics::rightmost.get() ),
+				 nodeId( GeomBasics::uppermost.get() ), nodeId( GeomBasics::lowermost.get() ) };
+
+	// Recording an entity may reach new ones, which are recorded in turn
+	size_t n = 0, e = 0, el = 0;
+	while ( n < nodeAt.size() || e < edgeAt.size() || el < elementAt.size() )
+	{
+		for ( ; n < nodeAt.size(); n++ )
+		{
+			const auto* cur = nodeAt[n];
+			NodeRecord r;
+			r.x = cur->x;
+			r.y = cur->y;
+			r.number = cur->GetNumber();
+			r.movedByOBS = cur->movedByOBS;
+			r.color = cur->color;
+			r.firstPattern = static_cast<uint32_t>(patterns.size());
+			r.nPattern = static_cast<uint32_t>(cur->pattern.size());
+			patterns.insert( patterns.end(), cur->pattern.begin(), cur->pattern.end() );
+			r.firstEdge = static_cast<uint32_t>(nodeEdges.size());
+			r.nEdges = static_cast<uint32_t>(cur->edgeList.size());
+			for ( const auto& ne : cur->edgeList )
+			{
+				nodeEdges.push_back( edgeId( ne.get() ) );
+			}
+			nodes.push_back( r );
+		}
+		for ( ; e < edgeAt.size(); e++ )
+		{
+			const auto* cur = edgeAt[e];
+			EdgeRecord r;
+			r.leftNode = nodeId( cur->leftNode.get() );
+			r.rightNode = nodeId( cur->rightNode.get() );
+			r.element1 = elementId( cur->element1.get() );
+			r.element2 = elementId( cur->element2.get() );
+			r.leftFrontNeighbor = edgeId( cur->leftFrontNeighbor.get() );
+			r.rightFrontNeighbor = edgeId( cur->rightFrontNeighbor.get() );
+			r.level = cur->level;
+			r.frontEdge = cur->frontEdge;
+			r.swappable = cur->swappable;
+			r.selectable = cur->selectable;
+			r.leftSide = cur->leftSide;
+			r.rightSide = cur->rightSide;
+			r.len = cur->len;
+			r.color = cur->color;
+			edges.push_back( r );
+		}
+		for ( ; el < elementAt.size(); el++ )
+		{
+			auto* cur = elementAt[el];
+			auto* q = dynamic_cast<Quad*>(cur);
+			ElementRecord r;
+			r.isQuad = q != nullptr;
+			r.isFake = q != nullptr && q->isFake;
+			r.nEdges = static_cast<uint8_t>(cur->edgeList.size());
+			r.nAng = static_cast<uint8_t>(cur->ang.size());
+			r.edges.fill( none );
+			r.ang.fill( 0.0 );
+			for ( size_t i = 0; i < cur->edgeList.size(); i++ )
+			{
+				r.edges[i] = edgeId( cur->edgeList[i].get() );
+			}
+			for ( size_t i = 0; i < cur->ang.size(); i++ )
+			{
+				r.ang[i] = cur->ang[i];
+			}
+			r.firstNode = nodeId( cur->firstNode.get() );
+			r.distortionMetric = cur->distortionMetric;
+			r.newDistortionMetric = cur->newDistortionMetric;
+			r.gX = cur->gX;
+			r.gY = cur->gY;
+			elements.push_back( r );
+		}
+	}
+}
+
+MeshSnapshot::Entities
+MeshSnapshot::build() const
+{
+	Entities m;
+	m.nodes.reserve( nodes.size() );
+	m.edges.reserve( edges.size() );
+	m.elements.reserve( elements.size() );
+
+	// Make every entity first, so that the references can then be set by index
+	for ( const auto& r : nodes )
+	{
+		auto n = std::make_shared<Node>();
+		n->x = r.x;
+		n->y = r.y;
+		n->SetNumber( r.number );
+		n->movedByOBS = r.movedByOBS;
+		n->color = r.color;
+		n->pattern.assign( patterns.begin() + r.firstPattern, patterns.begin() + r.firstPattern + r.nPattern );
+		m.nodes.push_back( std::move( n ) );
+	}
+	for ( size_t i = 0; i < edges.size(); i++ )
+	{
+		m.edges.push_back( std::make_shared<Edge>() );
+	}
+	for ( const auto& r : elements )
+	{
+		if ( r.isQuad )
+		{
+			auto q = std::make_shared<Quad>();
+			q->isFake = r.isFake;
+			m.elements.push_back( std::move( q ) );
+		}
+		else
+		{
+			m.elements.push_back( std::make_shared<Triangle>() );
+		}
+	}
+
+	auto node = [&m]( uint32_t i ) { return i == none ? nullptr : m.nodes[i]; };
+	auto edge = [&m]( uint32_t i ) { return i == none ? nullptr : m.edges[i]; };
+	auto element = [&m]( uint32_t i ) { return i == none ? nullptr : m.elements[i]; };
+
+	for ( size_t i = 0; i < nodes.size(); i++ )
+	{
+		const auto& r = nodes[i];
+		auto& list = m.nodes[i]->edgeList;
+		for ( uint32_t j = r.firstEdge; j < r.firstEdge + r.nEdges; j++ )
+		{
+			list.add( edge( nodeEdges[j] ) );
+		}
+	}
+	for ( size_t i = 0; i < edges.size(); i++ )
+	{
+		const auto& r = edges[i];
+		auto& e = m.edges[i];
+		e->leftNode = node( r.leftNode );
+		e->rightNode = node( r.rightNode );
+		e->element1 = element( r.element1 );
+		e->element2 = element( r.element2 );
+		e->leftFrontNeighbor = edge( r.leftFrontNeighbor );
+		e->rightFrontNeighbor = edge( r.rightFrontNeighbor );
+		e->level = r.level;
+		e->frontEdge = r.frontEdge;
+		e->swappable = r.swappable;
+		e->selectable = r.selectable;
+		e->leftSide = r.leftSide;
+		e->rightSide = r.rightSide;
+		e->len = r.len;
+		e->color = r.color;
+	}
+	for ( size_t i = 0; i < elements.size(); i++ )
+	{
+		const auto& r = elements[i];
+		auto& el = m.elements[i];
+		el->edgeList.resize( r.nEdges );
+		for ( size_t j = 0; j < r.nEdges; j++ )
+		{
+			el->edgeList[j] = edge( r.edges[j] );
+		}
+		el->ang.assign( r.ang.begin(), r.ang.begin() + r.nAng );
+		el->firstNode = node( r.firstNode );
+		el->distortionMetric = r.distortionMetric;
+		el->newDistortionMetric = r.newDistortionMetric;
+		el->gX = r.gX;
+		el->gY = r.gY;
+	}
+	return m;
+}
+
+//TODO: Tests
+void
+MeshSnapshot::restore() const
+{
+	auto m = build();
+
+	GeomBasics::clearLists();
+	for ( auto i : nodeList )
+	{
+		GeomBasics::nodeList.add( m.nodes[i] );
+	}
+	for ( auto i : edgeList )
+	{
+		GeomBasics::edgeList.add( m.edges[i] );
+	}
+	for ( auto i : triangleList )
+	{
+		GeomBasics::triangleList.add( std::static_pointer_cast<Triangle>(m.elements[i]) );
+	}
+	for ( auto i : elementList )
+	{
+		GeomBasics::elementList.add( m.elements[i] );
+	}
+	Edge::clearStateList();
+	for ( size_t s = 0; s < stateList.size(); s++ )
+	{
+		for ( auto i : stateList[s] )
+		{
+			Edge::stateList[s].add( m.edges[i] );
+		}
+	}
+	auto extreme = [&m]( uint32_t i ) { return i == none ? nullptr : m.nodes[i]; };
+	GeomBasics::leftmost = extreme( extremes[0] );
+	GeomBasics::rightmost = extreme( extremes[1] );
+	GeomBasics::uppermost = extreme( extremes[2] );
+	GeomBasics::lowermost = extreme( extremes[3] );
+}
+
+//TODO: Tests
+MeshComponents::Component
+MeshSnapshot::copy() const
+{
+	auto m = build();
+
+	MeshComponents::Component c;
+	for ( auto i : nodeList )
+	{
+		c.nodes.add( m.nodes[i] );
+	}
+	for ( auto i : edgeList )
+	{
+		c.edges.add( m.edges[i] );
+	}
+	for ( auto i : triangleList )
+	{
+		c.triangles.add( std::static_pointer_cast<Triangle>(m.elements[i]) );
+	}
+	for ( auto i : elementList )
+	{
+		c.elements.add( m.elements[i] );
+	}
+	return c;
+}
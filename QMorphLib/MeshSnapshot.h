@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Constants.h"
+#include "MeshComponents.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Node;
+class Edge;
+class Element;
+
+/**
+ * A copy of the mesh in the GeomBasics lists, held as flat records that refer
+ * to each other by index, from which any number of independent meshes can be
+ * made again.
+ *
+ * Like a Checkpoint, a snapshot holds every node, edge and element reachable
+ * from the lists of GeomBasics, Edge::stateList and the extreme nodes, with
+ * the fields the algorithms read, and the order of the lists. The caches that
+ * are rebuilt on demand and the front of a running QMorph are not held.
+ *
+ * Taking a snapshot numbers the entities through their snapshotIndex fields,
+ * so the pointers are remapped in one pass without lookups in a map, and a
+ * snapshot of the mesh of one thread must not be taken by two threads at once.
+ * Making a mesh from a snapshot only reads it, and can be done on any number
+ * of threads at once.
+ */
+
+class MeshSnapshot
+{
+public:
+	/** Take a snapshot of the mesh in the GeomBasics lists of this thread. */
+	MeshSnapshot();
+
+	/** @return the number of nodes, edges and elements in the snapshot */
+	size_t nodeCount() const { return nodes.size(); }
+	size_t edgeCount() const { return edges.size(); }
+	size_t elementCount() const { return elements.size(); }
+
+	/**
+	 * Replace the mesh in the GeomBasics lists of this thread, Edge::stateList
+	 * and the extreme nodes by a new copy of the snapshot.
+	 */
+	void restore() const;
+
+	/** @return a new copy of the lists of the snapshot */
+	MeshComponents::Component copy() const;
+
+private:
+	static constexpr uint32_t none = UINT32_MAX;
+
+	struct NodeRecord
+	{
+		double x, y;
+		int number;
+		bool movedByOBS;
+		Constants::Color color;
+		uint32_t firstPattern, nPattern;
+		uint32_t firstEdge, nEdges;
+	};
+
+	struct EdgeRecord
+	{
+		uint32_t leftNode, rightNode;
+		uint32_t element1, element2;
+		uint32_t leftFrontNeighbor, rightFrontNeighbor;
+		int level;
+		bool frontEdge, swappable, selectable, leftSide, rightSide;
+		double len;
+		Constants::Color color;
+	};
+
+	struct ElementRecord
+	{
+		bool isQuad, isFake;
+		uint8_t nEdges, nAng;
+		std::array<uint32_t, 4> edges;
+		std::array<double, 4> ang;
+		uint32_t firstNode;
+		double distortionMetric, newDistortionMetric, gX, gY;
+	};
+
+	std::vector<NodeRecord> nodes;
+	std::vector<EdgeRecord> edges;
+	std::vector<ElementRecord> elements;
+	// The valence patterns and the edge lists of the nodes, one after the other
+	std::vector<uint8_t> patterns;
+	std::vector<uint32_t> nodeEdges;
+
+	std::vector<uint32_t> nodeList, edgeList, triangleList, elementList;
+	std::array<std::vector<uint32_t>, 3> stateList;
+	std::array<uint32_t, 4> extremes;
+
+	/** The entities of a mesh made from the snapshot */
+	struct Entities
+	{
+		std::vector<std::shared_ptr<Node>> nodes;
+		std::vector<std::shared_ptr<Edge>> edges;
+		std::vector<std::shared_ptr<Element>> elements;
+	};
+
+	Entities build() const;
+};
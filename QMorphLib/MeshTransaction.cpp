@@ -0,0 +1,217 @@
+#include "pch.h"
+#include "MeshTransaction.h"
+
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Types.h"
+#include "Msg.h"
+
+MeshTransaction::~MeshTransaction()
+{
+	rollback();
+}
+
+//TODO: Tests
+void
+MeshTransaction::recordPosition( const std::shared_ptr<Node>& n )
+{
+	Entry entry;
+	entry.kind = Kind::NodePosition;
+	entry.node = n;
+	entry.x = n->x;
+	entry.y = n->y;
+	log.push_back( std::move( entry ) );
+}
+
+//TODO: Tests
+void
+MeshTransaction::moveNode( const std::shared_ptr<Node>& n, const Node& pos )
+{
+	recordPosition( n );
+	n->moveTo( pos );
+}
+
+//TODO: Tests
+void
+MeshTransaction::swapEdge( const std::shared_ptr<Edge>& e, const std::shared_ptr<Edge>& eNew )
+{
+	std::shared_ptr<Element> old1 = e->element1, old2 = e->element2;
+	if ( old1 == nullptr || old2 == nullptr )
+	{
+		Msg::error( "MeshTransaction::swapEdge(..): both elements not set" );
+	}
+
+	recordElementsAround( old1 );
+	recordElementsAround( old2 );
+	recordElements( eNew );
+	for ( const auto& n : { e->leftNode, e->rightNode } )
+	{
+		Entry entry;
+		entry.kind = Kind::NodeEdgeRemoved;
+		entry.node = n;
+		entry.edge = e;
+		entry.index = static_cast<size_t>(n->edgeList.indexOf( e ));
+		log.push_back( std::move( entry ) );
+	}
+
+	auto tNew = e->swapToAndSetElementsFor( eNew );
+
+	for ( const auto& n : { eNew->leftNode, eNew->rightNode } )
+	{
+		Entry entry;
+		entry.kind = Kind::NodeEdgeAdded;
+		entry.node = n;
+		entry.edge = eNew;
+		log.push_back( std::move( entry ) );
+	}
+
+	// The new triangles and edge take the places of the old ones in the lists
+	const std::shared_ptr<Element> olds[] = { old1, old2 };
+	const std::shared_ptr<Element> news[] = { tNew[0], tNew[1] };
+	for ( size_t k = 0; k < 2; k++ )
+	{
+		auto t = rcl::triangleCast(olds[k]);
+		auto i = t != nullptr ? GeomBasics::triangleList.indexOf( t ) : -1;
+		if ( i != -1 )
+		{
+			Entry entry;
+			entry.kind = Kind::TriangleSlot;
+			entry.element1 = olds[k];
+			entry.index = static_cast<size_t>(i);
+			log.push_back( std::move( entry ) );
+			GeomBasics::triangleList.set( static_cast<size_t>(i), std::static_pointer_cast<Triangle>(news[k]) );
+		}
+	}
+	auto i = GeomBasics::edgeList.indexOf( e );
+	if ( i != -1 )
+	{
+		Entry entry;
+		entry.kind = Kind::EdgeSlot;
+		entry.edge = e;
+		entry.index = static_cast<size_t>(i);
+		log.push_back( std::move( entry ) );
+		GeomBasics::edgeList.set( static_cast<size_t>(i), eNew );
+	}
+}
+
+//TODO: Tests
+void
+MeshTransaction::replaceElement( const std::shared_ptr<Element>& oldElem,
+								 const std::shared_ptr<Element>& newElem )
+{
+	recordElementsAround( oldElem );
+	recordElementsAround( newElem );
+
+	oldElem->disconnectEdges();
+	newElem->connectEdges();
+
+	Entry entry;
+	entry.element1 = oldElem;
+	auto i = GeomBasics::elementList.indexOf( oldElem );
+	if ( i != -1 )
+	{
+		entry.kind = Kind::ElementSlot;
+		entry.index = static_cast<size_t>(i);
+		log.push_back( std::move( entry ) );
+		GeomBasics::elementList.set( static_cast<size_t>(i), newElem );
+		return;
+	}
+
+	auto oldT = rcl::triangleCast(oldElem);
+	auto newT = rcl::triangleCast(newElem);
+	if ( oldT != nullptr && newT != nullptr )
+	{
+		i = GeomBasics::triangleList.indexOf( oldT );
+		if ( i != -1 )
+		{
+			entry.kind = Kind::TriangleSlot;
+			entry.index = static_cast<size_t>(i);
+			log.push_back( std::move( entry ) );
+			GeomBasics::triangleList.set( static_cast<size_t>(i), newT );
+		}
+	}
+}
+
+//TODO: Tests
+void
+MeshTransaction::commit()
+{
+	log.clear();
+}
+
+//TODO: Tests
+void
+MeshTransaction::rollback()
+{
+	for ( auto it = log.rbegin(); it != log.rend(); ++it )
+	{
+		undo( *it );
+	}
+	log.clear();
+}
+
+void
+MeshTransaction::recordElements( const std::shared_ptr<Edge>& e )
+{
+	Entry entry;
+	entry.kind = Kind::EdgeElements;
+	entry.edge = e;
+	entry.element1 = e->element1;
+	entry.element2 = e->element2;
+	log.push_back( std::move( entry ) );
+}
+
+void
+MeshTransaction::recordElementsAround( const std::shared_ptr<Element>& elem )
+{
+	for ( const auto& e : elem->edgeList )
+	{
+		if ( e != nullptr )
+		{
+			recordElements( e );
+		}
+	}
+}
+
+void
+MeshTransaction::undo( const Entry& entry )
+{
+	switch ( entry.kind )
+	{
+		case Kind::NodePosition:
+			entry.node->setXY( entry.x, entry.y );
+			entry.node->update();
+			break;
+		case Kind::EdgeElements:
+			entry.edge->element1 = entry.element1;
+			entry.edge->element2 = entry.element2;
+			entry.edge->invalidateStars();
+			break;
+		case Kind::NodeEdgeAdded:
+		{
+			auto i = entry.node->edgeList.indexOf( entry.edge );
+			if ( i != -1 )
+			{
+				entry.node->edgeList.remove( static_cast<size_t>(i) );
+			}
+			entry.node->invalidateStar();
+			break;
+		}
+		case Kind::NodeEdgeRemoved:
+			entry.node->edgeList.add( entry.index, entry.edge );
+			entry.node->invalidateStar();
+			break;
+		case Kind::TriangleSlot:
+			GeomBasics::triangleList.set( entry.index, std::static_pointer_cast<Triangle>(entry.element1) );
+			break;
+		case Kind::ElementSlot:
+			GeomBasics::elementList.set( entry.index, entry.element1 );
+			break;
+		case Kind::EdgeSlot:
+			GeomBasics::edgeList.set( entry.index, entry.edge );
+			break;
+	}
+}
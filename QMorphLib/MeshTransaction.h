@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Node;
+class Edge;
+class Element;
+
+/**
+ * An undo log for trial changes to the mesh in the GeomBasics lists. Node
+ * moves, edge swaps and element replacements made through a transaction are
+ * recorded as they are done, and can then either be kept by commit() or undone
+ * in reverse order by rollback().
+ *
+ * Only the state a change overwrites is recorded: the old position of a moved
+ * node, the element slots of the edges around a swap or a replacement, the
+ * places of an edge in the edge lists of its nodes and the slots of the
+ * GeomBasics lists. Undoing a change puts back the very same entities, so
+ * references to them held elsewhere stay valid, and no copies of nodes or
+ * elements are made for the purpose.
+ *
+ * A node moved by other code, such as Node::incrAdjustUntilNotInvertedOrZeroArea(..),
+ * is covered if its position is recorded through recordPosition(..) before the
+ * first move. A transaction that is neither committed nor rolled back is rolled
+ * back when it is destroyed.
+ */
+
+class MeshTransaction
+{
+public:
+	MeshTransaction() = default;
+	MeshTransaction( const MeshTransaction& ) = delete;
+	MeshTransaction& operator=( const MeshTransaction& ) = delete;
+
+	/** Roll back the changes that have not been committed. */
+	~MeshTransaction();
+
+	/** @return the number of changes recorded since the last commit or rollback */
+	size_t size() const { return log.size(); }
+
+	/** Record the position of n, so that a rollback moves n back there. */
+	void recordPosition( const std::shared_ptr<Node>& n );
+
+	/** Record the position of n and move n to the position of pos. */
+	void moveNode( const std::shared_ptr<Node>& n, const Node& pos );
+
+	/**
+	 * Swap the diagonal e of the two triangles on its sides for eNew, as by
+	 * Edge::swapToAndSetElementsFor(..), and put eNew and the two new
+	 * triangles in the places of e and the old triangles in the GeomBasics
+	 * lists.
+	 */
+	void swapEdge( const std::shared_ptr<Edge>& e, const std::shared_ptr<Edge>& eNew );
+
+	/**
+	 * Replace the element oldElem by newElem, which has been made over edges
+	 * already in the mesh. oldElem is disconnected from its edges, newElem is
+	 * connected to its own, and newElem takes the place of oldElem in
+	 * GeomBasics::elementList, or, for two triangles, in
+	 * GeomBasics::triangleList.
+	 */
+	void replaceElement( const std::shared_ptr<Element>& oldElem,
+						 const std::shared_ptr<Element>& newElem );
+
+	/** Keep the changes recorded so far and clear the log. */
+	void commit();
+
+	/** Undo the changes recorded so far, the last one first, and clear the log. */
+	void rollback();
+
+private:
+	enum class Kind
+	{
+		NodePosition,   // node was at x, y
+		EdgeElements,   // edge had the elements element1, element2
+		NodeEdgeAdded,  // edge was appended to the edgeList of node
+		NodeEdgeRemoved,// edge was removed from place index of the edgeList of node
+		TriangleSlot,   // place index of triangleList held element1
+		ElementSlot,    // place index of elementList held element1
+		EdgeSlot        // place index of edgeList held edge
+	};
+
+	struct Entry
+	{
+		Kind kind;
+		std::shared_ptr<Node> node;
+		std::shared_ptr<Edge> edge;
+		std::shared_ptr<Element> element1, element2;
+		double x = 0.0, y = 0.0;
+		size_t index = 0;
+	};
+
+	std::vector<Entry> log;
+
+	void recordElements( const std::shared_ptr<Edge>& e );
+	void recordElementsAround( const std::shared_ptr<Element>& elem );
+	void undo( const Entry& entry );
+};
@@ -27,11 +27,13 @@ void Msg::write( const std::string& level, const std::string& msg )
     using namespace std::chrono;
     auto now = system_clock::now();
     auto timeT = system_clock::to_time_t( now );
-    char buf[32];
-    strftime( buf, sizeof( buf ), "%Y-%m-%d %H:%M:%S", std::localtime( &timeT ) );
 
+    // std::localtime(..) returns a shared buffer, so it is guarded as well
     std::lock_guard<std::mutex> lk( logMutex );
 
+    char buf[32];
+    strftime( buf, sizeof( buf ), "%Y-%m-%d %H:%M:%S", std::localtime( &timeT ) );
+
     std::string line = "[" + std::string( buf ) + "] " + level + ": " + msg + "\n";
 
     // Console
@@ -3,6 +3,7 @@
 #include "Msg.h"
 
 #include "Node.h"
+#include "Predicates.h"
 
 //TODO: Tests
 MyLine::MyLine( const std::shared_ptr<Node>& n1,
@@ -27,7 +28,7 @@ MyLine::MyLine( const std::shared_ptr<Node>& n1,
 double 
 MyLine::cross( const MyLine& l )
 {
-	return x * l.y - l.x * y;
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, l.x, l.y );
 }
 
 //TODO: Tests
@@ -35,27 +36,30 @@ std::shared_ptr<Node>
 MyLine::pointIntersectsAt( const MyLine& d1 )
 {
 	Msg::debug( "Entering MyLine.pointIntersectsAt(..)" );
-	auto p0 = ref, p1 = d1.ref;
-	MyLine delta( p0, p1->x - p0->x, p1->y - p0->y );
-	MyLine d0 = *this;
-	Msg::debug( "... d0:" + d0.descr() );
+	Msg::debug( "... d0:" + descr() );
 	Msg::debug( "... d1:" + d1.descr() );
-	double d0crossd1 = d0.cross( d1 );
+	auto p = pointIntersectsAt( ref->point(), { x, y }, d1.ref->point(), { d1.x, d1.y } );
 
-	if ( d0crossd1 == 0 )
+	if ( !p )
 	{ // Parallel and, alas, no pointintersection
 		Msg::debug( "Leaving MyLine.pointIntersectsAt(..), returns null" );
 		return nullptr;
 	}
-	else
-	{
-		double t = delta.cross( d0 ) / d0crossd1;
+	Msg::debug( "Leaving MyLine.pointIntersectsAt(..), returns x: " + std::to_string( p->x ) + ", y:" + std::to_string( p->y ) );
+	return std::make_shared<Node>( p->x, p->y ); // Intersects at this line point
+}
 
-		double x = d1.ref->x + t * d1.x;
-		double y = d1.ref->y + t * d1.y;
-		Msg::debug( "Leaving MyLine.pointIntersectsAt(..), returns x: " + std::to_string( x ) + ", y:" + std::to_string( y ) );
-		return std::make_shared<Node>( x, y ); // Intersects at this line point
+//TODO: Tests
+std::optional<Point2>
+MyLine::pointIntersectsAt( const Point2& p0, const Vec2& d0,
+						   const Point2& p1, const Vec2& d1 )
+{
+	auto c = intersection( p0, d0, p1, d1 );
+	if ( !c )
+	{
+		return std::nullopt;
 	}
+	return p1 + d1 * c->t;
 }
 
 //TODO: Tests
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Vec2.h"
+
 #include <memory>
+#include <optional>
 #include <string>
 
 class Node;
@@ -27,6 +30,11 @@ public:
 
 	std::shared_ptr<Node> pointIntersectsAt( const MyLine& d1 );
 
+	// Coordinate version of pointIntersectsAt(MyLine): the lines pass through
+	// p0 and p1 in the directions d0 and d1
+	static std::optional<Point2> pointIntersectsAt( const Point2& p0, const Vec2& d0,
+													const Point2& p1, const Vec2& d1 );
+
 	std::string descr() const;
 
 	std::shared_ptr<Node> ref;
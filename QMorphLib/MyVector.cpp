@@ -3,6 +3,7 @@
 
 #include "Node.h"
 #include "Numbers.h"
+#include "Predicates.h"
 #include "Msg.h"
 #include "Ray.h"
 
@@ -74,12 +75,27 @@ MyVector::MyVector( const std::shared_ptr<Node>& a,
 	this->y = b->y - a->y;
 }
 
+//TODO: Tests
+MyVector::MyVector( const std::shared_ptr<Node>& origin,
+					const Vec2& v )
+{
+	this->origin = origin;
+	this->x = v.x;
+	this->y = v.y;
+}
+
 double 
 MyVector::length() const
 {
 	return std::sqrt( x * x + y * y );
 }
 
+Vec2
+MyVector::vec() const
+{
+	return { x, y };
+}
+
 double
 MyVector::angle()
 {
@@ -244,196 +260,45 @@ MyVector::isCWto( const MyVector& v )
 	{
 		return false; // A vector cannot be CW to itself
 	}
-	double thisR, vR;
-
-	if ( x != 0 )
-	{
-		thisR = y / x;
-	}
-	else
-	{
-		thisR = -std::numeric_limits<double>::infinity();
-	}
-
-	if ( v.x != 0 )
-	{
-		vR = v.y / v.x;
-	}
-	else
-	{
-		vR = -std::numeric_limits<double>::infinity();
-	}
-
-	if ( x > 0 && y >= 0 )
-	{ // ----- First quadrant -----
-		if ( v.x > 0 && v.y >= 0 )
-		{ // First quadrant
-			if ( thisR <= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else if ( v.x <= 0 && v.y > 0 )
-		{ // Second quadrant
-			return true;
-		}
-		else if ( v.x < 0 && v.y <= 0 )
-		{ // Third quadrant
-			if ( thisR >= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else
-		{ // Third quadrant
-			return false;
-		}
-	}
-	else if ( x <= 0 && y > 0 )
-	{ // ----- Second quadrant -----
-		if ( v.x > 0 && v.y >= 0 )
-		{ // First quadrant
-			return false;
-		}
-		else if ( v.x <= 0 && v.y > 0 )
-		{ // Second quadrant
-			if ( thisR <= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else if ( v.x < 0 && v.y <= 0 )
-		{ // Third quadrant
-			return true;
-		}
-		else
-		{// if (v.x>=0 && v.y< 0) { // Fourth quadrant
-			if ( thisR >= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-	}
-	else if ( x < 0 && y <= 0 )
-	{ // ----- Third quadrant -----
-		if ( v.x > 0 && v.y >= 0 )
-		{ // First quadrant
-			if ( thisR >= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else if ( v.x <= 0 && v.y > 0 )
-		{ // Second quadrant
-			return false;
-		}
-		else if ( v.x < 0 && v.y <= 0 )
-		{ // Third quadrant
-			if ( thisR <= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else
-		{ // Third quadrant
-			return true;
-		}
-
-	}
-	else
-	{ // if (x>=0 && y< 0) { // ----- Fourth quadrant -----
-		if ( v.x > 0 && v.y >= 0 )
-		{ // First quadrant
-			return true;
-		}
-		else if ( v.x <= 0 && v.y > 0 )
-		{ // Second quadrant
-			if ( thisR >= vR )
-			{
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		}
-		else if ( v.x < 0 && v.y <= 0 )
-		{ // Third quadrant
-			return false;
-		}
-		else
-		{// if (v.x>=0 && v.y< 0) { // Fourth quadrant
-			if ( thisR <= vR )
-			{ // <=
-				return true;
-			}
-			else
-			{ // <=
-				return false;
-			}
-		}
-	}
+	// Equal slopes count as cw, so only a strictly negative cross product
+	// means that v is cw to this. The sign comes from the adaptive predicate,
+	// which replaces the old quadrant-by-quadrant comparison of slopes.
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, v.x, v.y ) >= 0.0;
 }
 
 double
 MyVector::cross( const MyVector& v )
 {
-	return x * v.y - v.x * y;
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, v.x, v.y );
 }
 
-//TODO: Implement this method
 //TODO: Tests
 std::shared_ptr<Node>
 MyVector::pointIntersectsAt( const MyVector& d1 )
 {
-	auto p0 = origin, p1 = d1.origin;
-	MyVector delta( p0, p1->x - p0->x, p1->y - p0->y );
-	MyVector d0 = *this;
-	double d0crossd1 = d0.cross( d1 );
+	auto p = pointIntersectsAt( origin->point(), vec(), d1.origin->point(), d1.vec() );
+	if ( !p )
+	{
+		return nullptr;
+	}
+	return std::make_shared<Node>( p->x, p->y );
+}
 
-	if ( d0crossd1 == 0 )
+//TODO: Tests
+std::optional<Point2>
+MyVector::pointIntersectsAt( const Point2& p0, const Vec2& d0,
+							 const Point2& p1, const Vec2& d1 )
+{
+	auto c = intersection( p0, d0, p1, d1 );
+	if ( !c )
 	{
-		return nullptr; // Does not intersect at all OR the same MyVector
+		return std::nullopt; // Does not intersect at all OR the same MyVector
 	}
-	else
+	if ( c->t < 0 || c->t > 1 || c->s < 0 || c->s > 1 )
 	{
-		double s = delta.cross( d1 ) / d0crossd1;
-		double t = delta.cross( d0 ) / d0crossd1;
-		if ( t < 0 || t > 1 || s < 0 || s > 1 )
-		{
-			return nullptr; // Intersects not at an edge point (but extension)
-		}
-		else
-		{
-			double x = d1.origin->x + t * d1.x;
-			double y = d1.origin->y + t * d1.y;
-			return std::make_shared<Node>( x, y );// Intersects at this edge point
-		}
+		return std::nullopt; // Intersects not at an edge point (but extension)
 	}
+	return p1 + d1 * c->t; // Intersects at this edge point
 }
 
 double 
@@ -451,7 +316,7 @@ MyVector::dot( double vx, double vy )
 double 
 MyVector::cross( const Ray& r )
 {
-	return x * r.y - r.x * y;
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, r.x, r.y );
 }
 
 std::string 
@@ -566,44 +431,31 @@ MyVector::pointIntersects( const MyVector& d1 )
 bool 
 MyVector::innerpointIntersects( const MyVector& d1 )
 {
-	auto p0 = origin, p1 = d1.origin;
-	MyVector delta( p0, p1->x - p0->x, p1->y - p0->y );
-	MyVector d0 = *this;
-
-	if ( d0.origin->equals( d1.origin ) || 
-		 (rcl::equal( d0.origin->x, d1.origin->x + d1.x ) && rcl::equal( d0.origin->y, d1.origin->y + d1.y )) ||
-		 (rcl::equal( d0.origin->x + d0.x, d1.origin->x ) && rcl::equal( d0.origin->y + d0.y, d1.origin->y ))||
-		 (rcl::equal( d0.origin->x + d0.x, d1.origin->x + d1.x ) && rcl::equal( d0.origin->y + d0.y, d1.origin->y + d1.y )) )
+	if ( !innerpointIntersects( origin->point(), vec(), d1.origin->point(), d1.vec() ) )
 	{
-		Msg::debug( descr() + " doesn't intersect innerpoint of " + d1.descr() + " (0)" );
+		Msg::debug( descr() + " doesn't intersect innerpoint of " + d1.descr() );
 		return false;
 	}
+	return true;
+}
 
-	double d0crossd1 = d0.cross( d1 );
+bool
+MyVector::innerpointIntersects( const Point2& p0, const Vec2& d0,
+								const Point2& p1, const Vec2& d1 )
+{
+	if ( p0.nearlyEquals( p1 ) || p0.nearlyEquals( p1 + d1 ) ||
+		 (p0 + d0).nearlyEquals( p1 ) || (p0 + d0).nearlyEquals( p1 + d1 ) )
+	{
+		return false; // They share an endpoint
+	}
 
-	if ( d0crossd1 == 0 )
+	auto c = intersection( p0, d0, p1, d1 );
+	if ( !c )
 	{ // Non-intersecting and parallel OR intersect in an interval
-		Msg::debug( this->descr() + " doesn't intersect in inner point of " + d1.descr() + " (1)" );
 		return false;
 	}
-	else
-	{
-		double s = delta.cross( d1 ) / d0crossd1;
-		double t = delta.cross( d0 ) / d0crossd1;
-
-		Msg::debug( "innerpointIntersects(..): s: " + std::to_string( s ) );
-		Msg::debug( "innerpointIntersects(..): t: " + std::to_string( t ) );
-
-		if ( t <= 0 || t >= 1 || s <= 0 || s >= 1 )
-		{
-			Msg::debug( this->descr() + " doesn't innerintersect " + d1.descr() + " (2)" );
-			return false; // Intersects not at an Edge point (but possibly an interval)
-		}
-		else
-		{
-			return true; // Intersects at an Edge point
-		}
-	}
+	// Intersects at an inner point of both, and not only in an endpoint
+	return c->t > 0 && c->t < 1 && c->s > 0 && c->s < 1;
 }
 
 void 
@@ -1,5 +1,8 @@
 #pragma once
 #include "Constants.h"
+#include "Vec2.h"
+
+#include <optional>
 
 class Edge;
 class Node;
@@ -53,6 +56,13 @@ public:
 	MyVector( const std::shared_ptr<Node>& a, 
 			  const std::shared_ptr<Node>& b );
 
+	/**
+	 * @param origin the origin of the vector
+	 * @param v      the x and y components
+	 */
+	MyVector( const std::shared_ptr<Node>& origin,
+			  const Vec2& v );
+
 	//TODO: C++ equivalent of Java's BigDecimal
 //	private final static BigDecimal zero = new BigDecimal( 0.0 );
 //	private final static BigDecimal one = new BigDecimal( 1.0 );
@@ -63,6 +73,9 @@ public:
 	/** @return length of vector */
 	double length() const;
 
+	/** @return the x and y components as a value */
+	Vec2 vec() const;
+
 	/**
 	 * @return angle relative to the x-axis (which is directed from the origin (0,0)
 	 *         to the right, btw) in the range (-180, 180) in radians.
@@ -146,6 +159,15 @@ public:
 	 */
 	std::shared_ptr<Node> pointIntersectsAt( const MyVector& d1 );
 
+	/**
+	 * Coordinate version of pointIntersectsAt(MyVector).
+	 *
+	 * @return the point where the vector d0 from p0 and the vector d1 from p1
+	 *         intersect, if they intersect at one point exactly
+	 */
+	static std::optional<Point2> pointIntersectsAt( const Point2& p0, const Vec2& d0,
+													const Point2& p1, const Vec2& d1 );
+
 	/** @return true if this and d1 intersect, else false. */
 	bool intersects( const MyVector& d1 );
 
@@ -158,6 +180,10 @@ public:
 	 */
 	bool innerpointIntersects( const MyVector& d1 );
 
+	/** Coordinate version of innerpointIntersects(MyVector). */
+	static bool innerpointIntersects( const Point2& p0, const Vec2& d0,
+									  const Point2& p1, const Vec2& d1 );
+
 	 /** @return a string representation of this vector. */
 	std::string descr() const;
 
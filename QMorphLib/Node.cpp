@@ -7,8 +7,11 @@
 #include "Types.h"
 #include "Msg.h"
 #include "Ray.h"
+#include "ScratchArena.h"
 
 #include "Numbers.h"
+#include "Predicates.h"
+#include "EdgeGrid.h"
 
 #include <iostream>
 
@@ -34,7 +37,7 @@ Node::copy()
 std::shared_ptr<Node> 
 Node::copyXY()
 {
-	return std::make_shared<Node>( x, y );
+	return ScratchArena::make<Node>( x, y );
 }
 
 void 
@@ -48,6 +51,8 @@ Node::setXY( double x, double y )
 {
 	this->x = x;
 	this->y = y;
+	invalidateStarGeometry();
+	EdgeGrid::nodeMoved( *this );
 }
 
 //TODO: Tests
@@ -57,6 +62,7 @@ Node::update()
 	updateLRinEdgeList();
 	updateEdgeLengths();
 	updateAngles();
+	EdgeGrid::nodeMoved( *this );
 }
 
 //TODO: Tests
@@ -74,7 +80,7 @@ void
 Node::updateAngles()
 {
 	Msg::debug("Entering Node.updateAngles()");
-	ArrayList<std::shared_ptr<Element>> list;
+	ScratchList<std::shared_ptr<Element>> list;
 
 	for ( auto element : edgeList )
 	{
@@ -91,13 +97,13 @@ Node::updateAngles()
 
 			auto other2 = ne->otherNode( shared_from_this() );
 
-			if ( rcl::instanceOf<Triangle>( e->element1 ) )
+			if ( auto t = rcl::asTriangle( e->element1 ) )
 			{
-				e->element1->updateAngles();
+				t->updateAngles();
 			}
 			else
 			{
-				auto q = std::dynamic_pointer_cast<Quad>(e->element1);
+				auto q = rcl::asQuad( e->element1 );
 				q->updateAnglesExcept( q->oppositeNode( shared_from_this() ) );
 			}
 		}
@@ -111,13 +117,13 @@ Node::updateAngles()
 
 			auto other2 = ne->otherNode( shared_from_this() );
 
-			if ( rcl::instanceOf<Triangle>( e->element2 ) )
+			if ( auto t = rcl::asTriangle( e->element2 ) )
 			{
-				e->element2->updateAngles();
+				t->updateAngles();
 			}
 			else
 			{
-				auto q = std::dynamic_pointer_cast<Quad>(e->element2);
+				auto q = rcl::asQuad( e->element2 );
 				q->updateAnglesExcept( q->oppositeNode( shared_from_this() ) );
 			}
 		}
@@ -148,18 +154,16 @@ Node::updateLRinEdgeList()
 				e->rightSide = btemp;
 			}
 
-			if ( rcl::instanceOf<Quad>( e->element1 ) )
+			if ( auto q = rcl::asQuad( e->element1 ) )
 			{
-				auto q = std::dynamic_pointer_cast<Quad>(e->element1);
 				if ( e == q->edgeList[base] )
 				{
 					q->updateLR();
 				}
 			}
 
-			if ( rcl::instanceOf<Quad>( e->element2 ) )
+			if ( auto q = rcl::asQuad( e->element2 ) )
 			{
-				auto q = std::dynamic_pointer_cast<Quad>(e->element2);
 				if ( e == q->edgeList[base] )
 				{
 					q->updateLR();
@@ -175,8 +179,10 @@ Node::moveToPos( double x, double y )
 {
 	this->x = x;
 	this->y = y;
+	invalidateStarGeometry();
 
 	updateLRinEdgeList();
+	EdgeGrid::nodeMoved( *this );
 }
 
 //TODO: Tests
@@ -185,14 +191,16 @@ Node::moveTo( const Node& n )
 {
 	x = n.x;
 	y = n.y;
+	invalidateStarGeometry();
 
 	updateLRinEdgeList();
+	EdgeGrid::nodeMoved( *this );
 }
 
 double 
 Node::cross( const Node& n )
 {
-	return x * n.y - n.x * y;
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, n.x, n.y );
 }
 
 void
@@ -201,114 +209,202 @@ Node::connectToEdge( const std::shared_ptr<Edge>& edge )
 	if ( !edgeList.contains( edge ) )
 	{
 		edgeList.add( edge );
+		invalidateStar();
+	}
+}
+
+void
+Node::invalidateStar()
+{
+	starElements.clear();
+	starQuads.clear();
+	starTriangles.clear();
+	starCCWEdges.clear();
+	starNeighbors.clear();
+	starTopologyValid = false;
+	starCCWEdgesValid = false;
+	starNeighborsValid = false;
+}
+
+void
+Node::invalidateStarGeometry()
+{
+	starCCWEdgesValid = false;
+	starNeighborsValid = false;
+
+	auto invalidateAt = []( const std::shared_ptr<Element>& elem )
+	{
+		if ( elem == nullptr )
+		{
+			return;
+		}
+		for ( const auto& e : elem->edgeList )
+		{
+			if ( e != nullptr )
+			{
+				e->leftNode->starCCWEdgesValid = e->leftNode->starNeighborsValid = false;
+				e->rightNode->starCCWEdgesValid = e->rightNode->starNeighborsValid = false;
+			}
+		}
+	};
+
+	for ( const auto& e : edgeList )
+	{
+		if ( e == nullptr )
+		{
+			continue;
+		}
+		auto other = e->leftNode.get() == this ? e->rightNode : e->leftNode;
+		if ( other != nullptr )
+		{
+			other->starCCWEdgesValid = other->starNeighborsValid = false;
+		}
+		invalidateAt( e->element1 );
+		invalidateAt( e->element2 );
 	}
 }
 
 //TODO: Tests
-ArrayList<std::shared_ptr<MyVector>>
-Node::ccwSortedVectorList()
+void
+Node::releaseLinks()
+{
+	edgeList.clear();
+	starElements.clear();
+	starQuads.clear();
+	starTriangles.clear();
+	starCCWEdges.clear();
+	starNeighbors.clear();
+	invalidateStar();
+}
+
+//TODO: Tests
+size_t
+Node::heapBytes() const
+{
+	return pattern.capacity() * sizeof( uint8_t )
+		+ (edgeList.capacity() + starCCWEdges.capacity()) * sizeof( std::shared_ptr<Edge> )
+		+ (starElements.capacity() + starQuads.capacity()) * sizeof( std::shared_ptr<Element> )
+		+ starTriangles.capacity() * sizeof( std::shared_ptr<Triangle> )
+		+ starNeighbors.capacity() * sizeof( std::shared_ptr<Node> );
+}
+
+//TODO: Tests
+const ArrayList<std::shared_ptr<Edge>>&
+Node::ccwSortedEdges()
 {
-	std::shared_ptr<MyVector> v, v0, v1;
-	std::shared_ptr<Element> elem;
-	ArrayList<std::shared_ptr<MyVector>> boundaryVectors;
-	ArrayList<std::shared_ptr<MyVector>> vectors;
-	
-	for ( auto element : edgeList )
+	if ( starCCWEdgesValid )
 	{
-		auto e = element;
-		v = std::make_shared<MyVector>(e->getVector( shared_from_this() ));
-		v->edge = e;
+		return starCCWEdges;
+	}
 
-		if ( e->boundaryEdge() )
+	auto self = shared_from_this();
+	std::shared_ptr<Edge> e0, e1, inner;
+	std::shared_ptr<Element> elem;
+
+	for ( const auto& e : edgeList )
+	{
+		if ( !e->boundaryEdge() )
+		{
+			if ( inner == nullptr )
+			{
+				inner = e;
+			}
+		}
+		else if ( e0 == nullptr )
 		{
-			boundaryVectors.add( v );
+			e0 = e;
 		}
-		else
+		else if ( e1 == nullptr )
 		{
-			vectors.add( v );
+			e1 = e;
 		}
 	}
 
-	// If the edgeList contains boundary edges, then select the vector of most CW
-	// of these.
-	// Else select the vector of an arbitrary edge.
-	// The selected vector is put into v0.
-	// Sets elem to the element that is ccw to v0 around this Node
+	// If the edgeList contains boundary edges, then select the most CW of these.
+	// Else select an arbitrary edge.
+	// The selected edge is put into e0.
+	// Sets elem to the element that is ccw to e0 around this Node
 
-	if ( boundaryVectors.size() > 0 )
-	{ // this size is always 0 or 2
+	if ( e0 != nullptr )
+	{ // there are always 0 or 2 boundary edges
 		Msg::debug( "...boundaryVectors yeah!" );
-		v0 = boundaryVectors.get( 0 );
-		v1 = boundaryVectors.get( 1 );
+		elem = e0->element1;
+		auto e = elem->neighborEdge( self, e0 );
 
-		elem = v0->edge->element1;
-		auto e = elem->neighborEdge( shared_from_this(), v0->edge);
-		v = std::make_shared<MyVector>( e->getVector( shared_from_this() ) );
-		v->edge = e;
-
-		if ( v0->isCWto( *v ) )
+		if ( e0->getVec2( self ).isCWto( e->getVec2( self ) ) )
 		{
-			if ( elem->concavityAt( shared_from_this() ) )
+			if ( elem->concavityAt( self ) )
 			{
-				v0 = v1;
-				elem = v1->edge->element1;
+				e0 = e1;
+				elem = e1->element1;
 			}
 		}
-		else if ( !elem->concavityAt( shared_from_this() ) )
+		else if ( !elem->concavityAt( self ) )
 		{
-			v0 = v1;
-			elem = v1->edge->element1;
+			e0 = e1;
+			elem = e1->element1;
 		}
 	}
 	else
 	{
 		Msg::debug( "...boundaryVectors noooo!" );
-		v0 = vectors.get( 0 );
-		elem = v0->edge->element1;
-		auto e = elem->neighborEdge( shared_from_this(), v0->edge);
-		v1 = std::make_shared<MyVector>( e->getVector( shared_from_this() ) );
-		v1->edge = e;
+		e0 = inner;
+		elem = e0->element1;
+		auto e = elem->neighborEdge( self, e0 );
 
-		if ( v0->isCWto( *v1 ) )
+		if ( e0->getVec2( self ).isCWto( e->getVec2( self ) ) )
 		{
-			if ( elem->concavityAt( shared_from_this() ) )
+			if ( elem->concavityAt( self ) )
 			{
-				v0 = v1;
+				e0 = e;
 			}
 		}
-		else if ( !elem->concavityAt( shared_from_this() ) )
+		else if ( !elem->concavityAt( self ) )
 		{
-			v0 = v1;
+			e0 = e;
 		}
 	}
 
-	Msg::debug( "Node.ccwSortedVectorList(..): 0: " + v0->edge->descr() );
+	Msg::debug( "Node.ccwSortedEdges(..): 0: " + e0->descr() );
 
-	// Sort vectors in ccw order starting with v0.
-	// Uses the fact that elem initially is the element ccw to v0 around this Node.
-	ArrayList<std::shared_ptr<MyVector>> VS;
-	auto e = v0->edge;
+	// Sort the edges in ccw order starting with e0.
+	// Uses the fact that elem initially is the element ccw to e0 around this Node.
+	starCCWEdges.clear();
+	auto e = e0;
 
 	auto start = elem;
 	do
 	{
-		v = std::make_shared<MyVector>( e->getVector( shared_from_this() ) );
-		v->edge = e;
-		Msg::debug( "... VS.add(" + v->descr() + ")" );
-		VS.add( v );
+		Msg::debug( "... add(" + e->descr() + ")" );
+		starCCWEdges.add( e );
 
-		e = elem->neighborEdge( shared_from_this(), e);
+		e = elem->neighborEdge( self, e );
 		elem = elem->neighbor( e );
 	} while ( elem != start && elem != nullptr );
 
 	if ( elem == nullptr )
 	{
-		v = std::make_shared<MyVector>( e->getVector( shared_from_this() ) );
+		Msg::debug( "... add(" + e->descr() + ")" );
+		starCCWEdges.add( e );
+	}
+
+	starCCWEdgesValid = true;
+	return starCCWEdges;
+}
+
+//TODO: Tests
+ArrayList<std::shared_ptr<MyVector>>
+Node::ccwSortedVectorList()
+{
+	const auto& edges = ccwSortedEdges();
+	ArrayList<std::shared_ptr<MyVector>> VS;
+	VS.reserve( edges.size() );
+	for ( const auto& e : edges )
+	{
+		auto v = std::make_shared<MyVector>( e->getVector( shared_from_this() ) );
 		v->edge = e;
-		Msg::debug( "... VS.add(" + v->descr() + ")" );
 		VS.add( v );
 	}
-
 	return VS;
 }
 
@@ -401,10 +497,16 @@ Node::calcCCWSortedEdgeList( const std::shared_ptr<Edge>& b0,
 }
 
 //TODO: Tests
-std::vector<std::shared_ptr<Node>> 
+const std::vector<std::shared_ptr<Node>>&
 Node::ccwSortedNeighbors()
 {
-	std::vector<std::shared_ptr<Node>> ccwNodeList( edgeList.size() * 2, nullptr );
+	if ( starNeighborsValid )
+	{
+		return starNeighbors;
+	}
+	starNeighborsValid = true;
+	auto& ccwNodeList = starNeighbors;
+	ccwNodeList.assign( edgeList.size() * 2, nullptr );
 
 	Msg::debug("Entering Node.ccwSortedNeighbors(..)");
 	std::shared_ptr<Element> elem = nullptr;
@@ -480,12 +582,12 @@ Node::ccwSortedNeighbors()
 	do
 	{
 		ccwNodeList[i++] = e->otherNode( shared_from_this() );
-		if ( !(rcl::instanceOf<Quad>( elem )) )
+		auto q = rcl::asQuad( elem );
+		if ( q == nullptr )
 		{
 			ccwNodeList.clear();
 			return ccwNodeList;
 		}
-		auto q = std::dynamic_pointer_cast<Quad>(elem);
 		ccwNodeList[i++] = q->oppositeNode( shared_from_this() );
 		e = elem->neighborEdge( shared_from_this(), e );
 		elem = elem->neighbor( e );
@@ -523,92 +625,98 @@ Node::meanNeighborEdgeLength()
 int
 Node::nrOfAdjElements()
 {
-	auto list = adjElements();
-	return static_cast<int>(list.size());
+	return static_cast<int>(adjElements().size());
 }
 
-//TODO: Tests
-ArrayList<std::shared_ptr<Element>> 
-Node::adjElements()
+void
+Node::buildStarTopology()
 {
-	ArrayList<std::shared_ptr<Element>> list;
+	starElements.clear();
+	starQuads.clear();
+	starTriangles.clear();
 
-	for ( auto element : edgeList )
+	for ( const auto& e : edgeList )
 	{
-		auto e = element;
-		if ( !list.contains( e->element1 ) )
+		if ( !starElements.contains( e->element1 ) )
 		{
-			list.add( e->element1 );
+			starElements.add( e->element1 );
 		}
-		if ( e->element2 != nullptr && !list.contains( e->element2 ) )
+		if ( e->element2 != nullptr && !starElements.contains( e->element2 ) )
 		{
-			list.add( e->element2 );
+			starElements.add( e->element2 );
+		}
+
+		if ( rcl::instanceOf<Quad>( e->element1 ) && !starQuads.contains( e->element1 ) )
+		{
+			starQuads.add( e->element1 );
+		}
+		else if ( e->element2 != nullptr && rcl::instanceOf<Quad>( e->element2 ) && !starQuads.contains( e->element2 ) )
+		{
+			starQuads.add( e->element2 );
+		}
+
+		auto Tri = rcl::triangleCast( e->element1 );
+		if ( Tri && !starTriangles.contains( Tri ) )
+		{
+			starTriangles.add( Tri );
+		}
+		else
+		{
+			Tri = rcl::triangleCast( e->element2 );
+			if ( Tri && !starTriangles.contains( Tri ) )
+			{
+				starTriangles.add( Tri );
+			}
 		}
 	}
-	return list;
+	starTopologyValid = true;
+}
+
+//TODO: Tests
+const ArrayList<std::shared_ptr<Element>>&
+Node::adjElements()
+{
+	if ( !starTopologyValid )
+	{
+		buildStarTopology();
+	}
+	return starElements;
 }
 
 //TODO: Tests
 int 
 Node::nrOfAdjQuads()
 {
-	auto list = adjQuads();
-	return static_cast<int>(list.size());
+	return static_cast<int>(adjQuads().size());
 }
 
 //TODO: Tests
-ArrayList<std::shared_ptr<Element>> 
+const ArrayList<std::shared_ptr<Element>>&
 Node::adjQuads()
 {
-	ArrayList<std::shared_ptr<Element>> list;
-
-	for ( auto element : edgeList )
+	if ( !starTopologyValid )
 	{
-		auto e = element;
-		if ( rcl::instanceOf<Quad>( e->element1 ) && !list.contains( e->element1 ) )
-		{
-			list.add( e->element1 );
-		}
-		else if ( e->element2 != nullptr && rcl::instanceOf<Quad>( e->element2 ) && !list.contains( e->element2 ) )
-		{
-			list.add( e->element2 );
-		}
+		buildStarTopology();
 	}
-	return list;
+	return starQuads;
 }
 
 //TODO: Tests
 int 
 Node::nrOfAdjTriangles()
 {
-	auto list = adjTriangles();
-	return static_cast<int>( list.size() );
+	return static_cast<int>( adjTriangles().size() );
 }
 
 //TODO: Tests
-ArrayList<std::shared_ptr<Triangle>>
+const ArrayList<std::shared_ptr<Triangle>>&
 Node::adjTriangles()
 {
-	ArrayList<std::shared_ptr<Triangle>> list;
-
-	for ( int i = 0; i < edgeList.size(); i++ )
+	if ( !starTopologyValid )
 	{
-		auto e = edgeList.get( i );
-		auto Tri = std::dynamic_pointer_cast<Triangle>( e->element1 );
-		if ( Tri && !list.contains( Tri ) )
-		{
-			list.add( Tri );
-		}
-		else
-		{
-			Tri = std::dynamic_pointer_cast<Triangle>( e->element2 );
-			if ( Tri && !list.contains( Tri ) )
-			{
-				list.add( Tri );
-			}
-		}
+		buildStarTopology();
 	}
-	return list;
+	return starTriangles;
 }
 
 //TODO: Tests
@@ -771,7 +879,7 @@ Node::blackerSmooth( const std::shared_ptr<Node>& nJ,
 
 	for ( auto adjQuad : adjQuads )
 	{
-		auto q = std::dynamic_pointer_cast<Quad>(adjQuad);
+		auto q = rcl::quadCast(adjQuad);
 
 		auto n1 = q->edgeList[base]->leftNode;
 		auto n2 = q->edgeList[base]->rightNode;
@@ -1269,32 +1377,18 @@ Node::inHalfplane( const std::shared_ptr<Node>& l1,
 {
 	Msg::debug( "Entering Node.inHalfplane(..)" );
 	Msg::debug( "l1: " + l1->descr() + ", l2: " + l2->descr() + ", n:" + n->descr() );
-	double x1 = l1->x;
-	double y1 = l1->y;
-	double x2 = l2->x;
-	double y2 = l2->y;
-	double x3 = x;
-	double y3 = y;
-	double x4 = n->x;
-	double y4 = n->y;
-
-	double zero = 0.0;
-	double l_cross_r = (x1 * y2) - (x2 * y1);
-	double xdiff = x1 - x2;
-	double ydiff = y1 - y2;
-	double det1 = l_cross_r - (xdiff * y3) + (ydiff * x3);
-
-	int eval1 = rcl::compareTo( det1, zero );
+	// Both determinants are evaluated with the adaptive predicates, so a node
+	// close to the line l1-l2 is never put on the wrong side of it.
+	int eval1 = rcl::orientation( l1->x, l1->y, l2->x, l2->y, x, y );
 	if ( eval1 == 0 )
 	{
 		Msg::debug( "Leaving Node.inHalfplane(..)" );
 		return 0;
 	}
 
-	double det2 = l_cross_r - (xdiff * y4) + (ydiff * x4);
-	int eval2 = rcl::compareTo( det2, zero );
+	int eval2 = rcl::orientation( l1->x, l1->y, l2->x, l2->y, n->x, n->y );
 	Msg::debug( "Leaving Node.inHalfplane(..)" );
-	if ( (eval1 < 0 && eval2 < 0) || (eval1 > 0 && eval2 > 0) )
+	if ( eval1 == eval2 )
 	{
 		return 1;
 	}
@@ -1375,48 +1469,19 @@ Node::inCircle( const std::shared_ptr<Node>& p1,
 {
 	Msg::debug( "Entering inCircle(..)" );
 
-	//
-	// a * b = a_1*b_1 + a_2*b_2 Scalar product a x b = (a_1*b_2 - b_1*a_2) Vector
-	// product
-	//
-	// e_3 is the unit vector (0,0,1). All the points are defined in 3D space, with
-	// z-values equal to 0. The v_i vectors are unit vectors. The points are ccw
-	// ordered.
-	//
-	// sin(alpha) = (v_1 x v_2) * e_3= x3y1 -x3y2 -x2y1 -y3x1 +y3x2 +y2x1 sin(beta)
-	// = (v_3 x v_4) * e_3= y3x1 -x1y4 -x4y3 -x3y1 +y1x4 +y4x3 cos(alpha) = v_1 *
-	// v_2 = (x3 -x2)(x1 -x2) +(y3 -y2)(y1 -y2) cos(beta) = v_3 * v_4 = (x1 -x4)(x3
-	// -x4) +(y1 -y4)(y3 -y4)
-	//
-	//
-
-	double cosAlpha = (p3->x - p2->x) * (p1->x - p2->x) + (p3->y - p2->y) * (p1->y - p2->y);
-	double cosBeta = (p1->x - x) * (p3->x - x) + (p1->y - y) * (p3->y - y);
-
-	if ( cosAlpha < 0 && cosBeta < 0 )
-	{ // (if both angles > than 90 degrees)
-		Msg::debug( "Leaving inCircle(..), cosAlpha && cosBeta <0, return true" );
+	// The angle sum alpha + beta exceeds 180 degrees exactly when this Node lies
+	// strictly inside the circumcircle of p1, p2 and p3. Evaluating the sign of
+	// the incircle determinant adaptively gives the same answer, but without
+	// the roundoff that made cocircular points flip back and forth.
+	if ( rcl::inCircumcircle( p1->x, p1->y, p2->x, p2->y, p3->x, p3->y, x, y ) )
+	{
+		Msg::debug( "Leaving inCircle(..), passed last check, returns true" );
 		return true;
 	}
-	else if ( cosAlpha > 0 && cosBeta > 0 )
-	{ // (if both angles < than 90 degrees)
-		Msg::debug( "Leaving inCircle(..), cosAlpha && cosBeta >0, return false" );
-		return false;
-	}
 	else
 	{
-		double sinAlpha = p3->x * p1->y - p3->x * p2->y - p2->x * p1->y - p3->y * p1->x + p3->y * p2->x + p2->y * p1->x;
-		double sinBeta = p3->y * p1->x - p1->x * y - x * p3->y - p3->x * p1->y + p1->y * x + y * p3->x;
-		if ( cosAlpha * sinBeta + sinAlpha * cosBeta < 0 )
-		{
-			Msg::debug( "Leaving inCircle(..), passed last check, returns true" );
-			return true;
-		}
-		else
-		{
-			Msg::debug( "Leaving inCircle(..), failed last check, returns false" );
-			return false;
-		}
+		Msg::debug( "Leaving inCircle(..), failed last check, returns false" );
+		return false;
 	}
 }
 
@@ -1444,6 +1509,7 @@ Node::merge( const std::shared_ptr<Node>& n )
 			}
 		}
 	}
+	invalidateStar();
 	n->setXY( *oldN );
 }
 
@@ -1674,7 +1740,7 @@ Node::patternMatch( const std::vector<uint8_t>& pattern2 )
 		}
 		if ( matches == pattern2[0] - 2 )
 		{
-			Msg::debug( "Leaving patternMatch(..): match, returns: " + jstart );
+			Msg::debug( "Leaving patternMatch(..): match, returns: " + std::to_string( jstart ) );
 			return jstart; // Search completed, patterns match
 		}
 		jstart += 2;
@@ -1909,7 +1975,7 @@ Node::surroundingAngles( const std::vector<std::shared_ptr<Node>>& ccwNeighbors,
 
 			const auto& ep = commonEdge( np );
 			const auto& en = commonEdge( nn );
-			const auto& q = std::dynamic_pointer_cast<Quad>(ep->commonElement( en ));
+			const auto& q = rcl::quadCast(ep->commonElement( en ));
 
 			const auto& no = q->oppositeNode( shared_from_this() );
 			angles[i] = q->ang[q->angleIndex( no )];
@@ -1917,8 +1983,8 @@ Node::surroundingAngles( const std::vector<std::shared_ptr<Node>>& ccwNeighbors,
 		else
 		{
 			const auto& no = e->otherNode( shared_from_this() );
-			const auto& qa = std::dynamic_pointer_cast<Quad>(e->element1);
-			const auto& qb = std::dynamic_pointer_cast<Quad>(e->element2);
+			const auto& qa = rcl::quadCast(e->element1);
+			const auto& qb = rcl::quadCast(e->element2);
 
 			angles[i] = qa->ang[qa->angleIndex( no )] + qb->ang[qb->angleIndex( no )];
 		}
@@ -2008,13 +2074,13 @@ Node::boundaryPatternMatchSpecial( const std::vector<uint8_t>& pattern2,
 	for ( k = 2; k < pattern[0]; k++ )
 	{
 
-		Msg::debug( "...k== " + k );
+		Msg::debug( "...k== " + std::to_string( k ) );
 		j = k;
 		match = true;
 
 		for ( i = 2; i < pattern[0]; i++ )
 		{
-			Msg::debug( "...i== " + i );
+			Msg::debug( "...i== " + std::to_string( i ) );
 
 			Msg::debug( "...pattern[" + std::to_string( j ) + "]== " + std::to_string( pattern[j] ) );
 			Msg::debug( "...pattern2[" + std::to_string( i ) + "]== " + std::to_string( pattern2[i] ) );
@@ -2,8 +2,13 @@
 
 #include "Constants.h"
 #include "ArrayList.h"
+#include "LiveCount.h"
 #include "Numbers.h"
+#include "Vec2.h"
+#include "WeakLink.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -24,18 +29,47 @@ class Node:
 {
 private:
 	int mNumber = 0;
+
+	// The cached star of this node. The topological part (the adjacent
+	// elements) stays valid until an edge or element at this node is
+	// connected, disconnected or replaced. The ccw ordering also depends on
+	// the positions of the nodes around this one, and is dropped as well when
+	// any of them moves. The cache holds strong references back into the
+	// mesh, so a change of topology empties it, and a node that leaves the
+	// mesh does not keep its old elements alive.
+	ArrayList<std::shared_ptr<Element>> starElements;
+	ArrayList<std::shared_ptr<Element>> starQuads;
+	ArrayList<std::shared_ptr<Triangle>> starTriangles;
+	ArrayList<std::shared_ptr<Edge>> starCCWEdges;
+	std::vector<std::shared_ptr<Node>> starNeighbors;
+	// The flags share a word with movedByOBS, color and snapshotIndex below
+	bool starTopologyValid : 1 = false;
+	bool starGeometryValid : 1 = false;
+	bool starCCWEdgesValid : 1 = false;
+	bool starNeighborsValid : 1 = false;
+
+	void buildStarTopology();
+
 public:
 	/** Boolean indicating whether the node has been moved by the OBS */
 	bool movedByOBS = false; // Used by the smoother
+	Color color = Color::Cyan;
+	LiveCount<Node> liveCount;
+	// The number of this node in the last MeshSnapshot taken of its mesh
+	uint32_t snapshotIndex = 0;
 	/** The coordinates */
 	double x, y;
 	/** A valence pattern for this node */
 	std::vector<uint8_t> pattern;
 	// byte state= 0; // For front Nodes only
-	ArrayList<std::shared_ptr<Edge>> edgeList;
-	Color color = Color::Cyan;
+	// The edges at this node. They are owned by the edgeList of GeomBasics
+	// and by their elements, not by the node.
+	ArrayList<WeakLink<Edge>> edgeList;
+	// A number given to this node when it is made, unique among the nodes
+	uint64_t id = lastId.fetch_add( 1, std::memory_order_relaxed ) + 1;
     
-    inline static int mLastNumber = 0;
+    inline static std::atomic<int> mLastNumber = 0;
+	inline static std::atomic<uint64_t> lastId = 0;
 	
 	Node() :
 		x(0.0),
@@ -65,10 +99,19 @@ public:
 		return rcl::equal( other.x, x ) && rcl::equal( other.y, y );
 	}
 
+	/** @return the position of this node as a value */
+	Point2 point() const
+	{
+		return { x, y };
+	}
+
 	/** @return a "real" copy of this node with a shallow copy of its edgeList. */
 	std::shared_ptr<Node> copy();
 
-	/** @return a new node with the same position as this. */
+	/**
+	 * @return a new node with the same position as this, made in scratch memory
+	 *         for keeping an old position during the current step.
+	 */
 	std::shared_ptr<Node> copyXY();
 
 	/** Relocate this node to the same position as n. */
@@ -102,8 +145,40 @@ public:
 
 	void connectToEdge( const std::shared_ptr<Edge>& edge );
 
+	/**
+	 * Drop the cached star of this node. Must be called whenever an edge is
+	 * added to or removed from edgeList, or an edge in edgeList gets a new
+	 * element. The methods of Node, Edge and the elements that do so call it
+	 * themselves.
+	 */
+	void invalidateStar();
+
+	/**
+	 * Drop the cached ccw orderings of this node and of the nodes of all
+	 * elements adjacent to it, after this node has moved.
+	 */
+	void invalidateStarGeometry();
+
+	/**
+	 * @return the bytes held by this node in heap blocks of its own: its
+	 *         pattern, edgeList and cached star
+	 */
+	size_t heapBytes() const;
+
+	/**
+	 * Drop the edges and the cached star of this node, so that none of them is
+	 * kept alive by it. Used when the whole mesh is released.
+	 */
+	void releaseLinks();
+
 	// Rewrite of ccwSortedEdgeList().
-	// We use vector representations instead of the edges directly.
+	// The edges at this node in ccw order. The order is decided on Vec2 values
+	// of the edges and cached, and the cached list is returned, so that it
+	// is only valid until the star of this node changes.
+	const ArrayList<std::shared_ptr<Edge>>& ccwSortedEdges();
+
+	// The edges of ccwSortedEdges() as vectors from this node, created anew
+	// on every call.
 	ArrayList<std::shared_ptr<MyVector>> ccwSortedVectorList();
 
 	 /**
@@ -124,22 +199,22 @@ public:
 	 * @return a ccw sorted list of the neighboring nodes to this, but returns null
 	 *         if this node is part of any triangle.
 	 */
-	std::vector<std::shared_ptr<Node>> ccwSortedNeighbors();
+	const std::vector<std::shared_ptr<Node>>& ccwSortedNeighbors();
 	
 	double meanNeighborEdgeLength();
 
 	int nrOfAdjElements();
 
-	ArrayList<std::shared_ptr<Element>> adjElements();
+	const ArrayList<std::shared_ptr<Element>>& adjElements();
 
 	int nrOfAdjQuads();
 	
-	ArrayList<std::shared_ptr<Element>> adjQuads();
+	const ArrayList<std::shared_ptr<Element>>& adjQuads();
 
 	int nrOfAdjTriangles();
 
 	// Hmm. Should I include fake quads as well?
-	ArrayList<std::shared_ptr<Triangle>> adjTriangles();
+	const ArrayList<std::shared_ptr<Triangle>>& adjTriangles();
 
 	/**
 	 * Classic Laplacian smooth. Of course, to be run on internal nodes only.
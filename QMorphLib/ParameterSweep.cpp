@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "ParameterSweep.h"
+
+#include "GeomBasics.h"
+#include "QMorph.h"
+#include "ThreadPool.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Quad.h"
+#include "Triangle.h"
+#include "Types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <limits>
+
+//TODO: Tests
+ParameterSweep::ParameterSweep()
+{
+}
+
+//TODO: Tests
+std::vector<ParameterSweep::Result>
+ParameterSweep::run( const std::vector<QMorphOptions>& configs, unsigned nThreads ) const
+{
+	if ( nThreads == 0 )
+	{
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+	nThreads = std::max( 1u, std::min( nThreads, static_cast<unsigned>(configs.size()) ) );
+
+	std::vector<std::future<Result>> futures;
+	{
+		ThreadPool pool( nThreads );
+		for ( const auto& opts : configs )
+		{
+			futures.push_back( pool.submit( [this, opts]() {
+				Result r;
+				r.options = opts;
+				auto mesh = input.copy();
+
+				auto start = std::chrono::steady_clock::now();
+				auto meshed = QMorph::meshOnThisThread( mesh, opts, -1, 0.0, false );
+				r.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+				double sum = 0.0, minDM = std::numeric_limits<double>::max();
+				auto measure = [&]( const std::shared_ptr<Element>& elem ) {
+					elem->updateDistortionMetric();
+					sum += elem->distortionMetric;
+					minDM = std::min( minDM, elem->distortionMetric );
+				};
+				for ( const auto& elem : meshed.elements )
+				{
+					if ( elem == nullptr )
+					{
+						continue;
+					}
+					auto q = rcl::quadCast(elem);
+					if ( q != nullptr && !q->isFake )
+					{
+						r.quads++;
+					}
+					else
+					{
+						r.triangles++;
+					}
+					measure( elem );
+				}
+				for ( const auto& t : meshed.triangles )
+				{
+					if ( t != nullptr )
+					{
+						r.triangles++;
+						measure( t );
+					}
+				}
+				size_t n = r.quads + r.triangles;
+				r.averageMetric = n > 0 ? sum / n : 0.0;
+				r.minMetric = n > 0 ? minDM : 0.0;
+				return r;
+			} ) );
+		}
+	}
+
+	std::vector<Result> results;
+	for ( auto& f : futures )
+	{
+		results.push_back( f.get() );
+	}
+	return results;
+}
+
+//TODO: Tests
+std::string
+ParameterSweep::report( const std::vector<Result>& results )
+{
+	std::string s = "seconds  quads  tris  avg metric  min metric  options\n";
+	char line[96];
+	for ( const auto& r : results )
+	{
+		std::snprintf( line, sizeof( line ), "%7.3f  %5zu  %4zu  %10.6f  %10.6f  ", r.seconds, r.quads, r.triangles, r.averageMetric, r.minMetric );
+		s += line + r.options.descr() + "\n";
+	}
+	return s;
+}
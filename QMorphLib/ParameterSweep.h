@@ -0,0 +1,55 @@
+#pragma once
+
+#include "MeshSnapshot.h"
+#include "QMorphOptions.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Runs QMorph on one triangle mesh with many sets of options, concurrently, and
+ * reports the quality of each resulting mesh against the time it took.
+ *
+ * The input is taken once from the GeomBasics lists as a MeshSnapshot, which
+ * the runs only read. Each run meshes a copy of its own made from the snapshot
+ * in the thread_local lists of a worker thread, so the runs share nothing but
+ * the snapshot.
+ *
+ * A run that fails in QMorph ends the process through Msg::error(..), as a
+ * sequential run would.
+ */
+
+class ParameterSweep
+{
+public:
+	/** The outcome of one run */
+	struct Result
+	{
+		QMorphOptions options;
+		// The wall clock time of the run, the copying of the input excluded
+		double seconds = 0.0;
+		size_t quads = 0;
+		size_t triangles = 0;
+		double averageMetric = 0.0;
+		double minMetric = 0.0;
+	};
+
+	/** Take the triangle mesh in the GeomBasics lists as the input of the sweep. */
+	ParameterSweep();
+
+	/**
+	 * Mesh the input once with each of configs.
+	 *
+	 * @param nThreads the number of worker threads, or 0 for one per hardware
+	 *                 thread
+	 * @return the results, in the order of configs
+	 */
+	std::vector<Result> run( const std::vector<QMorphOptions>& configs,
+							 unsigned nThreads = 0 ) const;
+
+	/** @return a table of the results, one line each */
+	static std::string report( const std::vector<Result>& results );
+
+private:
+	MeshSnapshot input;
+};
@@ -0,0 +1,299 @@
+#include "pch.h"
+#include "Predicates.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	// Half an ulp of 1.0, the unit roundoff of IEEE double arithmetic.
+	constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+
+	constexpr double ccwerrboundA = (3.0 + 16.0 * epsilon) * epsilon;
+	constexpr double iccerrboundA = (10.0 + 96.0 * epsilon) * epsilon;
+
+	// An expansion is a sum of non-overlapping doubles, stored in order of
+	// increasing magnitude and without zero components.
+	using Expansion = std::vector<double>;
+
+	void
+	twoSum( double a, double b, double& x, double& y )
+	{
+		x = a + b;
+		double bVirtual = x - a;
+		double aVirtual = x - bVirtual;
+		double bRoundoff = b - bVirtual;
+		double aRoundoff = a - aVirtual;
+		y = aRoundoff + bRoundoff;
+	}
+
+	void
+	fastTwoSum( double a, double b, double& x, double& y )
+	{
+		x = a + b;
+		double bVirtual = x - a;
+		y = b - bVirtual;
+	}
+
+	void
+	twoProduct( double a, double b, double& x, double& y )
+	{
+		x = a * b;
+		y = std::fma( a, b, -x );
+	}
+
+	Expansion
+	twoDiff( double a, double b )
+	{
+		double x, y;
+		twoSum( a, -b, x, y );
+		Expansion e;
+		if ( y != 0.0 )
+		{
+			e.push_back( y );
+		}
+		if ( x != 0.0 )
+		{
+			e.push_back( x );
+		}
+		return e;
+	}
+
+	void
+	growExpansion( Expansion& e, double b )
+	{
+		Expansion h;
+		h.reserve( e.size() + 1 );
+		double q = b, hh;
+		for ( double ei : e )
+		{
+			twoSum( q, ei, q, hh );
+			if ( hh != 0.0 )
+			{
+				h.push_back( hh );
+			}
+		}
+		if ( q != 0.0 )
+		{
+			h.push_back( q );
+		}
+		e.swap( h );
+	}
+
+	Expansion
+	sum( const Expansion& e, const Expansion& f )
+	{
+		Expansion h = e;
+		for ( double fi : f )
+		{
+			growExpansion( h, fi );
+		}
+		return h;
+	}
+
+	Expansion
+	diff( const Expansion& e, const Expansion& f )
+	{
+		Expansion h = e;
+		for ( double fi : f )
+		{
+			growExpansion( h, -fi );
+		}
+		return h;
+	}
+
+	Expansion
+	scale( const Expansion& e, double b )
+	{
+		Expansion h;
+		if ( e.empty() || b == 0.0 )
+		{
+			return h;
+		}
+		h.reserve( 2 * e.size() );
+
+		double q, hh, product1, product0, s;
+		twoProduct( e[0], b, q, hh );
+		if ( hh != 0.0 )
+		{
+			h.push_back( hh );
+		}
+		for ( size_t i = 1; i < e.size(); i++ )
+		{
+			twoProduct( e[i], b, product1, product0 );
+			twoSum( q, product0, s, hh );
+			if ( hh != 0.0 )
+			{
+				h.push_back( hh );
+			}
+			fastTwoSum( product1, s, q, hh );
+			if ( hh != 0.0 )
+			{
+				h.push_back( hh );
+			}
+		}
+		if ( q != 0.0 )
+		{
+			h.push_back( q );
+		}
+		return h;
+	}
+
+	Expansion
+	product( const Expansion& e, const Expansion& f )
+	{
+		Expansion h;
+		for ( double fi : f )
+		{
+			h = sum( h, scale( e, fi ) );
+		}
+		return h;
+	}
+
+	// The largest component carries the sign, the others refine the magnitude.
+	double
+	estimate( const Expansion& e )
+	{
+		double s = 0.0;
+		for ( double ei : e )
+		{
+			s += ei;
+		}
+		return s;
+	}
+
+	double
+	cross2dExact( double o1x, double o1y, double p1x, double p1y,
+				  double o2x, double o2y, double p2x, double p2y )
+	{
+		auto x1 = twoDiff( p1x, o1x ), y1 = twoDiff( p1y, o1y );
+		auto x2 = twoDiff( p2x, o2x ), y2 = twoDiff( p2y, o2y );
+		return estimate( diff( product( x1, y2 ), product( y1, x2 ) ) );
+	}
+
+	double
+	incircleExact( double ax, double ay, double bx, double by,
+				   double cx, double cy, double dx, double dy )
+	{
+		auto adx = twoDiff( ax, dx ), ady = twoDiff( ay, dy );
+		auto bdx = twoDiff( bx, dx ), bdy = twoDiff( by, dy );
+		auto cdx = twoDiff( cx, dx ), cdy = twoDiff( cy, dy );
+
+		auto bc = diff( product( bdx, cdy ), product( cdx, bdy ) );
+		auto ca = diff( product( cdx, ady ), product( adx, cdy ) );
+		auto ab = diff( product( adx, bdy ), product( bdx, ady ) );
+
+		auto alift = sum( product( adx, adx ), product( ady, ady ) );
+		auto blift = sum( product( bdx, bdx ), product( bdy, bdy ) );
+		auto clift = sum( product( cdx, cdx ), product( cdy, cdy ) );
+
+		auto det = sum( sum( product( alift, bc ), product( blift, ca ) ), product( clift, ab ) );
+		return estimate( det );
+	}
+}
+
+double
+rcl::cross2d( double o1x, double o1y, double p1x, double p1y,
+			  double o2x, double o2y, double p2x, double p2y )
+{
+	double detleft = (p1x - o1x) * (p2y - o2y);
+	double detright = (p1y - o1y) * (p2x - o2x);
+	double det = detleft - detright;
+	double detsum;
+
+	// If the two products have different signs no cancellation can occur
+	if ( detleft > 0.0 )
+	{
+		if ( detright <= 0.0 )
+		{
+			return det;
+		}
+		detsum = detleft + detright;
+	}
+	else if ( detleft < 0.0 )
+	{
+		if ( detright >= 0.0 )
+		{
+			return det;
+		}
+		detsum = -detleft - detright;
+	}
+	else
+	{
+		return det;
+	}
+
+	double errbound = ccwerrboundA * detsum;
+	if ( det >= errbound || -det >= errbound )
+	{
+		return det;
+	}
+	return cross2dExact( o1x, o1y, p1x, p1y, o2x, o2y, p2x, p2y );
+}
+
+double
+rcl::orient2d( double ax, double ay,
+			   double bx, double by,
+			   double cx, double cy )
+{
+	return cross2d( cx, cy, ax, ay, cx, cy, bx, by );
+}
+
+double
+rcl::incircle( double ax, double ay,
+			   double bx, double by,
+			   double cx, double cy,
+			   double dx, double dy )
+{
+	double adx = ax - dx, ady = ay - dy;
+	double bdx = bx - dx, bdy = by - dy;
+	double cdx = cx - dx, cdy = cy - dy;
+
+	double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	double alift = adx * adx + ady * ady;
+
+	double cdxady = cdx * ady, adxcdy = adx * cdy;
+	double blift = bdx * bdx + bdy * bdy;
+
+	double adxbdy = adx * bdy, bdxady = bdx * ady;
+	double clift = cdx * cdx + cdy * cdy;
+
+	double det = alift * (bdxcdy - cdxbdy)
+		+ blift * (cdxady - adxcdy)
+		+ clift * (adxbdy - bdxady);
+
+	double permanent = (std::abs( bdxcdy ) + std::abs( cdxbdy )) * alift
+		+ (std::abs( cdxady ) + std::abs( adxcdy )) * blift
+		+ (std::abs( adxbdy ) + std::abs( bdxady )) * clift;
+	double errbound = iccerrboundA * permanent;
+	if ( det > errbound || -det > errbound )
+	{
+		return det;
+	}
+	return incircleExact( ax, ay, bx, by, cx, cy, dx, dy );
+}
+
+int
+rcl::orientation( double ax, double ay,
+				  double bx, double by,
+				  double cx, double cy )
+{
+	double det = orient2d( ax, ay, bx, by, cx, cy );
+	return (det > 0.0) - (det < 0.0);
+}
+
+bool
+rcl::inCircumcircle( double ax, double ay,
+					 double bx, double by,
+					 double cx, double cy,
+					 double dx, double dy )
+{
+	int orient = orientation( ax, ay, bx, by, cx, cy );
+	if ( orient == 0 )
+	{
+		return false;
+	}
+	double det = incircle( ax, ay, bx, by, cx, cy, dx, dy );
+	return orient > 0 ? det > 0.0 : det < 0.0;
+}
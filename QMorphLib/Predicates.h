@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * Adaptive-precision geometric predicates, after J. R. Shewchuk, "Adaptive
+ * Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+ *
+ * Each predicate first evaluates the determinant in plain double arithmetic
+ * and compares it against a forward error bound. Only when the result is too
+ * close to zero to trust is it recomputed exactly with expansion arithmetic.
+ * The sign of the returned value is therefore always correct, while its
+ * magnitude is an approximation of the true determinant.
+ */
+
+namespace rcl
+{
+	/**
+	 * The cross product (p1 - o1) x (p2 - o2) with a guaranteed correct sign.
+	 *
+	 * @return a positive value if (p2 - o2) is ccw to (p1 - o1), a negative value
+	 *         if it is cw and 0 if the two vectors are parallel.
+	 */
+	double cross2d( double o1x, double o1y, double p1x, double p1y,
+					double o2x, double o2y, double p2x, double p2y );
+
+	/**
+	 * @return a positive value if a, b and c are in ccw order, a negative value if
+	 *         they are in cw order and 0 if they are collinear.
+	 */
+	double orient2d( double ax, double ay,
+					 double bx, double by,
+					 double cx, double cy );
+
+	/**
+	 * @return a positive value if d lies inside the circle through a, b and c, a
+	 *         negative value if it lies outside and 0 if the four points are
+	 *         cocircular. The points a, b and c must be in ccw order, otherwise
+	 *         the sign is reversed.
+	 */
+	double incircle( double ax, double ay,
+					 double bx, double by,
+					 double cx, double cy,
+					 double dx, double dy );
+
+	/** @return the sign (-1, 0 or 1) of orient2d(..) */
+	int orientation( double ax, double ay,
+					 double bx, double by,
+					 double cx, double cy );
+
+	/**
+	 * The conflict test of Bowyer-Watson insertion, shared by DelaunayMeshGen
+	 * and IndexedDelaunay.
+	 *
+	 * @return true if d lies strictly inside the circle through a, b and c, in
+	 *         whichever order these are given. False if a, b and c are collinear.
+	 */
+	bool inCircumcircle( double ax, double ay,
+						 double bx, double by,
+						 double cx, double cy,
+						 double dx, double dy );
+}
@@ -12,6 +12,18 @@
 #include "Ray.h"
 #include "Msg.h"
 #include "Types.h"
+#include "MeshComponents.h"
+#include "DomainDecomposition.h"
+#include "DelaunayMeshGen.h"
+#include "MeshCavity.h"
+#include "ThreadPool.h"
+#include "ScratchArena.h"
+
+//TODO: Tests
+QMorph::QMorph( const QMorphOptions& options ) :
+	m_options( options )
+{
+}
 
 //TODO: Tests
 void 
@@ -28,12 +40,12 @@ QMorph::init( int step_limit, double mesh_size, bool skip_last_smooth)
 
 	if ( doCleanUp )
 	{
-		topoCleanup = std::make_shared<TopoCleanup>();
+		topoCleanup = std::make_shared<TopoCleanup>( m_options );
 	}
 
 	if ( doSmooth )
 	{
-		m_globalSmooth = std::make_shared<GlobalSmooth>();
+		m_globalSmooth = std::make_shared<GlobalSmooth>( m_options );
 	}
 
 	if ( doTri2QuadConversion )
@@ -44,6 +56,7 @@ QMorph::init( int step_limit, double mesh_size, bool skip_last_smooth)
 		level = 0;
 
 		repairZeroAreaTriangles();
+		edgeList.setGrid( std::make_shared<EdgeGrid>( edgeList ) );
 
 		if ( !verifyTriangleMesh( triangleList ) )
 		{
@@ -51,7 +64,9 @@ QMorph::init( int step_limit, double mesh_size, bool skip_last_smooth)
 		}
 
 		Edge::clearStateList();
-		frontList = defineInitFronts( edgeList );
+		frontList.clear();
+		defineInitFronts( edgeList, frontList );
+		frontLoops = std::make_shared<FrontLoops>( frontList );
 		Msg::debug( "Initial front list (size==" + std::to_string( frontList.size() ) + "):" );
 		printEdgeList( frontList );
 		classifyStateOfAllFronts( frontList );
@@ -78,7 +93,7 @@ QMorph::init( int step_limit, double mesh_size, bool skip_last_smooth)
 	}
 }
 
-static int stepcount = 0;
+static thread_local int stepcount = 0;
 
 //TODO: Tests
 void 
@@ -93,15 +108,7 @@ QMorph::run()
 			Msg::debug( "---------------------------------------------------" );
 
 			stepcount = 0;
-			// The program's main loop from where all the real action originates
-            finished = m_step_limit != -1 && stepcount == m_step_limit;
-			while ( !finished )
-			{
-				step();
-				if ( m_step_limit != -1 && stepcount == m_step_limit )
-					finished = true;
-			}
-
+			runSteps();
 		}
 	}
     else if (!m_step && m_step_limit != -1)
@@ -124,6 +131,316 @@ QMorph::run()
 	}
 }
 
+//TODO: Tests
+void
+QMorph::runSteps()
+{
+	// The program's main loop from where all the real action originates
+	finished = m_step_limit != -1 && stepcount == m_step_limit;
+	while ( !finished )
+	{
+		step();
+		if ( m_step_limit != -1 && stepcount == m_step_limit )
+		{
+			finished = true;
+		}
+		else if ( checkpointInterval > 0 && stepcount % checkpointInterval == 0 && !finished )
+		{
+			Checkpoint::saveIfEnabled( Checkpoint::Phase::Morph, this );
+		}
+	}
+	compactLists();
+}
+
+//TODO: Tests
+void
+QMorph::finishRun()
+{
+	if ( doSmooth )
+	{
+		m_globalSmooth->init();
+		m_globalSmooth->run();
+	}
+
+	Msg::debug( "The final elements are:" );
+	printElements( elementList );
+	finished = true;
+}
+
+//TODO: Tests
+void
+QMorph::resume( const std::string& filename, int step_limit )
+{
+	Checkpoint::Phase phase;
+	if ( !Checkpoint::load( filename, *this, phase ) )
+	{
+		Msg::error( "Cannot resume from checkpoint " + filename );
+	}
+	m_step_limit = step_limit;
+
+	if ( doCleanUp && topoCleanup == nullptr )
+	{
+		topoCleanup = std::make_shared<TopoCleanup>( m_options );
+	}
+	if ( doSmooth )
+	{
+		m_globalSmooth = std::make_shared<GlobalSmooth>( m_options );
+	}
+	// The grid only holds live edges, so drop the tombstones the snapshot kept
+	compactLists();
+	edgeList.setGrid( std::make_shared<EdgeGrid>( edgeList ) );
+
+	if ( phase == Checkpoint::Phase::Morph )
+	{
+		setCurMethod( shared_from_this() );
+		frontLoops = std::make_shared<FrontLoops>( frontList );
+		runSteps();
+	}
+	else if ( phase == Checkpoint::Phase::Cleanup )
+	{
+		setCurMethod( topoCleanup );
+		topoCleanup->run();
+		finishRun();
+	}
+	else if ( phase == Checkpoint::Phase::Smooth )
+	{
+		finishRun();
+	}
+	else
+	{
+		finished = true;
+	}
+}
+
+//TODO: Tests
+void
+QMorph::writeState( Checkpoint::Writer& w ) const
+{
+	w.flag( finished );
+	w.i32( level );
+	w.i32( nrOfFronts );
+	w.flag( evenInitNrOfFronts );
+	w.i32( stepcount );
+	w.f64( m_mesh_size );
+	w.flag( m_skip_last_smooth );
+	w.edges( frontList );
+}
+
+//TODO: Tests
+void
+QMorph::readState( Checkpoint::Reader& r )
+{
+	finished = r.flag();
+	level = r.i32();
+	nrOfFronts = r.i32();
+	evenInitNrOfFronts = r.flag();
+	stepcount = r.i32();
+	m_mesh_size = r.f64();
+	m_skip_last_smooth = r.flag();
+
+	frontList.clear();
+	for ( const auto& e : r.edges() )
+	{
+		if ( e != nullptr )
+		{
+			frontList.add( e );
+		}
+	}
+}
+
+//TODO: Tests
+void
+QMorph::runParallel( unsigned nThreads, int step_limit, double mesh_size, bool skip_last_smooth )
+{
+	std::vector<MeshComponents::Component> components;
+	// A checkpoint holds one mesh, so checkpointed runs stay on this thread
+	if ( doTri2QuadConversion && !m_step && checkpointFilename.empty() )
+	{
+		components = MeshComponents::split( triangleList, edgeList, nodeList );
+	}
+	if ( components.size() < 2 )
+	{
+		init( step_limit, mesh_size, skip_last_smooth );
+		run();
+		return;
+	}
+
+	Msg::debug( "Meshing " + std::to_string( components.size() ) + " mesh components in parallel" );
+
+	if ( nThreads == 0 )
+	{
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+	nThreads = std::min( nThreads, static_cast<unsigned>(components.size()) );
+
+	// Each task meshes its component in the thread_local lists of its worker
+	// thread, and leaves them empty for the next task
+	std::vector<std::future<MeshComponents::Component>> futures;
+	{
+		ThreadPool pool( nThreads );
+		for ( auto& c : components )
+		{
+			futures.push_back( pool.submit( [c = std::move( c ), opts = m_options, step_limit, mesh_size, skip_last_smooth]() {
+				return meshOnThisThread( c, opts, step_limit, mesh_size, skip_last_smooth );
+			} ) );
+		}
+	}
+
+	// The entities of the components live on in the results
+	detachLists();
+	for ( auto& f : futures )
+	{
+		auto result = f.get();
+		triangleList.addAll( result.triangles );
+		edgeList.addAll( result.edges );
+		nodeList.addAll( result.nodes );
+		elementList.addAll( result.elements );
+	}
+	findExtremeNodes();
+	finished = true;
+}
+
+//TODO: Tests
+void
+QMorph::runDecomposed( unsigned nSubdomains, unsigned nThreads, int step_limit, double mesh_size, bool skip_last_smooth )
+{
+	std::unique_ptr<DomainDecomposition> dd;
+	if ( doTri2QuadConversion && !m_step && checkpointFilename.empty() )
+	{
+		dd = std::make_unique<DomainDecomposition>( triangleList, edgeList, nodeList, nSubdomains );
+	}
+	if ( dd == nullptr || dd->size() < 2 )
+	{
+		init( step_limit, mesh_size, skip_last_smooth );
+		run();
+		return;
+	}
+
+	Msg::debug( "Meshing " + std::to_string( dd->size() ) + " subdomains in parallel" );
+
+	if ( nThreads == 0 )
+	{
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+	nThreads = std::min( nThreads, static_cast<unsigned>(dd->size()) );
+
+	std::vector<std::future<MeshComponents::Component>> futures;
+	{
+		ThreadPool pool( nThreads );
+		for ( size_t i = 0; i < dd->size(); i++ )
+		{
+			const auto& c = dd->subdomain( i );
+			futures.push_back( pool.submit( [&c, opts = m_options, step_limit, mesh_size, skip_last_smooth]() {
+				return meshOnThisThread( c, opts, step_limit, mesh_size, skip_last_smooth );
+			} ) );
+		}
+	}
+	std::vector<MeshComponents::Component> meshed;
+	for ( auto& f : futures )
+	{
+		meshed.push_back( f.get() );
+	}
+
+	MeshComponents::Component stitched;
+	ArrayList<std::shared_ptr<Node>> seam;
+	if ( !dd->stitch( meshed, stitched, seam ) )
+	{
+		Msg::warning( "The meshing of the subdomains changed their interfaces, meshing the whole domain instead" );
+		init( step_limit, mesh_size, skip_last_smooth );
+		run();
+		return;
+	}
+
+	detachLists();
+	triangleList.addAll( stitched.triangles );
+	edgeList.addAll( stitched.edges );
+	nodeList.addAll( stitched.nodes );
+	elementList.addAll( stitched.elements );
+	findExtremeNodes();
+
+	if ( doCleanUp )
+	{
+		topoCleanup = std::make_shared<TopoCleanup>( m_options );
+		topoCleanup->cleanupAlong( seam );
+		compactLists();
+		topoCleanup = nullptr;
+	}
+	finished = true;
+}
+
+//TODO: Tests
+bool
+QMorph::remeshAround( const ArrayList<std::shared_ptr<Node>>& changed, double band )
+{
+	MeshCavity cavity( changed, band );
+	if ( cavity.size() == 0 )
+	{
+		Msg::warning( "QMorph.remeshAround(..): no elements to mesh again" );
+		return false;
+	}
+	Msg::debug( "Meshing a cavity of " + std::to_string( cavity.size() ) + " elements again" );
+
+	// The cavity is meshed in the thread_local lists of a worker thread, which
+	// leaves the rest of the mesh in the lists of this one
+	std::future<MeshComponents::Component> future;
+	{
+		ThreadPool pool( 1 );
+		future = pool.submit( [&cavity, opts = m_options]() {
+			const auto& loops = cavity.getLoops();
+			auto gen = std::make_shared<DelaunayMeshGen>();
+			gen->setRefinement( [&cavity]( double x, double y ) { return cavity.edgeLength( x, y ); } );
+			gen->setKeepBoundary( true );
+			gen->runConstrained( loops[0], std::vector<ArrayList<std::shared_ptr<Node>>>( loops.begin() + 1, loops.end() ) );
+
+			MeshComponents::Component triangles;
+			triangles.triangles.addAll( triangleList );
+			triangles.edges.addAll( edgeList );
+			triangles.nodes.addAll( nodeList );
+			return meshOnThisThread( triangles, opts, -1, 0.0, false );
+		} );
+	}
+	auto meshed = future.get();
+
+	if ( !cavity.replace( meshed ) )
+	{
+		Msg::warning( "QMorph.remeshAround(..): the new mesh changed the boundary of the cavity, keeping the old one" );
+		return false;
+	}
+	compactLists();
+	return true;
+}
+
+//TODO: Tests
+MeshComponents::Component
+QMorph::meshOnThisThread( const MeshComponents::Component& c, const QMorphOptions& opts, int step_limit, double mesh_size, bool skip_last_smooth )
+{
+	detachLists();
+	leftmost = rightmost = uppermost = lowermost = nullptr;
+	triangleList.addAll( c.triangles );
+	edgeList.addAll( c.edges );
+	nodeList.addAll( c.nodes );
+
+	auto morph = std::make_shared<QMorph>( opts );
+	morph->init( step_limit, mesh_size, skip_last_smooth );
+	morph->run();
+
+	MeshComponents::Component result;
+	result.triangles.addAll( triangleList );
+	result.edges.addAll( edgeList );
+	result.nodes.addAll( nodeList );
+	result.elements.addAll( elementList );
+
+	// Leave the thread_local lists empty for the next task on this thread
+	edgeList.setGrid( nullptr );
+	detachLists();
+	leftmost = rightmost = uppermost = lowermost = nullptr;
+	Edge::clearStateList();
+	topoCleanup = nullptr;
+	m_globalSmooth = nullptr;
+	setCurMethod( nullptr );
+	return result;
+}
+
 //TODO: Tests
 void 
 QMorph::step()
@@ -136,9 +453,14 @@ QMorph::step()
 	e = Edge::getNextFront(/* frontList, */ );
 	if ( e != nullptr )
 	{
+		// The temporaries of the step are dropped together
+		ScratchArena::Scope scratch;
 		oldBaseState = e->getState();
 		if ( nrOfFronts <= 0 )
 		{
+			// clearQuad(..) only marks the triangles, edges and nodes it removes,
+			// so drop them from the lists once per level
+			compactLists();
 			level++;
 			nrOfFronts = countNOFrontsAtCurLowestLevel( frontList );
             for (auto& edge:frontList)
@@ -202,9 +524,17 @@ QMorph::step()
 		nrOfFronts -= i;
 		Msg::debug( "nr of fronts removed from lowest level: " + std::to_string( i ) );
 		Msg::debug( "nrOfFronts= " + std::to_string( nrOfFronts ) );
+
+		if ( m_step )
+		{
+			compactLists();
+		}
 	}
 	else if ( !finished )
 	{
+		frontLoops = nullptr;
+		compactLists();
+
 		// Post-processing methods
 		if ( doCleanUp )
 		{
@@ -212,6 +542,7 @@ QMorph::step()
 			if ( !m_step )
 			{
 				topoCleanup->run();
+				Checkpoint::saveIfEnabled( Checkpoint::Phase::Smooth, this );
 			}
 			else
 			{
@@ -220,15 +551,7 @@ QMorph::step()
 				return;
 			}
 		}
-		if ( doSmooth )
-		{
-			m_globalSmooth->init();
-			m_globalSmooth->run();
-		}
-
-		Msg::debug( "The final elements are:" );
-		printElements( elementList );
-		finished = true;
+		finishRun();
 	}
 }
 
@@ -282,6 +605,129 @@ QMorph::countFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
 	Msg::debug( "...side== " + side->descr() );
 	Msg::debug( "...otherSide== " + otherSide->descr() );
 
+	int count;
+	if ( frontLoops == nullptr || !lookUpFrontsInNewLoopAt( b, side, otherSide, count ) )
+	{
+		count = walkFrontsInNewLoopAt( b, side, otherSide );
+	}
+
+	Msg::debug( "Leaving int countFrontsInNewLoopAt(..), returns " + std::to_string( count ) );
+	return count;
+}
+
+//TODO: Tests
+bool
+QMorph::lookUpFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
+								 const std::shared_ptr<Edge>& side,
+								 const std::shared_ptr<Edge>& otherSide,
+								 int& count )
+{
+	auto n1 = side->commonNode( b ), n2 = otherSide->commonNode( b ), n3 = side->otherNode( n1 ), n4 = otherSide->otherNode( n2 );
+	int count2ndLoop = 1, count3rdLoop = 1, n3n4Edges = 0;
+	bool n4Inn3Loop = false;
+
+	// Step from b past n1 to the first front edge at n1 or n3. The walk checks
+	// n1 first, so a tie means both sides are in the loop.
+	auto cur = b->frontNeighborAt( n1 );
+	int dir = cur != nullptr ? frontLoops->direction( b, cur ) : 0;
+	if ( dir == 0 )
+	{
+		return false;
+	}
+	int toN1 = frontDistanceTo( b, dir, n1, 2 );
+	int toN3 = frontDistanceTo( b, dir, n3, 2 );
+	if ( toN3 != -1 && toN3 < toN1 )
+	{ // Case 1
+		count = toN3 + 1; // Add the new edge between n1 and n3
+		return true;
+	}
+	int count1stLoop = toN1;
+
+	// Case 2,3,4,5 or 6: step along the n3 loop, away from the side edge
+	auto prev = n3->anotherFrontEdge( nullptr );
+	cur = prev != nullptr ? prev->frontNeighborAt( n3 ) : nullptr;
+	if ( cur == nullptr )
+	{
+		return false;
+	}
+	if ( prev->computeCCWAngle( side ) < cur->computeCCWAngle( side ) )
+	{
+		std::swap( cur, prev );
+	}
+	dir = -frontLoops->direction( cur, prev );
+	int toN3Again = dir != 0 ? frontDistanceTo( cur, dir, n3, 1 ) : -1;
+	if ( toN3Again == -1 )
+	{
+		return false;
+	}
+	count2ndLoop += toN3Again;
+
+	if ( cur->hasNode( n4 ) )
+	{
+		n4Inn3Loop = true;
+		n3n4Edges = 1;
+	}
+	else
+	{
+		int toN4 = frontDistanceTo( cur, dir, n4, 1 );
+		if ( toN4 != -1 && toN4 <= toN3Again )
+		{
+			n4Inn3Loop = true;
+			n3n4Edges = 1 + toN4;
+		}
+	}
+
+	if ( !n4Inn3Loop && !otherSide->isFrontEdge() && n4->frontNode() )
+	{ // Case 5 only
+		prev = n4->anotherFrontEdge( nullptr );
+		cur = prev != nullptr ? prev->frontNeighborAt( n4 ) : nullptr;
+		dir = cur != nullptr ? -frontLoops->direction( cur, prev ) : 0;
+		int toN4Again = dir != 0 ? frontDistanceTo( cur, dir, n4, 1 ) : -1;
+		if ( toN4Again == -1 )
+		{
+			return false;
+		}
+		count3rdLoop += toN4Again;
+	}
+
+	bothSidesInLoop = true;
+	Msg::debug( "...both sides in loop" );
+	count = countFrontsInMergedLoops( otherSide, n4, count1stLoop, count2ndLoop, count3rdLoop,
+									  n3n4Edges, n4Inn3Loop );
+	return true;
+}
+
+//TODO: Tests
+int
+QMorph::frontDistanceTo( const std::shared_ptr<Edge>& start, int dir,
+						 const std::shared_ptr<Node>& n, int minDist )
+{
+	int size = frontLoops->loopSize( start ), best = -1;
+	for ( const auto& e : n->edgeList )
+	{
+		int d = frontLoops->distance( start, e, dir );
+		if ( d == -1 )
+		{
+			continue;
+		}
+		if ( d < minDist )
+		{ // Reached only after going once round the loop
+			d += size;
+		}
+		if ( best == -1 || d < best )
+		{
+			best = d;
+		}
+	}
+	return best;
+}
+
+//TODO: Tests
+int
+QMorph::walkFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
+							   const std::shared_ptr<Edge>& side,
+							   const std::shared_ptr<Edge>& otherSide )
+{
 	std::shared_ptr<Edge> cur = nullptr, prev, tmp;
 	auto n1 = side->commonNode( b ), n2 = otherSide->commonNode( b ), n3 = side->otherNode( n1 ), n4 = otherSide->otherNode( n2 );
 	int count1stLoop = 1, count2ndLoop = 1, count3rdLoop = 1, n3n4Edges = 0, count = 0;
@@ -360,26 +806,8 @@ QMorph::countFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
 				} while ( !cur->hasNode( n4 ) /* && count3rdLoop < 300 */ );
 			}
 
-			if ( n4Inn3Loop && !otherSide->isFrontEdge() )
-			{// Case 2,3
-				count = count1stLoop + count2ndLoop + 1 - n3n4Edges;
-				Msg::debug( "...case 2 or 3" );
-			}
-			else if ( !n4Inn3Loop && otherSide->isFrontEdge() )
-			{// Case 4
-				count = count1stLoop + count2ndLoop;
-				Msg::debug( "...case 4" );
-			}
-			else if ( !n4Inn3Loop && !otherSide->isFrontEdge() && !n4->frontNode() )
-			{// Case 6
-				count = count1stLoop + count2ndLoop + 2;
-				Msg::debug( "...case 6" );
-			}
-			else if ( !n4Inn3Loop && !otherSide->isFrontEdge() && n4->frontNode() )
-			{// Case 5
-				count = count1stLoop + count2ndLoop + count3rdLoop + 2;
-				Msg::debug( "...case 5" );
-			}
+			count = countFrontsInMergedLoops( otherSide, n4, count1stLoop, count2ndLoop, count3rdLoop,
+											  n3n4Edges, n4Inn3Loop );
 			break;
 		}
 	} while ( !cur->hasNode( n1 ) && !cur->hasNode( n3 ) );
@@ -388,30 +816,58 @@ QMorph::countFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
 	{ // Case 1
 		count = count1stLoop + 1; // Add the new edge between n1 and n3
 	}
+	return count;
+}
 
-	Msg::debug( "Leaving int countFrontsInNewLoopAt(..), returns " + std::to_string( count ) );
+//TODO: Tests
+int
+QMorph::countFrontsInMergedLoops( const std::shared_ptr<Edge>& otherSide,
+								  const std::shared_ptr<Node>& n4,
+								  int count1stLoop, int count2ndLoop, int count3rdLoop,
+								  int n3n4Edges, bool n4Inn3Loop )
+{
+	int count = 0;
+	if ( n4Inn3Loop && !otherSide->isFrontEdge() )
+	{// Case 2,3
+		count = count1stLoop + count2ndLoop + 1 - n3n4Edges;
+		Msg::debug( "...case 2 or 3" );
+	}
+	else if ( !n4Inn3Loop && otherSide->isFrontEdge() )
+	{// Case 4
+		count = count1stLoop + count2ndLoop;
+		Msg::debug( "...case 4" );
+	}
+	else if ( !n4Inn3Loop && !otherSide->isFrontEdge() && !n4->frontNode() )
+	{// Case 6
+		count = count1stLoop + count2ndLoop + 2;
+		Msg::debug( "...case 6" );
+	}
+	else if ( !n4Inn3Loop && !otherSide->isFrontEdge() && n4->frontNode() )
+	{// Case 5
+		count = count1stLoop + count2ndLoop + count3rdLoop + 2;
+		Msg::debug( "...case 5" );
+	}
 	return count;
 }
 
 //TODO: Tests
 int 
-QMorph::countNOFrontsAtCurLowestLevel( const ArrayList<std::shared_ptr<Edge>>& frontList2 )
+QMorph::countNOFrontsAtCurLowestLevel( const FrontList& frontList2 )
 {
 	Msg::debug( "Entering countNOFrontsAtCurLowestLevel(..)" );
 
-	std::shared_ptr<Edge> cur;
-	int lowestLevel, count = 0;
+	int lowestLevel = 0, count = 0;
 
 	// Get nr of fronts at the lowest level:
-	if ( frontList2.size() > 0 )
+	if ( frontLoops != nullptr && &frontList2 == &frontList )
 	{
-		cur = frontList2.get( 0 );
-		lowestLevel = cur->level;
-		count = 1;
-		for ( int i = 1; i < frontList2.size(); i++ )
+		count = frontLoops->countAtLowestLevel();
+	}
+	else
+	{
+		for ( const auto& cur : frontList2 )
 		{
-			cur = frontList2.get( i );
-			if ( cur->level < lowestLevel )
+			if ( count == 0 || cur->level < lowestLevel )
 			{
 				lowestLevel = cur->level;
 				count = 1;
@@ -477,7 +933,7 @@ QMorph::makeQuad( std::shared_ptr<Edge>& e )
 		Msg::debug( "right :" + rightSide->descr() );
 
 		t = std::make_shared<Triangle>( e, leftSide, rightSide );
-		index = static_cast<int>( triangleList.indexOf( t ) );
+		index = static_cast<int>( triangleList.indexOfEqual( t ) );
 		if ( index != -1 )
 		{
 			t = triangleList.get( index );
@@ -579,10 +1035,10 @@ QMorph::smoothFrontNode( const std::shared_ptr<Node>& nK,
 		Msg::error( "front2 is null" );
 	}
 
-	auto eD = std::make_shared<Edge>( nK, nJ );
-	if ( nK->edgeList.contains( eD ) )
+	auto eD = ScratchArena::make<Edge>( nK, nJ );
+	if ( nK->edgeList.containsEqual( eD ) )
 	{
-		eD = nK->edgeList.get( nK->edgeList.indexOf( eD ) );
+		eD = nK->edgeList.get( nK->edgeList.indexOfEqual( eD ) );
 	}
 
 	for (auto i = 0; i < kIterLimit; ++i)
@@ -833,7 +1289,7 @@ QMorph::getSmoothedPos( const std::shared_ptr<Node>& n,
 //TODO: Tests
 void
 QMorph::localSmooth( const std::shared_ptr<Quad>& q,
-					 const ArrayList<std::shared_ptr<Edge>>& frontList2,
+					 const FrontList& /*frontList2*/,
 					 int iterations )
 {
 	Msg::debug( "Entering localSmooth(..)" );
@@ -1093,7 +1549,6 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 				   const ArrayList<std::shared_ptr<Triangle>>& tris )
 {
 	Msg::debug( "Entering clearQuad(Quad q)..." );
-	int nodeInd, edgeInd, triInd;
 	std::shared_ptr<Node> node;
 	std::shared_ptr<Edge> e;
 
@@ -1104,32 +1559,20 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 			e = t->edgeList[i];
 			if ( !q->hasEdge( e ) )
 			{
-				edgeInd = static_cast<int>( edgeList.indexOf( e ) );
-				if ( edgeInd != -1 )
-				{
-					edgeList.remove( edgeInd );
-				}
+				edgeList.markRemoved( e );
 
 				e->tryToDisconnectNodes();
 
 				// Remove the leftNode if not a vertex of q:
 				if ( !q->hasNode( e->leftNode ) )
 				{
-					nodeInd = static_cast<int>(nodeList.indexOf( e->leftNode ));
-					if ( nodeInd != -1 )
-					{
-						nodeList.remove( nodeInd );
-					}
+					nodeList.markRemoved( e->leftNode );
 				}
 
 				// Remove the rightNode if not a vertex of q:
 				if ( !q->hasNode( e->rightNode ) )
 				{
-					nodeInd = static_cast<int>(nodeList.indexOf( e->rightNode ));
-					if ( nodeInd != -1 )
-					{
-						nodeList.remove( nodeInd );
-					}
+					nodeList.markRemoved( e->rightNode );
 				}
 
 				Msg::debug( "disconnecting t-edge " + e->descr() + " from " + t->descr() );
@@ -1142,11 +1585,9 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 			}
 		}
 
-		triInd = static_cast<int>(triangleList.indexOf( t ));
-		if ( triInd != -1 )
+		if ( triangleList.markRemoved( t ) )
 		{
 			Msg::debug( "...removing triangle " + t->descr() + " from triangleList." );
-			triangleList.remove( triInd );
 		}
 	}
 
@@ -1162,16 +1603,15 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 	Msg::debug( "Entering clearQuad(Quad q)..." );
 	std::shared_ptr<Element> neighbor;
 	std::shared_ptr<Triangle> cur;
-	ArrayList<std::shared_ptr<Element>> n;
+	ScratchList<std::shared_ptr<Element>> n;
 	std::shared_ptr<Edge> e;
-	int nodeInd, edgeInd, triInd;
 	std::shared_ptr<Edge> lEdge, rEdge;
 	std::shared_ptr<Node> node;
 
 	n.add( first );
 	for ( int j = 0; j < n.size(); j++ )
 	{
-		cur = std::dynamic_pointer_cast<Triangle>( n.get( j ) );
+		cur = rcl::triangleCast( n.get( j ) );
 		Msg::debug( "...parsing triangle " + cur->descr() );
 
 		for ( int i = 0; i < 3; i++ )
@@ -1186,31 +1626,19 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 					n.add( neighbor );
 				}
 
-				edgeInd = static_cast<int>(edgeList.indexOf( e ));
-				if ( edgeInd != -1 )
-				{
-					edgeList.remove( edgeInd );
-				}
+				edgeList.markRemoved( e );
 
 				e->tryToDisconnectNodes();
 
 				// Remove the leftNode if not a vertex of q:
 				if ( !q->hasNode( e->leftNode ) )
 				{
-					nodeInd = static_cast<int>(nodeList.indexOf( e->leftNode ));
-					if ( nodeInd != -1 )
-					{
-						nodeList.remove( nodeInd );
-					}
+					nodeList.markRemoved( e->leftNode );
 				}
 				// Remove the rightNode if not a vertex of q:
 				if ( !q->hasNode( e->rightNode ) )
 				{
-					nodeInd = static_cast<int>(nodeList.indexOf( e->rightNode ));
-					if ( nodeInd != -1 )
-					{
-						nodeList.remove( nodeInd );
-					}
+					nodeList.markRemoved( e->rightNode );
 				}
 
 				Msg::debug( "disconnecting t-edge " + e->descr() + " from " + cur->descr() );
@@ -1223,11 +1651,9 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 			}
 		}
 
-		triInd = static_cast<int>(triangleList.indexOf( cur ));
-		if ( triInd != -1 )
+		if ( triangleList.markRemoved( cur ) )
 		{
 			Msg::debug( "...removing triangle " + cur->descr() + " from triangleList." );
-			triangleList.remove( triInd );
 		}
 
 	}
@@ -1239,7 +1665,7 @@ QMorph::clearQuad( const std::shared_ptr<Quad>& q,
 int 
 QMorph::localFakeUpdateFronts( const std::shared_ptr<Quad>& q,
 							   int lowestLevel,
-							   ArrayList<std::shared_ptr<Edge>>& frontList2 )
+							   FrontList& frontList2 )
 {
 	Msg::debug( "Entering localFakeUpdateFronts()..." );
 	int curLevelEdgesRemoved = 0;
@@ -1397,7 +1823,7 @@ QMorph::localFakeUpdateFronts( const std::shared_ptr<Quad>& q,
 //TODO: Tests
 void
 QMorph::preSmoothUpdateFronts( const std::shared_ptr<Quad>& q,
-							   ArrayList<std::shared_ptr<Edge>>& frontList )
+							   FrontList& frontList )
 {
 	Msg::debug( "Entering preSmoothUpdateFronts()..." );
 	q->edgeList[top]->setFrontNeighbors( frontList );
@@ -1408,7 +1834,7 @@ QMorph::preSmoothUpdateFronts( const std::shared_ptr<Quad>& q,
 int
 QMorph::localUpdateFronts( const std::shared_ptr<Quad>& q,
 						   int lowestLevel,
-						   ArrayList<std::shared_ptr<Edge>>& frontList2 )
+						   FrontList& frontList2 )
 {
 	if ( q->isFake )
 	{
@@ -1611,26 +2037,26 @@ QMorph::localUpdateFronts( const std::shared_ptr<Quad>& q,
 	}
 }
 
-const ArrayList<std::shared_ptr<Edge>> 
-QMorph::defineInitFronts( const ArrayList<std::shared_ptr<Edge>>& edgeList )
+void
+QMorph::defineInitFronts( const ArrayList<std::shared_ptr<Edge>>& edgeList,
+						  FrontList& frontList2 )
 {
-	ArrayList<std::shared_ptr<Edge>> frontList;
 	for ( auto e : edgeList )
 	{
 		if ( e->hasElement( nullptr ) )
 		{
-			e->promoteToFront( 0, frontList );
+			e->promoteToFront( 0, frontList2 );
 			e->swappable = false;
 		}
 	}
 
-	for ( auto e : frontList )
+	for ( auto e : frontList2 )
 	{
-		e->setFrontNeighbors( frontList );
+		e->setFrontNeighbors( frontList2 );
 	}
 
 	// for safety...
-	for ( auto e : frontList )
+	for ( auto e : frontList2 )
 	{
 		if ( e->leftFrontNeighbor == nullptr )
 		{
@@ -1649,13 +2075,11 @@ QMorph::defineInitFronts( const ArrayList<std::shared_ptr<Edge>>& edgeList )
 			Msg::warning( "e.rightFrontNeighbor points to e." );
 		}
 	}
-
-	return frontList;
 }
 
 //TODO: Tests
 void
-QMorph::classifyStateOfAllFronts( ArrayList<std::shared_ptr<Edge>>& frontList2 )
+QMorph::classifyStateOfAllFronts( FrontList& frontList2 )
 {
 	for ( auto e : frontList2 )
 	{
@@ -1694,7 +2118,7 @@ QMorph::doSeam( std::shared_ptr<Edge>& e1,
 		Msg::debug( "Leaving doSeam(..), failure" );
 		return nullptr;
 	}
-	auto ta = std::dynamic_pointer_cast<Triangle>(e0->element1), tb = std::dynamic_pointer_cast<Triangle>(e0->element2);
+	auto ta = rcl::triangleCast(e0->element1), tb = rcl::triangleCast(e0->element2);
 	std::shared_ptr<Edge> et1, et2;
 	auto nta = ta->oppositeOfEdge( e0 ), ntb = tb->oppositeOfEdge( e0 );
 	std::shared_ptr<Node> nT;
@@ -2345,7 +2769,7 @@ QMorph::needsSeam( const std::shared_ptr<Edge>& e1,
 	Msg::debug( "Leaving needsSeam(..)" );
 	if ( nQ >= 5 )
 	{
-		if ( ang < EPSILON1 )
+		if ( ang < m_options.epsilon1 )
 		{
 			return true;
 		}
@@ -2356,7 +2780,7 @@ QMorph::needsSeam( const std::shared_ptr<Edge>& e1,
 	}
 	else
 	{
-		if ( ang < EPSILON2 )
+		if ( ang < m_options.epsilon2 )
 		{
 			return true;
 		}
@@ -2386,7 +2810,11 @@ QMorph::handleSpecialCases( std::shared_ptr<Edge>& e )
 			}
 			else
 			{
-				q = doSeam( e, e->leftFrontNeighbor, e->leftNode );
+				// doSeam(..) may swap its edges, and so the neighbor of e
+				auto seamed = e;
+				std::shared_ptr<Edge> neighbor = e->leftFrontNeighbor;
+				q = doSeam( e, neighbor, seamed->leftNode );
+				seamed->leftFrontNeighbor = neighbor;
 			}
 		}
 		else if ( e->getState() != 2 && e->isLargeTransition( e->leftFrontNeighbor ) && e->sumAngle( eTri, e->leftNode, e->leftFrontNeighbor ) < PI )
@@ -2403,7 +2831,11 @@ QMorph::handleSpecialCases( std::shared_ptr<Edge>& e )
 			}
 			else
 			{
-				q = doSeam( e, e->rightFrontNeighbor, e->rightNode );
+				// doSeam(..) may swap its edges, and so the neighbor of e
+				auto seamed = e;
+				std::shared_ptr<Edge> neighbor = e->rightFrontNeighbor;
+				q = doSeam( e, neighbor, seamed->rightNode );
+				seamed->rightFrontNeighbor = neighbor;
 			}
 		}
 		else if ( e->getState() != 2 && e->isLargeTransition( e->rightFrontNeighbor ) && e->sumAngle( eTri, e->rightNode, e->rightFrontNeighbor ) < PI )
@@ -2767,7 +3199,7 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 		}
 		// selInd= elem1.indexOf(selected);
 		// otherInd= elem1.indexOf(otherEdge);
-		bisectTriangle = std::dynamic_pointer_cast<Triangle>(elem1);
+		bisectTriangle = rcl::triangleCast(elem1);
 	}
 	else if ( elem2 != nullptr )
 	{ // Nope, it seems vK goes through elem2, not elem1.
@@ -2782,7 +3214,7 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 		otherEdge = elem2->neighborEdge( nK, closest );
 		// otherInd= elem2.indexOf(otherEdge);
 
-		bisectTriangle = std::dynamic_pointer_cast<Triangle>(elem2);
+		bisectTriangle = rcl::triangleCast(elem2);
 	}
 	else
 	{
@@ -2796,7 +3228,7 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 	// e0 cannot be a front edge, that is already ruled out in the reuse part.
 	// If e0 belongs to a quad or lies at the boundary,
 	// I cannot swap, so I just return:
-	auto neighborTriangle = std::dynamic_pointer_cast<Triangle>(bisectTriangle->neighbor( e0 ));
+	auto neighborTriangle = rcl::triangleCast(bisectTriangle->neighbor( e0 ));
 	if ( e0->frontEdge || neighborTriangle == nullptr )
 	{
 		Msg::debug( "Leaving defineSideEdge(..), returning selected==" + selected->descr() );
@@ -2816,16 +3248,17 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 		Msg::debug( "... swapping" );
 		// ok, swap edges: remove e0 and introduce eK.... update stuff...
 
-		// Remove old triangles from list...
-		triangleList.remove( triangleList.indexOf( std::dynamic_pointer_cast<Triangle>( e0->element1 ) ) );
-		triangleList.remove( triangleList.indexOf( std::dynamic_pointer_cast<Triangle>( e0->element2 ) ) );
+		// Remove old triangles from list, holding on to them for the swap...
+		auto old1 = rcl::triangleCast( e0->element1 ), old2 = rcl::triangleCast( e0->element2 );
+		triangleList.remove( triangleList.indexOf( old1 ) );
+		triangleList.remove( triangleList.indexOf( old2 ) );
 
 		// ... swap ...
-		e0->swapToAndSetElementsFor( eK );
+		auto tNew = e0->swapToAndSetElementsFor( eK );
 
 		// ... and replace with new ones:
-		triangleList.add( std::dynamic_pointer_cast<Triangle>(eK->element1) );
-		triangleList.add( std::dynamic_pointer_cast<Triangle>(eK->element2) );
+		triangleList.add( tNew[0] );
+		triangleList.add( tNew[1] );
 
 		// Update "global" edge list
 		edgeList.remove( edgeList.indexOf( e0 ) );
@@ -2840,36 +3273,23 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 		// and it's neighbor at edge e0.
 		Msg::debug( "... splitting edge " + e0->descr() );
 
-		MyVector vEF1( nK, eF1->otherNode( nK ) );
-		MyVector vEF2( nK, eF2->otherNode( nK ) );
+		auto vEF1 = eF1->otherNode( nK )->point() - nK->point();
+		auto vEF2 = eF2->otherNode( nK )->point() - nK->point();
 
 		// Take special care to construct Ray rK correctly:
-		std::shared_ptr<Ray> rK;
+		std::shared_ptr<Edge> relEdge;
 		if ( vEF2.isCWto( vEF1 ) )
 		{
-			if ( bisected < PIdiv2 )
-			{
-				rK = std::make_shared<Ray>( nK, eF2, bisected );
-			}
-			else
-			{
-				rK = std::make_shared<Ray>( nK, eF1, bisected );
-			}
+			relEdge = bisected < PIdiv2 ? eF2 : eF1;
 		}
 		else
 		{
-			if ( bisected < PIdiv2 )
-			{
-				rK = std::make_shared<Ray>( nK, eF1, bisected );
-			}
-			else
-			{
-				rK = std::make_shared<Ray>( nK, eF2, bisected );
-			}
+			relEdge = bisected < PIdiv2 ? eF1 : eF2;
 		}
+		Ray rK( nK, relEdge, bisected );
 
 		auto v0 = e0->getVector();
-		auto nN = rK->pointIntersectsAt( v0 );
+		auto nN = rK.pointIntersectsAt( v0 );
 		if ( nN == nullptr )
 		{
 			Msg::debug( "...bisectTriangle:" + bisectTriangle->descr() );
@@ -2877,7 +3297,7 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 			Msg::debug( "...eF2== " + eF2->descr() );
 			Msg::debug( "...nN== null" );
 			Msg::debug( "...bisected== " + std::to_string( toDegrees * bisected ) + " degrees" );
-			Msg::debug( "...rK==" + rK->descr() );
+			Msg::debug( "...rK==" + rK.descr() );
 			Msg::debug( "...v0==" + v0.descr() );
 			Msg::error( "defineSideEdge(..): Cannot split edge e0==" + e0->descr() );
 		}
@@ -2944,48 +3364,99 @@ QMorph::defineSideEdge( const std::shared_ptr<Edge>& eF1,
 	}
 }
 
-std::shared_ptr<Edge> 
-QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
-					 const std::shared_ptr<Node>& nD )
+//TODO: Tests
+bool
+QMorph::findIntersectedEdges( const std::shared_ptr<Node>& nC,
+							  const std::shared_ptr<Node>& nD,
+							  ArrayList<std::shared_ptr<Edge>>& intersectedEdges )
 {
-	Msg::debug( "Entering recoverEdge(Node, Node)..." );
-	auto S = std::make_shared<Edge>( nD, nC );
-	Msg::debug( "nC= " + nC->descr() );
-	Msg::debug( "nD= " + nD->descr() );
+	const auto& grid = edgeList.getGrid();
+	if ( grid == nullptr )
+	{
+		return walkIntersectedEdges( nC, nD, intersectedEdges );
+	}
 
-	printEdgeList( nC->edgeList );
+	// The grid gives the crossed edges directly, ordered from nC to nD. Accept
+	// them only if they form a chain of adjacent elements from nC to nD; when
+	// the segment passes through a node or the query is otherwise
+	// inconclusive, walk the elements instead.
+	auto crossed = grid->crossing( *nC, *nD );
+	if ( crossed.size() == 0 )
+	{
+		return walkIntersectedEdges( nC, nD, intersectedEdges );
+	}
 
-	if ( nC->edgeList.contains( S ) )
+	const auto& first = crossed.get( 0 );
+	std::shared_ptr<Element> elem = nullptr;
+	if ( first->element1 != nullptr && first->element1->hasNode( nC ) )
 	{
-		auto edge = nC->edgeList.get( nC->edgeList.indexOf( S ) );
-		Msg::debug( "recoverEdge returns edge " + edge->descr() + " (shortcut)" );
-		return edge;
+		elem = first->element1;
 	}
-	/* ---- First find the edges connecting nodes nC and nD: ---- */
-	/* (Implementation of algorithm 2 in Owen) */
-	ArrayList<std::shared_ptr<Edge>> intersectedEdges;
-	std::shared_ptr<Edge> eK, eKp1, eI = nullptr, eJ = nullptr, eN, eNp1;
+	else if ( first->element2 != nullptr && first->element2->hasNode( nC ) )
+	{
+		elem = first->element2;
+	}
+
+	// elements[k] is the element entered before crossing edge k
+	std::vector<std::shared_ptr<Element>> elements;
+	elements.reserve( crossed.size() );
+	for ( const auto& e : crossed )
+	{
+		if ( elem == nullptr || (elem != e->element1 && elem != e->element2) )
+		{
+			return walkIntersectedEdges( nC, nD, intersectedEdges );
+		}
+		elements.push_back( elem );
+		elem = elem == e->element1 ? e->element2 : e->element1;
+	}
+	if ( elem == nullptr || !elem->hasNode( nD ) )
+	{
+		return walkIntersectedEdges( nC, nD, intersectedEdges );
+	}
+
+	for ( size_t k = 0; k < crossed.size(); k++ )
+	{
+		if ( rcl::instanceOf<Quad>( elements[k] ) )
+		{
+			Msg::warning( k == 0 ? "Leaving recoverEdge(..): intersecting quad, returning null." : "Leaving recoverEdge: intersecting quad." );
+			return false;
+		}
+		if ( crossed.get( k )->frontEdge )
+		{
+			Msg::warning( "Leaving recoverEdge: eI=" + crossed.get( k )->descr() + " is part of the front." );
+			return false;
+		}
+	}
+	intersectedEdges = crossed;
+	return true;
+}
+
+//TODO: Tests
+bool
+QMorph::walkIntersectedEdges( const std::shared_ptr<Node>& nC,
+							  const std::shared_ptr<Node>& nD,
+							  ArrayList<std::shared_ptr<Edge>>& intersectedEdges )
+{
+	std::shared_ptr<Edge> eK, eKp1, eI = nullptr, eN, eNp1;
 	std::shared_ptr<Element> tK = nullptr;
 	std::shared_ptr<Triangle> tI = nullptr, tIp1;
-	std::shared_ptr<MyVector> vK, vKp1, vI;
-	MyVector vS( nC, nD );
+	auto vS = nD->point() - nC->point();
 	std::shared_ptr<Node> nI;
 
-	auto V = nC->ccwSortedVectorList();
-	V.add( V.get( 0 ) ); // First add first edge to end of list to avoid crash in loops
-	Msg::debug( "V.size()==" + std::to_string( V.size() ) );
-	printVectors( V );
+	// The edges at nC in ccw order. The edge after the last one is the first.
+	const auto& V = nC->ccwSortedEdges();
+	auto n = V.size();
+	Msg::debug( "V.size()==" + std::to_string( n ) );
+	printEdgeList( V );
 
 	// Aided by V, fill T with elements adjacent nC, in
 	// ccw order (should work even for nodes with only two edges in their list):
-	ArrayList<std::shared_ptr<Element>> T;
+	ScratchList<std::shared_ptr<Element>> T;
 
-	for ( int k = 0; k < V.size() - 1; k++ )
+	for ( size_t k = 0; k < n; k++ )
 	{
-		vK = V.get( k );
-		vKp1 = V.get( k + 1 );
-		eK = vK->edge;
-		eKp1 = vKp1->edge;
+		eK = V.get( k );
+		eKp1 = V.get( (k + 1) % n );
 
 		if ( eK == nullptr || eKp1 == nullptr )
 		{
@@ -3003,23 +3474,22 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 
 	// Now, get the element attached to nC that contains a part of S, tI:
 	Msg::debug( "T.size()==" + std::to_string( T.size() ) );
-	for ( int k = 0; k < T.size(); k++ )
+	for ( size_t k = 0; k < T.size(); k++ )
 	{
-		vK = V.get( k );
-		vKp1 = V.get( k + 1 );
+		auto vK = V.get( k )->getVec2( nC );
+		auto vKp1 = V.get( (k + 1) % n )->getVec2( nC );
 
 		tK = T.get( k );
 
 		// We could optimize by using isCWto(..) directly instead of dot(..)
 		// And I can't get the dot(...) to work properly anyway, sooo...
 
-		Msg::debug( "vS==" + vS.descr() );
-		Msg::debug( "vK==" + vK->descr() );
-		Msg::debug( "vKp1==" + vKp1->descr() );
+		Msg::debug( "eK==" + V.get( k )->descr() );
+		Msg::debug( "eKp1==" + V.get( (k + 1) % n )->descr() );
 		Msg::debug( "tK=" + tK->descr() );
 		// Msg.debug("vS.dot(vK)=="+vS.dot(vK)+" and vS.dot(vKp1)=="+vS.dot(vKp1));
 
-		if ( !vS.isCWto( *vK ) && vS.isCWto( *vKp1 ) )
+		if ( !vS.isCWto( vK ) && vS.isCWto( vKp1 ) )
 		{
 			// tI= tK;
 			// eI= vKp1.edge; // just something I tried.. no good
@@ -3039,11 +3509,11 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 	if ( rcl::instanceOf<Quad>( elemI ) )
 	{
 		Msg::warning( "Leaving recoverEdge(..): intersecting quad, returning null." );
-		return nullptr;
+		return false;
 	}
 	else
 	{ // elemI is a Triangle...
-		tI = std::dynamic_pointer_cast<Triangle>(elemI);
+		tI = rcl::triangleCast(elemI);
 		eI = tI->oppositeOfNode( nC );
 	}
 	if ( !eI->frontEdge )
@@ -3053,7 +3523,7 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 	else
 	{
 		Msg::warning( "Leaving recoverEdge: eI=" + eI->descr() + " is part of the front." );
-		return nullptr;
+		return false;
 	}
 
 	// Quad qI;
@@ -3069,16 +3539,16 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 		elemI = elemIp1;
 		if ( rcl::instanceOf<Triangle>(elemI) )
 		{
-			tI = std::dynamic_pointer_cast<Triangle>(elemI);
+			tI = rcl::triangleCast(elemI);
 			nI = tI->oppositeOfEdge( eI );
-			vI = std::make_shared<MyVector>( nC, nI );
+			auto vI = nI->point() - nC->point();
 			eN = tI->nextCCWEdge( eI );
 			eNp1 = tI->nextCWEdge( eI );
 
 			Msg::debug( "eN= " + eN->descr() );
 			Msg::debug( "eNp1= " + eNp1->descr() );
 			// if (vS.dot(vI)<0) // Not convinced that dot(..) works properly
-			if ( vS.isCWto( *vI ) )
+			if ( vS.isCWto( vI ) )
 			{
 				eI = eN;
 			}
@@ -3094,16 +3564,47 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 			else
 			{
 				Msg::warning( "Leaving recoverEdge: eI=" + eI->descr() + " is part of the front." );
-				return nullptr;
+				return false;
 			}
 		}
 		else
 		{ // elemI is instanceof Quad
 			Msg::warning( "Leaving recoverEdge: intersecting quad." );
-			return nullptr;
+			return false;
 		}
 	}
 
+	return true;
+}
+
+std::shared_ptr<Edge> 
+QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
+					 const std::shared_ptr<Node>& nD )
+{
+	Msg::debug( "Entering recoverEdge(Node, Node)..." );
+	auto S = std::make_shared<Edge>( nD, nC );
+	Msg::debug( "nC= " + nC->descr() );
+	Msg::debug( "nD= " + nD->descr() );
+
+	printEdgeList( nC->edgeList );
+
+	if ( nC->edgeList.containsEqual( S ) )
+	{
+		auto edge = nC->edgeList.get( nC->edgeList.indexOfEqual( S ) );
+		Msg::debug( "recoverEdge returns edge " + edge->descr() + " (shortcut)" );
+		return edge;
+	}
+	/* ---- First find the edges connecting nodes nC and nD: ---- */
+	/* (Implementation of algorithm 2 in Owen) */
+	ArrayList<std::shared_ptr<Edge>> intersectedEdges;
+	if ( !findIntersectedEdges( nC, nD, intersectedEdges ) )
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<Edge> eI = nullptr, eJ = nullptr;
+	auto vS = nD->point() - nC->point();
+
 	/* ---- ---- ---- ---- ---- ---- */
 
 	/* ---- Secondly, do the actual recovering of the top edge ---- */
@@ -3128,7 +3629,7 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 
 	// When this loop is done, the edge should be recovered
 	std::shared_ptr<Element> oldEIElement1, oldEIElement2;
-	ArrayList<std::shared_ptr<Element>> removeList;
+	ScratchList<std::shared_ptr<Element>> removeList;
 	std::shared_ptr<Triangle> t;
 	std::shared_ptr<Quad> q;
 	int index;
@@ -3144,14 +3645,14 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 		Msg::debug( "eI= " + eI->descr() );
 
 		// We must avoid creating inverted or degenerate triangles.
-		q = std::make_shared<Quad>( eI );
+		q = ScratchArena::make<Quad>( eI );
 		Msg::debug( "eI.element1= " + eI->element1->descr() );
 		Msg::debug( "eI.element2= " + eI->element2->descr() );
 		old1 = eI->element1;
 		old2 = eI->element2;
 
-		na = (std::dynamic_pointer_cast<Triangle>(old1))->oppositeOfEdge( eI );
-		nb = (std::dynamic_pointer_cast<Triangle>(old2))->oppositeOfEdge( eI );
+		na = (rcl::triangleCast(old1))->oppositeOfEdge( eI );
+		nb = (rcl::triangleCast(old2))->oppositeOfEdge( eI );
 		nc = eI->leftNode;
 		nd = eI->rightNode;
 
@@ -3170,7 +3671,7 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 			eJ = eI->getSwappedEdge();
 
 			Msg::debug( "eJ= " + eJ->descr() );
-			eI->swapToAndSetElementsFor( eJ );
+			auto tNew = eI->swapToAndSetElementsFor( eJ );
 
 			Msg::debug( "eJ.element1==" + eJ->element1->descr() );
 			Msg::debug( "eJ.element2==" + eJ->element2->descr() );
@@ -3199,10 +3700,10 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 			}
 
 			// ... and replace with new ones:
-			triangleList.add( std::dynamic_pointer_cast<Triangle>(eJ->element1) );
-			Msg::debug( "Added element: " + eJ->element1->descr() );
-			triangleList.add( std::dynamic_pointer_cast<Triangle>(eJ->element2) );
-			Msg::debug( "Added element: " + eJ->element2->descr() );
+			triangleList.add( tNew[0] );
+			Msg::debug( "Added element: " + tNew[0]->descr() );
+			triangleList.add( tNew[1] );
+			Msg::debug( "Added element: " + tNew[1]->descr() );
 
 			// Update "global" edge list
 			Msg::debug( "...removing edge " + eI->descr() );
@@ -3210,11 +3711,11 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 			edgeList.add( eJ );
 
 			intersectedEdges.remove( 0 );
-			MyVector vEj( eJ->leftNode, eJ->rightNode );
+			auto vEj = eJ->rightNode->point() - eJ->leftNode->point();
 
-			if ( !eJ->hasNode( nC ) && !eJ->hasNode( nD ) && vEj.innerpointIntersects( vS ) )
+			if ( !eJ->hasNode( nC ) && !eJ->hasNode( nD ) && MyVector::innerpointIntersects( eJ->leftNode->point(), vEj, nC->point(), vS ) )
 			{
-				Msg::debug( "recoverEdge: vEj: " + vEj.descr() + " is innerpoint-intersecting vS: " + vS.descr() );
+				Msg::debug( "recoverEdge: eJ: " + eJ->descr() + " is innerpoint-intersecting S: " + S->descr() );
 				intersectedEdges.add( eJ );
 			}
 
@@ -3240,7 +3741,7 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 			// Remove all triangles found in the removeList from triangleList:
 			for ( auto element : removeList )
 			{
-				t = std::dynamic_pointer_cast<Triangle>(element);
+				t = rcl::triangleCast(element);
 				index = static_cast<int>(triangleList.indexOf( t ));
 				if ( index != -1 )
 				{
@@ -3255,7 +3756,7 @@ QMorph::recoverEdge( const std::shared_ptr<Node>& nC,
 	// Remove all triangles found in the removeList from triangleList:
 	for ( auto element : removeList )
 	{
-		t = std::dynamic_pointer_cast<Triangle>(element);
+		t = rcl::triangleCast(element);
 		index = static_cast<int>(triangleList.indexOf( t ));
 		if ( index != -1 )
 		{
@@ -2,6 +2,10 @@
 
 #include "GeomBasics.h"
 #include "ArrayList.h"
+#include "Checkpoint.h"
+#include "FrontList.h"
+#include "MeshComponents.h"
+#include "QMorphOptions.h"
 
 #include <memory>
 
@@ -29,7 +33,7 @@ class QMorph :
 	public std::enable_shared_from_this<QMorph>
 {
 private:
-	ArrayList<std::shared_ptr<Edge>> frontList;
+	FrontList frontList;
 	bool finished = false;
 	int level = 0;
 	int nrOfFronts = 0;
@@ -37,8 +41,18 @@ private:
 	bool evenInitNrOfFronts = false;
     double m_mesh_size = 0.0;
     bool m_skip_last_smooth = false;
+	QMorphOptions m_options;
 
 public:
+	/**
+	 * @param options the tunable parameters of the runs of this object, handed
+	 *                on to TopoCleanup, GlobalSmooth and the worker threads
+	 */
+	explicit QMorph( const QMorphOptions& options = QMorphOptions() );
+
+	/** @return the tunable parameters of the runs of this object */
+	const QMorphOptions& getOptions() const { return m_options; }
+
 	/** Initialize the class */
 	void init( int step_limit = -1,
 			   double mesh_size = 0.0,
@@ -47,11 +61,85 @@ public:
 	///** Run the implementation on the given triangle mesh */
 	void run();
 
+	/**
+	 * Initialize and run the implementation on each connected component of the
+	 * triangle mesh on a thread of its own, and merge the resulting meshes. The
+	 * components share no nodes, so their fronts cannot interact. A mesh of a
+	 * single component, as well as step mode, takes the sequential path through
+	 * init(..) and run().
+	 *
+	 * @param nThreads the number of worker threads, or 0 for one per hardware
+	 *                 thread
+	 */
+	void runParallel( unsigned nThreads = 0,
+					  int step_limit = -1,
+					  double mesh_size = 0.0,
+					  bool skip_last_smooth = false );
+
+	/**
+	 * Partition the triangle mesh into subdomains with an even number of
+	 * boundary edges each, mesh the subdomains on separate threads with their
+	 * interface edges held as boundary, stitch them together and clean up the
+	 * connectivity along the seams. Falls back to init(..) and run() on the
+	 * whole mesh if it cannot be partitioned, or if the meshing of a subdomain
+	 * changed its interface.
+	 *
+	 * @param nSubdomains the number of subdomains to aim for
+	 * @param nThreads    the number of worker threads, or 0 for one per
+	 *                    hardware thread
+	 */
+	void runDecomposed( unsigned nSubdomains,
+						unsigned nThreads = 0,
+						int step_limit = -1,
+						double mesh_size = 0.0,
+						bool skip_last_smooth = false );
+
+	/**
+	 * Continue the run saved in a checkpoint, see Checkpoint, up to its end or
+	 * until step_limit steps have been taken in all.
+	 */
+	void resume( const std::string& filename, int step_limit = -1 );
+
+	/**
+	 * Mesh again the part of the finished mesh around a local edit, see
+	 * MeshCavity. The elements within band of the changed nodes are torn out,
+	 * the hole they leave is triangulated with its boundary edges kept as they
+	 * are, and QMorph, TopoCleanup and GlobalSmooth are run on the triangles
+	 * alone before they are put in place.
+	 *
+	 * @param changed the nodes at the edit, e.g. those of a hole that was moved
+	 * @param band    the distance from the changed nodes within which the mesh
+	 *                is rebuilt, larger than the distance the nodes moved
+	 * @return false, leaving the mesh unchanged, if there was nothing to tear
+	 *         out or the new mesh does not fit the hole
+	 */
+	bool remeshAround( const ArrayList<std::shared_ptr<Node>>& changed,
+					   double band );
+
+	/**
+	 * Mesh a triangle mesh in the thread_local lists of the calling thread with
+	 * the given options, and leave the lists empty afterwards. The entities of
+	 * c are changed in place.
+	 *
+	 * @return the resulting mesh
+	 */
+	static MeshComponents::Component meshOnThisThread( const MeshComponents::Component& c,
+													   const QMorphOptions& opts,
+													   int step_limit,
+													   double mesh_size,
+													   bool skip_last_smooth );
+
+	/** Write the counters and the front list, as saved in Checkpoint::Phase::Morph. */
+	void writeState( Checkpoint::Writer& w ) const;
+
+	/** Restore what writeState(..) wrote. */
+	void readState( Checkpoint::Reader& r );
+
 	///** Step through the morphing process one front edge at the time. */
 	void step() override;
 
 	/** @return the frontList, that is, the list of front edges */
-	const ArrayList<std::shared_ptr<Edge>>& getFrontList() { return frontList; }
+	const FrontList& getFrontList() { return frontList; }
 
 	bool equals( const std::shared_ptr<Constants>& elem ) const override
 	{
@@ -83,6 +171,12 @@ private:
 
 	bool  bothSidesInLoop = false;
 
+	/** Take steps until the fronts are done or the step limit is reached. */
+	void runSteps();
+
+	/** Run the global smooth once the topological cleanup is done. */
+	void finishRun();
+
 	/**
 	 * Supposing that the edges side and otherSide are promoted to front edges. The
 	 * method parses a new loop involving the edges side, otherSide and possibly
@@ -101,8 +195,48 @@ private:
 								const std::shared_ptr<Edge>& side,
 								const std::shared_ptr<Edge>& otherSide );
 
+	/**
+	 * Do the count of countFrontsInNewLoopAt(..) by looking up positions in
+	 * frontLoops.
+	 *
+	 * @param count set to the number of edges in the new loop
+	 * @return false if some loop involved is not a closed loop of frontLoops, in
+	 *         which case the loops must be walked instead
+	 */
+	bool lookUpFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
+								  const std::shared_ptr<Edge>& side,
+								  const std::shared_ptr<Edge>& otherSide,
+								  int& count );
+
+	/** Do the count of countFrontsInNewLoopAt(..) by walking the front loops. */
+	int walkFrontsInNewLoopAt( const std::shared_ptr<Edge>& b,
+							   const std::shared_ptr<Edge>& side,
+							   const std::shared_ptr<Edge>& otherSide );
+
+	/**
+	 * Combine the edge counts of the loops parsed by countFrontsInNewLoopAt(..)
+	 * when both sides are in the same loop.
+	 */
+	int countFrontsInMergedLoops( const std::shared_ptr<Edge>& otherSide,
+								  const std::shared_ptr<Node>& n4,
+								  int count1stLoop, int count2ndLoop, int count3rdLoop,
+								  int n3n4Edges, bool n4Inn3Loop );
+
+	/**
+	 * @param start   a front edge in a closed loop of frontLoops
+	 * @param dir     the direction to step in, as returned by
+	 *                FrontLoops::direction(..)
+	 * @param n       a node
+	 * @param minDist the least number of steps to take
+	 * @return the number of steps, at least minDist, from start to the first
+	 *         front edge at node n when stepping along the loop, or -1 if there
+	 *         is no such edge in the loop
+	 */
+	int frontDistanceTo( const std::shared_ptr<Edge>& start, int dir,
+						 const std::shared_ptr<Node>& n, int minDist );
+
 	/** Returns the number of front edges at the currently lowest level loop(s). */
-	int countNOFrontsAtCurLowestLevel( const ArrayList<std::shared_ptr<Edge>>& frontList2 );
+	int countNOFrontsAtCurLowestLevel( const FrontList& frontList2 );
 
 	/** Make sure the triangle mesh consists exclusively of triangles */
 	bool verifyTriangleMesh( const ArrayList<std::shared_ptr<Triangle>>& triangleList );
@@ -146,7 +280,7 @@ private:
 	 * smoothed. So is every node directly connected to these.
 	 */
 	void localSmooth( const std::shared_ptr<Quad>& q,
-					  const ArrayList<std::shared_ptr<Edge>>& frontList2,
+					  const FrontList& frontList2,
 					  int iterations = 1 );
 
 	/**
@@ -168,11 +302,11 @@ private:
 	/** Updates fronts in fake quads (which are triangles, really) */
 	int localFakeUpdateFronts( const std::shared_ptr<Quad>& q,
 							   int lowestLevel,
-							   ArrayList<std::shared_ptr<Edge>>& frontList2 );
+							   FrontList& frontList2 );
 
 	// Do some neccessary updating of the fronts before localSmooth(..) is run
 	void preSmoothUpdateFronts( const std::shared_ptr<Quad>& q,
-								ArrayList<std::shared_ptr<Edge>>& frontList );
+								FrontList& frontList );
 
 	/**
 	 * Define new fronts, remove old ones. Set new frontNeighbors. Reclassify front
@@ -182,11 +316,13 @@ private:
 	 */
 	int localUpdateFronts( const std::shared_ptr<Quad>& q,
 						   int lowestLevel,
-						   ArrayList<std::shared_ptr<Edge>>& frontList2 );
+						   FrontList& frontList2 );
 
-	const ArrayList<std::shared_ptr<Edge>> defineInitFronts( const ArrayList<std::shared_ptr<Edge>>& edgeList );
+	/** Fill frontList2 with the boundary edges of the triangle mesh. */
+	void defineInitFronts( const ArrayList<std::shared_ptr<Edge>>& edgeList,
+						   FrontList& frontList2 );
 
-	void classifyStateOfAllFronts( ArrayList<std::shared_ptr<Edge>>& frontList2 );
+	void classifyStateOfAllFronts( FrontList& frontList2 );
 
 	/** Performs seaming operation as described in Owen's paper */
 	std::shared_ptr<Quad> doSeam( std::shared_ptr<Edge>& e1,
@@ -249,6 +385,27 @@ private:
 										  const std::shared_ptr<Edge>& leftSide,
 										  const std::shared_ptr<Edge>& rightSide,
 										  const ArrayList<std::shared_ptr<Edge>>& altRSE );
+	/**
+	 * Find the edges crossed by the line segment from nC to nD, ordered from nC to
+	 * nD. The EdgeGrid attached to edgeList is queried when there is one,
+	 * otherwise the elements along the segment are walked.
+	 *
+	 * @return false if the segment crosses a Quad or a front Edge.
+	 */
+	bool findIntersectedEdges( const std::shared_ptr<Node>& nC,
+							   const std::shared_ptr<Node>& nD,
+							   ArrayList<std::shared_ptr<Edge>>& intersectedEdges );
+
+	/**
+	 * Find the edges crossed by the line segment from nC to nD by walking the
+	 * elements from nC towards nD (algorithm 2 in Owen).
+	 *
+	 * @return false if the segment crosses a Quad or a front Edge.
+	 */
+	bool walkIntersectedEdges( const std::shared_ptr<Node>& nC,
+							   const std::shared_ptr<Node>& nD,
+							   ArrayList<std::shared_ptr<Edge>>& intersectedEdges );
+
 	/**
 	 * Create an edge from nC to nD, or if it already exists, return that edge.
 	 * Remove all edges intersected by the new edge. This is accomplished through a
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "QMorphOptions.h"
+
+#include <sstream>
+
+//TODO: Tests
+bool
+QMorphOptions::set( const std::string& name, double value )
+{
+	if ( name == "epsilon1" )
+	{
+		epsilon1 = Constants::toRadians * value;
+	}
+	else if ( name == "epsilon2" )
+	{
+		epsilon2 = Constants::toRadians * value;
+	}
+	else if ( name == "chevronMin" )
+	{
+		chevronMin = Constants::toRadians * value;
+	}
+	else if ( name == "obsTol" )
+	{
+		obsTol = value;
+	}
+	else if ( name == "myMin" )
+	{
+		myMin = value;
+	}
+	else if ( name == "gamma" )
+	{
+		gamma = value;
+	}
+	else if ( name == "maxIter" )
+	{
+		maxIter = static_cast<int>(value);
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+//TODO: Tests
+bool
+QMorphOptions::parse( const std::string& pairs )
+{
+	std::istringstream in( pairs );
+	std::string pair;
+	while ( in >> pair )
+	{
+		auto eq = pair.find( '=' );
+		if ( eq == std::string::npos )
+		{
+			return false;
+		}
+		try
+		{
+			if ( !set( pair.substr( 0, eq ), std::stod( pair.substr( eq + 1 ) ) ) )
+			{
+				return false;
+			}
+		}
+		catch ( const std::exception& )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//TODO: Tests
+std::string
+QMorphOptions::descr() const
+{
+	std::ostringstream s;
+	s << "epsilon1=" << Constants::toDegrees * epsilon1
+	  << " epsilon2=" << Constants::toDegrees * epsilon2
+	  << " chevronMin=" << Constants::toDegrees * chevronMin
+	  << " obsTol=" << obsTol
+	  << " myMin=" << myMin
+	  << " gamma=" << gamma
+	  << " maxIter=" << maxIter;
+	return s.str();
+}
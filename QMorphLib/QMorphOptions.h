@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Constants.h"
+
+#include <string>
+
+/**
+ * The tunable parameters of QMorph, TopoCleanup and GlobalSmooth, which can be
+ * changed between runs without a rebuild. The defaults are those of Constants
+ * and of the paper.
+ *
+ * The options of a run are given to QMorph when it is made, which hands them on
+ * to its TopoCleanup and GlobalSmooth and to the QMorph of each worker thread.
+ */
+
+struct QMorphOptions
+{
+	// Seam angle limits: a seam is made at a node with 5 or more quads if the
+	// angle is below epsilon1, and otherwise if it is below epsilon2. Must
+	// have epsilon1 < epsilon2.
+	double epsilon1 = Constants::PI * Constants::defaultE1Factor;
+	double epsilon2 = Constants::PI * Constants::defaultE2Factor;
+	// The minimum size of the greatest angle in a chevron
+	double chevronMin = Constants::defaultCHEVRONMIN;
+	// The distortion metric below which the optimization based smooth is used
+	double obsTol = Constants::defaultOBSTOL;
+	// The least improvement of the distortion metric for a node to be moved
+	double myMin = Constants::defaultMYMIN;
+	// The relaxation factor of the optimization based smooth, in (0, 1]
+	double gamma = Constants::defaultGAMMA;
+	// The largest number of global smoothing iterations
+	int maxIter = Constants::defaultMAXITER;
+
+	/**
+	 * Set an option by its name, with angles in degrees.
+	 *
+	 * @return false if there is no option of that name
+	 */
+	bool set( const std::string& name, double value );
+
+	/**
+	 * Set the options given as name=value pairs separated by white space, as
+	 * written by descr().
+	 *
+	 * @return false if a pair is malformed or names no option
+	 */
+	bool parse( const std::string& pairs );
+
+	/** @return the options as name=value pairs, as read by set(..) */
+	std::string descr() const;
+};
@@ -5,6 +5,7 @@
 #include "Node.h"
 #include "Edge.h"
 #include "MyVector.h"
+#include "ScratchArena.h"
 
 #include "Msg.h"
 #include "Types.h"
@@ -15,7 +16,8 @@
 Quad::Quad( const std::shared_ptr<Edge>& baseEdge,
 			const std::shared_ptr<Edge>& leftEdge,
 			const std::shared_ptr<Edge>& rightEdge,
-			const std::shared_ptr<Edge>& topEdge )
+			const std::shared_ptr<Edge>& topEdge ) :
+	Element( ElementType::Quad )
 {
 	edgeList.assign( 4, nullptr );
 	ang.assign( 4, 0.0 );
@@ -52,14 +54,15 @@ Quad::Quad( const std::shared_ptr<Edge>& baseEdge,
 }
 
 //TODO: Test
-Quad::Quad( const std::shared_ptr<Edge>& e )
+Quad::Quad( const std::shared_ptr<Edge>& e ) :
+	Element( ElementType::Quad )
 {
 	isFake = false;
 	edgeList.assign( 4, nullptr );
 	ang.assign( 4, 0.0 );
 
-	auto t1 = std::dynamic_pointer_cast<Triangle>(e->element1);
-	auto t2 = std::dynamic_pointer_cast<Triangle>(e->element2);
+	auto t1 = rcl::triangleCast(e->element1);
+	auto t2 = rcl::triangleCast(e->element2);
 
 	auto c11 = t1->otherEdge( e );
 	auto c12 = t1->otherEdge( e, c11 );
@@ -132,7 +135,8 @@ Quad::Quad( const std::shared_ptr<Edge>& e )
 }
 
 //TODO: Test
-Quad::Quad( const std::shared_ptr<Triangle>& t )
+Quad::Quad( const std::shared_ptr<Triangle>& t ) :
+	Element( ElementType::Quad )
 {
 	isFake = true;
 	edgeList.assign( 4, nullptr );
@@ -161,7 +165,8 @@ Quad::Quad( const std::shared_ptr<Triangle>& t )
 //TODO: Test
 Quad::Quad( const std::shared_ptr<Edge>& e,
 			const std::shared_ptr<Node>& n1,
-			const std::shared_ptr<Node>& n2 )
+			const std::shared_ptr<Node>& n2 ) :
+	Element( ElementType::Quad )
 {
 	Msg::debug( "Entering Quad(Edge, Node, Node)" );
 	Msg::debug( "e= " + e->descr() + ", n1= " + n1->descr() + ", n2= " + n2->descr() );
@@ -196,22 +201,23 @@ Quad::Quad( const std::shared_ptr<Edge>& e,
 Quad::Quad( const std::shared_ptr<Node>& n1,
 			const std::shared_ptr<Node>& n2,
 			const std::shared_ptr<Node>& n3,
-			const std::shared_ptr<Node>& f )
+			const std::shared_ptr<Node>& f ) :
+	Element( ElementType::Quad )
 {
 	isFake = true;
 	edgeList.assign( 4, nullptr );
 	ang.assign( 4, 0.0 );
 
-	edgeList[base] = std::make_shared<Edge>( n1, n2 );
+	edgeList[base] = ScratchArena::make<Edge>( n1, n2 );
 	if ( edgeList[base]->leftNode == n1 )
 	{
-		edgeList[left] = std::make_shared<Edge>( n1, n3 );
-		edgeList[right] = std::make_shared<Edge>( n2, n3 );
+		edgeList[left] = ScratchArena::make<Edge>( n1, n3 );
+		edgeList[right] = ScratchArena::make<Edge>( n2, n3 );
 	}
 	else
 	{
-		edgeList[left] = std::make_shared<Edge>( n2, n3 );
-		edgeList[right] = std::make_shared<Edge>( n1, n3 );
+		edgeList[left] = ScratchArena::make<Edge>( n2, n3 );
+		edgeList[right] = ScratchArena::make<Edge>( n1, n3 );
 	}
 	edgeList[top] = edgeList[right];
 
@@ -224,23 +230,24 @@ Quad::Quad( const std::shared_ptr<Node>& n1,
 			const std::shared_ptr<Node>& n2,
 			const std::shared_ptr<Node>& n3,
 			const std::shared_ptr<Node>& n4,
-			const std::shared_ptr<Node>& f )
+			const std::shared_ptr<Node>& f ) :
+	Element( ElementType::Quad )
 {
 	isFake = false;
 	edgeList.assign( 4, nullptr );
 	ang.assign( 4, 0.0 );
 
-	edgeList[base] = std::make_shared<Edge>( n1, n2 );
-	edgeList[top] = std::make_shared<Edge>( n3, n4 );
+	edgeList[base] = ScratchArena::make<Edge>( n1, n2 );
+	edgeList[top] = ScratchArena::make<Edge>( n3, n4 );
 	if ( edgeList[base]->leftNode == n1 )
 	{
-		edgeList[left] = std::make_shared<Edge>( n1, n3 );
-		edgeList[right] = std::make_shared<Edge>( n2, n4 );
+		edgeList[left] = ScratchArena::make<Edge>( n1, n3 );
+		edgeList[right] = ScratchArena::make<Edge>( n2, n4 );
 	}
 	else
 	{
-		edgeList[left] = std::make_shared<Edge>( n2, n4 );
-		edgeList[right] = std::make_shared<Edge>( n1, n3 );
+		edgeList[left] = ScratchArena::make<Edge>( n2, n4 );
+		edgeList[right] = ScratchArena::make<Edge>( n1, n3 );
 	}
 
 	firstNode = f;
@@ -262,33 +269,33 @@ Quad::elementWithExchangedNodes( const std::shared_ptr<Node>& original,
 		{
 			if ( original == firstNode )
 			{
-				return std::make_shared<Quad>( replacement, node2, node3, replacement );
+				return ScratchArena::make<Quad>( replacement, node2, node3, replacement );
 			}
 			else
 			{
-				return std::make_shared<Quad>( replacement, node2, node3, firstNode );
+				return ScratchArena::make<Quad>( replacement, node2, node3, firstNode );
 			}
 		}
 		else if ( node2 == original )
 		{
 			if ( original == firstNode )
 			{
-				return std::make_shared<Quad>( node1, replacement, node3, replacement );
+				return ScratchArena::make<Quad>( node1, replacement, node3, replacement );
 			}
 			else
 			{
-				return std::make_shared<Quad>( node1, replacement, node3, firstNode );
+				return ScratchArena::make<Quad>( node1, replacement, node3, firstNode );
 			}
 		}
 		else if ( node3 == original )
 		{
 			if ( original == firstNode )
 			{
-				return std::make_shared<Quad>( node1, node2, replacement, replacement );
+				return ScratchArena::make<Quad>( node1, node2, replacement, replacement );
 			}
 			else
 			{
-				return std::make_shared<Quad>( node1, node2, replacement, firstNode );
+				return ScratchArena::make<Quad>( node1, node2, replacement, firstNode );
 			}
 		}
 		else
@@ -303,44 +310,44 @@ Quad::elementWithExchangedNodes( const std::shared_ptr<Node>& original,
 	{
 		if ( original == firstNode )
 		{
-			return std::make_shared<Quad>( replacement, node2, node3, node4, replacement );
+			return ScratchArena::make<Quad>( replacement, node2, node3, node4, replacement );
 		}
 		else
 		{
-			return std::make_shared<Quad>( replacement, node2, node3, node4, firstNode );
+			return ScratchArena::make<Quad>( replacement, node2, node3, node4, firstNode );
 		}
 	}
 	else if ( node2 == original )
 	{
 		if ( original == firstNode )
 		{
-			return std::make_shared<Quad>( node1, replacement, node3, node4, replacement );
+			return ScratchArena::make<Quad>( node1, replacement, node3, node4, replacement );
 		}
 		else
 		{
-			return std::make_shared<Quad>( node1, replacement, node3, node4, firstNode );
+			return ScratchArena::make<Quad>( node1, replacement, node3, node4, firstNode );
 		}
 	}
 	else if ( node3 == original )
 	{
 		if ( original == firstNode )
 		{
-			return std::make_shared<Quad>( node1, node2, replacement, node4, replacement );
+			return ScratchArena::make<Quad>( node1, node2, replacement, node4, replacement );
 		}
 		else
 		{
-			return std::make_shared<Quad>( node1, node2, replacement, node4, firstNode );
+			return ScratchArena::make<Quad>( node1, node2, replacement, node4, firstNode );
 		}
 	}
 	else if ( node4 == original )
 	{
 		if ( original == firstNode )
 		{
-			return std::make_shared<Quad>( node1, node2, node3, replacement, replacement );
+			return ScratchArena::make<Quad>( node1, node2, node3, replacement, replacement );
 		}
 		else
 		{
-			return std::make_shared<Quad>( node1, node2, node3, replacement, firstNode );
+			return ScratchArena::make<Quad>( node1, node2, node3, replacement, firstNode );
 		}
 	}
 	else
@@ -404,7 +411,7 @@ Quad::invertedWhenNodeRelocated( const std::shared_ptr<Node>& n1,
 		okays = 4 - okays;
 	}
 
-	Msg::debug( "Leaving Quad.invertedWhenNodeRelocated(..), okays: " + okays );
+	Msg::debug( "Leaving Quad.invertedWhenNodeRelocated(..), okays: " + std::to_string( okays ) );
 	if ( okays >= 3 )
 	{
 		return false;
@@ -539,6 +546,7 @@ Quad::closeQuad( const std::shared_ptr<Edge>& e1,
 				Msg::debug( "...eI is connected to eJ== " + eJ->descr() );
 
 				other->edgeList.remove( other->edgeList.indexOf( eI ) );
+				other->invalidateStar();
 
 				if ( eI->element1 != nullptr )
 				{
@@ -550,7 +558,7 @@ Quad::closeQuad( const std::shared_ptr<Edge>& e1,
 
 					eI->element1->replaceEdge( eI, eJ );
 					eJ->connectToElement( eI->element1 );
-					if ( auto q = std::dynamic_pointer_cast<Quad>(eI->element1) )
+					if ( auto q = rcl::quadCast(eI->element1) )
 					{ // Then LR might need updating
 						quadList.add( q ); // but that must be done later
 					}
@@ -574,6 +582,7 @@ Quad::closeQuad( const std::shared_ptr<Edge>& e1,
 			Msg::debug( "...replacing " + nKm1->descr() + " with " + nKp1->descr() + " on edge " + eI->descr() );
 
 			nKm1->edgeList.set( i, nullptr );
+			nKm1->invalidateStar();
 			eI->replaceNode( nKm1, nKp1 );
 			addList.add( eI ); 
 		}
@@ -588,6 +597,7 @@ Quad::closeQuad( const std::shared_ptr<Edge>& e1,
 		const auto& e = addList.get( i );
 		nKp1->edgeList.add( e );
 	}
+	nKp1->invalidateStar();
 
 	for ( auto& q : quadList )
 	{
@@ -595,6 +605,7 @@ Quad::closeQuad( const std::shared_ptr<Edge>& e1,
 	}
 
 	nKm1->edgeList.clear();
+	nKm1->invalidateStar();
 
 	Msg::debug( "Leaving Quad.closeQuad(..)" );
 }
@@ -1149,9 +1160,9 @@ Quad::isBowtie()
 
 //TODO: Test
 bool
-Quad::isChevron()
+Quad::isChevron( double chevronMin )
 {
-	if ( largestAngle() >= CHEVRONMIN )
+	if ( largestAngle() >= chevronMin )
 	{
 		return true;
 	}
@@ -1869,7 +1880,7 @@ Quad::getAdjTriangles()
 		{
 			if ( rcl::instanceOf<Triangle>( curElem ) )
 			{
-				triangleList.add( std::dynamic_pointer_cast<Triangle>(curElem) );
+				triangleList.add( rcl::triangleCast(curElem) );
 			}
 			curEdge = curElem->neighborEdge( uLNode, curEdge );
 			curElem = curElem->neighbor( curEdge );
@@ -1881,7 +1892,7 @@ Quad::getAdjTriangles()
 	curEdge = edgeList[top];
 	while ( curElem != nullptr && curEdge != edgeList[right] )
 	{
-		auto Tri = std::dynamic_pointer_cast<Triangle>(curElem);
+		auto Tri = rcl::triangleCast(curElem);
 		if ( Tri && !triangleList.contains( Tri ) )
 		{
 			triangleList.add( Tri );
@@ -1967,7 +1978,9 @@ void
 Quad::replaceEdge( const std::shared_ptr<Edge>& e,
 				   const std::shared_ptr<Edge>& replacement )
 {
+	e->invalidateStars();
 	edgeList[indexOf( e )] = replacement;
+	replacement->invalidateStars();
 }
 
 //TODO: Test
@@ -2177,14 +2190,14 @@ Quad::updateDistortionMetric()
 	auto n4 = edgeList[right]->otherNode( n2 );
 
 	// The two diagonals
-	auto e1 = std::make_shared<Edge>( n1, n4 );
-	auto e2 = std::make_shared<Edge>( n2, n3 );
+	auto e1 = ScratchArena::make<Edge>( n1, n4 );
+	auto e2 = ScratchArena::make<Edge>( n2, n3 );
 
 	// The four triangles
-	auto t1 = std::make_shared<Triangle>( edgeList[base], edgeList[left], e2 );
-	auto t2 = std::make_shared<Triangle>( edgeList[base], e1, edgeList[right] );
-	auto t3 = std::make_shared<Triangle>( edgeList[top], edgeList[right], e2 );
-	auto t4 = std::make_shared<Triangle>( edgeList[top], e1, edgeList[left] );
+	auto t1 = ScratchArena::make<Triangle>( edgeList[base], edgeList[left], e2 );
+	auto t2 = ScratchArena::make<Triangle>( edgeList[base], e1, edgeList[right] );
+	auto t3 = ScratchArena::make<Triangle>( edgeList[top], edgeList[right], e2 );
+	auto t4 = ScratchArena::make<Triangle>( edgeList[top], e1, edgeList[left] );
 
 	// Place the firstNodes correctly
 	t1->firstNode = firstNode;
@@ -2358,7 +2371,7 @@ Quad::trianglesContained( const std::shared_ptr<Triangle>& first )
 	tris.add( first );
 	for ( int j = 0; j < tris.size(); j++ )
 	{
-		auto cur = std::dynamic_pointer_cast<Triangle>( tris.get( j ) );
+		auto cur = rcl::triangleCast( tris.get( j ) );
 		Msg::debug( "...parsing triangle " + cur->descr() );
 
 		for ( int i = 0; i < 3; i++ )
@@ -2366,7 +2379,7 @@ Quad::trianglesContained( const std::shared_ptr<Triangle>& first )
 			auto e = cur->edgeList[i];
 			if ( !hasEdge( e ) )
 			{
-				auto neighbor = std::dynamic_pointer_cast<Triangle>( cur->neighbor( e ) );
+				auto neighbor = rcl::triangleCast( cur->neighbor( e ) );
 				if ( neighbor != nullptr && !tris.contains( neighbor ) )
 				{
 					tris.add( neighbor );
@@ -2389,7 +2402,7 @@ Quad::containsHole( const ArrayList<std::shared_ptr<Triangle>>& tris )
 
 	for ( const auto& element : tris )
 	{
-		if ( auto t = std::dynamic_pointer_cast<Triangle>(element) )
+		if ( auto t = rcl::triangleCast(element) )
 		{
 			if ( t->edgeList[0]->boundaryEdge() && !hasEdge( t->edgeList[0] ) || t->edgeList[1]->boundaryEdge() && !hasEdge( t->edgeList[1] )
 				 || t->edgeList[2]->boundaryEdge() && !hasEdge( t->edgeList[2] ) )
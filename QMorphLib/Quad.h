@@ -20,6 +20,12 @@ class Quad :
 	public std::enable_shared_from_this<Quad>
 {
 public:
+	/** Create an empty quad, whose fields are filled in by MeshSnapshot */
+	Quad() :
+		Element( ElementType::Quad )
+	{
+	}
+
 	/** Create ordinary quad */
 	Quad( const std::shared_ptr<Edge>& baseEdge,
 		  const std::shared_ptr<Edge>& leftEdge,
@@ -51,14 +57,18 @@ public:
 
 	/**
 	 * Constructor to make life easier for elementWithExchangedNode(..) Create fake
-	 * quad with only three nodes
+	 * quad with only three nodes. The edges are made in scratch memory (see
+	 * ScratchArena.h), so the quad must not outlive the current step.
 	 */
 	Quad( const std::shared_ptr<Node>& n1,
 		  const std::shared_ptr<Node>& n2,
 		  const std::shared_ptr<Node>& n3,
 		  const std::shared_ptr<Node>& f );
 
-	/** Constructor to make life easier for elementWithExchangedNode(..) */
+	/**
+	 * Constructor to make life easier for elementWithExchangedNode(..) The edges
+	 * are made in scratch memory, like those of the fake quad above.
+	 */
 	Quad( const std::shared_ptr<Node>& n1,
 		  const std::shared_ptr<Node>& n2,
 		  const std::shared_ptr<Node>& n3,
@@ -203,10 +213,12 @@ public:
 	bool isBowtie();
 
 	/**
+	 * @param chevronMin the least greatest angle of a chevron, 200 degrees by
+	 *                   default, see QMorphOptions
 	 * @return true if the quad is a chevron, defined as a quad with a greatest
-	 *         angle that is greater than 200 degrees.
+	 *         angle that is at least chevronMin.
 	 */
-	bool isChevron();
+	bool isChevron( double chevronMin );
 
 	/**
 	 * @return true if the largest angle of the quad is greater than 180 degrees.
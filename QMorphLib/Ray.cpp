@@ -7,6 +7,7 @@
 #include "MyVector.h"
 
 #include "Numbers.h"
+#include "Predicates.h"
 
 #include <iostream>
 
@@ -47,48 +48,55 @@ Ray::Ray( const std::shared_ptr<Node>& origin,
 double 
 Ray::cross( const MyVector& v )
 {
-	return x * v.y - v.x * y;
+	return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, v.x, v.y );
+}
+
+Vec2
+Ray::direction() const
+{
+	return { x, y };
 }
 
 std::shared_ptr<Node>
 Ray::pointIntersectsAt( const MyVector& d1 )
 {
-	auto p0 = origin;        // this ray's origin
-	auto p1 = d1.origin;     // d1's origin
-	MyVector delta( p0, p1->x - p0->x, p1->y - p0->y ); // vector from p0 to p1
-	Ray d0 = *this;
+	auto p = pointIntersectsAt( d1.origin->point(), d1.vec() );
+	if ( !p )
+	{
+		return nullptr;
+	}
+	if ( rcl::equal( direction().cross( d1.vec() ), 0.0 ) )
+	{ // Parallel, so they touch at the origin of this ray
+		return origin;
+	}
+	return std::make_shared<Node>( p->x, p->y );
+}
 
-	double d0crossd1 = d0.cross( d1 );
+std::optional<Point2>
+Ray::pointIntersectsAt( const Point2& p1, const Vec2& d1 ) const
+{
+	auto p0 = origin->point(); // this ray's origin
+	auto d0 = direction();
 
-	if ( rcl::equal( d0crossd1, 0.0 ) )
+	if ( rcl::equal( d0.cross( d1 ), 0.0 ) )
 	{
-		if ( rcl::equal( delta.cross( d0 ), 0.0 ) )
+		if ( rcl::equal( (p1 - p0).cross( d0 ), 0.0 ) )
 		{ // Parallel and collinear
 			// Check if they touch
-			if ( d0.origin->equals( d1.origin ) ||
-				 (rcl::equal( d0.origin->x, d1.origin->x + d1.x ) &&
-				   rcl::equal( d0.origin->y, d1.origin->y + d1.y )) )
+			if ( p0.nearlyEquals( p1 ) || p0.nearlyEquals( p1 + d1 ) )
 			{
-				return d0.origin;
+				return p0;
 			}
 		}
-		return nullptr; // Parallel but not collinear
+		return std::nullopt; // Parallel but not collinear
 	}
-	else
+
+	auto c = intersection( p0, d0, p1, d1 );
+	if ( !c || c->t < 0 || c->t > 1 || c->s < 0 )
 	{
-		double s = delta.cross( d1 ) / d0crossd1;
-		double t = delta.cross( d0 ) / d0crossd1;
-		if ( t < 0 || t > 1 || s < 0 )
-		{
-			return nullptr; // Intersection not within ray1 or vector2 bounds
-		}
-		else
-		{
-			double x = d1.origin->x + t * d1.x;
-			double y = d1.origin->y + t * d1.y;
-			return std::make_shared<Node>( x, y );
-		}
+		return std::nullopt; // Intersection not within ray1 or vector2 bounds
 	}
+	return p1 + d1 * c->t;
 }
 
 std::string
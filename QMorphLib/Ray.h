@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Vec2.h"
+
 #include <memory>
+#include <optional>
 #include <string>
 
 /**
@@ -37,8 +40,15 @@ public:
 
 	double cross( const MyVector& v );
 
+	// The direction of the ray, of length 1
+	Vec2 direction() const;
+
 	std::shared_ptr<Node> pointIntersectsAt( const MyVector& d1 );
 
+	// Coordinate version of pointIntersectsAt(MyVector): the vector d1 starts
+	// at p1
+	std::optional<Point2> pointIntersectsAt( const Point2& p1, const Vec2& d1 ) const;
+
 	std::string values();
 
 	std::string descr();
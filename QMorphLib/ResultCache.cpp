@@ -0,0 +1,255 @@
+#include "pch.h"
+#include "ResultCache.h"
+
+#include "Checkpoint.h"
+#include "GeomBasics.h"
+#include "QMorph.h"
+#include "ThreadPool.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Msg.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+// Bumped whenever the canonical form or the tunables hashed by key(..) change
+static constexpr uint32_t resultCacheVersion = 2;
+
+ResultCache::ResultCache( const std::string& directory, size_t capacity ) :
+	directory( directory ),
+	capacity( capacity )
+{
+	std::error_code ec;
+	std::filesystem::create_directories( directory, ec );
+	if ( ec )
+	{
+		Msg::warning( "Cannot create the result cache " + directory + ": " + ec.message() );
+	}
+}
+
+//TODO: Tests
+std::string
+ResultCache::key( int step_limit, double mesh_size, bool skip_last_smooth, const QMorphOptions& options )
+{
+	// 64 bit FNV-1a over the canonical form
+	uint64_t h = 0xcbf29ce484222325ull;
+	auto bytes = [&h]( const void* p, size_t n ) {
+		auto c = static_cast<const unsigned char*>(p);
+		for ( size_t i = 0; i < n; i++ )
+		{
+			h = (h ^ c[i]) * 0x100000001b3ull;
+		}
+	};
+	auto u64 = [&bytes]( uint64_t v ) { bytes( &v, sizeof( v ) ); };
+	auto f64 = [&u64]( double v ) {
+		uint64_t bits;
+		std::memcpy( &bits, &v, sizeof( v ) );
+		u64( bits );
+	};
+
+	std::vector<const Node*> nodes;
+	for ( const auto& n : GeomBasics::nodeList )
+	{
+		if ( n != nullptr )
+		{
+			nodes.push_back( n.get() );
+		}
+	}
+	std::sort( nodes.begin(), nodes.end(), []( const Node* a, const Node* b ) {
+		return a->x < b->x || (a->x == b->x && a->y < b->y);
+	} );
+	std::unordered_map<const Node*, uint64_t> index( nodes.size() );
+	for ( const auto& n : nodes )
+	{
+		index.emplace( n, index.size() );
+	}
+	auto indexOf = [&index]( const std::shared_ptr<Node>& n ) {
+		auto it = index.find( n.get() );
+		return it != index.end() ? it->second : ~0ull;
+	};
+
+	// Each edge and element as the sorted indices of its nodes, and then the
+	// edges and the elements sorted
+	std::vector<std::vector<uint64_t>> edges, elements;
+	for ( const auto& e : GeomBasics::edgeList )
+	{
+		if ( e != nullptr )
+		{
+			edges.push_back( { indexOf( e->leftNode ), indexOf( e->rightNode ) } );
+			std::sort( edges.back().begin(), edges.back().end() );
+		}
+	}
+	auto addElement = [&indexOf, &elements]( const std::shared_ptr<Element>& elem ) {
+		std::vector<uint64_t> tuple;
+		for ( const auto& e : elem->edgeList )
+		{
+			tuple.push_back( indexOf( e->leftNode ) );
+			tuple.push_back( indexOf( e->rightNode ) );
+		}
+		std::sort( tuple.begin(), tuple.end() );
+		tuple.erase( std::unique( tuple.begin(), tuple.end() ), tuple.end() );
+		elements.push_back( std::move( tuple ) );
+	};
+	for ( const auto& t : GeomBasics::triangleList )
+	{
+		if ( t != nullptr )
+		{
+			addElement( t );
+		}
+	}
+	for ( const auto& elem : GeomBasics::elementList )
+	{
+		if ( elem != nullptr )
+		{
+			addElement( elem );
+		}
+	}
+	std::sort( edges.begin(), edges.end() );
+	std::sort( elements.begin(), elements.end() );
+
+	u64( resultCacheVersion );
+	u64( nodes.size() );
+	for ( const auto& n : nodes )
+	{
+		f64( n->x );
+		f64( n->y );
+	}
+	for ( const auto* list : { &edges, &elements } )
+	{
+		u64( list->size() );
+		for ( const auto& tuple : *list )
+		{
+			u64( tuple.size() );
+			for ( auto i : tuple )
+			{
+				u64( i );
+			}
+		}
+	}
+
+	u64( static_cast<uint64_t>(step_limit) );
+	f64( mesh_size );
+	u64( skip_last_smooth );
+	u64( Constants::doTri2QuadConversion );
+	u64( Constants::doCleanUp );
+	u64( Constants::doSmooth );
+	const auto& o = options;
+	for ( double v : { o.epsilon1, o.epsilon2, o.chevronMin, o.obsTol, o.myMin, o.gamma,
+					   Constants::EPSILON, Constants::EPSILONLARGER, Constants::COINCTOL,
+					   Constants::MOVETOLERANCE, Constants::DELTAFACTOR, Constants::THETAMAX,
+					   Constants::TOL } )
+	{
+		f64( v );
+	}
+	u64( static_cast<uint64_t>(o.maxIter) );
+
+	char hex[17];
+	std::snprintf( hex, sizeof( hex ), "%016llx", static_cast<unsigned long long>(h) );
+	return hex;
+}
+
+std::string
+ResultCache::pathOf( const std::string& key ) const
+{
+	return (std::filesystem::path( directory ) / (key + ".qmcp")).string();
+}
+
+//TODO: Tests
+bool
+ResultCache::load( const std::string& key )
+{
+	auto path = pathOf( key );
+	std::error_code ec;
+	if ( !std::filesystem::exists( path, ec ) )
+	{
+		nMisses++;
+		return false;
+	}
+
+	// Read the entry into the lists of a worker thread, so that the lists of
+	// this thread are left alone if it turns out to be unreadable
+	bool ok = false;
+	MeshComponents::Component result;
+	{
+		ThreadPool pool( 1 );
+		result = pool.submit( [&path, &ok]() {
+			MeshComponents::Component c;
+			QMorph morph;
+			Checkpoint::Phase phase;
+			if ( Checkpoint::load( path, morph, phase ) && phase == Checkpoint::Phase::Done )
+			{
+				ok = true;
+				GeomBasics::compactLists();
+				c.triangles.addAll( GeomBasics::triangleList );
+				c.edges.addAll( GeomBasics::edgeList );
+				c.nodes.addAll( GeomBasics::nodeList );
+				c.elements.addAll( GeomBasics::elementList );
+				// The mesh is handed on in c
+				GeomBasics::detachLists();
+				Edge::clearStateList();
+			}
+			GeomBasics::clearLists();
+			return c;
+		} ).get();
+	}
+	if ( !ok )
+	{
+		Msg::warning( "Dropping the unreadable result cache entry " + path );
+		std::filesystem::remove( path, ec );
+		nMisses++;
+		return false;
+	}
+
+	GeomBasics::clearLists();
+	GeomBasics::triangleList.addAll( result.triangles );
+	GeomBasics::edgeList.addAll( result.edges );
+	GeomBasics::nodeList.addAll( result.nodes );
+	GeomBasics::elementList.addAll( result.elements );
+	GeomBasics::findExtremeNodes();
+
+	std::filesystem::last_write_time( path, std::filesystem::file_time_type::clock::now(), ec );
+	nHits++;
+	return true;
+}
+
+//TODO: Tests
+bool
+ResultCache::store( const std::string& key )
+{
+	if ( !Checkpoint::save( pathOf( key ), Checkpoint::Phase::Done, nullptr ) )
+	{
+		return false;
+	}
+	evict();
+	return true;
+}
+
+void
+ResultCache::evict()
+{
+	std::error_code ec;
+	std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+	for ( const auto& entry : std::filesystem::directory_iterator( directory, ec ) )
+	{
+		if ( entry.is_regular_file( ec ) && entry.path().extension() == ".qmcp" )
+		{
+			entries.emplace_back( entry.last_write_time( ec ), entry.path() );
+		}
+	}
+	if ( entries.size() <= capacity )
+	{
+		return;
+	}
+
+	std::sort( entries.begin(), entries.end() );
+	for ( size_t i = 0; i < entries.size() - capacity; i++ )
+	{
+		Msg::debug( "Evicting result cache entry " + entries[i].second.string() );
+		std::filesystem::remove( entries[i].second, ec );
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "QMorphOptions.h"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * An on-disk cache of finished quad meshes, keyed by the input triangle mesh
+ * and the parameters of the run.
+ *
+ * The key is a hash of the input in the GeomBasics lists in a canonical form,
+ * that is the node coordinates sorted, and the edges and elements as sorted
+ * tuples of indices into the sorted nodes, together with the arguments of
+ * QMorph::init(..), the QMorphOptions and the
+ * tolerances in Constants.
+ * The same mesh read in another order thus gives the same key.
+ *
+ * Each entry is a binary snapshot of the finished mesh, see Checkpoint, in a
+ * file named by its key. The cache holds at most a given number of entries,
+ * and evicts the least recently used ones, as told by the modification times
+ * of their files, which are renewed on every hit. The cache can therefore be
+ * shared by successive runs.
+ */
+
+class ResultCache
+{
+public:
+	/**
+	 * @param directory the directory to keep the entries in, created if needed
+	 * @param capacity  the largest number of entries to keep
+	 */
+	ResultCache( const std::string& directory, size_t capacity );
+
+	/** @return the key of the triangle mesh in the GeomBasics lists, run with the given parameters */
+	static std::string key( int step_limit = -1,
+							double mesh_size = 0.0,
+							bool skip_last_smooth = false,
+							const QMorphOptions& options = QMorphOptions() );
+
+	/**
+	 * Replace the mesh in the GeomBasics lists by the cached result for key, if
+	 * there is one.
+	 *
+	 * @return false on a miss, leaving the lists as they were
+	 */
+	bool load( const std::string& key );
+
+	/** Store the mesh in the GeomBasics lists as the result for key. */
+	bool store( const std::string& key );
+
+	/** @return the number of calls to load(..) that found a result */
+	size_t hits() const { return nHits; }
+
+	/** @return the number of calls to load(..) that did not */
+	size_t misses() const { return nMisses; }
+
+private:
+	std::string directory;
+	size_t capacity;
+	size_t nHits = 0;
+	size_t nMisses = 0;
+
+	std::string pathOf( const std::string& key ) const;
+
+	/** Remove the least recently used entries beyond the capacity. */
+	void evict();
+};
@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "ScratchArena.h"
+
+#include "Msg.h"
+
+#include <algorithm>
+#include <bit>
+
+ScratchArena::Scope::Scope()
+{
+	local().open();
+}
+
+ScratchArena::Scope::~Scope()
+{
+	local().close();
+}
+
+ScratchArena::ScratchArena() :
+	block( initialBlockSize )
+{
+	arena.emplace( block.data(), block.size() );
+}
+
+ScratchArena&
+ScratchArena::local()
+{
+	thread_local ScratchArena scratch;
+	return scratch;
+}
+
+std::pmr::memory_resource*
+ScratchArena::resource()
+{
+	auto& scratch = local();
+	if ( scratch.depth > 0 )
+	{
+		return &scratch;
+	}
+	return std::pmr::new_delete_resource();
+}
+
+bool
+ScratchArena::active()
+{
+	return local().depth > 0;
+}
+
+size_t
+ScratchArena::bytesInUse()
+{
+	return local().inUse;
+}
+
+size_t
+ScratchArena::blockSize()
+{
+	return local().block.size();
+}
+
+void
+ScratchArena::open()
+{
+	depth++;
+}
+
+void
+ScratchArena::close()
+{
+	if ( --depth > 0 )
+	{
+		return;
+	}
+	if ( inUse != 0 )
+	{
+		Msg::error( "ScratchArena: a Scope closed with " + std::to_string( inUse ) + " bytes of scratch memory still in use" );
+	}
+
+	arena->release();
+	if ( used > block.size() && block.size() < maxBlockSize )
+	{
+		// The Scope outgrew the block, so make it large enough for next time
+		arena.reset();
+		block = std::vector<std::byte>( std::min( std::bit_ceil( used ), maxBlockSize ) );
+		arena.emplace( block.data(), block.size() );
+	}
+	used = 0;
+}
+
+void*
+ScratchArena::do_allocate( size_t bytes, size_t alignment )
+{
+	inUse += bytes;
+	used += bytes;
+	return arena->allocate( bytes, alignment );
+}
+
+void
+ScratchArena::do_deallocate( void* p, size_t bytes, size_t alignment )
+{
+	// The memory itself is given back when the Scope closes
+	inUse -= bytes;
+	arena->deallocate( p, bytes, alignment );
+}
+
+bool
+ScratchArena::do_is_equal( const std::pmr::memory_resource& other ) const noexcept
+{
+	return this == &other;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ArrayList.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+/**
+ * A monotonic arena for the short-lived temporaries of the meshing loop: the
+ * lists, edges, triangles and element copies that a step of QMorph or a
+ * cleanup operation of TopoCleanup makes and drops again. While a Scope is
+ * open on a thread, the ScratchAllocators made on that thread take their
+ * memory from its arena, and when the outermost Scope closes the whole arena
+ * is released at once. Scopes opened inside another one share its arena.
+ * Outside a Scope, scratch memory comes from the heap, so the code making
+ * scratch temporaries also works when it is not called from the meshing loop.
+ *
+ * Everything allocated in a Scope must be gone when it closes. Scratch lists
+ * and objects are therefore only made for values that do not outlive the
+ * function making them, or that are passed out to callers in the same Scope.
+ * Closing a Scope while scratch memory is still in use is an error.
+ *
+ * The arena starts with a block of its own and grows it, up to a limit, to
+ * fit the largest Scope seen on the thread, so that after the first few steps
+ * the temporaries make no heap allocations at all.
+ */
+
+class ScratchArena :
+	public std::pmr::memory_resource
+{
+public:
+	/** Opens the arena of the calling thread for the lifetime of the object. */
+	class Scope
+	{
+	public:
+		Scope();
+		~Scope();
+
+		Scope( const Scope& ) = delete;
+		Scope& operator=( const Scope& ) = delete;
+	};
+
+	/**
+	 * @return the arena of the calling thread if a Scope is open on it, else
+	 *         the heap
+	 */
+	static std::pmr::memory_resource* resource();
+
+	/** @return true if a Scope is open on the calling thread */
+	static bool active();
+
+	/** @return the bytes of scratch memory in use on the calling thread */
+	static size_t bytesInUse();
+
+	/** @return the size of the arena's own block on the calling thread */
+	static size_t blockSize();
+
+	/** Make a T in scratch memory. */
+	template< typename T, typename... Args >
+	static std::shared_ptr<T> make( Args&&... args );
+
+	ScratchArena( const ScratchArena& ) = delete;
+	ScratchArena& operator=( const ScratchArena& ) = delete;
+
+private:
+	ScratchArena();
+
+	static ScratchArena& local();
+
+	void open();
+	void close();
+
+	void* do_allocate( size_t bytes, size_t alignment ) override;
+	void do_deallocate( void* p, size_t bytes, size_t alignment ) override;
+	bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override;
+
+	static constexpr size_t initialBlockSize = 64 * 1024;
+	static constexpr size_t maxBlockSize = 4 * 1024 * 1024;
+
+	std::vector<std::byte> block;
+	std::optional<std::pmr::monotonic_buffer_resource> arena;
+	size_t inUse = 0; // Allocated and not yet deallocated
+	size_t used = 0; // Allocated since the Scope opened
+	int depth = 0;
+};
+
+/**
+ * An allocator taking its memory from ScratchArena::resource() at the time it
+ * is made. Copies of a container share its memory resource, except that a
+ * copy constructed container takes the one current when it is made.
+ */
+template< typename T >
+class ScratchAllocator
+{
+public:
+	using value_type = T;
+
+	ScratchAllocator() noexcept :
+		mResource( ScratchArena::resource() )
+	{
+	}
+
+	template< typename U >
+	ScratchAllocator( const ScratchAllocator<U>& other ) noexcept :
+		mResource( other.resource() )
+	{
+	}
+
+	T* allocate( size_t n )
+	{
+		return static_cast<T*>(mResource->allocate( n * sizeof( T ), alignof(T) ));
+	}
+
+	void deallocate( T* p, size_t n ) noexcept
+	{
+		mResource->deallocate( p, n * sizeof( T ), alignof(T) );
+	}
+
+	ScratchAllocator select_on_container_copy_construction() const
+	{
+		return ScratchAllocator();
+	}
+
+	std::pmr::memory_resource* resource() const noexcept
+	{
+		return mResource;
+	}
+
+	template< typename U >
+	bool operator==( const ScratchAllocator<U>& other ) const noexcept
+	{
+		return mResource == other.resource();
+	}
+
+private:
+	std::pmr::memory_resource* mResource;
+};
+
+/** An ArrayList in scratch memory, for the temporary lists of a step. */
+template< typename T >
+using ScratchList = ArrayList<T, ScratchAllocator<T>>;
+
+template< typename T, typename... Args >
+std::shared_ptr<T>
+ScratchArena::make( Args&&... args )
+{
+	return std::allocate_shared<T>( ScratchAllocator<T>(), std::forward<Args>( args )... );
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool( unsigned nThreads )
+{
+	if ( nThreads == 0 )
+	{
+		nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+	workers.reserve( nThreads );
+	for ( unsigned i = 0; i < nThreads; i++ )
+	{
+		workers.emplace_back( [this]() { work(); } );
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lk( mutex );
+		stopping = true;
+	}
+	cv.notify_all();
+	for ( auto& worker : workers )
+	{
+		worker.join();
+	}
+}
+
+void
+ThreadPool::work()
+{
+	while ( true )
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lk( mutex );
+			cv.wait( lk, [this]() { return stopping || !tasks.empty(); } );
+			if ( tasks.empty() )
+			{
+				return;
+			}
+			task = std::move( tasks.front() );
+			tasks.pop();
+		}
+		task();
+	}
+}
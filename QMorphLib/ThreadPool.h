@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A fixed-size pool of worker threads executing queued tasks in FIFO order.
+ * The mesh lists in GeomBasics are thread_local, so a task sees the lists of
+ * its worker thread, not those of the thread that submitted it. Worker threads
+ * are reused, and a task must leave those lists as it found them.
+ */
+
+class ThreadPool
+{
+public:
+	/**
+	 * @param nThreads the number of worker threads, or 0 to use one thread per
+	 *                 hardware thread
+	 */
+	explicit ThreadPool( unsigned nThreads = 0 );
+
+	/** Finish the queued tasks and join the workers. */
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+
+	/** @return the number of worker threads */
+	unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+	/**
+	 * Queue a task for execution.
+	 *
+	 * @return a future holding the result of the task, or the exception it threw
+	 */
+	template< typename F >
+	auto submit( F&& f ) -> std::future<std::invoke_result_t<F>>
+	{
+		using R = std::invoke_result_t<F>;
+		auto task = std::make_shared<std::packaged_task<R()>>( std::forward<F>( f ) );
+		auto result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lk( mutex );
+			tasks.emplace( [task]() { (*task)(); } );
+		}
+		cv.notify_one();
+		return result;
+	}
+
+private:
+	void work();
+
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool stopping = false;
+};
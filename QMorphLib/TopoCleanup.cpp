@@ -4,10 +4,20 @@
 #include "Quad.h"
 #include "Triangle.h"
 #include "GlobalSmooth.h"
+#include "MeshTransaction.h"
+#include "ScratchArena.h"
 
 #include "Msg.h"
 #include "Types.h"
 
+#include <unordered_set>
+
+//TODO: Tests
+TopoCleanup::TopoCleanup( const QMorphOptions& options ) :
+	m_options( options )
+{
+}
+
 //TODO: Tests
 void 
 TopoCleanup::init()
@@ -33,7 +43,9 @@ TopoCleanup::init()
 	// Ok... Remove fake quads and replace with triangles:
 	for ( int i = 0; i < elementList.size(); i++ )
 	{
-		if ( auto q = std::dynamic_pointer_cast<Quad>( elementList.get( i ) ) )
+		// Held, as the quad leaves the list before it is disconnected
+		auto elem = elementList.get( i );
+		if ( auto q = rcl::asQuad( elem ) )
 		{
 			if ( q->isFake )
 			{
@@ -55,59 +67,78 @@ TopoCleanup::run()
 {
 	Msg::debug( "Entering TopoCleanup.run()" );
 
-	int j;
-
 	if ( !m_step )
 	{
+		// The cleanups finished so far are skipped when resuming from a
+		// checkpoint, so each one is followed by a checkpoint of its own
+		Checkpoint::saveIfEnabled( Checkpoint::Phase::Cleanup, nullptr );
+
 		// Initial pass to eliminate chevrons
-		while ( !elimChevsFinished )
+		if ( !elimChevsFinished )
 		{
-			elimChevsStep();
+			while ( !elimChevsFinished )
+			{
+				elimChevsStep();
+			}
+			Checkpoint::saveIfEnabled( Checkpoint::Phase::Cleanup, nullptr );
 		}
 
 		// Then the major cleanup processes:
-		for ( j = 0; j < 3; j++ )
+		for ( ; passNum < 3; passNum++ )
 		{
-
 			// Perform connectivity cleanup:
 			// Parse the list of nodes looking for cases that match. Fix these.
-			connCleanupFinished = false;
-			while ( !connCleanupFinished )
+			if ( !connCleanupFinished )
 			{
-				connCleanupStep();
+				while ( !connCleanupFinished )
+				{
+					connCleanupStep();
+				}
+				// Run some kind of global smooth
+				globalSmooth();
+				Checkpoint::saveIfEnabled( Checkpoint::Phase::Cleanup, nullptr );
 			}
-			// Run some kind of global smooth
-			globalSmooth();
 
 			// Boundary cleanup:
 			// Parse the list of elements looking for cases that match. Fix these.
-			boundaryCleanupFinished = false;
-			bcaseValPat1Fin = false;
-			bcaseValPat2Fin = false;
-			bcaseValPat3Fin = false;
-			bcaseValPat4Fin = false;
-			bcaseTriQFin = false;
-			bcaseDiamondFin = false;
-			while ( !boundaryCleanupFinished )
+			if ( !boundaryCleanupFinished )
 			{
-				boundaryCleanupStep();
+				while ( !boundaryCleanupFinished )
+				{
+					boundaryCleanupStep();
+				}
+				// Run some kind of global smooth
+				globalSmooth();
+				Checkpoint::saveIfEnabled( Checkpoint::Phase::Cleanup, nullptr );
 			}
-			// Run some kind of global smooth
-			globalSmooth();
 
 			// Shape cleanup:
 			// Parse the list of elements looking for cases that match. Fix these.
 			// Run a local smooth after each action.
-			shapeCleanupFinished = false;
-			shape1stTypeFin = false;
-			while ( !shapeCleanupFinished )
+			if ( !shapeCleanupFinished )
 			{
-				shapeCleanupStep();
+				while ( !shapeCleanupFinished )
+				{
+					shapeCleanupStep();
+				}
+
+				// Run some kind of global smooth
+				globalSmooth();
+				Checkpoint::saveIfEnabled( Checkpoint::Phase::Cleanup, nullptr );
 			}
 
-			// Run some kind of global smooth
-			globalSmooth();
+			connCleanupFinished = false;
+			boundaryCleanupFinished = false;
+			bcaseValPat1Fin = false;
+			bcaseValPat2Fin = false;
+			bcaseValPat3Fin = false;
+			bcaseValPat4Fin = false;
+			bcaseTriQFin = false;
+			bcaseDiamondFin = false;
+			shapeCleanupFinished = false;
+			shape1stTypeFin = false;
 		}
+		passNum = 0;
 	}
 
 	if ( doSmooth )
@@ -121,6 +152,85 @@ TopoCleanup::run()
 	Msg::debug( "Leaving TopoCleanup.run()" );
 }
 
+//TODO: Tests
+void
+TopoCleanup::cleanupAlong( const ArrayList<std::shared_ptr<Node>>& seam )
+{
+	Msg::debug( "Entering TopoCleanup.cleanupAlong(..)" );
+
+	nodes = seam;
+	count = 0;
+	connCleanupFinished = false;
+	while ( !connCleanupFinished )
+	{
+		connCleanupStep();
+	}
+
+	// Smooth the seam nodes that survived the cleanup
+	std::unordered_set<const Node*> alive;
+	for ( const auto& n : nodeList )
+	{
+		alive.insert( n.get() );
+	}
+	ArrayList<std::shared_ptr<Node>> remaining;
+	for ( const auto& n : seam )
+	{
+		if ( alive.count( n.get() ) != 0 )
+		{
+			remaining.add( n );
+		}
+	}
+	smoothNodes( remaining );
+
+	Msg::debug( "Leaving TopoCleanup.cleanupAlong(..)" );
+}
+
+//TODO: Tests
+void
+TopoCleanup::writeState( Checkpoint::Writer& w ) const
+{
+	w.flag( elimChevsFinished );
+	w.flag( connCleanupFinished );
+	w.flag( boundaryCleanupFinished );
+	w.flag( shapeCleanupFinished );
+	w.flag( bcaseTriQFin );
+	w.flag( bcaseValPat1Fin );
+	w.flag( bcaseValPat2Fin );
+	w.flag( bcaseValPat3Fin );
+	w.flag( bcaseValPat4Fin );
+	w.flag( bcaseDiamondFin );
+	w.flag( shape1stTypeFin );
+	w.i32( passNum );
+	w.i32( count );
+	w.nodes( nodes );
+	w.node( d.n );
+	w.edge( d.e );
+	w.element( d.elem );
+}
+
+//TODO: Tests
+void
+TopoCleanup::readState( Checkpoint::Reader& r )
+{
+	elimChevsFinished = r.flag();
+	connCleanupFinished = r.flag();
+	boundaryCleanupFinished = r.flag();
+	shapeCleanupFinished = r.flag();
+	bcaseTriQFin = r.flag();
+	bcaseValPat1Fin = r.flag();
+	bcaseValPat2Fin = r.flag();
+	bcaseValPat3Fin = r.flag();
+	bcaseValPat4Fin = r.flag();
+	bcaseDiamondFin = r.flag();
+	shape1stTypeFin = r.flag();
+	passNum = r.i32();
+	count = r.i32();
+	nodes = r.nodes();
+	d.n = r.node();
+	d.e = r.edge();
+	d.elem = r.element();
+}
+
 //TODO: Tests
 void
 TopoCleanup::step()
@@ -193,6 +303,8 @@ void
 TopoCleanup::elimChevsStep()
 {
 	Msg::debug( "Entering TopoCleanup.elimChevsStep()" );
+	// The temporaries of the cleanup operation are dropped together
+	ScratchArena::Scope scratch;
 
 	std::shared_ptr<Element> elem;
 
@@ -208,13 +320,13 @@ TopoCleanup::elimChevsStep()
 		{
 			Msg::debug( "...testing element " + elem->descr() );
 
-			auto q = std::dynamic_pointer_cast<Quad>(elem);
+			auto q = rcl::quadCast(elem);
 			if ( q->isFake )
 			{
 				Msg::error( "...Fake quad encountered!!!" );
 			}
 
-			if ( q->isChevron() )
+			if ( q->isChevron( m_options.chevronMin ) )
 			{
 				eliminateChevron( q );
 				count++;
@@ -228,11 +340,8 @@ TopoCleanup::elimChevsStep()
 		}
 	}
 
-	//Remove all nullptr items from the elementList:
-	elementList.erase(
-		std::remove( elementList.begin(), elementList.end(), nullptr ),
-		elementList.end()
-	);
+	// Drop the removed elements, edges and nodes from the lists:
+	compactLists();
 
 	elimChevsFinished = true;
 	count = 0;
@@ -274,30 +383,31 @@ TopoCleanup::eliminateChevron( const std::shared_ptr<Quad>& q )
 
 		if ( !n->equals( nNew ) )
 		{
-			n->moveTo( *nNew );
+			MeshTransaction trial;
+			trial.moveNode( n, *nNew );
 			inversionCheckAndRepair( n, nOld );
-			if ( !q->isChevron() )
+			if ( !q->isChevron( m_options.chevronMin ) )
 			{
 				n->update();
+				trial.commit();
 				Msg::debug( "...success! Chevron resolved by smoothing!!!!" );
 				return;
 			}
 			else
 			{
-				n->setXY( nOld->x, nOld->y );
-				n->update();
+				trial.rollback();
 				Msg::debug( "...unsuccessful! Chevron not resolved by smoothing!" );
 			}
 		}
 	}
 
-	auto q1 = std::dynamic_pointer_cast<Quad>(neighbor1);
+	auto q1 = rcl::quadCast(neighbor1);
 	if ( q1 && q1->largestAngleGT180() )
 	{
 		q1 = nullptr;
 	}
 
-	auto q2 = std::dynamic_pointer_cast<Quad>(neighbor2);
+	auto q2 = rcl::quadCast(neighbor2);
 	if ( q2 && q2->largestAngleGT180() )
 	{
 		q2 = nullptr;
@@ -379,8 +489,8 @@ TopoCleanup::eliminateChevron( const std::shared_ptr<Quad>& q )
 	{
 
 		Msg::debug( "...alt1 preferred, q1: " + q1->descr() );
-		elementList.set( elementList.indexOf( q ), nullptr );
-		elementList.set( elementList.indexOf( q1 ), nullptr );
+		elementList.markRemoved( q );
+		elementList.markRemoved( q1 );
 
 		if ( q->ang[q->angleIndex( n1 )] + q1->ang[q1->angleIndex( n1 )] < DEG_180 )
 		{
@@ -395,8 +505,8 @@ TopoCleanup::eliminateChevron( const std::shared_ptr<Quad>& q )
 	else if ( q2 != nullptr )
 	{
 		Msg::debug( "...alt2 preferred, q2: " + q2->descr() );
-		elementList.set( elementList.indexOf( q ), nullptr );
-		elementList.set( elementList.indexOf( q2 ), nullptr );
+		elementList.markRemoved( q );
+		elementList.markRemoved( q2 );
 
 		if ( q->ang[q->angleIndex( n3 )] + q2->ang[q2->angleIndex( n3 )] < DEG_180 )
 		{
@@ -425,11 +535,11 @@ TopoCleanup::fill3( const std::shared_ptr<Quad>& q,
 	Msg::debug( "Entering TopoCleanup.fill3(..)" );
 	Msg::debug( "...q= " + q->descr() + ", e= " + e->descr() + ", n= " + n->descr() );
 
-	auto qn = std::dynamic_pointer_cast<Quad>(q->neighbor( e ));
+	auto qn = rcl::quadCast(q->neighbor( e ));
 	auto nOpp = q->oppositeNode( n );
 	auto e2 = q->neighborEdge( n, e );
 	auto eother = e->otherNode( n ), e2other = e2->otherNode( n );
-	auto d = std::make_shared<Dart>();
+	auto d = ScratchArena::make<Dart>();
 
 	std::shared_ptr<Node> newNode;
 	if ( safe )
@@ -508,7 +618,7 @@ TopoCleanup::fill3( const std::shared_ptr<Quad>& q,
 	elementList.add( qn3 );
 
 	e->disconnectNodes();
-	edgeList.remove( edgeList.indexOf( e ) );
+	edgeList.markRemoved( e );
 
 	edgeList.add( ea );
 	edgeList.add( eb );
@@ -547,8 +657,8 @@ TopoCleanup::fill4( const std::shared_ptr<Quad>& q,
 	Msg::debug( "Entering TopoCleanup.fill4(..)" );
 	Msg::debug( "...q= " + q->descr() + ", e= " + e->descr() + ", n= " + n2->descr() );
 
-	auto d = std::make_shared<Dart>();
-	auto qn = std::dynamic_pointer_cast<Quad>( q->neighbor( e ) );
+	auto d = ScratchArena::make<Dart>();
+	auto qn = rcl::quadCast( q->neighbor( e ) );
 	// First get the nodes and edges in the two quads
 	//Edge temp;
 	auto n5 = e->otherNode( n2 );
@@ -645,7 +755,7 @@ TopoCleanup::fill4( const std::shared_ptr<Quad>& q,
 	qNew3->connectEdges();
 	qNew4->connectEdges();
 
-	edgeList.remove( edgeList.indexOf( e ) );
+	edgeList.markRemoved( e );
 	edgeList.add( eNew1 );
 	edgeList.add( eNew2 );
 	edgeList.add( eNew3 );
@@ -717,39 +827,35 @@ TopoCleanup::applyComposition( const std::shared_ptr<Dart>& startDart,
 		}
 		else if ( a == 3 )
 		{
-			d = closeQuad( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n, false );
+			d = closeQuad( rcl::quadCast(d->elem), d->e, d->n, false );
 		}
 		else if ( a == 4 )
 		{
-			d = closeQuad( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n, true );
+			d = closeQuad( rcl::quadCast(d->elem), d->e, d->n, true );
 		}
 		else if ( a == 5 )
 		{
-			auto qaIndex = elementList.indexOf( d->elem );
-			elementList.remove( qaIndex );
-			auto qbIndex = elementList.indexOf( d->elem->neighbor( d->e ) );
-			elementList.remove( qbIndex );
-			d = fill3( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n, true );
+			elementList.markRemoved( d->elem );
+			elementList.markRemoved( d->elem->neighbor( d->e ) );
+			d = fill3( rcl::quadCast(d->elem), d->e, d->n, true );
 		}
 		else if ( a == 6 )
 		{
-			auto qaIndex = elementList.indexOf( d->elem );
-			elementList.remove( qaIndex );
-			auto qbIndex = elementList.indexOf( d->elem->neighbor( d->e ) );
-			elementList.remove( qbIndex );
-			d = fill4( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n );
+			elementList.markRemoved( d->elem );
+			elementList.markRemoved( d->elem->neighbor( d->e ) );
+			d = fill4( rcl::quadCast(d->elem), d->e, d->n );
 		}
 		else if ( a == 7 )
 		{
-			d = openQuad( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n );
+			d = openQuad( rcl::quadCast(d->elem), d->e, d->n );
 		}
 		else if ( a == 8 )
 		{
-			d = switchDiagonalCW( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n );
+			d = switchDiagonalCW( rcl::quadCast(d->elem), d->e, d->n );
 		}
 		else if ( a == 9 )
 		{
-			d = switchDiagonalCCW( std::dynamic_pointer_cast<Quad>(d->elem), d->e, d->n );
+			d = switchDiagonalCCW( rcl::quadCast(d->elem), d->e, d->n );
 		}
 		else
 		{
@@ -785,6 +891,7 @@ void
 TopoCleanup::connCleanupStep()
 {
 	Msg::debug( "Entering TopoCleanup.connCleanupStep()" );
+	ScratchArena::Scope scratch;
 	int i, vInd;
 	std::shared_ptr<Node> c = nullptr;
 	std::shared_ptr<Element> elem;
@@ -988,6 +1095,7 @@ TopoCleanup::connCleanupStep()
 		}
 	}
 
+	compactLists();
 	nodes = nodeList;
 	connCleanupFinished = true;
 	count = 0;
@@ -1048,6 +1156,7 @@ void
 TopoCleanup::boundaryCleanupStep()
 {
 	Msg::debug( "Entering TopoCleanup.boundaryCleanupStep()" );
+	ScratchArena::Scope scratch;
 	int i, j, index;
 	std::shared_ptr<Element> elem;
 	std::shared_ptr<Triangle> tri;
@@ -1251,7 +1360,7 @@ TopoCleanup::boundaryCleanupStep()
 				{ // Must be quad
 					continue;
 				}
-				q = std::dynamic_pointer_cast<Quad>(elem);
+				q = rcl::quadCast(elem);
 
 				if ( n1->edgeList.size() == 2 && q->ang[q->angleIndex( n1 )] > DEG_150 )
 				{
@@ -1271,13 +1380,13 @@ TopoCleanup::boundaryCleanupStep()
 						elem = q->neighbor( e3 );
 						if ( rcl::instanceOf<Quad>(elem) )
 						{
-							q3 = std::dynamic_pointer_cast<Quad>(elem);
+							q3 = rcl::quadCast(elem);
 						}
 
 						elem = q->neighbor( e4 );
 						if ( rcl::instanceOf<Quad>(elem) )
 						{
-							q4 = std::dynamic_pointer_cast<Quad>(elem);
+							q4 = rcl::quadCast(elem);
 						}
 
 						if ( q3 != nullptr && q4 != nullptr )
@@ -1289,13 +1398,13 @@ TopoCleanup::boundaryCleanupStep()
 							elem = q3->neighbor( e33 );
 							if ( rcl::instanceOf<Quad>( elem ) )
 							{
-								q33 = std::dynamic_pointer_cast<Quad>(elem);
+								q33 = rcl::quadCast(elem);
 							}
 
 							elem = q4->neighbor( e44 );
 							if ( rcl::instanceOf<Quad>(elem) )
 							{
-								q44 = std::dynamic_pointer_cast<Quad>(elem);
+								q44 = rcl::quadCast(elem);
 							}
 
 							if ( q33 != nullptr )
@@ -1304,21 +1413,21 @@ TopoCleanup::boundaryCleanupStep()
 								elem = q33->neighbor( e );
 								if ( rcl::instanceOf<Quad>(elem) )
 								{
-									qn = std::dynamic_pointer_cast<Quad>(elem);
+									qn = rcl::quadCast(elem);
 								}
 							}
 
 							if ( q33 == nullptr || q44 == nullptr || qn != q44 )
 							{
 								// One row transition
-								elementList.remove( elementList.indexOf( q ) );
-								elementList.remove( elementList.indexOf( q3 ) );
-								elementList.remove( elementList.indexOf( q4 ) );
+								elementList.markRemoved( q );
+								elementList.markRemoved( q3 );
+								elementList.markRemoved( q4 );
 
 								fill4( q, e4, n3 );
-								qNew = std::dynamic_pointer_cast<Quad>(q3->neighbor( e3 ));
+								qNew = rcl::quadCast(q3->neighbor( e3 ));
 								fill3( q3, e3, n2, true );
-								elementList.remove( elementList.indexOf( qNew ) );
+								elementList.markRemoved( qNew );
 
 								j = static_cast<int>(nodes.indexOf( n1 ));
 								if ( j != -1 )
@@ -1329,15 +1438,15 @@ TopoCleanup::boundaryCleanupStep()
 							else if ( qn == q44 )
 							{
 								// Two row transition
-								elementList.remove( elementList.indexOf( q ) );
-								elementList.remove( elementList.indexOf( q4 ) );
-								elementList.remove( elementList.indexOf( q44 ) );
+								elementList.markRemoved( q );
+								elementList.markRemoved( q4 );
+								elementList.markRemoved( q44 );
 
 								fill3( q4, e44, e44->otherNode( n3 ), true );
-								qNew = std::dynamic_pointer_cast<Quad>(q->neighbor( e4 ));
+								qNew = rcl::quadCast(q->neighbor( e4 ));
 								fill3( q, e4, n3, true );
 
-								elementList.remove( elementList.indexOf( qNew ) );
+								elementList.markRemoved( qNew );
 
 								j = static_cast<int>(nodes.indexOf( n1 ));
 								if ( j != -1 )
@@ -1376,13 +1485,13 @@ TopoCleanup::boundaryCleanupStep()
 				e1 = n1->anotherBoundaryEdge( nullptr );
 				if ( rcl::instanceOf<Quad>(e1->element1) )
 				{
-					q = std::dynamic_pointer_cast<Quad>(e1->element1);
+					q = rcl::quadCast(e1->element1);
 					pq = q;
 					ep = e1;
 				}
 				else
 				{
-					tri = std::dynamic_pointer_cast<Triangle>(e1->element1);
+					tri = rcl::triangleCast(e1->element1);
 					e1 = e1->nextQuadEdgeAt( n1, e1->element1 );
 					if ( e1 != nullptr )
 					{
@@ -1433,7 +1542,7 @@ TopoCleanup::boundaryCleanupStep()
 					e1 = e1->nextQuadEdgeAt( n1, q );
 					if ( e1 != nullptr )
 					{
-						q = std::dynamic_pointer_cast<Quad>(q->neighbor( e1 ));
+						q = rcl::quadCast(q->neighbor( e1 ));
 					}
 					else
 					{
@@ -1448,6 +1557,7 @@ TopoCleanup::boundaryCleanupStep()
 	}
 	else
 	{
+		compactLists();
 		nodes = nodeList;
 		boundaryCleanupFinished = true;
 		count = 0;
@@ -1461,6 +1571,7 @@ void
 TopoCleanup::shapeCleanupStep()
 {
 	Msg::debug( "Entering TopoCleanup.shapeCleanupStep()" );
+	ScratchArena::Scope scratch;
 
 	std::shared_ptr<Element> elem;
 	std::shared_ptr<Quad> q = nullptr, q2 = nullptr, qo = nullptr, qtemp;
@@ -1491,14 +1602,14 @@ TopoCleanup::shapeCleanupStep()
 					{
 						continue;
 					}
-					q = std::dynamic_pointer_cast<Quad>(elem);
+					q = rcl::quadCast(elem);
 					ang = q->ang[q->angleIndex( n )];
 
 					e2 = q->neighborEdge( n, e1 );
 					elem = q->neighbor( e2 );
 					if ( rcl::instanceOf<Quad>( elem ) )
 					{
-						q2 = std::dynamic_pointer_cast<Quad>(elem);
+						q2 = rcl::quadCast(elem);
 
 						ang2 = q2->ang[q2->angleIndex( n )];
 						if ( ang2 > DEG_160 && ang2 > ang )
@@ -1535,7 +1646,7 @@ TopoCleanup::shapeCleanupStep()
 					elem = q->neighbor( eo );
 					if ( rcl::instanceOf<Quad>( elem ) )
 					{
-						qo = std::dynamic_pointer_cast<Quad>(elem);
+						qo = rcl::quadCast(elem);
 						ango = qo->ang[qo->angleIndex( n1 )];
 					}
 
@@ -1556,15 +1667,15 @@ TopoCleanup::shapeCleanupStep()
 					if ( ang2 != 0 && q2angn3 > ango && n3->boundaryNode() && nq2Opp->boundaryNode() )
 					{
 
-						elementList.remove( elementList.indexOf( q ) );
-						elementList.remove( elementList.indexOf( q2 ) );
+						elementList.markRemoved( q );
+						elementList.markRemoved( q2 );
 						fill4( q, e2, n );
 					}
 					else if ( ango != 0 && ango > q2angn3 && n4->boundaryNode() && nq2Opp->boundaryNode() )
 					{
 
-						elementList.remove( elementList.indexOf( q ) );
-						elementList.remove( elementList.indexOf( qo ) );
+						elementList.markRemoved( q );
+						elementList.markRemoved( qo );
 						fill4( qo, eo, n1 );
 					}
 				}
@@ -1574,7 +1685,7 @@ TopoCleanup::shapeCleanupStep()
 					elem = e1->element1;
 					if ( rcl::instanceOf<Quad>(elem) )
 					{
-						q2 = std::dynamic_pointer_cast<Quad>(elem);
+						q2 = rcl::quadCast(elem);
 					}
 					else
 					{
@@ -1585,7 +1696,7 @@ TopoCleanup::shapeCleanupStep()
 					elem = q2->neighbor( e2 );
 					if ( rcl::instanceOf<Quad>(elem) )
 					{
-						q = std::dynamic_pointer_cast<Quad>(elem);
+						q = rcl::quadCast(elem);
 					}
 					else
 					{
@@ -1601,7 +1712,7 @@ TopoCleanup::shapeCleanupStep()
 					elem = q->neighbor( e3 );
 					if ( rcl::instanceOf<Quad>(elem) )
 					{
-						qo = std::dynamic_pointer_cast<Quad>(elem);
+						qo = rcl::quadCast(elem);
 					}
 					else
 					{
@@ -1620,13 +1731,13 @@ TopoCleanup::shapeCleanupStep()
 					}
 
 					openQuad( q, e2, n );
-					elementList.remove( elementList.indexOf( q2->neighbor( e2 ) ) );
-					elementList.remove( elementList.indexOf( qo->neighbor( e3 ) ) );
+					elementList.markRemoved( q2->neighbor( e2 ) );
+					elementList.markRemoved( qo->neighbor( e3 ) );
 					fill3( q2, e2, n2, true );
 					fill3( qo, e3, n3, true );
 
-					elementList.remove( elementList.indexOf( q2 ) );
-					elementList.remove( elementList.indexOf( qo ) );
+					elementList.markRemoved( q2 );
+					elementList.markRemoved( qo );
 				}
 			}
 		}
@@ -1646,13 +1757,13 @@ TopoCleanup::shapeCleanupStep()
 		{
 			Msg::debug( "...testing element " + elem->descr() );
 
-			q = std::dynamic_pointer_cast<Quad>(elem);
+			q = rcl::quadCast(elem);
 			if ( q->isFake )
 			{
 				Msg::error( "...Fake quad encountered!!!" );
 			}
 
-			if ( q->isChevron() )
+			if ( q->isChevron( m_options.chevronMin ) )
 			{
 				eliminateChevron( q );
 				count++;
@@ -1664,11 +1775,7 @@ TopoCleanup::shapeCleanupStep()
 		}
 	}
 
-	elementList.erase(
-		std::remove( elementList.begin(), elementList.end(), nullptr ),
-		elementList.end()
-	);
-
+	compactLists();
 	nodes = nodeList;
 	shapeCleanupFinished = true;
 	count = 0;
@@ -1689,17 +1796,17 @@ TopoCleanup::getDartAt( const std::shared_ptr<Node>& c,
 		return nullptr;
 	}
 	Msg::debug( "...1st matching node in neighbors: " + neighbors[i]->descr() );
-	auto q1 = std::dynamic_pointer_cast<Quad>(e->element1);
-	auto q2 = std::dynamic_pointer_cast<Quad>(e->element2);
+	auto q1 = rcl::quadCast(e->element1);
+	auto q2 = rcl::quadCast(e->element2);
 
 	Msg::debug( "Leaving getDartAt(..)" );
 	if ( q1->hasNode( neighbors[i + 1] ) )
 	{
-		return std::make_shared<Dart>( c, e, q1 );
+		return ScratchArena::make<Dart>( c, e, q1 );
 	}
 	else if ( q2->hasNode( neighbors[i + 1] ) )
 	{
-		return std::make_shared<Dart>( c, e, q2 );
+		return ScratchArena::make<Dart>( c, e, q2 );
 	}
 	else
 	{
@@ -1715,7 +1822,7 @@ TopoCleanup::closeQuad( const std::shared_ptr<Quad>& q,
 						bool centroid )
 {
 	Msg::debug( "Entering closeQuad(..)" );
-	auto d = std::make_shared<Dart>();
+	auto d = ScratchArena::make<Dart>();
 	auto nElem = q->neighbor( e1 ); // Save for later...
 	auto nKOpp = q->oppositeNode( nK );
 	auto nKp1 = e1->otherNode( nK );
@@ -1746,15 +1853,15 @@ TopoCleanup::closeQuad( const std::shared_ptr<Quad>& q,
 			n = nKOpp;
 		}
 	}
-	elementList.remove( elementList.indexOf( q ) );
+	elementList.markRemoved( q );
 
-	edgeList.remove( edgeList.indexOf( e1 ) ); // e2
-	edgeList.remove( edgeList.indexOf( q->neighborEdge( nK, e1 ) ) ); 
+	edgeList.markRemoved( e1 ); // e2
+	edgeList.markRemoved( q->neighborEdge( nK, e1 ) );
 	q->disconnectEdges();
 	q->closeQuad( e2, e1 ); 
 
 	nKOpp->setXY( *n ); 
-	nodeList.remove( nodeList.indexOf( nK ) ); // nKOpp
+	nodeList.markRemoved( nK ); // nKOpp
 	i = static_cast<int>(nodes.indexOf( nK ));
 	if ( i != -1 )
 	{
@@ -1777,7 +1884,7 @@ TopoCleanup::openQuad( const std::shared_ptr<Quad>& q,
 					   const std::shared_ptr<Node>& n1 )
 {
 	Msg::debug( "Entering openQuad(..)" );
-	auto d = std::make_shared<Dart>();
+	auto d = ScratchArena::make<Dart>();
 	auto c = q->centroid();
 	auto e1 = q->neighborEdge( n1 );
 	auto e2 = q->neighborEdge( n1, e1 );
@@ -1839,13 +1946,13 @@ TopoCleanup::switchDiagonalCCW( const std::shared_ptr<Quad>& qa,
 								const std::shared_ptr<Node>& n )
 {
 	Msg::debug( "Entering switchDiagonalCCW(..)" );
-	auto d = std::make_shared<Dart>();
+	auto d = ScratchArena::make<Dart>();
 	std::shared_ptr<Node> n1a, n2a, n3a, n4a, n1b, n2b, n3b, n4b;
 	std::shared_ptr<Edge> e2a, e3a, e4a, e1b, e2b, e3b, e4b;
 	std::shared_ptr<Edge> eNew, l, r;
 	std::shared_ptr<Quad> q1, q2;
 
-	auto qb = std::dynamic_pointer_cast<Quad>(qa->neighbor( e1a ));
+	auto qb = rcl::quadCast(qa->neighbor( e1a ));
 	auto qaIndex = elementList.indexOf( qa ), qbIndex = elementList.indexOf( qb );
 
 	// First get the edges of qa in ccw order:
@@ -1998,13 +2105,13 @@ TopoCleanup::switchDiagonalCW( const std::shared_ptr<Quad>& qa,
 							   const std::shared_ptr<Node>& n )
 {
 	Msg::debug( "Entering switchDiagonalCW(..)" );
-	auto d = std::make_shared<Dart>();
+	auto d = ScratchArena::make<Dart>();
 	std::shared_ptr<Node> n1a, n2a, n3a, n4a, n1b, n2b, n3b, n4b;
 	std::shared_ptr<Edge> e2a, e3a, e4a, e1b, e2b, e3b, e4b;
 	std::shared_ptr<Edge> eNew, l, r;
 	std::shared_ptr<Quad> q1, q2;
 
-	auto qb = std::dynamic_pointer_cast<Quad>(qa->neighbor( e1a ));
+	auto qb = rcl::quadCast(qa->neighbor( e1a ));
 	auto qaIndex = elementList.indexOf( qa ), qbIndex = elementList.indexOf( qb );
 
 	// First get the edges of qa in ccw order:
@@ -2144,15 +2251,23 @@ void
 TopoCleanup::globalSmooth()
 {
 	Msg::debug( "Entering TopoCleanup.globalSmoth()" );
-	std::shared_ptr<Node> n, nn, nOld;
+	smoothNodes( nodeList );
+	Msg::debug( "Leaving TopoCleanup.globalSmoth()" );
+}
 
-	for ( auto n: nodeList )
+//TODO: Tests
+void
+TopoCleanup::smoothNodes( const ArrayList<std::shared_ptr<Node>>& list )
+{
+	std::shared_ptr<Node> nn, nOld;
+
+	for ( auto n: list )
 	{
 		if ( !n->boundaryNode() )
 		{
 
 			// Try smoothing the pos of the node:
-			nOld = std::make_shared<Node>( n->x, n->y );
+			nOld = n->copyXY();
 			nn = n->laplacianSmooth();
 			if ( !n->equals( nn ) )
 			{
@@ -2162,5 +2277,4 @@ TopoCleanup::globalSmooth()
 			}
 		}
 	}
-	Msg::debug( "Leaving TopoCleanup.globalSmoth()" );
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "Dart.h"
 #include "ArrayList.h"
+#include "Checkpoint.h"
+#include "QMorphOptions.h"
 
 #include <memory>
 
@@ -47,14 +49,34 @@ private:
 	/** A dart used when traversing the mesh in cleanup operations. */
 	int count = 0;
 	ArrayList<std::shared_ptr<Node>> nodes;
+	QMorphOptions m_options;
 
 public:
+	/** @param options the tunable parameters of the cleanup */
+	explicit TopoCleanup( const QMorphOptions& options = QMorphOptions() );
+
 	/** Initialize the object */
 	void init();
 
 	/** Main loop for global topological clean-up */
 	void run();
 
+	/**
+	 * Run the connectivity cleanup on the given nodes and on the nodes it
+	 * changes, and smooth the given nodes. Used along the seams left when the
+	 * subdomains meshed by QMorph::runDecomposed(..) are stitched together.
+	 */
+	void cleanupAlong( const ArrayList<std::shared_ptr<Node>>& seam );
+
+	/**
+	 * Write the pass and the cleanups finished in it, as saved in
+	 * Checkpoint::Phase::Cleanup. run() continues from there.
+	 */
+	void writeState( Checkpoint::Writer& w ) const;
+
+	/** Restore what writeState(..) wrote. */
+	void readState( Checkpoint::Reader& r );
+
 	bool equals( const std::shared_ptr<Constants>& elem ) const override
 	{
 		return std::dynamic_pointer_cast<TopoCleanup>(elem) != nullptr;
@@ -308,4 +330,7 @@ private:
 											const std::shared_ptr<Node>& n );
 	void globalSmooth();
 
+	/** Move each interior node in the list to its Laplacian smoothed position. */
+	void smoothNodes( const ArrayList<std::shared_ptr<Node>>& list );
+
 };
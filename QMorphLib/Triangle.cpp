@@ -4,6 +4,7 @@
 #include "Edge.h"
 #include "MyVector.h"
 #include "Node.h"
+#include "ScratchArena.h"
 
 #include "Msg.h"
 #include "Types.h"
@@ -16,7 +17,8 @@ Triangle::Triangle( const std::shared_ptr<Edge>& edge1,
 					const std::shared_ptr<Edge>& edge3,
 					double len1, double len2, double len3,
 					double ang1, double ang2, double ang3,
-					bool lengthsOpt, bool anglesOpt )
+					bool lengthsOpt, bool anglesOpt ) :
+	Element( ElementType::Triangle )
 {
 	edgeList.assign(3, nullptr);
 
@@ -58,7 +60,8 @@ Triangle::Triangle( const std::shared_ptr<Edge>& edge1,
 }
 
 //TODO: Tests
-Triangle::Triangle( const Triangle& t )
+Triangle::Triangle( const Triangle& t ) :
+	Element( ElementType::Triangle )
 {
 	edgeList.assign( 3, nullptr );
 
@@ -77,7 +80,16 @@ Triangle::Triangle( const Triangle& t )
 //TODO: Tests
 Triangle::Triangle( const std::shared_ptr<Edge>& edge1,
 					const std::shared_ptr<Edge>& edge2,
-					const std::shared_ptr<Edge>& edge3 )
+					const std::shared_ptr<Edge>& edge3 ) :
+	Element( ElementType::Triangle )
+{
+	reinit( edge1, edge2, edge3 );
+}
+
+void
+Triangle::reinit( const std::shared_ptr<Edge>& edge1,
+				  const std::shared_ptr<Edge>& edge2,
+				  const std::shared_ptr<Edge>& edge3 )
 {
 	edgeList.assign( 3, nullptr );
 
@@ -108,6 +120,9 @@ Triangle::Triangle( const std::shared_ptr<Edge>& edge1,
 
 	ang.assign( 3, 0.0 );
 	updateAngles();
+
+	distortionMetric = newDistortionMetric = 0.0;
+	gX = gY = 0.0;
 }
 
 //TODO: Tests
@@ -133,7 +148,7 @@ Triangle::elementWithExchangedNodes( const std::shared_ptr<Node>& original,
 	}
 
 	// Make a copy of the original triangle...
-	auto t = std::make_shared<Triangle>( *this );
+	auto t = ScratchArena::make<Triangle>( *this );
 	auto edge1 = t->edgeList[0], edge2 = t->edgeList[1], edge3 = t->edgeList[2];
 
 	// ... and then replace the node
@@ -868,7 +883,9 @@ void
 Triangle::replaceEdge( const std::shared_ptr<Edge>& e,
 					   const std::shared_ptr<Edge>& replacement )
 {
+	e->invalidateStars();
 	edgeList[indexOf( e )] = replacement;
+	replacement->invalidateStars();
 }
 
 //TODO: Tests
@@ -29,9 +29,24 @@ public:
 			  const std::shared_ptr<Edge>& edge2,
 			  const std::shared_ptr<Edge>& edge3 );
 
+	/** Create an empty triangle, whose fields are filled in by MeshSnapshot */
+	Triangle() :
+		Element( ElementType::Triangle )
+	{
+	}
+
 	// Makes a copy of the given triangle
 	Triangle( const Triangle& t );
 
+	/**
+	 * Make this the triangle with the given edges, as the constructor does, for
+	 * reuse by the mesh generator. The id is kept; the angles, the orientation
+	 * and the smoothing metrics are computed anew.
+	 */
+	void reinit( const std::shared_ptr<Edge>& edge1,
+				 const std::shared_ptr<Edge>& edge2,
+				 const std::shared_ptr<Edge>& edge3 );
+
 	// Create a simple triangle for testing purposes only
 	// (constrainedLaplacianSmooth()
 	// and optBasedSmooth(..))
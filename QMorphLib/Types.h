@@ -4,12 +4,70 @@
 #include "Quad.h"
 
 #include <memory>
+#include <type_traits>
 namespace rcl
 {
+	// Quads and triangles are told apart by Element::type. Other types fall
+	// back on an RTTI cast.
 	template<typename T>
 	static bool instanceOf( const std::shared_ptr<Element>& obj )
 	{
-		return std::dynamic_pointer_cast<T>(obj) != nullptr;
+		if constexpr ( std::is_same_v<T, Quad> )
+		{
+			return obj != nullptr && obj->isQuad();
+		}
+		else if constexpr ( std::is_same_v<T, Triangle> )
+		{
+			return obj != nullptr && obj->isTriangle();
+		}
+		else
+		{
+			return std::dynamic_pointer_cast<T>(obj) != nullptr;
+		}
+	}
+
+	/** @return elem as a Quad, or nullptr if it is not one */
+	inline Quad* asQuad( const std::shared_ptr<Element>& elem )
+	{
+		return elem != nullptr && elem->isQuad() ? static_cast<Quad*>(elem.get()) : nullptr;
+	}
+
+	/** @return elem as a Triangle, or nullptr if it is not one */
+	inline Triangle* asTriangle( const std::shared_ptr<Element>& elem )
+	{
+		return elem != nullptr && elem->isTriangle() ? static_cast<Triangle*>(elem.get()) : nullptr;
+	}
+
+	/**
+	 * @return elem as a shared Quad, or nullptr if it is not one. Like
+	 *         std::dynamic_pointer_cast<Quad>(..), without the RTTI lookup.
+	 */
+	inline std::shared_ptr<Quad> quadCast( const std::shared_ptr<Element>& elem )
+	{
+		return elem != nullptr && elem->isQuad() ? std::static_pointer_cast<Quad>(elem) : nullptr;
+	}
+
+	/**
+	 * @return elem as a shared Triangle, or nullptr if it is not one. Like
+	 *         std::dynamic_pointer_cast<Triangle>(..), without the RTTI lookup.
+	 */
+	inline std::shared_ptr<Triangle> triangleCast( const std::shared_ptr<Element>& elem )
+	{
+		return elem != nullptr && elem->isTriangle() ? std::static_pointer_cast<Triangle>(elem) : nullptr;
+	}
+
+	/**
+	 * Call f with elem, which must be a Quad or a Triangle, as a Quad& or a
+	 * Triangle&, as told by its type. The two calls must return the same type.
+	 */
+	template<typename F>
+	decltype(auto) visit( Element& elem, F&& f )
+	{
+		if ( elem.isQuad() )
+		{
+			return f( static_cast<Quad&>(elem) );
+		}
+		return f( static_cast<Triangle&>(elem) );
 	}
 
 	inline static std::shared_ptr<Node> origin = std::make_shared<Node>( 0.0, 0.0 );
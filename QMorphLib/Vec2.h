@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Numbers.h"
+#include "Predicates.h"
+
+#include <cmath>
+#include <optional>
+#include <type_traits>
+
+/**
+ * A vector in the plane, held by value. Unlike MyVector it has no origin and
+ * no edge, so that it can be made, copied and dropped in the inner loops
+ * without touching any reference counts or the heap. The arithmetic is
+ * constexpr; the cross products used for orientation decisions take their
+ * sign from the adaptive predicate at run time, the same as MyVector does.
+ */
+
+struct Vec2
+{
+	double x = 0.0, y = 0.0;
+
+	constexpr Vec2 operator+( const Vec2& v ) const { return { x + v.x, y + v.y }; }
+	constexpr Vec2 operator-( const Vec2& v ) const { return { x - v.x, y - v.y }; }
+	constexpr Vec2 operator-() const { return { -x, -y }; }
+	constexpr Vec2 operator*( double d ) const { return { x * d, y * d }; }
+	constexpr Vec2 operator/( double d ) const { return { x / d, y / d }; }
+
+	/** @return the dot product of this and v */
+	constexpr double dot( const Vec2& v ) const
+	{
+		return x * v.x + y * v.y;
+	}
+
+	/**
+	 * @return the cross product of this and v: positive if v is ccw to this,
+	 *         negative if it is cw and 0 if the two are parallel. The sign is
+	 *         exact.
+	 */
+	constexpr double cross( const Vec2& v ) const
+	{
+		if ( std::is_constant_evaluated() )
+		{
+			return x * v.y - y * v.x;
+		}
+		return rcl::cross2d( 0.0, 0.0, x, y, 0.0, 0.0, v.x, v.y );
+	}
+
+	/** @return true if the components of this and v are equal within rcl::kZero */
+	constexpr bool nearlyEquals( const Vec2& v ) const
+	{
+		auto dx = x - v.x, dy = y - v.y;
+		return dx < rcl::kZero && -dx < rcl::kZero && dy < rcl::kZero && -dy < rcl::kZero;
+	}
+
+	/**
+	 * Same as MyVector::isCWto(..): vectors with equal slopes are cw to each
+	 * other, but a vector is not cw to itself.
+	 *
+	 * @return true if this vector is clockwise (cw) to v
+	 */
+	constexpr bool isCWto( const Vec2& v ) const
+	{
+		return !nearlyEquals( v ) && cross( v ) >= 0.0;
+	}
+
+	/** @return the squared length of this vector */
+	constexpr double lengthSquared() const
+	{
+		return dot( *this );
+	}
+
+	/** @return the length of this vector */
+	double length() const
+	{
+		return std::sqrt( lengthSquared() );
+	}
+
+	/** @return this vector scaled to length 1 */
+	Vec2 normalized() const
+	{
+		return *this / length();
+	}
+};
+
+/** A point in the plane, held by value. */
+struct Point2
+{
+	double x = 0.0, y = 0.0;
+
+	constexpr Vec2 operator-( const Point2& p ) const { return { x - p.x, y - p.y }; }
+	constexpr Point2 operator+( const Vec2& v ) const { return { x + v.x, y + v.y }; }
+
+	/** @return true if the coordinates of this and p are equal within rcl::kZero */
+	constexpr bool nearlyEquals( const Point2& p ) const
+	{
+		return (*this - p).nearlyEquals( Vec2{} );
+	}
+};
+
+/**
+ * Where the lines p0 + s*d0 and p1 + t*d1 cross, given by the parameters s
+ * and t along each of them.
+ */
+struct Crossing
+{
+	double s = 0.0, t = 0.0;
+};
+
+/**
+ * @return where the line through p0 along d0 crosses the line through p1 along
+ *         d1, or nothing if the lines are parallel
+ */
+constexpr std::optional<Crossing>
+intersection( const Point2& p0, const Vec2& d0,
+			  const Point2& p1, const Vec2& d1 )
+{
+	double d0crossd1 = d0.cross( d1 );
+	if ( d0crossd1 == 0 )
+	{
+		return std::nullopt;
+	}
+	auto delta = p1 - p0;
+	return Crossing{ delta.cross( d1 ) / d0crossd1, delta.cross( d0 ) / d0crossd1 };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/**
+ * A non-owning link from one mesh entity back to another, such as from an edge
+ * to its elements or from a node to its edges. The entities are owned by the
+ * lists of GeomBasics and by the entities above them, so the back-links must
+ * not form cycles of shared_ptr that keep a dropped entity alive.
+ *
+ * A WeakLink reads like the std::shared_ptr it replaces: it is dereferenced
+ * without locking, compares with shared_ptr and nullptr by identity, and
+ * converts to a shared_ptr where one is needed. A link to an entity that has
+ * been freed reads as nullptr.
+ */
+
+template< typename T >
+class WeakLink
+{
+public:
+	WeakLink() = default;
+
+	WeakLink( std::nullptr_t )
+	{
+	}
+
+	template< typename U >
+		requires std::is_convertible_v<U*, T*>
+	WeakLink( const std::shared_ptr<U>& p ) :
+		ref( p ),
+		ptr( p.get() )
+	{
+	}
+
+	/** @return the entity, or nullptr if there is none or it has been freed */
+	T* get() const
+	{
+		return ptr != nullptr && !ref.expired() ? ptr : nullptr;
+	}
+
+	/** @return the entity as an owning pointer, or nullptr */
+	std::shared_ptr<T> lock() const
+	{
+		return ref.lock();
+	}
+
+	T* operator->() const
+	{
+		return get();
+	}
+
+	T& operator*() const
+	{
+		return *get();
+	}
+
+	explicit operator bool() const
+	{
+		return get() != nullptr;
+	}
+
+	template< typename U >
+		requires std::is_convertible_v<T*, U*>
+	operator std::shared_ptr<U>() const
+	{
+		return ref.lock();
+	}
+
+	friend bool operator==( const WeakLink& a, std::nullptr_t )
+	{
+		return a.get() == nullptr;
+	}
+
+	friend bool operator==( const WeakLink& a, const WeakLink& b )
+	{
+		return a.get() == b.get();
+	}
+
+	template< typename U >
+	friend bool operator==( const WeakLink& a, const std::shared_ptr<U>& b )
+	{
+		return a.get() == b.get();
+	}
+
+private:
+	std::weak_ptr<T> ref;
+	T* ptr = nullptr;
+};
@@ -2,31 +2,174 @@
 //
 
 #include "GeomBasics.h"
+#include "ParameterSweep.h"
 #include "QMorph.h"
+#include "ResultCache.h"
 
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
 int main( int argc, char* argv[] )
 {
-	if ( argc < 2 )
+	std::vector<std::string> inputFilenames;
+	std::string resumeFilename, cacheDirectory, sweepFilename;
+	size_t cacheSize = 64;
+	unsigned nThreads = 0;
+	QMorphOptions options;
+	bool memory = false;
+	bool usage = argc < 2;
+	for ( int i = 1; i < argc && !usage; i++ )
 	{
-		std::cout << "Usage: QuadMindConsole <input file>\n";
+		std::string arg = argv[i];
+		if ( arg == "--checkpoint" && i + 1 < argc )
+		{
+			GeomBasics::checkpointFilename = argv[++i];
+		}
+		else if ( arg == "--every" && i + 1 < argc )
+		{
+			GeomBasics::checkpointInterval = std::stoi( argv[++i] );
+		}
+		else if ( arg == "--resume" && i + 1 < argc )
+		{
+			resumeFilename = argv[++i];
+		}
+		else if ( arg == "--cache" && i + 1 < argc )
+		{
+			cacheDirectory = argv[++i];
+		}
+		else if ( arg == "--cache-size" && i + 1 < argc )
+		{
+			cacheSize = std::stoul( argv[++i] );
+		}
+		else if ( arg == "--option" && i + 1 < argc )
+		{
+			usage = !options.parse( argv[++i] );
+		}
+		else if ( arg == "--sweep" && i + 1 < argc )
+		{
+			sweepFilename = argv[++i];
+		}
+		else if ( arg == "--threads" && i + 1 < argc )
+		{
+			nThreads = std::stoul( argv[++i] );
+		}
+		else if ( arg == "--memory" )
+		{
+			memory = true;
+		}
+		else if ( arg.rfind( "--", 0 ) != 0 )
+		{
+			inputFilenames.push_back( arg );
+		}
+		else
+		{
+			usage = true;
+		}
+	}
+	if ( usage || inputFilenames.empty() == resumeFilename.empty()
+		 || (inputFilenames.size() > 1 && (!GeomBasics::checkpointFilename.empty() || !sweepFilename.empty())) )
+	{
+		std::cout << "Usage: QuadMindConsole <input file> [--checkpoint <file> [--every <steps>]]\n"
+				  << "       QuadMindConsole --resume <checkpoint file> [--checkpoint <file> [--every <steps>]]\n"
+				  << "       QuadMindConsole <input file>... [--cache <directory> [--cache-size <entries>]]\n"
+				  << "       QuadMindConsole <input file> --sweep <options file> [--threads <n>]\n"
+				  << "With --memory each run ends with a report of the bytes taken by the mesh.\n"
+				  << "Each run takes [--option \"<name>=<value> ...\"], the options file one such\n"
+				  << "list per line. The options are epsilon1, epsilon2 and chevronMin in degrees,\n"
+				  << "and obsTol, myMin, gamma and maxIter.\n";
 		return 1;
 	}
 
-	std::string inputFilename = argv[1];
-	std::filesystem::path inputPath( inputFilename );
+	if ( !resumeFilename.empty() )
+	{
+		auto Morph = std::make_shared<QMorph>( options );
+		Morph->resume( resumeFilename );
+		return 0;
+	}
+
+	if ( !sweepFilename.empty() )
+	{
+		std::ifstream in( sweepFilename );
+		if ( !in )
+		{
+			std::cout << "Cannot read " << sweepFilename << "\n";
+			return 1;
+		}
+		std::vector<QMorphOptions> configs;
+		std::string line;
+		while ( std::getline( in, line ) )
+		{
+			if ( line.find_first_not_of( " \t\r" ) == std::string::npos || line[0] == '#' )
+			{
+				continue;
+			}
+			configs.push_back( options );
+			if ( !configs.back().parse( line ) )
+			{
+				std::cout << "Cannot read the options " << line << "\n";
+				return 1;
+			}
+		}
+
+		std::filesystem::path inputPath( inputFilenames[0] );
+		GeomBasics::setParams( inputPath.filename().string(), inputPath.parent_path().string(), false, false );
+		GeomBasics::loadMesh();
+		GeomBasics::findExtremeNodes();
+
+		ParameterSweep sweep;
+		std::cout << ParameterSweep::report( sweep.run( configs, nThreads ) );
+		return 0;
+	}
+
+	std::unique_ptr<ResultCache> cache;
+	if ( !cacheDirectory.empty() )
+	{
+		cache = std::make_unique<ResultCache>( cacheDirectory, cacheSize );
+	}
+
+	for ( const auto& inputFilename : inputFilenames )
+	{
+		std::filesystem::path inputPath( inputFilename );
+
+		GeomBasics::clearLists();
 
-	GeomBasics::clearLists();
+		GeomBasics::setParams( inputPath.filename().string(), inputPath.parent_path().string(), false, false);
+		GeomBasics::loadMesh();
+		GeomBasics::findExtremeNodes();
 
-	GeomBasics::setParams( inputPath.filename().string(), inputPath.parent_path().string(), false, false);
-	GeomBasics::loadMesh();
-	GeomBasics::findExtremeNodes();
+		std::string key;
+		if ( cache )
+		{
+			key = ResultCache::key( -1, 0.0, false, options );
+			if ( cache->load( key ) )
+			{
+				continue;
+			}
+		}
 
-	auto Morph = std::make_shared<QMorph>();
-	Morph->init();
-	Morph->run();
+		auto Morph = std::make_shared<QMorph>( options );
+		Morph->runParallel();
+		if ( memory )
+		{
+			std::cout << GeomBasics::memoryReport();
+		}
+
+		if ( cache )
+		{
+			cache->store( key );
+		}
+	}
+
+	if ( cache && inputFilenames.size() > 1 )
+	{
+		size_t total = cache->hits() + cache->misses();
+		std::cout << "Result cache hits: " << cache->hits() << " of " << total << " ("
+				  << 100.0 * cache->hits() / total << "%)\n";
+	}
 }
 
 // Run program: Ctrl + F5 or Debug > Start Without Debugging menu
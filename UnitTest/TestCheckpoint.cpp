@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "Checkpoint.h"
+#include "GeomBasics.h"
+#include "QMorph.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+class CheckpointTest : public ::testing::Test
+{
+protected:
+    std::string filename = (std::filesystem::temp_directory_path() / "TestCheckpoint.qmcp").string();
+
+    // Two triangles sharing the diagonal of the unit square
+    void SetUp() override
+    {
+        GeomBasics::clearLists();
+        auto a = std::make_shared<Node>( 0.0, 0.0 ), b = std::make_shared<Node>( 1.0, 0.0 );
+        auto c = std::make_shared<Node>( 1.0, 1.0 ), d = std::make_shared<Node>( 0.0, 1.0 );
+        std::shared_ptr<Edge> ab = std::make_shared<Edge>( a, b ), bc = std::make_shared<Edge>( b, c );
+        std::shared_ptr<Edge> cd = std::make_shared<Edge>( c, d ), da = std::make_shared<Edge>( d, a );
+        std::shared_ptr<Edge> ac = std::make_shared<Edge>( a, c );
+        for ( const auto& e : { ab, bc, cd, da, ac } )
+        {
+            e->connectNodes();
+            GeomBasics::edgeList.add( e );
+        }
+        auto t1 = std::make_shared<Triangle>( ab, bc, ac ), t2 = std::make_shared<Triangle>( ac, cd, da );
+        t1->connectEdges();
+        t2->connectEdges();
+        GeomBasics::triangleList.add( t1 );
+        GeomBasics::triangleList.add( t2 );
+        for ( const auto& n : { a, b, c, d } )
+        {
+            GeomBasics::nodeList.add( n );
+        }
+        ab->level = 3;
+        GeomBasics::findExtremeNodes();
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+        GeomBasics::leftmost = GeomBasics::rightmost = GeomBasics::uppermost = GeomBasics::lowermost = nullptr;
+        std::filesystem::remove( filename );
+    }
+
+    std::string contents()
+    {
+        std::ifstream in( filename, std::ios::binary );
+        return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+    }
+};
+
+TEST_F( CheckpointTest, RestoresTheMesh )
+{
+    ASSERT_TRUE( Checkpoint::save( filename, Checkpoint::Phase::Smooth, nullptr ) );
+    GeomBasics::clearLists();
+
+    QMorph morph;
+    Checkpoint::Phase phase;
+    ASSERT_TRUE( Checkpoint::load( filename, morph, phase ) );
+    EXPECT_EQ( phase, Checkpoint::Phase::Smooth );
+
+    ASSERT_EQ( GeomBasics::nodeList.size(), 4u );
+    ASSERT_EQ( GeomBasics::edgeList.size(), 5u );
+    ASSERT_EQ( GeomBasics::triangleList.size(), 2u );
+    EXPECT_EQ( GeomBasics::nodeList.get( 2 )->x, 1.0 );
+    EXPECT_EQ( GeomBasics::nodeList.get( 2 )->y, 1.0 );
+    EXPECT_EQ( GeomBasics::edgeList.get( 0 )->level, 3 );
+
+    // The restored entities refer to each other as the saved ones did
+    auto ac = GeomBasics::edgeList.get( 4 );
+    auto t1 = GeomBasics::triangleList.get( 0 ), t2 = GeomBasics::triangleList.get( 1 );
+    EXPECT_EQ( ac->element1, t1 );
+    EXPECT_EQ( ac->element2, t2 );
+    EXPECT_TRUE( t1->hasEdge( ac ) );
+    EXPECT_EQ( ac->leftNode, GeomBasics::nodeList.get( 0 ) );
+    EXPECT_EQ( GeomBasics::nodeList.get( 0 )->edgeList.size(), 3u );
+    EXPECT_EQ( GeomBasics::uppermost->y, 1.0 );
+
+    // Saving the restored mesh gives the same snapshot
+    auto first = contents();
+    ASSERT_TRUE( Checkpoint::save( filename, Checkpoint::Phase::Smooth, nullptr ) );
+    EXPECT_EQ( contents(), first );
+}
+
+TEST_F( CheckpointTest, RejectsTruncatedSnapshots )
+{
+    ASSERT_TRUE( Checkpoint::save( filename, Checkpoint::Phase::Smooth, nullptr ) );
+    auto full = contents();
+    {
+        std::ofstream out( filename, std::ios::binary | std::ios::trunc );
+        out.write( full.data(), static_cast<std::streamsize>(full.size() / 2) );
+    }
+
+    QMorph morph;
+    Checkpoint::Phase phase;
+    EXPECT_FALSE( Checkpoint::load( filename, morph, phase ) );
+    EXPECT_EQ( GeomBasics::nodeList.size(), 0u );
+}
+
+TEST_F( CheckpointTest, RejectsLengthsLongerThanTheSnapshot )
+{
+    ASSERT_TRUE( Checkpoint::save( filename, Checkpoint::Phase::Smooth, nullptr ) );
+    auto full = contents();
+
+    // The node count follows the magic number, the version and the phase, and
+    // the length of the pattern of the first node follows its 22 bytes
+    for ( size_t offset : { 9u, 43u } )
+    {
+        auto corrupt = full;
+        corrupt.replace( offset, 4, "\xff\xff\xff\xff" );
+        {
+            std::ofstream out( filename, std::ios::binary | std::ios::trunc );
+            out.write( corrupt.data(), static_cast<std::streamsize>(corrupt.size()) );
+        }
+
+        QMorph morph;
+        Checkpoint::Phase phase;
+        EXPECT_FALSE( Checkpoint::load( filename, morph, phase ) ) << "offset " << offset;
+        EXPECT_EQ( GeomBasics::nodeList.size(), 0u );
+    }
+}
@@ -0,0 +1,396 @@
+#include "pch.h"
+#include "DelaunayMeshGen.h"
+#include "Node.h"
+#include "Edge.h"
+#include "Triangle.h"
+#include "Msg.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+class DelaunayMeshGenTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Msg::debugMode = false;
+        GeomBasics::clearLists();
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+        Msg::debugMode = true;
+    }
+
+    static void addRandomNodes( int count, unsigned seed )
+    {
+        std::mt19937 gen( seed );
+        std::uniform_real_distribution<double> dist( 0.0, 1.0 );
+        for ( int i = 0; i < count; i++ )
+        {
+            GeomBasics::nodeList.add( std::make_shared<Node>( dist( gen ), dist( gen ) ) );
+        }
+    }
+
+    // A slightly rotated grid: every grid cell is (nearly) cocircular
+    static void addRotatedGridNodes( int size )
+    {
+        double c = std::cos( 0.3 ), s = std::sin( 0.3 );
+        for ( int i = 0; i < size; i++ )
+        {
+            for ( int j = 0; j < size; j++ )
+            {
+                GeomBasics::nodeList.add( std::make_shared<Node>( 0.1 * (c * i - s * j), 0.1 * (s * i + c * j) ) );
+            }
+        }
+    }
+
+    static double triangulate( DelaunayMeshGen::InsertionMode mode )
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto gen = std::make_shared<DelaunayMeshGen>();
+        gen->init( true, mode );
+        gen->run();
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    // No node may lie strictly inside the circumcircle of any triangle, and
+    // the node and edge lists must agree with each other.
+    static void expectValidDelaunay()
+    {
+        for ( const auto& t : GeomBasics::triangleList )
+        {
+            const auto& e = t->edgeList[0];
+            auto a = e->leftNode, b = e->rightNode, c = t->oppositeOfEdge( e );
+            EXPECT_TRUE( t->areaLargerThan0() );
+            for ( const auto& n : GeomBasics::nodeList )
+            {
+                EXPECT_FALSE( n->inCircle( a, b, c ) );
+            }
+        }
+
+        size_t nodeEdges = 0;
+        for ( const auto& n : GeomBasics::nodeList )
+        {
+            nodeEdges += n->edgeList.size();
+        }
+        EXPECT_EQ( nodeEdges, 2 * GeomBasics::edgeList.size() );
+
+        // Euler's formula for a triangulated disk
+        EXPECT_EQ( GeomBasics::nodeList.size() - GeomBasics::edgeList.size() + GeomBasics::triangleList.size(), 1u );
+    }
+
+    static ArrayList<std::shared_ptr<Node>> makeLoop( const std::vector<std::pair<double, double>>& coords )
+    {
+        ArrayList<std::shared_ptr<Node>> loop;
+        for ( const auto& c : coords )
+        {
+            loop.add( std::make_shared<Node>( c.first, c.second ) );
+        }
+        return loop;
+    }
+
+    static double meshArea()
+    {
+        double area = 0.0;
+        for ( const auto& t : GeomBasics::triangleList )
+        {
+            const auto& e = t->edgeList[0];
+            auto a = e->leftNode, b = e->rightNode, c = t->oppositeOfEdge( e );
+            area += 0.5 * std::abs( (b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x) );
+        }
+        return area;
+    }
+
+    // The smallest and largest angle and edge length of the triangles
+    struct MeshStats
+    {
+        double minAngle = 180.0, maxEdge = 0.0, meanEdge = 0.0;
+    };
+
+    static MeshStats meshStats()
+    {
+        const double pi = std::acos( -1.0 );
+        MeshStats stats;
+        for ( const auto& t : GeomBasics::triangleList )
+        {
+            const auto& e = t->edgeList[0];
+            std::shared_ptr<Node> v[3] = { e->leftNode, e->rightNode, t->oppositeOfEdge( e ) };
+            for ( int k = 0; k < 3; k++ )
+            {
+                const auto& o = v[k];
+                const auto& p = v[(k + 1) % 3];
+                const auto& q = v[(k + 2) % 3];
+                double ux = p->x - o->x, uy = p->y - o->y, wx = q->x - o->x, wy = q->y - o->y;
+                double angle = std::acos( (ux * wx + uy * wy) / (std::hypot( ux, uy ) * std::hypot( wx, wy )) );
+                stats.minAngle = std::min( stats.minAngle, angle * 180.0 / pi );
+            }
+        }
+        for ( const auto& e : GeomBasics::edgeList )
+        {
+            double len = std::hypot( e->leftNode->x - e->rightNode->x, e->leftNode->y - e->rightNode->y );
+            stats.maxEdge = std::max( stats.maxEdge, len );
+            stats.meanEdge += len / GeomBasics::edgeList.size();
+        }
+        return stats;
+    }
+
+    // Each segment of the loop must be an Edge bordering exactly one triangle
+    static void expectBoundaryLoop( const ArrayList<std::shared_ptr<Node>>& loop )
+    {
+        for ( size_t i = 0; i < loop.size(); i++ )
+        {
+            auto a = loop.get( i ), b = loop.get( (i + 1) % loop.size() );
+            std::shared_ptr<Edge> found;
+            for ( const auto& e : a->edgeList )
+            {
+                if ( e->otherNode( a ) == b )
+                {
+                    found = e;
+                }
+            }
+            ASSERT_NE( found, nullptr );
+            EXPECT_NE( found->element1, nullptr );
+            EXPECT_EQ( found->element2, nullptr );
+        }
+    }
+
+    // The same as expectValidDelaunay(), but only tests each triangle against
+    // the nodes of its neighbours, which suffices for a triangulation and is
+    // fast enough for large meshes. The mesh may have holes.
+    static void expectLocallyDelaunay( size_t holes = 0 )
+    {
+        for ( const auto& t : GeomBasics::triangleList )
+        {
+            const auto& e = t->edgeList[0];
+            auto a = e->leftNode, b = e->rightNode, c = t->oppositeOfEdge( e );
+            EXPECT_TRUE( t->areaLargerThan0() );
+            for ( const auto& edge : t->edgeList )
+            {
+                auto other = edge->element1 == t ? edge->element2 : edge->element1;
+                if ( other )
+                {
+                    auto d = std::dynamic_pointer_cast<Triangle>( other.lock() )->oppositeOfEdge( edge );
+                    EXPECT_FALSE( d->inCircle( a, b, c ) );
+                }
+            }
+        }
+
+        size_t nodeEdges = 0;
+        for ( const auto& n : GeomBasics::nodeList )
+        {
+            nodeEdges += n->edgeList.size();
+        }
+        EXPECT_EQ( nodeEdges, 2 * GeomBasics::edgeList.size() );
+        EXPECT_EQ( GeomBasics::nodeList.size() + GeomBasics::triangleList.size() + holes, GeomBasics::edgeList.size() + 1 );
+    }
+};
+
+TEST_F( DelaunayMeshGenTest, EdgeFlipRandomNodes )
+{
+    addRandomNodes( 150, 1 );
+    triangulate( DelaunayMeshGen::InsertionMode::EdgeFlip );
+    expectValidDelaunay();
+}
+
+TEST_F( DelaunayMeshGenTest, CavityRandomNodes )
+{
+    addRandomNodes( 150, 1 );
+    triangulate( DelaunayMeshGen::InsertionMode::Cavity );
+    expectValidDelaunay();
+}
+
+TEST_F( DelaunayMeshGenTest, CavityMatchesEdgeFlip )
+{
+    addRandomNodes( 150, 2 );
+    triangulate( DelaunayMeshGen::InsertionMode::EdgeFlip );
+    auto nTriangles = GeomBasics::triangleList.size();
+    auto nEdges = GeomBasics::edgeList.size();
+
+    auto nodes = GeomBasics::nodeList;
+    GeomBasics::clearLists();
+    for ( const auto& n : nodes )
+    {
+        GeomBasics::nodeList.add( std::make_shared<Node>( n->x, n->y ) );
+    }
+    triangulate( DelaunayMeshGen::InsertionMode::Cavity );
+
+    EXPECT_EQ( GeomBasics::triangleList.size(), nTriangles );
+    EXPECT_EQ( GeomBasics::edgeList.size(), nEdges );
+}
+
+TEST_F( DelaunayMeshGenTest, CavityCocircularNodes )
+{
+    addRotatedGridNodes( 12 );
+    triangulate( DelaunayMeshGen::InsertionMode::Cavity );
+    expectValidDelaunay();
+}
+
+// Not a correctness test: reports the time spent by each insertion mode. Run
+// it with --gtest_also_run_disabled_tests.
+TEST_F( DelaunayMeshGenTest, DISABLED_BenchmarkCavityVersusEdgeFlip )
+{
+    const int count = 800;
+    addRandomNodes( count, 3 );
+    double flipTime = triangulate( DelaunayMeshGen::InsertionMode::EdgeFlip );
+
+    GeomBasics::clearLists();
+    addRandomNodes( count, 3 );
+    double cavityTime = triangulate( DelaunayMeshGen::InsertionMode::Cavity );
+
+    std::cout << "[ BENCH    ] " << count << " nodes, edge flip: " << flipTime
+              << " s, cavity: " << cavityTime << " s\n";
+    EXPECT_GT( GeomBasics::triangleList.size(), 0u );
+}
+
+TEST_F( DelaunayMeshGenTest, ParallelMatchesCavity )
+{
+    addRandomNodes( 2000, 4 );
+    auto nodes = GeomBasics::nodeList;
+    triangulate( DelaunayMeshGen::InsertionMode::Cavity );
+    auto nTriangles = GeomBasics::triangleList.size();
+    auto nEdges = GeomBasics::edgeList.size();
+
+    GeomBasics::clearLists();
+    for ( const auto& n : nodes )
+    {
+        GeomBasics::nodeList.add( std::make_shared<Node>( n->x, n->y ) );
+    }
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->runParallel( 4, 6 );
+
+    EXPECT_EQ( GeomBasics::triangleList.size(), nTriangles );
+    EXPECT_EQ( GeomBasics::edgeList.size(), nEdges );
+}
+
+TEST_F( DelaunayMeshGenTest, ParallelRandomNodes )
+{
+    addRandomNodes( 20000, 5 );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->runParallel( 3, 5 );
+    expectLocallyDelaunay();
+}
+
+TEST_F( DelaunayMeshGenTest, ParallelCocircularNodes )
+{
+    addRotatedGridNodes( 50 );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->runParallel( 4, 4 );
+    expectLocallyDelaunay();
+}
+
+TEST_F( DelaunayMeshGenTest, ConstrainedSquareWithHole )
+{
+    auto outer = makeLoop( { { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 } } );
+    auto hole = makeLoop( { { 0.4, 0.4 }, { 0.4, 0.6 }, { 0.6, 0.6 }, { 0.6, 0.4 } } );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->runConstrained( outer, { hole } );
+
+    EXPECT_EQ( GeomBasics::nodeList.size(), 8u );
+    EXPECT_EQ( GeomBasics::triangleList.size(), 8u );
+    EXPECT_NEAR( meshArea(), 0.96, 1e-12 );
+    expectBoundaryLoop( outer );
+    expectBoundaryLoop( hole );
+}
+
+// A star shaped polygon whose boundary is mostly not part of the Delaunay
+// triangulation of its vertices
+TEST_F( DelaunayMeshGenTest, ConstrainedStarPolygon )
+{
+    const int spikes = 25;
+    const double pi = std::acos( -1.0 );
+    std::vector<std::pair<double, double>> coords;
+    double area = 0.0;
+    for ( int i = 0; i < 2 * spikes; i++ )
+    {
+        double r = i % 2 == 0 ? 1.0 : 0.15, phi = pi * i / spikes;
+        coords.emplace_back( r * std::cos( phi ), r * std::sin( phi ) );
+    }
+    for ( size_t i = 0; i < coords.size(); i++ )
+    {
+        const auto& a = coords[i];
+        const auto& b = coords[(i + 1) % coords.size()];
+        area += 0.5 * (a.first * b.second - b.first * a.second);
+    }
+
+    auto outer = makeLoop( coords );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->runConstrained( outer );
+
+    EXPECT_EQ( GeomBasics::triangleList.size(), coords.size() - 2 );
+    EXPECT_NEAR( meshArea(), area, 1e-12 );
+    expectBoundaryLoop( outer );
+}
+
+TEST_F( DelaunayMeshGenTest, RefinementMinAngle )
+{
+    auto outer = makeLoop( { { 0.0, 0.0 }, { 2.0, 0.0 }, { 2.0, 0.1 }, { 1.0, 1.0 }, { 0.0, 1.0 } } );
+    auto hole = makeLoop( { { 0.4, 0.4 }, { 0.4, 0.6 }, { 0.6, 0.6 }, { 0.6, 0.4 } } );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->setRefinement( 0.0, 28.0 );
+    gen->runConstrained( outer, { hole } );
+
+    EXPECT_GE( meshStats().minAngle, 28.0 - 1e-9 );
+    EXPECT_NEAR( meshArea(), 1.55 - 0.04, 1e-12 );
+    expectLocallyDelaunay( 1 );
+}
+
+TEST_F( DelaunayMeshGenTest, RefinementMeshSize )
+{
+    const double size = 0.05;
+    auto outer = makeLoop( { { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 } } );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->setRefinement( size );
+    gen->runConstrained( outer );
+
+    auto stats = meshStats();
+    EXPECT_GE( stats.minAngle, 20.0 );
+    EXPECT_LE( stats.maxEdge, 1.5 * size );
+    EXPECT_NEAR( stats.meanEdge, size, 0.2 * size );
+    EXPECT_NEAR( meshArea(), 1.0, 1e-12 );
+    EXPECT_EQ( GeomBasics::nodeList.size() - GeomBasics::edgeList.size() + GeomBasics::triangleList.size(), 1u );
+}
+
+TEST_F( DelaunayMeshGenTest, RefinementSizingFunction )
+{
+    auto outer = makeLoop( { { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 } } );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->setRefinement( []( double x, double ) { return 0.02 + 0.1 * x; } );
+    gen->runConstrained( outer );
+
+    int left = 0, right = 0;
+    for ( const auto& t : GeomBasics::triangleList )
+    {
+        const auto& e = t->edgeList[0];
+        double x = (e->leftNode->x + e->rightNode->x + t->oppositeOfEdge( e )->x) / 3.0;
+        (x < 0.5 ? left : right)++;
+    }
+    EXPECT_GT( left, 3 * right );
+    EXPECT_NEAR( meshArea(), 1.0, 1e-12 );
+}
+
+// The spikes of the star meet at angles far below the requested minimum, which
+// must not make the refinement run away
+TEST_F( DelaunayMeshGenTest, RefinementSmallInputAngles )
+{
+    const int spikes = 25;
+    const double pi = std::acos( -1.0 );
+    std::vector<std::pair<double, double>> coords;
+    for ( int i = 0; i < 2 * spikes; i++ )
+    {
+        double r = i % 2 == 0 ? 1.0 : 0.15, phi = pi * i / spikes;
+        coords.emplace_back( r * std::cos( phi ), r * std::sin( phi ) );
+    }
+
+    auto outer = makeLoop( coords );
+    auto gen = std::make_shared<DelaunayMeshGen>();
+    gen->setRefinement( 0.0, 25.0, 100000 );
+    gen->runConstrained( outer );
+
+    EXPECT_LT( GeomBasics::nodeList.size(), 2000u );
+    EXPECT_EQ( GeomBasics::nodeList.size() - GeomBasics::edgeList.size() + GeomBasics::triangleList.size(), 1u );
+    expectLocallyDelaunay();
+}
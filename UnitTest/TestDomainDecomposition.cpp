@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "DomainDecomposition.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+#include <map>
+#include <unordered_set>
+
+namespace
+{
+    // A grid of nx by ny unit squares, each split into two triangles
+    struct Grid
+    {
+        ArrayList<std::shared_ptr<Triangle>> triangles;
+        ArrayList<std::shared_ptr<Edge>> edges;
+        ArrayList<std::shared_ptr<Node>> nodes;
+        std::map<std::pair<int, int>, std::shared_ptr<Node>> nodeAt;
+        std::map<std::pair<const Node*, const Node*>, std::shared_ptr<Edge>> edgeAt;
+
+        Grid( int nx, int ny )
+        {
+            for ( int j = 0; j <= ny; j++ )
+            {
+                for ( int i = 0; i <= nx; i++ )
+                {
+                    auto n = std::make_shared<Node>( i, j );
+                    nodes.add( n );
+                    nodeAt[{ i, j }] = n;
+                }
+            }
+            for ( int j = 0; j < ny; j++ )
+            {
+                for ( int i = 0; i < nx; i++ )
+                {
+                    auto a = nodeAt[{ i, j }], b = nodeAt[{ i + 1, j }];
+                    auto c = nodeAt[{ i + 1, j + 1 }], d = nodeAt[{ i, j + 1 }];
+                    triangle( a, b, c );
+                    triangle( a, c, d );
+                }
+            }
+        }
+
+        std::shared_ptr<Edge>
+        edge( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b )
+        {
+            auto key = a.get() < b.get() ? std::make_pair( a.get(), b.get() ) : std::make_pair( b.get(), a.get() );
+            auto& e = edgeAt[key];
+            if ( e == nullptr )
+            {
+                e = std::make_shared<Edge>( a, b );
+                e->connectNodes();
+                edges.add( e );
+            }
+            return e;
+        }
+
+        void
+        triangle( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b, const std::shared_ptr<Node>& c )
+        {
+            auto t = std::make_shared<Triangle>( edge( a, b ), edge( b, c ), edge( a, c ) );
+            t->connectEdges();
+            triangles.add( t );
+        }
+    };
+
+    int
+    boundaryEdges( const ArrayList<std::shared_ptr<Edge>>& edges )
+    {
+        int count = 0;
+        for ( const auto& e : edges )
+        {
+            if ( e->element2 == nullptr )
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+TEST( DomainDecompositionTest, SubdomainsHaveEvenBoundaries )
+{
+    Grid g( 5, 3 );
+    for ( unsigned k : { 2u, 3u, 4u } )
+    {
+        DomainDecomposition dd( g.triangles, g.edges, g.nodes, k );
+        ASSERT_GE( dd.size(), 2u );
+
+        size_t total = 0;
+        for ( size_t i = 0; i < dd.size(); i++ )
+        {
+            const auto& s = dd.subdomain( i );
+            total += s.triangles.size();
+            EXPECT_EQ( dd.boundaryEdgeCount( i ) % 2, 0 );
+            EXPECT_EQ( boundaryEdges( s.edges ), dd.boundaryEdgeCount( i ) );
+        }
+        EXPECT_EQ( total, g.triangles.size() );
+    }
+}
+
+TEST( DomainDecompositionTest, SubdomainsAreCopies )
+{
+    Grid g( 4, 2 );
+    DomainDecomposition dd( g.triangles, g.edges, g.nodes, 2 );
+    ASSERT_EQ( dd.size(), 2u );
+
+    std::unordered_set<const Node*> originals;
+    for ( const auto& n : g.nodes )
+    {
+        originals.insert( n.get() );
+    }
+    for ( size_t i = 0; i < dd.size(); i++ )
+    {
+        for ( const auto& n : dd.subdomain( i ).nodes )
+        {
+            EXPECT_EQ( originals.count( n.get() ), 0u );
+        }
+    }
+}
+
+TEST( DomainDecompositionTest, StitchRestoresTheMesh )
+{
+    Grid g( 4, 2 );
+    DomainDecomposition dd( g.triangles, g.edges, g.nodes, 2 );
+    ASSERT_EQ( dd.size(), 2u );
+
+    std::vector<MeshComponents::Component> meshed;
+    for ( size_t i = 0; i < dd.size(); i++ )
+    {
+        meshed.push_back( dd.subdomain( i ) );
+    }
+
+    MeshComponents::Component result;
+    ArrayList<std::shared_ptr<Node>> seam;
+    ASSERT_TRUE( dd.stitch( meshed, result, seam ) );
+
+    EXPECT_EQ( result.triangles.size(), g.triangles.size() );
+    EXPECT_EQ( result.edges.size(), g.edges.size() );
+    EXPECT_EQ( result.nodes.size(), g.nodes.size() );
+    EXPECT_EQ( boundaryEdges( result.edges ), boundaryEdges( g.edges ) );
+    EXPECT_FALSE( seam.isEmpty() );
+
+    // Every edge of the stitched triangles is one of the stitched edges
+    std::unordered_set<const Edge*> edges;
+    for ( const auto& e : result.edges )
+    {
+        edges.insert( e.get() );
+    }
+    for ( const auto& t : result.triangles )
+    {
+        for ( const auto& e : t->edgeList )
+        {
+            EXPECT_EQ( edges.count( e.get() ), 1u );
+        }
+    }
+}
+
+TEST( DomainDecompositionTest, StitchRejectsChangedInterfaces )
+{
+    Grid g( 4, 2 );
+    DomainDecomposition dd( g.triangles, g.edges, g.nodes, 2 );
+    ASSERT_EQ( dd.size(), 2u );
+
+    std::vector<MeshComponents::Component> meshed;
+    for ( size_t i = 0; i < dd.size(); i++ )
+    {
+        meshed.push_back( dd.subdomain( i ) );
+    }
+    // Drop an interface edge from the first subdomain
+    for ( size_t i = 0; i < meshed[0].edges.size(); i++ )
+    {
+        const auto& e = meshed[0].edges.get( i );
+        auto onSide = [&e]( double Node::*c, double v ) { return (*e->leftNode).*c == v && (*e->rightNode).*c == v; };
+        if ( e->element2 == nullptr && !onSide( &Node::x, 0.0 ) && !onSide( &Node::x, 4.0 )
+             && !onSide( &Node::y, 0.0 ) && !onSide( &Node::y, 2.0 ) )
+        {
+            meshed[0].edges.remove( i );
+            break;
+        }
+    }
+
+    MeshComponents::Component result;
+    ArrayList<std::shared_ptr<Node>> seam;
+    EXPECT_FALSE( dd.stitch( meshed, result, seam ) );
+}
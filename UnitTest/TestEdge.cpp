@@ -7,6 +7,7 @@
 
 double expected = M_PI_2; // 90 degrees in radians
 #include "Edge.h"
+#include "EdgeGrid.h"
 #include "Node.h"
 #include "MyVector.h"
 #include "Triangle.h"
@@ -95,6 +96,25 @@ TEST_F( EdgeTest, CopyConstructor )
     EXPECT_EQ( copiedEdge->element2, originalEdge.element2 );
 }
 
+TEST( EdgeReinitTest, KeepsTheIdentity )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 );
+    auto b = std::make_shared<Node>( 1.0, 0.0 );
+    auto c = std::make_shared<Node>( 1.0, 1.0 );
+    auto e = std::make_shared<Edge>( a, b );
+    e->element1 = std::make_shared<Triangle>( e, std::make_shared<Edge>( a, c ), std::make_shared<Edge>( b, c ) );
+    e->frontEdge = true;
+    auto id = e->id;
+
+    e->reinit( c, a );
+    EXPECT_EQ( e->id, id );
+    EXPECT_EQ( e->leftNode, a );
+    EXPECT_EQ( e->rightNode, c );
+    EXPECT_DOUBLE_EQ( e->len, std::sqrt( 2.0 ) );
+    EXPECT_EQ( e->element1, nullptr );
+    EXPECT_FALSE( e->frontEdge );
+}
+
 TEST_F( EdgeTest, ClearStateList )
 {
     Edge::stateList[0].add( edge );
@@ -2361,10 +2381,10 @@ TEST_F(EdgeTest, SplitTrianglesAt_SplitsCorrectly)
     eCA->element2 = tri2;
 
     // Prepare lists
-    ArrayList<std::shared_ptr<Triangle>> triangleList;
+    MeshList<std::shared_ptr<Triangle>> triangleList;
     triangleList.add(tri1);
     triangleList.add(tri2);
-    ArrayList<std::shared_ptr<Edge>> edgeList;
+    EdgeList edgeList;
     edgeList.add(eAB);
     edgeList.add(eBC);
     edgeList.add(eCA);
@@ -2383,6 +2403,12 @@ TEST_F(EdgeTest, SplitTrianglesAt_SplitsCorrectly)
     // Call splitTrianglesAt on edge AC (eCA), ben = nA
     auto resultEdge = eCA->splitTrianglesAt(nN, nA, triangleList, edgeList, nodeList);
 
+    // The split edge and triangles are left as tombstones until compacted
+    EXPECT_EQ(triangleList.removedCount(), 2);
+    EXPECT_EQ(edgeList.removedCount(), 1);
+    triangleList.compact();
+    edgeList.compact();
+
     // There should now be 4 triangles and 7 edges
     EXPECT_EQ(triangleList.size(), 4);
     EXPECT_EQ(edgeList.size(), 7);
@@ -2436,10 +2462,10 @@ TEST_F(EdgeTest, SplitTrianglesAtMyMidPoint_SplitsEdgeAndUpdatesLists)
     e4->connectNodes();
     e5->connectNodes();
 
-    ArrayList<std::shared_ptr<Triangle>> triangleList;
+    MeshList<std::shared_ptr<Triangle>> triangleList;
     triangleList.add(t1);
     triangleList.add(t2);
-    ArrayList<std::shared_ptr<Edge>> edgeList;
+    EdgeList edgeList;
     edgeList.add(e1);
     edgeList.add(e2);
     edgeList.add(e3);
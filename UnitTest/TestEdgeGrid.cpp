@@ -0,0 +1,237 @@
+#include "pch.h"
+#include "EdgeGrid.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace
+{
+    ArrayList<std::shared_ptr<Edge>>
+    randomEdges( size_t n, unsigned seed )
+    {
+        std::mt19937 rng( seed );
+        std::uniform_real_distribution<double> pos( 0.0, 10.0 );
+        std::uniform_real_distribution<double> len( -0.5, 0.5 );
+        ArrayList<std::shared_ptr<Edge>> edges;
+        for ( size_t i = 0; i < n; i++ )
+        {
+            double x = pos( rng ), y = pos( rng );
+            auto a = std::make_shared<Node>( x, y );
+            auto b = std::make_shared<Node>( x + len( rng ), y + len( rng ) );
+            edges.add( std::make_shared<Edge>( a, b ) );
+        }
+        return edges;
+    }
+
+    bool
+    properlyCrosses( const Edge& e, double ax, double ay, double bx, double by )
+    {
+        const auto& p = *e.leftNode;
+        const auto& q = *e.rightNode;
+        int sp = rcl::orientation( ax, ay, bx, by, p.x, p.y );
+        int sq = rcl::orientation( ax, ay, bx, by, q.x, q.y );
+        int sa = rcl::orientation( p.x, p.y, q.x, q.y, ax, ay );
+        int sb = rcl::orientation( p.x, p.y, q.x, q.y, bx, by );
+        return sp * sq < 0 && sa * sb < 0;
+    }
+
+    double
+    distanceTo( const Edge& e, double x, double y )
+    {
+        const auto& p = *e.leftNode;
+        const auto& q = *e.rightNode;
+        double dx = q.x - p.x, dy = q.y - p.y;
+        double t = std::clamp( ((x - p.x) * dx + (y - p.y) * dy) / (dx * dx + dy * dy), 0.0, 1.0 );
+        return std::hypot( p.x + t * dx - x, p.y + t * dy - y );
+    }
+}
+
+TEST( EdgeGridTest, CrossingMatchesBruteForce )
+{
+    auto edges = randomEdges( 2000, 7 );
+    EdgeGrid grid( edges );
+    EXPECT_EQ( grid.size(), edges.size() );
+
+    std::mt19937 rng( 11 );
+    std::uniform_real_distribution<double> pos( -1.0, 11.0 );
+    for ( int k = 0; k < 200; k++ )
+    {
+        double ax = pos( rng ), ay = pos( rng ), bx = pos( rng ), by = pos( rng );
+        auto found = grid.crossing( ax, ay, bx, by );
+
+        size_t expected = 0;
+        for ( const auto& e : edges )
+        {
+            if ( properlyCrosses( *e, ax, ay, bx, by ) )
+            {
+                expected++;
+                EXPECT_TRUE( std::find( found.begin(), found.end(), e ) != found.end() );
+            }
+        }
+        EXPECT_EQ( found.size(), expected );
+    }
+}
+
+TEST( EdgeGridTest, CrossingOrderedFromStart )
+{
+    ArrayList<std::shared_ptr<Edge>> edges;
+    for ( int i = 5; i >= 1; i-- )
+    {
+        edges.add( std::make_shared<Edge>( std::make_shared<Node>( i, -1.0 ), std::make_shared<Node>( i, 1.0 ) ) );
+    }
+    // Touches the segment at an endpoint only, and is not reported
+    edges.add( std::make_shared<Edge>( std::make_shared<Node>( 2.5, 0.0 ), std::make_shared<Node>( 2.5, 1.0 ) ) );
+    EdgeGrid grid( 0.7 );
+    for ( const auto& e : edges )
+    {
+        grid.insert( e );
+    }
+
+    auto found = grid.crossing( 0.0, 0.0, 6.0, 0.0 );
+    ASSERT_EQ( found.size(), 5u );
+    for ( size_t i = 0; i < found.size(); i++ )
+    {
+        EXPECT_DOUBLE_EQ( found.get( i )->leftNode->x, static_cast<double>(i + 1) );
+    }
+
+    auto reversed = grid.crossing( 6.0, 0.0, 0.0, 0.0 );
+    ASSERT_EQ( reversed.size(), 5u );
+    EXPECT_DOUBLE_EQ( reversed.get( 0 )->leftNode->x, 5.0 );
+}
+
+TEST( EdgeGridTest, NearestMatchesBruteForce )
+{
+    auto edges = randomEdges( 1000, 3 );
+    EdgeGrid grid( edges );
+
+    std::mt19937 rng( 5 );
+    std::uniform_real_distribution<double> pos( -20.0, 30.0 );
+    for ( int k = 0; k < 200; k++ )
+    {
+        double x = pos( rng ), y = pos( rng );
+        double best = std::numeric_limits<double>::infinity();
+        for ( const auto& e : edges )
+        {
+            best = std::min( best, distanceTo( *e, x, y ) );
+        }
+
+        double dist;
+        auto e = grid.nearest( x, y, &dist );
+        ASSERT_NE( e, nullptr );
+        EXPECT_DOUBLE_EQ( dist, best );
+        EXPECT_DOUBLE_EQ( distanceTo( *e, x, y ), best );
+    }
+
+    EdgeGrid empty( 1.0 );
+    EXPECT_EQ( empty.nearest( 0.0, 0.0 ), nullptr );
+}
+
+TEST( EdgeGridTest, EdgeListKeepsGridInSync )
+{
+    auto& list = GeomBasics::edgeList;
+    list.clear();
+    auto edges = randomEdges( 50, 13 );
+    list.addAll( edges );
+    list.setGrid( std::make_shared<EdgeGrid>( 1.0 ) );
+    const auto& grid = list.getGrid();
+    EXPECT_EQ( grid->size(), 50u );
+
+    auto removed = list.get( 10 );
+    list.remove( 10 );
+    EXPECT_FALSE( grid->contains( removed ) );
+    EXPECT_EQ( grid->size(), 49u );
+
+    auto a = std::make_shared<Node>( 20.0, 20.0 );
+    auto b = std::make_shared<Node>( 21.0, 21.0 );
+    auto added = std::make_shared<Edge>( a, b );
+    added->connectNodes();
+    list.add( added );
+    EXPECT_TRUE( grid->contains( added ) );
+    EXPECT_EQ( grid->crossing( 20.2, 20.8, 20.8, 20.2 ).size(), 1u );
+
+    // Moving a node through Node re-registers its edges
+    b->moveToPos( 21.0, 40.0 );
+    EXPECT_EQ( grid->crossing( 20.0, 30.0, 22.0, 30.0 ).size(), 1u );
+    EXPECT_EQ( grid->crossing( 20.2, 20.8, 20.8, 20.2 ).size(), 0u );
+
+    // So does setXY(..), which the smoothers use
+    b->setXY( 40.0, 40.0 );
+    EXPECT_EQ( grid->crossing( 29.0, 31.0, 31.0, 29.0 ).size(), 1u );
+    EXPECT_EQ( grid->crossing( 20.0, 30.0, 22.0, 30.0 ).size(), 0u );
+    b->setXY( 21.0, 21.0 );
+    EXPECT_EQ( grid->crossing( 20.2, 20.8, 20.8, 20.2 ).size(), 1u );
+
+    list.clear();
+    EXPECT_EQ( grid->size(), 0u );
+    list.setGrid( nullptr );
+}
+
+TEST( EdgeGridTest, SplitAndReinitKeepGridInSync )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 );
+    auto b = std::make_shared<Node>( 1.0, 0.0 );
+    auto c = std::make_shared<Node>( 1.0, 1.0 );
+    auto d = std::make_shared<Node>( 0.0, 1.0 );
+    auto ab = std::make_shared<Edge>( a, b );
+    auto bc = std::make_shared<Edge>( b, c );
+    auto ca = std::make_shared<Edge>( c, a );
+    auto cd = std::make_shared<Edge>( c, d );
+    auto da = std::make_shared<Edge>( d, a );
+    auto& list = GeomBasics::edgeList;
+    list.clear();
+    for ( const auto& e : { ab, bc, ca, cd, da } )
+    {
+        e->connectNodes();
+        list.add( e );
+    }
+    auto t1 = std::make_shared<Triangle>( ab, bc, ca );
+    auto t2 = std::make_shared<Triangle>( ca, cd, da );
+    t1->connectEdges();
+    t2->connectEdges();
+    MeshList<std::shared_ptr<Triangle>> triangles;
+    triangles.add( t1 );
+    triangles.add( t2 );
+    ArrayList<std::shared_ptr<Node>> nodes;
+    for ( const auto& n : { a, b, c, d } )
+    {
+        nodes.add( n );
+    }
+
+    list.setGrid( std::make_shared<EdgeGrid>( 0.5 ) );
+    const auto& grid = list.getGrid();
+    auto crossed = grid->crossing( 0.1, 0.3, 0.3, 0.1 );
+    ASSERT_EQ( crossed.size(), 1u );
+    EXPECT_EQ( crossed.get( 0 ), ca );
+
+    // The split edits the edgeList, so the grid follows without any help
+    auto lower = ca->splitTrianglesAtMyMidPoint( triangles, list, nodes, ab );
+    EXPECT_FALSE( grid->contains( ca ) );
+    list.compact();
+    EXPECT_EQ( grid->size(), list.size() );
+    for ( const auto& e : list )
+    {
+        EXPECT_TRUE( grid->contains( e ) );
+    }
+    crossed = grid->crossing( 0.1, 0.3, 0.3, 0.1 );
+    ASSERT_EQ( crossed.size(), 1u );
+    EXPECT_EQ( crossed.get( 0 ), lower );
+
+    // A reused edge moves to the cells of its new nodes
+    auto far1 = std::make_shared<Node>( 5.0, 5.0 );
+    auto far2 = std::make_shared<Node>( 6.0, 6.0 );
+    lower->reinit( far1, far2 );
+    EXPECT_EQ( grid->crossing( 0.1, 0.3, 0.3, 0.1 ).size(), 0u );
+    crossed = grid->crossing( 5.2, 5.8, 5.8, 5.2 );
+    ASSERT_EQ( crossed.size(), 1u );
+    EXPECT_EQ( crossed.get( 0 ), lower );
+
+    list.clear();
+    list.setGrid( nullptr );
+}
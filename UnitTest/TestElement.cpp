@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "Element.h"
 #include "Node.h"
+#include "Edge.h"
+#include "Types.h"
 
 //All tests are working.
 
@@ -42,3 +44,32 @@ TEST( ElementTest, CrossProductTest )
     EXPECT_DOUBLE_EQ( result, 0.0 );
 }
 
+TEST( ElementTest, TypeTagMatchesTheClass )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 ), b = std::make_shared<Node>( 1.0, 0.0 );
+    auto c = std::make_shared<Node>( 1.0, 1.0 ), d = std::make_shared<Node>( 0.0, 1.0 );
+    auto ab = std::make_shared<Edge>( a, b ), bc = std::make_shared<Edge>( b, c );
+    auto cd = std::make_shared<Edge>( c, d ), da = std::make_shared<Edge>( d, a );
+    auto ac = std::make_shared<Edge>( a, c );
+
+    std::shared_ptr<Element> t = std::make_shared<Triangle>( ab, bc, ac );
+    std::shared_ptr<Element> q = std::make_shared<Quad>( ab, da, bc, cd );
+    std::shared_ptr<Element> none;
+
+    EXPECT_EQ( t->type, ElementType::Triangle );
+    EXPECT_EQ( q->type, ElementType::Quad );
+    EXPECT_TRUE( rcl::instanceOf<Triangle>( t ) );
+    EXPECT_FALSE( rcl::instanceOf<Quad>( t ) );
+    EXPECT_TRUE( rcl::instanceOf<Quad>( q ) );
+    EXPECT_FALSE( rcl::instanceOf<Quad>( none ) );
+
+    EXPECT_EQ( rcl::asQuad( q ), q.get() );
+    EXPECT_EQ( rcl::asQuad( t ), nullptr );
+    EXPECT_EQ( rcl::triangleCast( t ), std::dynamic_pointer_cast<Triangle>( t ) );
+    EXPECT_EQ( rcl::triangleCast( q ), nullptr );
+    EXPECT_EQ( rcl::quadCast( none ), nullptr );
+
+    auto corners = []( auto& elem ) { return elem.edgeList.size(); };
+    EXPECT_EQ( rcl::visit( *t, corners ), 3u );
+    EXPECT_EQ( rcl::visit( *q, corners ), 4u );
+}
@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "FrontList.h"
+#include "Edge.h"
+#include "Node.h"
+
+#include <vector>
+
+namespace
+{
+    std::vector<std::shared_ptr<Edge>>
+    makeEdges( int n )
+    {
+        std::vector<std::shared_ptr<Edge>> edges;
+        for ( int i = 0; i < n; i++ )
+        {
+            edges.push_back( std::make_shared<Edge>( std::make_shared<Node>( i, 0.0 ),
+                                                     std::make_shared<Node>( i, 1.0 ) ) );
+        }
+        return edges;
+    }
+
+    std::vector<std::shared_ptr<Edge>>
+    contents( const FrontList& list )
+    {
+        return std::vector<std::shared_ptr<Edge>>( list.begin(), list.end() );
+    }
+}
+
+TEST( FrontListTest, KeepsInsertionOrderWhenRemoving )
+{
+    auto edges = makeEdges( 5 );
+    FrontList list;
+    for ( const auto& e : edges )
+    {
+        list.add( e );
+    }
+    list.add( edges[2] );
+    EXPECT_EQ( list.size(), 5u );
+
+    EXPECT_TRUE( list.remove( edges[2] ) );
+    EXPECT_FALSE( list.remove( edges[2] ) );
+    EXPECT_EQ( contents( list ), (std::vector{ edges[0], edges[1], edges[3], edges[4] }) );
+
+    EXPECT_TRUE( list.remove( edges[0] ) );
+    EXPECT_TRUE( list.remove( edges[4] ) );
+    EXPECT_EQ( contents( list ), (std::vector{ edges[1], edges[3] }) );
+
+    list.add( edges[0] );
+    EXPECT_EQ( contents( list ), (std::vector{ edges[1], edges[3], edges[0] }) );
+    EXPECT_TRUE( list.contains( edges[3] ) );
+    EXPECT_FALSE( list.contains( edges[4] ) );
+
+    list.clear();
+    EXPECT_TRUE( list.empty() );
+    EXPECT_FALSE( list.contains( edges[3] ) );
+    EXPECT_EQ( edges[1]->frontNext, nullptr );
+}
+
+TEST( FrontListTest, PromoteAndRemoveFromFront )
+{
+    auto edges = makeEdges( 3 );
+    FrontList list;
+    for ( const auto& e : edges )
+    {
+        e->promoteToFront( 2, list );
+    }
+    edges[1]->promoteToFront( 3, list );
+    EXPECT_EQ( list.size(), 3u );
+    EXPECT_EQ( edges[1]->level, 2 );
+    EXPECT_TRUE( edges[1]->frontEdge );
+
+    EXPECT_TRUE( edges[1]->removeFromFront( list ) );
+    EXPECT_FALSE( edges[1]->frontEdge );
+    EXPECT_FALSE( edges[1]->removeFromFront( list ) );
+    EXPECT_EQ( contents( list ), (std::vector{ edges[0], edges[2] }) );
+}
+
+TEST( FrontListTest, ClearsLongListsIteratively )
+{
+    auto edges = makeEdges( 100000 );
+    FrontList list;
+    for ( const auto& e : edges )
+    {
+        list.add( e );
+    }
+    EXPECT_EQ( list.size(), edges.size() );
+    edges.clear();
+    list.clear();
+    EXPECT_EQ( list.size(), 0u );
+}
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "FrontLoops.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+
+#include <cmath>
+#include <numbers>
+
+class FrontLoopsTest : public ::testing::Test
+{
+protected:
+    std::vector<std::shared_ptr<Node>> nodes;
+    std::vector<std::shared_ptr<Edge>> ring;
+    ArrayList<std::shared_ptr<Edge>> frontList;
+
+    // A loop of n front edges around the unit circle
+    void SetUp() override
+    {
+        const int n = 12;
+        for ( int i = 0; i < n; i++ )
+        {
+            double a = 2.0 * std::numbers::pi * i / n;
+            nodes.push_back( std::make_shared<Node>( std::cos( a ), std::sin( a ) ) );
+        }
+        for ( int i = 0; i < n; i++ )
+        {
+            ring.push_back( std::make_shared<Edge>( nodes[i], nodes[(i + 1) % n] ) );
+            ring.back()->promoteToFront( 0, frontList );
+        }
+        for ( int i = 0; i < n; i++ )
+        {
+            linkFronts( ring[i], ring[(i + 1) % n] );
+        }
+        GeomBasics::frontLoops = std::make_shared<FrontLoops>( frontList );
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::frontLoops = nullptr;
+    }
+
+    static void linkFronts( const std::shared_ptr<Edge>& a, const std::shared_ptr<Edge>& b )
+    {
+        a->setFrontNeighbor( b );
+        b->setFrontNeighbor( a );
+    }
+
+    // The length of the loop at e, found by walking it
+    static int walkLoop( const std::shared_ptr<Edge>& e )
+    {
+        int n = 1;
+        std::shared_ptr<Edge> prev = e, cur = e->leftFrontNeighbor;
+        while ( cur != e )
+        {
+            auto next = cur->nextFrontNeighbor( prev );
+            prev = cur;
+            cur = next;
+            n++;
+        }
+        return n;
+    }
+};
+
+TEST_F( FrontLoopsTest, RingIsOneLoop )
+{
+    auto& loops = *GeomBasics::frontLoops;
+    EXPECT_EQ( loops.size(), 12u );
+    EXPECT_EQ( loops.loopSize( ring[0] ), 12 );
+    EXPECT_EQ( loops.countAtLowestLevel(), 12 );
+    EXPECT_EQ( loops.lowestLevel(), 0 );
+
+    int dir = loops.direction( ring[0], ring[1] );
+    ASSERT_NE( dir, 0 );
+    EXPECT_EQ( loops.direction( ring[0], ring[11] ), -dir );
+    EXPECT_EQ( loops.direction( ring[0], ring[5] ), 0 );
+    EXPECT_EQ( loops.distance( ring[0], ring[5], dir ), 5 );
+    EXPECT_EQ( loops.distance( ring[0], ring[5], -dir ), 7 );
+    EXPECT_EQ( loops.distance( ring[3], ring[3], dir ), 0 );
+}
+
+TEST_F( FrontLoopsTest, SplitAndMergeFollowNeighbors )
+{
+    auto& loops = *GeomBasics::frontLoops;
+
+    // Split the ring in two loops through two new nodes near the center
+    auto m1 = std::make_shared<Node>( 0.0, 0.1 ), m2 = std::make_shared<Node>( 0.0, -0.1 );
+    auto a1 = std::make_shared<Edge>( nodes[6], m1 ), a2 = std::make_shared<Edge>( m1, nodes[0] );
+    auto b1 = std::make_shared<Edge>( nodes[0], m2 ), b2 = std::make_shared<Edge>( m2, nodes[6] );
+    for ( const auto& e : { a1, a2, b1, b2 } )
+    {
+        e->promoteToFront( 1, frontList );
+    }
+    linkFronts( ring[5], a1 );
+    linkFronts( a1, a2 );
+    linkFronts( a2, ring[0] );
+    linkFronts( ring[11], b1 );
+    linkFronts( b1, b2 );
+    linkFronts( b2, ring[6] );
+
+    EXPECT_EQ( loops.size(), 16u );
+    EXPECT_EQ( loops.loopSize( ring[0] ), 8 );
+    EXPECT_EQ( loops.loopSize( ring[6] ), 8 );
+    EXPECT_EQ( loops.loopSize( ring[0] ), walkLoop( ring[0] ) );
+    EXPECT_TRUE( loops.sameLoop( ring[2], a2 ) );
+    EXPECT_FALSE( loops.sameLoop( ring[2], b2 ) );
+    EXPECT_EQ( loops.countAtLowestLevel(), 12 );
+
+    int dir = loops.direction( ring[5], a1 );
+    ASSERT_NE( dir, 0 );
+    EXPECT_EQ( loops.distance( ring[5], ring[0], dir ), 3 );
+
+    // Join the two loops again
+    for ( const auto& e : { a1, a2, b1, b2 } )
+    {
+        e->removeFromFront( frontList );
+    }
+    linkFronts( ring[5], ring[6] );
+    linkFronts( ring[11], ring[0] );
+
+    EXPECT_EQ( loops.size(), 12u );
+    EXPECT_EQ( loops.loopSize( ring[0] ), 12 );
+    EXPECT_TRUE( loops.sameLoop( ring[2], ring[8] ) );
+    EXPECT_FALSE( loops.contains( a1 ) );
+
+    // Removing one edge opens the loop
+    ring[3]->removeFromFront( frontList );
+    EXPECT_EQ( loops.loopSize( ring[0] ), 0 );
+    EXPECT_EQ( loops.direction( ring[0], ring[1] ), 0 );
+}
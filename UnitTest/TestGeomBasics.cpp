@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "GeomBasics.h"
+#include "QMorph.h"
+#include "Edge.h"
+#include "Element.h"
+#include "Node.h"
+#include "Triangle.h"
+#include "Msg.h"
+
+#include <array>
+#include <filesystem>
+
+class GeomBasicsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Msg::debugMode = false;
+        GeomBasics::clearLists();
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+        Msg::debugMode = true;
+    }
+
+    static std::array<int64_t, 3> liveCounts()
+    {
+        return { LiveCount<Node>::get(), LiveCount<Edge>::get(), LiveCount<Element>::get() };
+    }
+
+    // Load, mesh and tear down every example that meshes in this process.
+    // The skipped ones stop in Msg::error or throw.
+    static void meshExamples()
+    {
+        const std::filesystem::path examples = EXAMPLES_DIR;
+        for ( const auto& dir : { "others-tri", "thesis-tri" } )
+        {
+            for ( const auto& entry : std::filesystem::directory_iterator( examples / dir ) )
+            {
+                auto name = entry.path().filename().string();
+                if ( entry.path().extension() != ".mesh"
+                     || name == "ball-t-2.mesh" || name == "onehole.mesh" || name == "mask.mesh" )
+                {
+                    continue;
+                }
+                GeomBasics::setParams( name, entry.path().parent_path().string(), false, false );
+                GeomBasics::loadMesh();
+                GeomBasics::findExtremeNodes();
+                std::make_shared<QMorph>()->runParallel();
+                EXPECT_GT( GeomBasics::elementList.size(), 0u ) << name;
+                GeomBasics::clearLists();
+            }
+        }
+    }
+};
+
+TEST_F( GeomBasicsTest, ClearListsFreesTheMesh )
+{
+    auto before = liveCounts();
+    {
+        auto a = std::make_shared<Node>( 0.0, 0.0 );
+        auto b = std::make_shared<Node>( 1.0, 0.0 );
+        auto c = std::make_shared<Node>( 0.0, 1.0 );
+        std::shared_ptr<Edge> ab = std::make_shared<Edge>( a, b );
+        std::shared_ptr<Edge> bc = std::make_shared<Edge>( b, c );
+        std::shared_ptr<Edge> ca = std::make_shared<Edge>( c, a );
+        for ( const auto& e : { ab, bc, ca } )
+        {
+            e->connectNodes();
+            GeomBasics::edgeList.add( e );
+        }
+        auto t = std::make_shared<Triangle>( ab, bc, ca );
+        t->connectEdges();
+        GeomBasics::triangleList.add( t );
+        for ( const auto& n : { a, b, c } )
+        {
+            GeomBasics::nodeList.add( n );
+        }
+        // Fills the star cache of a, which points back at t
+        EXPECT_EQ( a->adjElements().size(), 1u );
+    }
+    EXPECT_EQ( LiveCount<Element>::get(), before[2] + 1 );
+    GeomBasics::clearLists();
+    EXPECT_EQ( liveCounts(), before );
+}
+
+TEST_F( GeomBasicsTest, DetachListsKeepsTheLinks )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 );
+    auto b = std::make_shared<Node>( 1.0, 0.0 );
+    auto ab = std::make_shared<Edge>( a, b );
+    ab->connectNodes();
+    GeomBasics::edgeList.add( ab );
+    GeomBasics::nodeList.add( a );
+    GeomBasics::nodeList.add( b );
+
+    GeomBasics::detachLists();
+    EXPECT_EQ( GeomBasics::edgeList.size(), 0u );
+    EXPECT_EQ( GeomBasics::nodeList.size(), 0u );
+    EXPECT_EQ( ab->leftNode, a );
+    EXPECT_EQ( a->edgeList.size(), 1u );
+
+    // Put back, so that TearDown() frees them
+    GeomBasics::edgeList.add( ab );
+}
+
+TEST_F( GeomBasicsTest, EntitiesDroppedWhileMeshingAreFreed )
+{
+    auto before = liveCounts();
+    const std::filesystem::path examples = EXAMPLES_DIR;
+    GeomBasics::setParams( "castle.mesh", (examples / "others-tri").string(), false, false );
+    GeomBasics::loadMesh();
+    GeomBasics::findExtremeNodes();
+
+    // Most of the initial triangles and many of their edges are replaced
+    // while meshing
+    std::vector<std::weak_ptr<Triangle>> triangles;
+    std::vector<std::weak_ptr<Edge>> edges;
+    for ( const auto& t : GeomBasics::triangleList )
+    {
+        triangles.push_back( t );
+    }
+    for ( const auto& e : GeomBasics::edgeList )
+    {
+        edges.push_back( e );
+    }
+
+    {
+        auto morph = std::make_shared<QMorph>();
+        morph->init();
+        morph->run();
+    }
+    GeomBasics::compactLists();
+
+    size_t dropped = 0;
+    for ( const auto& t : triangles )
+    {
+        auto kept = t.lock();
+        if ( kept == nullptr )
+        {
+            dropped++;
+        }
+        else
+        {
+            EXPECT_TRUE( GeomBasics::triangleList.contains( kept ) || GeomBasics::elementList.contains( kept ) );
+        }
+    }
+    for ( const auto& e : edges )
+    {
+        auto kept = e.lock();
+        if ( kept == nullptr )
+        {
+            dropped++;
+        }
+        else
+        {
+            EXPECT_TRUE( GeomBasics::edgeList.contains( kept ) );
+        }
+    }
+    EXPECT_GT( dropped, 0u );
+
+    // Nor is any edge made and dropped along the way kept alive
+    EXPECT_EQ( LiveCount<Edge>::get(), before[1] + static_cast<int64_t>(GeomBasics::edgeList.size()) );
+}
+
+TEST_F( GeomBasicsTest, MeshingTheExamplesDoesNotLeak )
+{
+    // The first round settles whatever is made once and kept, such as the
+    // scratch arena of the thread
+    meshExamples();
+    auto after = liveCounts();
+    for ( int round = 0; round < 2; round++ )
+    {
+        meshExamples();
+        EXPECT_EQ( liveCounts(), after ) << "round " << round;
+    }
+}
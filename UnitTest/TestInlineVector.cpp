@@ -0,0 +1,39 @@
+#include "pch.h"
+#include "InlineVector.h"
+
+#include <memory>
+#include <vector>
+
+TEST( InlineVectorTest, AssignAndResize )
+{
+    InlineVector<double, 4> v;
+    EXPECT_TRUE( v.empty() );
+    v.assign( 3, 1.5 );
+    ASSERT_EQ( v.size(), 3u );
+    EXPECT_EQ( v[2], 1.5 );
+
+    std::vector<double> other = { 1.0, 2.0, 3.0, 4.0 };
+    v = other;
+    ASSERT_EQ( v.size(), 4u );
+    double sum = 0.0;
+    for ( auto a : v )
+    {
+        sum += a;
+    }
+    EXPECT_EQ( sum, 10.0 );
+
+    EXPECT_THROW( v.push_back( 5.0 ), std::length_error );
+    EXPECT_THROW( v.resize( 5 ), std::length_error );
+    EXPECT_THROW( v.at( 4 ), std::out_of_range );
+}
+
+TEST( InlineVectorTest, ShrinkingReleasesElements )
+{
+    auto p = std::make_shared<int>( 1 );
+    InlineVector<std::shared_ptr<int>, 4> v( 4, p );
+    EXPECT_EQ( p.use_count(), 5 );
+    v.resize( 1 );
+    EXPECT_EQ( p.use_count(), 2 );
+    v.clear();
+    EXPECT_EQ( p.use_count(), 1 );
+}
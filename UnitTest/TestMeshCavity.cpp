@@ -0,0 +1,141 @@
+#include "pch.h"
+#include "MeshCavity.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Quad.h"
+
+#include <map>
+
+class MeshCavityTest : public ::testing::Test
+{
+protected:
+    static constexpr int N = 4;
+    std::map<std::pair<int, int>, std::shared_ptr<Node>> nodeAt;
+    std::map<std::pair<const Node*, const Node*>, std::shared_ptr<Edge>> edgeAt;
+
+    std::shared_ptr<Edge> edge( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b,
+                                ArrayList<std::shared_ptr<Edge>>& list )
+    {
+        auto key = a.get() < b.get() ? std::make_pair( a.get(), b.get() ) : std::make_pair( b.get(), a.get() );
+        auto& e = edgeAt[key];
+        if ( e == nullptr )
+        {
+            e = std::make_shared<Edge>( a, b );
+            e->connectNodes();
+            list.add( e );
+        }
+        return e;
+    }
+
+    std::shared_ptr<Quad> quad( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b,
+                                const std::shared_ptr<Node>& c, const std::shared_ptr<Node>& d,
+                                ArrayList<std::shared_ptr<Edge>>& list )
+    {
+        auto q = std::make_shared<Quad>( edge( a, b, list ), edge( a, d, list ), edge( b, c, list ), edge( d, c, list ) );
+        q->connectEdges();
+        return q;
+    }
+
+    // A grid of N x N unit quads
+    void SetUp() override
+    {
+        GeomBasics::clearLists();
+        for ( int j = 0; j <= N; j++ )
+        {
+            for ( int i = 0; i <= N; i++ )
+            {
+                nodeAt[{ i, j }] = std::make_shared<Node>( i, j );
+                GeomBasics::nodeList.add( nodeAt[{ i, j }] );
+            }
+        }
+        for ( int j = 0; j < N; j++ )
+        {
+            for ( int i = 0; i < N; i++ )
+            {
+                GeomBasics::elementList.add( quad( nodeAt[{ i, j }], nodeAt[{ i + 1, j }], nodeAt[{ i + 1, j + 1 }],
+                                                   nodeAt[{ i, j + 1 }], GeomBasics::edgeList ) );
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+    }
+};
+
+TEST_F( MeshCavityTest, HoldsTheElementsNearTheChange )
+{
+    ArrayList<std::shared_ptr<Node>> changed;
+    changed.add( nodeAt[{ 2, 2 }] );
+
+    MeshCavity cavity( changed, 0.5 );
+    EXPECT_EQ( cavity.size(), 4u );
+    ASSERT_EQ( cavity.getLoops().size(), 1u );
+    EXPECT_EQ( cavity.getLoops()[0].size(), 8u );
+    for ( const auto& n : cavity.getLoops()[0] )
+    {
+        EXPECT_NE( n, nodeAt[std::make_pair( 2, 2 )] );
+        EXPECT_DOUBLE_EQ( std::max( std::abs( n->x - 2.0 ), std::abs( n->y - 2.0 ) ), 1.0 );
+    }
+    EXPECT_DOUBLE_EQ( cavity.edgeLength( 2.3, 1.9 ), 1.0 );
+
+    // A wider band reaches the next ring of elements
+    MeshCavity wider( changed, 1.5 );
+    EXPECT_EQ( wider.size(), 16u );
+    ASSERT_EQ( wider.getLoops().size(), 1u );
+    EXPECT_EQ( wider.getLoops()[0].size(), 16u );
+}
+
+TEST_F( MeshCavityTest, ReplacesTheCavity )
+{
+    ArrayList<std::shared_ptr<Node>> changed;
+    changed.add( nodeAt[{ 2, 2 }] );
+    MeshCavity cavity( changed, 0.5 );
+
+    // Mesh the loop again with the inner node moved
+    std::map<std::pair<int, int>, std::shared_ptr<Node>> copyAt;
+    MeshComponents::Component meshed;
+    for ( const auto& n : cavity.getLoops()[0] )
+    {
+        copyAt[{ static_cast<int>(n->x), static_cast<int>(n->y) }] = n;
+        meshed.nodes.add( n );
+    }
+    copyAt[{ 2, 2 }] = std::make_shared<Node>( 2.25, 1.75 );
+    meshed.nodes.add( copyAt[{ 2, 2 }] );
+    edgeAt.clear();
+    for ( int j = 1; j < 3; j++ )
+    {
+        for ( int i = 1; i < 3; i++ )
+        {
+            meshed.elements.add( quad( copyAt[{ i, j }], copyAt[{ i + 1, j }], copyAt[{ i + 1, j + 1 }],
+                                       copyAt[{ i, j + 1 }], meshed.edges ) );
+        }
+    }
+
+    ASSERT_TRUE( cavity.replace( meshed ) );
+    GeomBasics::compactLists();
+    EXPECT_EQ( GeomBasics::elementList.size(), 16u );
+    EXPECT_EQ( GeomBasics::edgeList.size(), 40u );
+    EXPECT_EQ( GeomBasics::nodeList.size(), 25u );
+    EXPECT_EQ( GeomBasics::nodeList.indexOf( nodeAt[{ 2, 2 }] ), -1 );
+
+    // The new elements share the original edges around the cavity
+    auto corner = nodeAt[{ 1, 1 }];
+    EXPECT_EQ( corner->edgeList.size(), 4u );
+    for ( const auto& e : corner->edgeList )
+    {
+        EXPECT_NE( e->element1, nullptr );
+        EXPECT_NE( e->element2, nullptr );
+        EXPECT_NE( GeomBasics::edgeList.indexOf( e ), -1 );
+    }
+    for ( const auto& elem : GeomBasics::elementList )
+    {
+        for ( const auto& e : elem->edgeList )
+        {
+            EXPECT_NE( GeomBasics::edgeList.indexOf( e ), -1 );
+            EXPECT_TRUE( e->element1 == elem || e->element2 == elem );
+        }
+    }
+}
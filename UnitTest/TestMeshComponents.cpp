@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "MeshComponents.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+namespace
+{
+    struct Mesh
+    {
+        ArrayList<std::shared_ptr<Triangle>> triangles;
+        ArrayList<std::shared_ptr<Edge>> edges;
+        ArrayList<std::shared_ptr<Node>> nodes;
+
+        std::shared_ptr<Node>
+        node( double x, double y )
+        {
+            auto n = std::make_shared<Node>( x, y );
+            nodes.add( n );
+            return n;
+        }
+
+        std::shared_ptr<Edge>
+        edge( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b )
+        {
+            auto e = std::make_shared<Edge>( a, b );
+            edges.add( e );
+            return e;
+        }
+
+        std::shared_ptr<Triangle>
+        triangle( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b, const std::shared_ptr<Node>& c )
+        {
+            auto t = std::make_shared<Triangle>( edge( a, b ), edge( b, c ), edge( a, c ) );
+            triangles.add( t );
+            return t;
+        }
+    };
+}
+
+TEST( MeshComponentsTest, TrianglesSharingANodeAreConnected )
+{
+    Mesh m;
+    auto a = m.node( 0.0, 0.0 ), b = m.node( 1.0, 0.0 ), c = m.node( 0.0, 1.0 );
+    auto d = m.node( 5.0, 5.0 ), e = m.node( 6.0, 5.0 ), f = m.node( 5.0, 6.0 );
+    auto g = m.node( -1.0, 1.0 ), h = m.node( -1.0, 2.0 );
+    auto t1 = m.triangle( a, b, c );
+    auto t2 = m.triangle( d, e, f );
+    auto t3 = m.triangle( c, g, h ); // Touches t1 at node c only
+
+    auto components = MeshComponents::split( m.triangles, m.edges, m.nodes );
+    ASSERT_EQ( components.size(), 2u );
+
+    EXPECT_EQ( components[0].triangles.size(), 2u );
+    EXPECT_EQ( components[0].triangles.get( 0 ), t1 );
+    EXPECT_EQ( components[0].triangles.get( 1 ), t3 );
+    EXPECT_EQ( components[0].edges.size(), 6u );
+    EXPECT_EQ( components[0].nodes.size(), 5u );
+
+    EXPECT_EQ( components[1].triangles.size(), 1u );
+    EXPECT_EQ( components[1].triangles.get( 0 ), t2 );
+    EXPECT_EQ( components[1].edges.size(), 3u );
+    EXPECT_EQ( components[1].nodes.size(), 3u );
+}
+
+TEST( MeshComponentsTest, RejectsEntitiesOutsideTriangles )
+{
+    Mesh m;
+    auto a = m.node( 0.0, 0.0 ), b = m.node( 1.0, 0.0 ), c = m.node( 0.0, 1.0 );
+    m.triangle( a, b, c );
+    EXPECT_EQ( MeshComponents::split( m.triangles, m.edges, m.nodes ).size(), 1u );
+
+    m.node( 3.0, 3.0 );
+    EXPECT_TRUE( MeshComponents::split( m.triangles, m.edges, m.nodes ).empty() );
+}
@@ -0,0 +1,117 @@
+#include "pch.h"
+#include "MeshList.h"
+#include "Node.h"
+
+#include <vector>
+
+namespace
+{
+    std::vector<std::shared_ptr<Node>>
+    makeNodes( int n )
+    {
+        std::vector<std::shared_ptr<Node>> nodes;
+        for ( int i = 0; i < n; i++ )
+        {
+            nodes.push_back( std::make_shared<Node>( i, 0.0 ) );
+        }
+        return nodes;
+    }
+}
+
+TEST( MeshListTest, MarkRemovedLeavesIndicesUntilCompacted )
+{
+    auto nodes = makeNodes( 5 );
+    MeshList<std::shared_ptr<Node>> list;
+    for ( const auto& n : nodes )
+    {
+        list.add( n );
+    }
+
+    EXPECT_TRUE( list.markRemoved( nodes[1] ) );
+    EXPECT_TRUE( list.markRemoved( nodes[3] ) );
+    EXPECT_FALSE( list.markRemoved( nodes[3] ) );
+    EXPECT_EQ( list.size(), 5u );
+    EXPECT_EQ( list.removedCount(), 2u );
+    EXPECT_EQ( list.get( 1 ), nullptr );
+    EXPECT_EQ( list.indexOf( nodes[4] ), 4 );
+    EXPECT_FALSE( list.contains( nodes[1] ) );
+
+    list.compact();
+    ASSERT_EQ( list.size(), 3u );
+    EXPECT_EQ( list.removedCount(), 0u );
+    EXPECT_EQ( list.get( 0 ), nodes[0] );
+    EXPECT_EQ( list.get( 1 ), nodes[2] );
+    EXPECT_EQ( list.get( 2 ), nodes[4] );
+}
+
+TEST( MeshListTest, FindsEntitiesAfterOtherChanges )
+{
+    auto nodes = makeNodes( 6 );
+    MeshList<std::shared_ptr<Node>> list;
+    for ( int i = 0; i < 4; i++ )
+    {
+        list.add( nodes[i] );
+    }
+    EXPECT_TRUE( list.markRemoved( nodes[0] ) );
+
+    // Shifting and replacing entities, then appending new ones
+    list.remove( list.indexOf( nodes[1] ) );
+    list.set( list.indexOf( nodes[2] ), nodes[5] );
+    list.add( nodes[4] );
+
+    EXPECT_FALSE( list.markRemoved( nodes[1] ) );
+    EXPECT_FALSE( list.markRemoved( nodes[2] ) );
+    EXPECT_TRUE( list.markRemoved( nodes[5] ) );
+    EXPECT_TRUE( list.markRemoved( nodes[4] ) );
+
+    list.compact();
+    ASSERT_EQ( list.size(), 1u );
+    EXPECT_EQ( list.get( 0 ), nodes[3] );
+}
+
+TEST( MeshListTest, FindsEntitiesAfterRemoveIf )
+{
+    auto nodes = makeNodes( 4 );
+    MeshList<std::shared_ptr<Node>> list;
+    for ( const auto& n : nodes )
+    {
+        list.add( n );
+    }
+    EXPECT_EQ( list.indexOf( nodes[3] ), 3 );
+
+    auto layout = list.layoutVersion();
+    list.removeIf( [&nodes]( const std::shared_ptr<Node>& n ) { return n == nodes[1]; } );
+    EXPECT_NE( list.layoutVersion(), layout );
+
+    // The entities behind the removed one have moved
+    EXPECT_TRUE( list.markRemoved( nodes[3] ) );
+    EXPECT_EQ( list.get( 2 ), nullptr );
+    EXPECT_EQ( list.get( 1 ), nodes[2] );
+}
+
+TEST( MeshListTest, FindsEntitiesAfterSet )
+{
+    auto nodes = makeNodes( 6 );
+    MeshList<std::shared_ptr<Node>> list;
+    for ( int i = 0; i < 4; i++ )
+    {
+        list.add( nodes[i] );
+    }
+    EXPECT_TRUE( list.markRemoved( nodes[0] ) );
+
+    // Replacing entities after the positions are known, then appending
+    list.set( 2, nodes[5] );
+    list.set( 1, nullptr );
+    list.add( nodes[4] );
+
+    EXPECT_FALSE( list.markRemoved( nodes[1] ) );
+    EXPECT_FALSE( list.markRemoved( nodes[2] ) );
+    EXPECT_TRUE( list.markRemoved( nodes[5] ) );
+    EXPECT_EQ( list.get( 2 ), nullptr );
+    EXPECT_TRUE( list.markRemoved( nodes[4] ) );
+    EXPECT_EQ( list.get( 4 ), nullptr );
+
+    list.compact();
+    ASSERT_EQ( list.size(), 1u );
+    EXPECT_EQ( list.get( 0 ), nodes[3] );
+}
@@ -0,0 +1,116 @@
+#include "pch.h"
+#include "MeshSnapshot.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Quad.h"
+#include "Triangle.h"
+
+class MeshSnapshotTest : public ::testing::Test
+{
+protected:
+    // Two triangles sharing the diagonal of the unit square
+    void SetUp() override
+    {
+        GeomBasics::clearLists();
+        Edge::clearStateList();
+        a = std::make_shared<Node>( 0.0, 0.0 );
+        b = std::make_shared<Node>( 1.0, 0.0 );
+        c = std::make_shared<Node>( 1.0, 1.0 );
+        d = std::make_shared<Node>( 0.0, 1.0 );
+        ab = std::make_shared<Edge>( a, b );
+        bc = std::make_shared<Edge>( b, c );
+        cd = std::make_shared<Edge>( c, d );
+        da = std::make_shared<Edge>( d, a );
+        ac = std::make_shared<Edge>( a, c );
+        for ( const auto& e : { ab, bc, cd, da, ac } )
+        {
+            e->connectNodes();
+            GeomBasics::edgeList.add( e );
+        }
+        t1 = std::make_shared<Triangle>( ab, bc, ac );
+        t2 = std::make_shared<Triangle>( ac, cd, da );
+        t1->connectEdges();
+        t2->connectEdges();
+        GeomBasics::triangleList.add( t1 );
+        GeomBasics::triangleList.add( t2 );
+        for ( const auto& n : { a, b, c, d } )
+        {
+            GeomBasics::nodeList.add( n );
+        }
+        GeomBasics::leftmost = a;
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+        Edge::clearStateList();
+        GeomBasics::leftmost = nullptr;
+    }
+
+    std::shared_ptr<Node> a, b, c, d;
+    std::shared_ptr<Edge> ab, bc, cd, da, ac;
+    std::shared_ptr<Triangle> t1, t2;
+};
+
+TEST_F( MeshSnapshotTest, CopiesAreIndependentOfTheMesh )
+{
+    MeshSnapshot snap;
+    EXPECT_EQ( snap.nodeCount(), 4u );
+    EXPECT_EQ( snap.edgeCount(), 5u );
+    EXPECT_EQ( snap.elementCount(), 2u );
+
+    auto m = snap.copy();
+    ASSERT_EQ( m.nodes.size(), 4u );
+    ASSERT_EQ( m.edges.size(), 5u );
+    ASSERT_EQ( m.triangles.size(), 2u );
+    for ( size_t i = 0; i < m.nodes.size(); i++ )
+    {
+        EXPECT_NE( m.nodes.get( i ), GeomBasics::nodeList.get( i ) );
+        EXPECT_TRUE( m.nodes.get( i )->equals( GeomBasics::nodeList.get( i ) ) );
+    }
+
+    // The diagonal keeps its nodes and both its triangles, all of the copy
+    auto diagonal = m.edges.get( 4 );
+    EXPECT_NE( diagonal, ac );
+    EXPECT_EQ( diagonal->leftNode, m.nodes.get( 0 ) );
+    EXPECT_EQ( diagonal->rightNode, m.nodes.get( 2 ) );
+    EXPECT_EQ( diagonal->element1, m.triangles.get( 0 ) );
+    EXPECT_EQ( diagonal->element2, m.triangles.get( 1 ) );
+    EXPECT_EQ( m.triangles.get( 1 )->edgeList[0], diagonal );
+    EXPECT_EQ( m.nodes.get( 0 )->edgeList.size(), 3u );
+    EXPECT_TRUE( m.nodes.get( 0 )->edgeList.contains( diagonal ) );
+
+    // Changing the copy leaves the mesh as it was
+    m.nodes.get( 0 )->x = 0.5;
+    EXPECT_EQ( a->x, 0.0 );
+}
+
+TEST_F( MeshSnapshotTest, RestoresTheMeshAsItWas )
+{
+    MeshSnapshot snap;
+
+    // Replace the two triangles by a quad
+    auto q = std::make_shared<Quad>( ab, da, bc, cd );
+    ac->disconnectNodes();
+    GeomBasics::edgeList.remove( 4 );
+    GeomBasics::triangleList.clear();
+    GeomBasics::elementList.add( q );
+    b->x = 2.0;
+
+    snap.restore();
+    ASSERT_EQ( GeomBasics::nodeList.size(), 4u );
+    ASSERT_EQ( GeomBasics::edgeList.size(), 5u );
+    ASSERT_EQ( GeomBasics::triangleList.size(), 2u );
+    EXPECT_EQ( GeomBasics::elementList.size(), 0u );
+    EXPECT_EQ( GeomBasics::nodeList.get( 1 )->x, 1.0 );
+    EXPECT_NE( GeomBasics::nodeList.get( 1 ), b );
+    EXPECT_EQ( GeomBasics::leftmost, GeomBasics::nodeList.get( 0 ) );
+    EXPECT_EQ( GeomBasics::edgeList.get( 4 )->element2, GeomBasics::triangleList.get( 1 ) );
+
+    // A snapshot of the restored mesh numbers its entities afresh
+    MeshSnapshot again;
+    EXPECT_EQ( again.nodeCount(), 4u );
+    EXPECT_EQ( again.edgeCount(), 5u );
+    EXPECT_EQ( again.elementCount(), 2u );
+}
@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "MeshTransaction.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+class MeshTransactionTest : public ::testing::Test
+{
+protected:
+    // Two triangles sharing the diagonal ac of the unit square
+    void SetUp() override
+    {
+        GeomBasics::clearLists();
+        a = std::make_shared<Node>( 0.0, 0.0 );
+        b = std::make_shared<Node>( 1.0, 0.0 );
+        c = std::make_shared<Node>( 1.0, 1.0 );
+        d = std::make_shared<Node>( 0.0, 1.0 );
+        ab = std::make_shared<Edge>( a, b );
+        bc = std::make_shared<Edge>( b, c );
+        cd = std::make_shared<Edge>( c, d );
+        da = std::make_shared<Edge>( d, a );
+        ac = std::make_shared<Edge>( a, c );
+        for ( const auto& e : { ab, bc, cd, da, ac } )
+        {
+            e->connectNodes();
+            GeomBasics::edgeList.add( e );
+        }
+        t1 = std::make_shared<Triangle>( ab, bc, ac );
+        t2 = std::make_shared<Triangle>( ac, cd, da );
+        t1->connectEdges();
+        t2->connectEdges();
+        GeomBasics::triangleList.add( t1 );
+        GeomBasics::triangleList.add( t2 );
+        for ( const auto& n : { a, b, c, d } )
+        {
+            GeomBasics::nodeList.add( n );
+        }
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+    }
+
+    // The mesh is the one made by SetUp()
+    void expectUnchanged()
+    {
+        ASSERT_EQ( GeomBasics::edgeList.size(), 5u );
+        EXPECT_EQ( GeomBasics::edgeList.get( 4 ), ac );
+        ASSERT_EQ( GeomBasics::triangleList.size(), 2u );
+        EXPECT_EQ( GeomBasics::triangleList.get( 0 ), t1 );
+        EXPECT_EQ( GeomBasics::triangleList.get( 1 ), t2 );
+        EXPECT_EQ( ac->element1, t1 );
+        EXPECT_EQ( ac->element2, t2 );
+        EXPECT_EQ( ab->element1, t1 );
+        EXPECT_EQ( cd->element1, t2 );
+        ASSERT_EQ( a->edgeList.size(), 3u );
+        EXPECT_EQ( a->edgeList.get( 0 ), ab );
+        EXPECT_EQ( a->edgeList.get( 1 ), da );
+        EXPECT_EQ( a->edgeList.get( 2 ), ac );
+        EXPECT_EQ( b->edgeList.size(), 2u );
+        EXPECT_EQ( d->edgeList.size(), 2u );
+    }
+
+    std::shared_ptr<Node> a, b, c, d;
+    std::shared_ptr<Edge> ab, bc, cd, da, ac;
+    std::shared_ptr<Triangle> t1, t2;
+};
+
+TEST_F( MeshTransactionTest, RollsBackASwap )
+{
+    MeshTransaction trial;
+    auto bd = std::make_shared<Edge>( b, d );
+    trial.swapEdge( ac, bd );
+
+    EXPECT_EQ( GeomBasics::edgeList.get( 4 ), bd );
+    EXPECT_EQ( GeomBasics::triangleList.get( 0 ), bd->element1 );
+    EXPECT_EQ( GeomBasics::triangleList.get( 1 ), bd->element2 );
+    EXPECT_EQ( a->edgeList.size(), 2u );
+    EXPECT_EQ( b->edgeList.size(), 3u );
+
+    trial.rollback();
+    EXPECT_EQ( trial.size(), 0u );
+    expectUnchanged();
+    EXPECT_EQ( b->edgeList.indexOf( bd ), -1 );
+    EXPECT_EQ( d->edgeList.indexOf( bd ), -1 );
+}
+
+TEST_F( MeshTransactionTest, RollsBackMovesAndReplacements )
+{
+    {
+        MeshTransaction trial;
+        trial.moveNode( c, Node( 2.0, 3.0 ) );
+        trial.recordPosition( c );
+        c->x = 5.0;
+        auto t = std::make_shared<Triangle>( ab, bc, ac );
+        trial.replaceElement( t1, t );
+        EXPECT_EQ( GeomBasics::triangleList.get( 0 ), t );
+        EXPECT_EQ( ac->element1, t2 );
+        EXPECT_EQ( ac->element2, t );
+        // Going out of scope rolls the transaction back
+    }
+    EXPECT_EQ( c->x, 1.0 );
+    EXPECT_EQ( c->y, 1.0 );
+    EXPECT_DOUBLE_EQ( ac->len, std::sqrt( 2.0 ) );
+    expectUnchanged();
+}
+
+TEST_F( MeshTransactionTest, KeepsCommittedChanges )
+{
+    MeshTransaction trial;
+    auto bd = std::make_shared<Edge>( b, d );
+    trial.swapEdge( ac, bd );
+    trial.commit();
+    EXPECT_EQ( trial.size(), 0u );
+    trial.rollback();
+    EXPECT_EQ( GeomBasics::edgeList.get( 4 ), bd );
+    EXPECT_EQ( ac->element1, nullptr );
+    EXPECT_EQ( a->edgeList.indexOf( ac ), -1 );
+}
@@ -4,6 +4,8 @@
 
 #include "Node.h"
 #include "Edge.h"
+#include "Triangle.h"
+#include "MyVector.h"
 
 //All tests are working.
 
@@ -215,4 +217,127 @@ TEST_F( NodeTest, ValDescrTest )
     // Test case 3: pattern with no elements
     node1.pattern = { 2, 0 };
     EXPECT_EQ( node1.valDescr(), "0-" );
-}
\ No newline at end of file
+}
+
+
+// A fan of four triangles around the node at the origin
+static std::vector<std::shared_ptr<Triangle>> makeFan( const std::shared_ptr<Node>& c,
+                                                       std::vector<std::shared_ptr<Node>>& outer )
+{
+    outer = { std::make_shared<Node>( 1.0, 0.0 ), std::make_shared<Node>( 0.0, 1.0 ),
+              std::make_shared<Node>( -1.0, 0.0 ), std::make_shared<Node>( 0.0, -1.0 ) };
+    std::vector<std::shared_ptr<Edge>> spokes, rim;
+    for ( size_t i = 0; i < 4; i++ )
+    {
+        spokes.push_back( std::make_shared<Edge>( c, outer[i] ) );
+        spokes.back()->connectNodes();
+    }
+    for ( size_t i = 0; i < 4; i++ )
+    {
+        rim.push_back( std::make_shared<Edge>( outer[i], outer[(i + 1) % 4] ) );
+        rim.back()->connectNodes();
+    }
+    std::vector<std::shared_ptr<Triangle>> fan;
+    for ( size_t i = 0; i < 4; i++ )
+    {
+        fan.push_back( std::make_shared<Triangle>( spokes[i], rim[i], spokes[(i + 1) % 4] ) );
+        fan.back()->connectEdges();
+    }
+    return fan;
+}
+
+TEST_F( NodeTest, StarFollowsTopologyChanges )
+{
+    auto c = std::make_shared<Node>( 0.0, 0.0 );
+    std::vector<std::shared_ptr<Node>> outer;
+    auto fan = makeFan( c, outer );
+
+    EXPECT_EQ( c->adjElements().size(), 4u );
+    EXPECT_EQ( c->adjTriangles().size(), 4u );
+    EXPECT_EQ( c->nrOfAdjQuads(), 0 );
+    EXPECT_EQ( outer[0]->adjTriangles().size(), 2u );
+    EXPECT_EQ( c->ccwSortedVectorList().size(), 4u );
+
+    // Removing a triangle must reach the cached stars of all its nodes
+    fan[0]->disconnectEdges();
+    EXPECT_EQ( c->adjElements().size(), 3u );
+    EXPECT_EQ( c->adjTriangles().size(), 3u );
+    EXPECT_EQ( outer[0]->adjTriangles().size(), 1u );
+    EXPECT_EQ( outer[1]->adjTriangles().size(), 1u );
+
+    fan[0]->connectEdges();
+    EXPECT_EQ( c->adjElements().size(), 4u );
+    EXPECT_EQ( outer[1]->adjElements().size(), 2u );
+}
+
+TEST_F( NodeTest, CcwSortedVectorListFollowsMoves )
+{
+    auto c = std::make_shared<Node>( 0.0, 0.0 );
+    std::vector<std::shared_ptr<Node>> outer;
+    auto fan = makeFan( c, outer );
+
+    auto first = c->ccwSortedVectorList();
+    auto second = c->ccwSortedVectorList();
+    ASSERT_EQ( first.size(), second.size() );
+    for ( size_t i = 0; i < first.size(); i++ )
+    {
+        EXPECT_EQ( first.get( i )->edge, second.get( i )->edge );
+        // Successive vectors turn ccw around the node
+        const auto& next = first.get( (i + 1) % first.size() );
+        EXPECT_FALSE( next->isCWto( *first.get( i ) ) );
+    }
+
+    outer[1]->setXY( 0.0, 2.0 );
+    for ( const auto& v : c->ccwSortedVectorList() )
+    {
+        if ( v->edge->hasNode( outer[1] ) )
+        {
+            EXPECT_DOUBLE_EQ( v->y, 2.0 );
+        }
+    }
+}
+
+TEST_F( NodeTest, CcwSortedEdgesIsTheCachedOrderOfTheVectorList )
+{
+    auto c = std::make_shared<Node>( 0.0, 0.0 );
+    std::vector<std::shared_ptr<Node>> outer;
+    auto fan = makeFan( c, outer );
+
+    const auto& edges = c->ccwSortedEdges();
+    auto vectors = c->ccwSortedVectorList();
+    ASSERT_EQ( edges.size(), 4u );
+    ASSERT_EQ( vectors.size(), edges.size() );
+    for ( size_t i = 0; i < edges.size(); i++ )
+    {
+        EXPECT_EQ( vectors.get( i )->edge, edges.get( i ) );
+        const auto& next = edges.get( (i + 1) % edges.size() );
+        EXPECT_FALSE( next->getVec2( c ).isCWto( edges.get( i )->getVec2( c ) ) );
+    }
+    EXPECT_EQ( &c->ccwSortedEdges(), &edges );
+}
+
+TEST( NodeIdentityTest, ListsFindNodesByIdentity )
+{
+    auto a = std::make_shared<Node>( 1.0, 1.0 );
+    auto b = std::make_shared<Node>( 1.0, 1.0 );
+    EXPECT_NE( a->id, b->id );
+    EXPECT_TRUE( a->equals( b ) );
+
+    ArrayList<std::shared_ptr<Node>> list;
+    list.add( a );
+    EXPECT_EQ( list.indexOf( a ), 0 );
+    EXPECT_EQ( list.indexOf( b ), -1 );
+    EXPECT_FALSE( list.contains( b ) );
+
+    // The search by coordinates is a query of its own
+    EXPECT_EQ( list.indexOfEqual( b ), 0 );
+    EXPECT_TRUE( list.containsEqual( b ) );
+
+    auto e1 = std::make_shared<Edge>( a, std::make_shared<Node>( 2.0, 1.0 ) );
+    auto e2 = std::make_shared<Edge>( *e1 );
+    EXPECT_NE( e1->id, e2->id );
+    ArrayList<std::shared_ptr<Edge>> edges;
+    edges.add( e1 );
+    EXPECT_FALSE( edges.contains( e2 ) );
+    EXPECT_TRUE( edges.containsEqual( e2 ) );
+}
@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "Predicates.h"
+#include "Node.h"
+
+#include <cmath>
+
+TEST( PredicatesTest, Orient2dSigns )
+{
+    EXPECT_GT( rcl::orient2d( 0.0, 0.0, 1.0, 0.0, 0.0, 1.0 ), 0.0 );
+    EXPECT_LT( rcl::orient2d( 0.0, 0.0, 0.0, 1.0, 1.0, 0.0 ), 0.0 );
+    EXPECT_EQ( rcl::orient2d( 0.0, 0.0, 1.0, 1.0, 2.0, 2.0 ), 0.0 );
+}
+
+TEST( PredicatesTest, Orient2dNearlyCollinear )
+{
+    // The naive determinant of these points is dominated by roundoff. The
+    // third point is nudged one ulp off the line y = x in either direction.
+    double a = 0.5;
+    double b = 12.0;
+    double c = 24.0;
+    double above = std::nextafter( c, 100.0 );
+    double below = std::nextafter( c, 0.0 );
+
+    EXPECT_EQ( rcl::orientation( a, a, b, b, c, c ), 0 );
+    EXPECT_EQ( rcl::orientation( a, a, b, b, c, above ), 1 );
+    EXPECT_EQ( rcl::orientation( a, a, b, b, c, below ), -1 );
+}
+
+TEST( PredicatesTest, Orient2dConsistentUnderPermutation )
+{
+    double ax = 0.1, ay = 0.1;
+    double bx = 0.3, by = 0.3 + 1e-17;
+    double cx = 0.7, cy = 0.7;
+
+    int s = rcl::orientation( ax, ay, bx, by, cx, cy );
+    EXPECT_EQ( rcl::orientation( bx, by, cx, cy, ax, ay ), s );
+    EXPECT_EQ( rcl::orientation( cx, cy, ax, ay, bx, by ), s );
+    EXPECT_EQ( rcl::orientation( bx, by, ax, ay, cx, cy ), -s );
+}
+
+TEST( PredicatesTest, Cross2dMatchesOrient2d )
+{
+    EXPECT_GT( rcl::cross2d( 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 ), 0.0 );
+    EXPECT_LT( rcl::cross2d( 1.0, 1.0, 1.0, 2.0, 5.0, 5.0, 6.0, 5.0 ), 0.0 );
+    EXPECT_EQ( rcl::cross2d( 1.0, 1.0, 2.0, 2.0, 3.0, 0.0, 4.0, 1.0 ), 0.0 );
+}
+
+TEST( PredicatesTest, IncircleSigns )
+{
+    // Unit circle through (1,0), (0,1) and (-1,0), ccw
+    EXPECT_GT( rcl::incircle( 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, 0.0 ), 0.0 );
+    EXPECT_LT( rcl::incircle( 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 2.0, 2.0 ), 0.0 );
+    EXPECT_EQ( rcl::incircle( 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, -1.0 ), 0.0 );
+}
+
+TEST( PredicatesTest, IncircleCocircularLargeOffset )
+{
+    // Four cocircular points far from the origin, where the filtered
+    // evaluation cannot decide and the exact fallback has to.
+    double o = 1e6;
+    EXPECT_EQ( rcl::incircle( o + 3.0, o + 4.0, o - 4.0, o + 3.0, o - 3.0, o - 4.0, o + 4.0, o - 3.0 ), 0.0 );
+    EXPECT_GT( rcl::incircle( o + 3.0, o + 4.0, o - 4.0, o + 3.0, o - 3.0, o - 4.0, std::nextafter( o + 4.0, o ), o - 3.0 ), 0.0 );
+    EXPECT_LT( rcl::incircle( o + 3.0, o + 4.0, o - 4.0, o + 3.0, o - 3.0, o - 4.0, std::nextafter( o + 4.0, 2 * o ), o - 3.0 ), 0.0 );
+}
+
+TEST( PredicatesTest, NodeInCircleCocircular )
+{
+    auto p1 = std::make_shared<Node>( 1.0, 0.0 );
+    auto p2 = std::make_shared<Node>( 0.0, 1.0 );
+    auto p3 = std::make_shared<Node>( -1.0, 0.0 );
+    auto inside = std::make_shared<Node>( 0.0, -0.5 );
+    auto on = std::make_shared<Node>( 0.0, -1.0 );
+
+    EXPECT_TRUE( inside->inCircle( p1, p2, p3 ) );
+    EXPECT_FALSE( on->inCircle( p1, p2, p3 ) );
+    EXPECT_TRUE( inside->inCircle( p3, p2, p1 ) );
+}
+
+TEST( PredicatesTest, InCircumcircleIgnoresTheOrder )
+{
+    EXPECT_TRUE( rcl::inCircumcircle( 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, -0.5 ) );
+    EXPECT_TRUE( rcl::inCircumcircle( -1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, -0.5 ) );
+    EXPECT_FALSE( rcl::inCircumcircle( 1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, -1.0 ) );
+    EXPECT_FALSE( rcl::inCircumcircle( -1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, -2.0 ) );
+    // Collinear points have no circumcircle
+    EXPECT_FALSE( rcl::inCircumcircle( 0.0, 0.0, 1.0, 1.0, 2.0, 2.0, 1.0, 0.0 ) );
+}
+
+TEST( PredicatesTest, NodeInHalfplane )
+{
+    auto l1 = std::make_shared<Node>( 0.0, 0.0 );
+    auto l2 = std::make_shared<Node>( 1.0, 1.0 );
+    auto same = std::make_shared<Node>( 0.0, 1.0 );
+    auto other = std::make_shared<Node>( 1.0, 0.0 );
+    auto n = std::make_shared<Node>( 0.25, 0.75 );
+    auto onLine = std::make_shared<Node>( 3.0, 3.0 );
+
+    EXPECT_EQ( n->inHalfplane( l1, l2, same ), 1 );
+    EXPECT_EQ( n->inHalfplane( l1, l2, other ), -1 );
+    EXPECT_EQ( onLine->inHalfplane( l1, l2, same ), 0 );
+}
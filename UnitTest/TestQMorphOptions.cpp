@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "QMorphOptions.h"
+#include "ParameterSweep.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+TEST( QMorphOptionsTest, DefaultsAreThoseOfThePaper )
+{
+    QMorphOptions o;
+    EXPECT_DOUBLE_EQ( o.epsilon1, std::numbers::pi * 0.04 );
+    EXPECT_DOUBLE_EQ( o.epsilon2, std::numbers::pi * 0.09 );
+    EXPECT_DOUBLE_EQ( o.chevronMin, Constants::DEG_200 );
+    EXPECT_DOUBLE_EQ( o.obsTol, 0.1 );
+    EXPECT_DOUBLE_EQ( o.myMin, 0.05 );
+    EXPECT_DOUBLE_EQ( o.gamma, 0.8 );
+    EXPECT_EQ( o.maxIter, 5 );
+}
+
+TEST( QMorphOptionsTest, ParsesWhatItDescribes )
+{
+    QMorphOptions o;
+    ASSERT_TRUE( o.parse( "epsilon1=5 chevronMin=190  gamma=0.5 maxIter=8" ) );
+    EXPECT_DOUBLE_EQ( o.epsilon1, Constants::toRadians * 5 );
+    EXPECT_DOUBLE_EQ( o.chevronMin, Constants::toRadians * 190 );
+    EXPECT_DOUBLE_EQ( o.gamma, 0.5 );
+    EXPECT_EQ( o.maxIter, 8 );
+    EXPECT_DOUBLE_EQ( o.myMin, 0.05 );
+
+    QMorphOptions p;
+    ASSERT_TRUE( p.parse( o.descr() ) );
+    EXPECT_EQ( p.descr(), o.descr() );
+
+    EXPECT_FALSE( p.parse( "gama=0.5" ) );
+    EXPECT_FALSE( p.parse( "gamma" ) );
+    EXPECT_FALSE( p.parse( "gamma=high" ) );
+}
+
+TEST( ParameterSweepTest, MeshesACopyPerConfiguration )
+{
+    // Two triangles sharing the diagonal of the unit square
+    GeomBasics::clearLists();
+    auto a = std::make_shared<Node>( 0.0, 0.0 ), b = std::make_shared<Node>( 1.0, 0.0 );
+    auto c = std::make_shared<Node>( 1.0, 1.0 ), d = std::make_shared<Node>( 0.0, 1.0 );
+    std::shared_ptr<Edge> ab = std::make_shared<Edge>( a, b ), bc = std::make_shared<Edge>( b, c );
+    std::shared_ptr<Edge> cd = std::make_shared<Edge>( c, d ), da = std::make_shared<Edge>( d, a );
+    std::shared_ptr<Edge> ac = std::make_shared<Edge>( a, c );
+    for ( const auto& e : { ab, bc, cd, da, ac } )
+    {
+        e->connectNodes();
+        GeomBasics::edgeList.add( e );
+    }
+    auto t1 = std::make_shared<Triangle>( ab, bc, ac ), t2 = std::make_shared<Triangle>( ac, cd, da );
+    t1->connectEdges();
+    t2->connectEdges();
+    GeomBasics::triangleList.add( t1 );
+    GeomBasics::triangleList.add( t2 );
+    for ( const auto& n : { a, b, c, d } )
+    {
+        GeomBasics::nodeList.add( n );
+    }
+
+    ParameterSweep sweep;
+    std::vector<QMorphOptions> configs( 3 );
+    configs[1].gamma = 0.5;
+    configs[2].maxIter = 1;
+    auto results = sweep.run( configs, 2 );
+
+    ASSERT_EQ( results.size(), 3u );
+    for ( size_t i = 0; i < results.size(); i++ )
+    {
+        EXPECT_EQ( results[i].options.descr(), configs[i].descr() );
+        EXPECT_EQ( results[i].quads, 1u );
+        EXPECT_EQ( results[i].triangles, 0u );
+        EXPECT_GT( results[i].averageMetric, 0.9 );
+    }
+
+    // The input is left as it was
+    EXPECT_EQ( GeomBasics::triangleList.size(), 2u );
+    EXPECT_EQ( ac->element1, t1 );
+    EXPECT_EQ( a->edgeList.size(), 3u );
+    GeomBasics::clearLists();
+}
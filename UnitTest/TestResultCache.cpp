@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "ResultCache.h"
+#include "GeomBasics.h"
+#include "Edge.h"
+#include "Node.h"
+#include "Triangle.h"
+
+#include <filesystem>
+
+class ResultCacheTest : public ::testing::Test
+{
+protected:
+    std::string directory = (std::filesystem::temp_directory_path() / "TestResultCache").string();
+
+    // Two triangles sharing the diagonal of the unit square, with the nodes
+    // added in the given order
+    void makeMesh( bool reversed )
+    {
+        GeomBasics::clearLists();
+        auto a = std::make_shared<Node>( 0.0, 0.0 ), b = std::make_shared<Node>( 1.0, 0.0 );
+        auto c = std::make_shared<Node>( 1.0, 1.0 ), d = std::make_shared<Node>( 0.0, 1.0 );
+        std::shared_ptr<Edge> ab = std::make_shared<Edge>( a, b ), bc = std::make_shared<Edge>( b, c );
+        std::shared_ptr<Edge> cd = std::make_shared<Edge>( c, d ), da = std::make_shared<Edge>( d, a );
+        std::shared_ptr<Edge> ac = std::make_shared<Edge>( a, c );
+        for ( const auto& e : { ab, bc, cd, da, ac } )
+        {
+            e->connectNodes();
+            GeomBasics::edgeList.add( e );
+        }
+        auto t1 = std::make_shared<Triangle>( ab, bc, ac ), t2 = std::make_shared<Triangle>( ac, cd, da );
+        t1->connectEdges();
+        t2->connectEdges();
+        GeomBasics::triangleList.add( t1 );
+        GeomBasics::triangleList.add( t2 );
+        for ( const auto& n : { a, b, c, d } )
+        {
+            GeomBasics::nodeList.add( n );
+        }
+        if ( reversed )
+        {
+            ArrayList<std::shared_ptr<Node>> nodes = GeomBasics::nodeList;
+            ArrayList<std::shared_ptr<Edge>> edges = GeomBasics::edgeList;
+            GeomBasics::nodeList.clear();
+            GeomBasics::edgeList.clear();
+            for ( size_t i = nodes.size(); i-- > 0; )
+            {
+                GeomBasics::nodeList.add( nodes.get( i ) );
+            }
+            for ( size_t i = edges.size(); i-- > 0; )
+            {
+                GeomBasics::edgeList.add( edges.get( i ) );
+            }
+        }
+        GeomBasics::findExtremeNodes();
+    }
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all( directory );
+        makeMesh( false );
+    }
+
+    void TearDown() override
+    {
+        GeomBasics::clearLists();
+        GeomBasics::leftmost = GeomBasics::rightmost = GeomBasics::uppermost = GeomBasics::lowermost = nullptr;
+        std::filesystem::remove_all( directory );
+    }
+};
+
+TEST_F( ResultCacheTest, KeyIgnoresTheOrderOfTheLists )
+{
+    auto key = ResultCache::key();
+    EXPECT_EQ( key, ResultCache::key() );
+    EXPECT_NE( key, ResultCache::key( 10 ) );
+    EXPECT_NE( key, ResultCache::key( -1, 0.5 ) );
+    QMorphOptions options;
+    EXPECT_EQ( key, ResultCache::key( -1, 0.0, false, options ) );
+    options.gamma = 0.5;
+    EXPECT_NE( key, ResultCache::key( -1, 0.0, false, options ) );
+
+    makeMesh( true );
+    EXPECT_EQ( key, ResultCache::key() );
+
+    GeomBasics::nodeList.get( 0 )->setXY( 1.0, 1.5 );
+    EXPECT_NE( key, ResultCache::key() );
+}
+
+TEST_F( ResultCacheTest, LoadsTheStoredMesh )
+{
+    ResultCache cache( directory, 4 );
+    auto key = ResultCache::key();
+    EXPECT_FALSE( cache.load( key ) );
+    ASSERT_TRUE( cache.store( key ) );
+
+    GeomBasics::clearLists();
+    ASSERT_TRUE( cache.load( key ) );
+    EXPECT_EQ( cache.hits(), 1u );
+    EXPECT_EQ( cache.misses(), 1u );
+    ASSERT_EQ( GeomBasics::nodeList.size(), 4u );
+    ASSERT_EQ( GeomBasics::edgeList.size(), 5u );
+    ASSERT_EQ( GeomBasics::triangleList.size(), 2u );
+    EXPECT_EQ( GeomBasics::uppermost->y, 1.0 );
+    EXPECT_EQ( key, ResultCache::key() );
+}
+
+TEST_F( ResultCacheTest, EvictsTheLeastRecentlyUsed )
+{
+    ResultCache cache( directory, 2 );
+    auto first = ResultCache::key( 1 ), second = ResultCache::key( 2 ), third = ResultCache::key( 3 );
+    ASSERT_TRUE( cache.store( first ) );
+    ASSERT_TRUE( cache.store( second ) );
+    auto old = std::filesystem::file_time_type::clock::now() - std::chrono::hours( 1 );
+    std::filesystem::last_write_time( std::filesystem::path( directory ) / (second + ".qmcp"), old );
+    std::filesystem::last_write_time( std::filesystem::path( directory ) / (first + ".qmcp"), old - std::chrono::hours( 1 ) );
+
+    // Using the first entry makes the second the least recently used
+    EXPECT_TRUE( cache.load( first ) );
+    ASSERT_TRUE( cache.store( third ) );
+    EXPECT_TRUE( cache.load( first ) );
+    EXPECT_FALSE( cache.load( second ) );
+    EXPECT_TRUE( cache.load( third ) );
+}
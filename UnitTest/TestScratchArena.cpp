@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "ScratchArena.h"
+#include "Node.h"
+
+#include <memory_resource>
+#include <thread>
+
+TEST( ScratchArenaTest, OutsideAScopeScratchMemoryIsTheHeap )
+{
+    EXPECT_FALSE( ScratchArena::active() );
+    EXPECT_EQ( ScratchArena::resource(), std::pmr::new_delete_resource() );
+
+    ScratchList<int> list;
+    list.add( 1 );
+    EXPECT_EQ( ScratchArena::bytesInUse(), 0u );
+}
+
+TEST( ScratchArenaTest, ScratchListsInAScopeUseTheArena )
+{
+    ScratchArena::Scope scratch;
+    EXPECT_TRUE( ScratchArena::active() );
+    EXPECT_NE( ScratchArena::resource(), std::pmr::new_delete_resource() );
+    {
+        ScratchList<int> list;
+        for ( int i = 0; i < 100; i++ )
+        {
+            list.add( i );
+        }
+        EXPECT_GE( ScratchArena::bytesInUse(), 100 * sizeof( int ) );
+
+        ArrayList<int> copy;
+        copy.addAll( list );
+        EXPECT_EQ( copy.size(), 100u );
+        EXPECT_EQ( copy.get( 99 ), 99 );
+    }
+    EXPECT_EQ( ScratchArena::bytesInUse(), 0u );
+}
+
+TEST( ScratchArenaTest, MakeAndCopyXYUseTheArena )
+{
+    auto n = std::make_shared<Node>( 1.0, 2.0 );
+    ScratchArena::Scope scratch;
+    {
+        auto old = n->copyXY();
+        EXPECT_GT( ScratchArena::bytesInUse(), 0u );
+        EXPECT_TRUE( old->equals( n ) );
+
+        auto other = ScratchArena::make<Node>( 3.0, 4.0 );
+        EXPECT_DOUBLE_EQ( other->x, 3.0 );
+    }
+    EXPECT_EQ( ScratchArena::bytesInUse(), 0u );
+}
+
+TEST( ScratchArenaTest, NestedScopesShareTheArena )
+{
+    ScratchArena::Scope outer;
+    auto resource = ScratchArena::resource();
+    ScratchList<int> list;
+    list.add( 1 );
+    {
+        ScratchArena::Scope inner;
+        EXPECT_EQ( ScratchArena::resource(), resource );
+    }
+    // Closing the inner Scope leaves the list of the outer one alone
+    EXPECT_TRUE( ScratchArena::active() );
+    list.add( 2 );
+    EXPECT_EQ( list.get( 0 ), 1 );
+    EXPECT_EQ( list.get( 1 ), 2 );
+}
+
+TEST( ScratchArenaTest, TheBlockGrowsToFitTheLargestScope )
+{
+    // On a thread of its own, so that the block starts at its initial size
+    std::thread( [] {
+        auto before = ScratchArena::blockSize();
+        {
+            ScratchArena::Scope scratch;
+            ScratchList<char> list;
+            list.reserve( 2 * before );
+        }
+        EXPECT_GT( ScratchArena::blockSize(), before );
+        EXPECT_FALSE( ScratchArena::active() );
+    } ).join();
+}
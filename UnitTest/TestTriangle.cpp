@@ -3,3 +3,21 @@
 #include "Edge.h"
 #include "Node.h"
 
+TEST( TriangleTest, ReinitKeepsTheIdentity )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 );
+    auto b = std::make_shared<Node>( 1.0, 0.0 );
+    auto c = std::make_shared<Node>( 1.0, 1.0 );
+    auto d = std::make_shared<Node>( 0.0, 1.0 );
+    auto ab = std::make_shared<Edge>( a, b );
+    auto t = std::make_shared<Triangle>( ab, std::make_shared<Edge>( a, c ), std::make_shared<Edge>( b, c ) );
+    auto id = t->id;
+    t->distortionMetric = 1.0;
+
+    auto ad = std::make_shared<Edge>( a, d ), cd = std::make_shared<Edge>( c, d );
+    t->reinit( cd, ad, std::make_shared<Edge>( a, c ) );
+    EXPECT_EQ( t->id, id );
+    EXPECT_EQ( t->edgeList[0], cd );
+    EXPECT_DOUBLE_EQ( t->distortionMetric, 0.0 );
+    EXPECT_NEAR( t->ang[0] + t->ang[1] + t->ang[2], 3.14159265358979323846, 1e-12 );
+}
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "Vec2.h"
+#include "MyVector.h"
+#include "MyLine.h"
+#include "Ray.h"
+#include "Node.h"
+
+// The arithmetic is usable in constant expressions
+static_assert( Vec2{ 1.0, 2.0 }.dot( Vec2{ 3.0, 4.0 } ) == 11.0 );
+static_assert( Vec2{ 1.0, 0.0 }.cross( Vec2{ 0.0, 1.0 } ) == 1.0 );
+static_assert( Vec2{ 1.0, 0.0 }.isCWto( Vec2{ 0.0, 1.0 } ) );
+static_assert( (Point2{ 3.0, 4.0 } - Point2{ 1.0, 1.0 }).lengthSquared() == 13.0 );
+static_assert( intersection( { 0.0, 0.0 }, { 2.0, 0.0 }, { 1.0, -1.0 }, { 0.0, 2.0 } )->s == 0.5 );
+
+TEST( Vec2Test, ArithmeticTest )
+{
+    Vec2 a{ 1.0, 2.0 }, b{ 3.0, -1.0 };
+    EXPECT_DOUBLE_EQ( (a + b).x, 4.0 );
+    EXPECT_DOUBLE_EQ( (a - b).y, 3.0 );
+    EXPECT_DOUBLE_EQ( (a * 2.0).y, 4.0 );
+    EXPECT_DOUBLE_EQ( (b / 2.0).x, 1.5 );
+    EXPECT_DOUBLE_EQ( (-a).x, -1.0 );
+    EXPECT_DOUBLE_EQ( Vec2( { 3.0, 4.0 } ).length(), 5.0 );
+    EXPECT_DOUBLE_EQ( Vec2( { 3.0, 4.0 } ).normalized().y, 0.8 );
+}
+
+TEST( Vec2Test, IsCWtoMatchesMyVector )
+{
+    auto origin = std::make_shared<Node>( 0.0, 0.0 );
+    const Vec2 vectors[] = { { 1.0, 0.0 }, { 0.0, 1.0 }, { -1.0, 1.0 }, { 2.0, 0.0 }, { 1.0, -1e-20 }, { -1.0, 0.0 } };
+    for ( const auto& a : vectors )
+    {
+        for ( const auto& b : vectors )
+        {
+            MyVector va( origin, a ), vb( origin, b );
+            EXPECT_EQ( a.isCWto( b ), va.isCWto( vb ) );
+        }
+    }
+    // A vector is not cw to itself
+    EXPECT_FALSE( vectors[0].isCWto( vectors[0] ) );
+}
+
+TEST( Vec2Test, IntersectionTest )
+{
+    auto c = intersection( { 0.0, 0.0 }, { 2.0, 2.0 }, { 0.0, 2.0 }, { 2.0, -2.0 } );
+    ASSERT_TRUE( c.has_value() );
+    EXPECT_DOUBLE_EQ( c->s, 0.5 );
+    EXPECT_DOUBLE_EQ( c->t, 0.5 );
+
+    EXPECT_FALSE( intersection( { 0.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 }, { 2.0, 2.0 } ).has_value() );
+}
+
+TEST( Vec2Test, CoordinateOverloadsMatchTheNodeVersions )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 ), b = std::make_shared<Node>( 2.0, 2.0 );
+    auto c = std::make_shared<Node>( 0.0, 2.0 ), d = std::make_shared<Node>( 2.0, 0.0 );
+    MyVector ab( a, b ), cd( c, d );
+
+    auto n = ab.pointIntersectsAt( cd );
+    auto p = MyVector::pointIntersectsAt( a->point(), ab.vec(), c->point(), cd.vec() );
+    ASSERT_NE( n, nullptr );
+    ASSERT_TRUE( p.has_value() );
+    EXPECT_DOUBLE_EQ( p->x, n->x );
+    EXPECT_DOUBLE_EQ( p->y, n->y );
+    EXPECT_TRUE( MyVector::innerpointIntersects( a->point(), ab.vec(), c->point(), cd.vec() ) );
+    EXPECT_EQ( ab.innerpointIntersects( cd ), true );
+    // Sharing an endpoint is not an inner point intersection
+    EXPECT_FALSE( MyVector::innerpointIntersects( a->point(), ab.vec(), a->point(), cd.vec() ) );
+
+    auto l = MyLine::pointIntersectsAt( a->point(), { 1.0, 1.0 }, c->point(), { 1.0, -1.0 } );
+    ASSERT_TRUE( l.has_value() );
+    EXPECT_DOUBLE_EQ( l->x, 1.0 );
+    EXPECT_DOUBLE_EQ( l->y, 1.0 );
+
+    Ray r( a, b );
+    auto q = r.pointIntersectsAt( c->point(), cd.vec() );
+    ASSERT_TRUE( q.has_value() );
+    EXPECT_DOUBLE_EQ( q->x, 1.0 );
+    EXPECT_FALSE( r.pointIntersectsAt( { 3.0, 0.0 }, { 0.0, -1.0 } ).has_value() );
+}
@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "WeakLink.h"
+#include "Node.h"
+
+TEST( WeakLinkTest, ReadsAsNullOnceTheEntityIsFreed )
+{
+    auto n = std::make_shared<Node>( 1.0, 2.0 );
+    WeakLink<Node> link = n;
+    EXPECT_EQ( n.use_count(), 1 );
+    EXPECT_TRUE( link == n );
+    EXPECT_EQ( link->x, 1.0 );
+
+    std::shared_ptr<Node> locked = link;
+    EXPECT_EQ( locked, n );
+    locked = nullptr;
+
+    n = nullptr;
+    EXPECT_TRUE( link == nullptr );
+    EXPECT_FALSE( link );
+    EXPECT_EQ( link.lock(), nullptr );
+}
+
+TEST( WeakLinkTest, ComparesByIdentity )
+{
+    auto a = std::make_shared<Node>( 0.0, 0.0 );
+    auto b = std::make_shared<Node>( 0.0, 0.0 );
+    WeakLink<Node> la = a, lb = b;
+    EXPECT_FALSE( la == lb );
+    EXPECT_TRUE( la == WeakLink<Node>( a ) );
+    EXPECT_TRUE( b == lb );
+    EXPECT_TRUE( WeakLink<Node>() == nullptr );
+
+    ArrayList<WeakLink<Node>> list;
+    list.add( a );
+    list.add( b );
+    EXPECT_EQ( list.indexOf( b ), 1 );
+}